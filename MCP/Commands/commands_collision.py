@@ -0,0 +1,124 @@
+"""Collision query commands for the UnrealMCP bridge.
+
+These tools run many traces against the editor world's collision in one request instead of
+one execute_python round trip per ray.
+"""
+
+import base64
+import json
+import os
+import struct
+import sys
+from typing import List, Optional
+
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+
+def _pack_doubles(values: List[float]) -> str:
+    return base64.b64encode(struct.pack(f"<{len(values)}d", *values)).decode("ascii")
+
+
+def _unpack(result: dict, field: str, fmt: str) -> tuple:
+    data = base64.b64decode(result.get(f"{field}_base64", ""))
+    return struct.unpack(f"<{len(data) // struct.calcsize(fmt)}{fmt}", data)
+
+
+def register_all(mcp):
+    """Register all collision query commands with the MCP server."""
+
+    @mcp.tool()
+    def batch_traces(
+        ctx: Context,
+        origins: List[float],
+        directions: Optional[List[float]] = None,
+        ends: Optional[List[float]] = None,
+        max_distance: float = 100000.0,
+        shape: str = "line",
+        radius: Optional[float] = None,
+        half_height: Optional[float] = None,
+        half_extent: Optional[List[float]] = None,
+        channel: str = "visibility",
+        trace_complex: bool = True,
+        ignore_actors: Optional[List[str]] = None,
+        include_misses: bool = False,
+    ) -> str:
+        """Run many line traces or shape sweeps against the editor world in a single call.
+
+        Args:
+            origins: Flat list of ray origins [x0, y0, z0, x1, ...].
+            directions: Flat list of directions (one per origin, or a single shared [x, y, z]);
+                each ray extends max_distance along it.
+            ends: Flat list of end points instead of directions (one per origin, or one shared).
+            max_distance: Ray length used with directions.
+            shape: "line", "sphere", "capsule" or "box".
+            radius: Sphere/capsule radius.
+            half_height: Capsule half height.
+            half_extent: Box half extent [x, y, z].
+            channel: Collision channel (visibility, camera, worldstatic, worlddynamic, pawn, ...).
+            trace_complex: Trace against complex (per-triangle) collision.
+            ignore_actors: Names or labels of actors the rays pass through.
+            include_misses: Also list rays that hit nothing.
+        """
+        try:
+            params = {
+                "origins_f64_base64": _pack_doubles(origins),
+                "max_distance": max_distance,
+                "shape": shape,
+                "channel": channel,
+                "trace_complex": trace_complex,
+            }
+            if ends:
+                params["ends_f64_base64"] = _pack_doubles(ends)
+            elif directions:
+                params["directions_f64_base64"] = _pack_doubles(directions)
+            else:
+                return "Error: provide either directions or ends"
+            if radius is not None:
+                params["radius"] = radius
+            if half_height is not None:
+                params["half_height"] = half_height
+            if half_extent:
+                params["half_extent"] = half_extent
+            if ignore_actors:
+                params["ignore_actors"] = ignore_actors
+
+            response = send_command("batch_traces", params)
+            if response["status"] != "success":
+                return f"Error: {response['message']}"
+
+            result = response["result"]
+            hits = _unpack(result, "hits", "B")
+            positions = _unpack(result, "positions", "d")
+            normals = _unpack(result, "normals", "f")
+            distances = _unpack(result, "distances", "f")
+            actor_ids = _unpack(result, "actor_ids", "i")
+            actors = result.get("actors", [])
+
+            rays = []
+            for index, hit in enumerate(hits):
+                if not hit:
+                    if include_misses:
+                        rays.append({"index": index, "hit": False})
+                    continue
+                actor_id = actor_ids[index]
+                rays.append({
+                    "index": index,
+                    "hit": True,
+                    "position": list(positions[index * 3:index * 3 + 3]),
+                    "normal": list(normals[index * 3:index * 3 + 3]),
+                    "distance": distances[index],
+                    "actor": actors[actor_id]["label"] if actor_id >= 0 else None,
+                })
+
+            return json.dumps({
+                "ray_count": result["ray_count"],
+                "hit_count": result["hit_count"],
+                "actors": actors,
+                "rays": rays,
+            }, indent=2)
+        except Exception as e:
+            return f"Error running batch traces: {str(e)}"
@@ -4,9 +4,10 @@ This module exposes tools for creating and modifying Unreal Engine data tables
 through the MCP bridge, enabling AI-driven workflows for structured game data.
 """
 
+import json
 import os
 import sys
-from typing import Dict, List, Optional
+from typing import Any, Dict, List, Optional
 
 from mcp.server.fastmcp import Context
 
@@ -15,6 +16,33 @@ sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 from unreal_mcp_bridge import send_command
 
 
+def _add_rows_file(params: Dict, rows_file: Optional[str], rows_format: Optional[str], name_column: Optional[str]) -> None:
+    """Add the file import fields shared by create_data_table and modify_data_table."""
+    if not rows_file:
+        return
+    params["rows_file"] = rows_file
+    if rows_format:
+        params["rows_format"] = rows_format
+    if name_column:
+        params["name_column"] = name_column
+
+
+def _describe_failures(result: Dict) -> str:
+    """Summarise the rows an import skipped."""
+    failed = result.get("rows_failed", 0)
+    if not failed:
+        return ""
+    lines = [f" {failed} rows failed:"]
+    for error in result.get("row_errors", []):
+        lines.append(f"  line {error['line']} '{error['row']}': {error['error']}")
+    if failed > len(result.get("row_errors", [])):
+        lines.append("  ...")
+    ignored = result.get("ignored_columns")
+    if ignored:
+        lines.append(f"  ignored columns: {', '.join(ignored)}")
+    return "\n".join(lines)
+
+
 def register_all(mcp):
     """Register all data table-related commands with the MCP server."""
 
@@ -26,6 +54,9 @@ def register_all(mcp):
         row_struct: str,
         rows: Optional[Dict[str, Dict]] = None,
         overwrite: bool = False,
+        rows_file: Optional[str] = None,
+        rows_format: Optional[str] = None,
+        name_column: Optional[str] = None,
     ) -> str:
         """Create a new data table asset.
 
@@ -35,6 +66,10 @@ def register_all(mcp):
             row_struct: Long object path to the struct that defines the table rows (e.g. "/Script/YourModule.YourRowStruct").
             rows: Optional dictionary of initial rows to add. Keys are row names, values are dictionaries matching the struct fields.
             overwrite: When true and a table already exists at the same location, its contents will be replaced.
+            rows_file: Optional CSV or JSON file on the editor machine (relative to the project directory) to stream rows from.
+                CSV needs a header row; JSON is an object keyed by row name or an array of row objects.
+            rows_format: "csv" or "json"; taken from the file extension when omitted.
+            name_column: Column (CSV) or field (JSON array) holding the row name. Defaults to the first CSV column or "Name".
         """
 
         try:
@@ -46,6 +81,7 @@ def register_all(mcp):
             }
             if rows:
                 params["rows"] = rows
+            _add_rows_file(params, rows_file, rows_format, name_column)
 
             response = send_command("create_data_table", params)
 
@@ -55,7 +91,7 @@ def register_all(mcp):
                 return (
                     f"{action} data table '{result['name']}' at {result['path']} "
                     f"with {result.get('row_count', 0)} rows."
-                )
+                ) + _describe_failures(result)
 
             return f"Error: {response['message']}"
         except Exception as exc:  # pragma: no cover - defensive logging
@@ -68,6 +104,9 @@ def register_all(mcp):
         add_or_update_rows: Optional[Dict[str, Dict]] = None,
         remove_rows: Optional[List[str]] = None,
         clear_existing: bool = False,
+        rows_file: Optional[str] = None,
+        rows_format: Optional[str] = None,
+        name_column: Optional[str] = None,
     ) -> str:
         """Modify an existing data table asset.
 
@@ -76,10 +115,14 @@ def register_all(mcp):
             add_or_update_rows: Optional dictionary mapping row names to new data. Rows will be added or replaced.
             remove_rows: Optional list of row names to remove from the table.
             clear_existing: When true, existing rows are cleared before applying updates.
+            rows_file: Optional CSV or JSON file on the editor machine (relative to the project directory) whose rows are added or replaced.
+                Rows that fail to convert are skipped and reported.
+            rows_format: "csv" or "json"; taken from the file extension when omitted.
+            name_column: Column (CSV) or field (JSON array) holding the row name. Defaults to the first CSV column or "Name".
         """
 
-        if not (add_or_update_rows or remove_rows or clear_existing):
-            return "No modifications requested. Provide rows to add/update or remove, or set clear_existing=True."
+        if not (add_or_update_rows or remove_rows or clear_existing or rows_file):
+            return "No modifications requested. Provide rows to add/update or remove, a rows_file, or set clear_existing=True."
 
         try:
             params = {"path": path}
@@ -89,6 +132,7 @@ def register_all(mcp):
                 params["remove_rows"] = remove_rows
             if clear_existing:
                 params["clear_existing"] = True
+            _add_rows_file(params, rows_file, rows_format, name_column)
 
             response = send_command("modify_data_table", params)
 
@@ -100,9 +144,58 @@ def register_all(mcp):
                 return (
                     f"Updated data table '{result['name']}' at {result['path']}: "
                     f"+{applied} / -{removed} (total {row_count})."
-                )
+                ) + _describe_failures(result)
 
             return f"Error: {response['message']}"
         except Exception as exc:  # pragma: no cover - defensive logging
             return f"Error modifying data table: {exc}"
 
+    @mcp.tool()
+    def query_data_table(
+        ctx: Context,
+        path: str,
+        columns: Optional[List[str]] = None,
+        filters: Optional[List[Dict[str, Any]]] = None,
+        order_by: Optional[str] = None,
+        descending: bool = False,
+        offset: int = 0,
+        limit: int = 100,
+        use_indexes: bool = True,
+    ) -> str:
+        """Read rows of a data table with projection, filters, sorting and pagination.
+
+        Args:
+            path: Long object path to the data table (e.g. "/Game/Data/MyTable.MyTable").
+            columns: Columns to return; all columns when omitted. The row name is always returned as "Name".
+            filters: Conditions every returned row must meet, e.g.
+                [{"column": "Level", "op": "gte", "value": 10}, {"column": "Tags", "op": "contains", "value": "Boss"}].
+                Ops: eq, ne, lt, lte, gt, gte, contains. Use column "Name" for the row name.
+                Numeric and bool columns compare as numbers, other columns as case-insensitive text;
+                contains matches an element of array/set columns or a substring otherwise.
+            order_by: Column to sort by; table order when omitted.
+            descending: Sort in descending order.
+            offset: Number of matching rows to skip.
+            limit: Maximum number of rows to return (up to 10000).
+            use_indexes: Answer equality and range filters on large tables from lazily built column indexes.
+        """
+        try:
+            params: Dict[str, Any] = {
+                "path": path,
+                "descending": descending,
+                "offset": offset,
+                "limit": limit,
+                "use_indexes": use_indexes,
+            }
+            if columns:
+                params["columns"] = columns
+            if filters:
+                params["filters"] = filters
+            if order_by:
+                params["order_by"] = order_by
+
+            response = send_command("query_data_table", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as exc:  # pragma: no cover - defensive logging
+            return f"Error querying data table: {exc}"
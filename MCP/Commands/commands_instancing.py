@@ -0,0 +1,241 @@
+"""Instanced static mesh commands for the UnrealMCP bridge.
+
+This module exposes tools that place many copies of a mesh as instances on a
+single (Hierarchical)InstancedStaticMeshComponent instead of one actor each.
+"""
+
+import base64
+import os
+import struct
+import sys
+from typing import List, Optional
+
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+
+def pack_floats(values: List[float]) -> str:
+    """Pack a flat float list as base64 little-endian float32 for the *_base64 fields."""
+    return base64.b64encode(struct.pack(f"<{len(values)}f", *values)).decode("ascii")
+
+
+def pack_doubles(values: List[float]) -> str:
+    """Pack a flat float list as base64 little-endian float64 for the *_f64_base64 fields."""
+    return base64.b64encode(struct.pack(f"<{len(values)}d", *values)).decode("ascii")
+
+
+def register_all(mcp):
+    """Register all instancing-related commands with the MCP server."""
+
+    @mcp.tool()
+    def create_instances(
+        ctx: Context,
+        mesh: str,
+        transforms: List[float],
+        stride: int = 9,
+        actor: Optional[str] = None,
+        label: Optional[str] = None,
+        hierarchical: bool = True,
+        custom_data: Optional[List[float]] = None,
+        num_custom_data: int = 0,
+        world_space: bool = True,
+    ) -> str:
+        """Add many instances of a static mesh to one instanced component in a single call.
+
+        Args:
+            mesh: Object path of the static mesh (e.g. "/Engine/BasicShapes/Cube.Cube").
+            transforms: Flat list of floats, `stride` values per instance.
+                stride 3 = [x, y, z], 6 = + [pitch, yaw, roll], 9 = + [sx, sy, sz].
+            stride: Number of floats per instance (3, 6 or 9).
+            actor: Optional name of an existing host actor to extend (a label works when exactly one actor has it).
+            label: Label for a newly spawned host actor (also used to find an existing one).
+            hierarchical: Create a HierarchicalInstancedStaticMeshComponent when a new component is needed.
+            custom_data: Optional flat list of per-instance custom data floats.
+            num_custom_data: Number of custom data floats per instance.
+            world_space: Whether transforms are in world space (otherwise relative to the host actor).
+        """
+        try:
+            params = {
+                "mesh": mesh,
+                "stride": stride,
+                "transforms_f64_base64": pack_doubles(transforms),
+                "hierarchical": hierarchical,
+                "world_space": world_space,
+            }
+            if actor:
+                params["actor"] = actor
+            if label:
+                params["label"] = label
+            if custom_data and num_custom_data > 0:
+                params["custom_data_base64"] = pack_floats(custom_data)
+                params["num_custom_data"] = num_custom_data
+
+            response = send_command("create_instances", params)
+            if response["status"] == "success":
+                result = response["result"]
+                return (
+                    f"Added {result['instances_added']} instances to {result['component']} on "
+                    f"{result['label']} (total {result['instance_count']})."
+                )
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error creating instances: {str(e)}"
+
+    @mcp.tool()
+    def scatter(
+        ctx: Context,
+        mesh: str,
+        region: str = "box",
+        bounds_min: Optional[List[float]] = None,
+        bounds_max: Optional[List[float]] = None,
+        source_actor: Optional[str] = None,
+        width: Optional[float] = None,
+        method: str = "poisson",
+        density: Optional[float] = None,
+        min_distance: Optional[float] = None,
+        jitter: float = 1.0,
+        seed: int = 0,
+        yaw_range: Optional[List[float]] = None,
+        pitch_range: Optional[List[float]] = None,
+        roll_range: Optional[List[float]] = None,
+        scale_range: Optional[List[float]] = None,
+        align_to_normal: bool = False,
+        project: bool = False,
+        max_slope: Optional[float] = None,
+        max_instances: int = 100000,
+        actor: Optional[str] = None,
+        label: Optional[str] = None,
+        hierarchical: bool = True,
+        replace: bool = False,
+    ) -> str:
+        """Generate instance transforms in the editor and add them to one instanced component.
+
+        Only the sampling parameters travel over the wire, so large scatters cost a few bytes of request.
+
+        Args:
+            mesh: Object path of the static mesh to scatter.
+            region: "box" (bounds_min/bounds_max), "spline" (band of `width` along source_actor's spline)
+                or "surface" (triangles of source_actor's static meshes).
+            bounds_min: Minimum corner [x, y, z] of the box region.
+            bounds_max: Maximum corner [x, y, z] of the box region.
+            source_actor: Name or label of the spline or surface actor.
+            width: Width of the spline band in world units.
+            method: "poisson" (minimum spacing between instances) or "grid" (jittered grid).
+            density: Instances per square metre.
+            min_distance: Minimum distance between instances in world units (poisson) or grid spacing.
+                On a surface, "grid" samples uniformly and only uses it to set the instance count.
+            jitter: Grid jitter as a fraction of the cell size (0-1).
+            seed: Random seed; the same request always produces the same layout.
+            yaw_range: [min, max] yaw in degrees (default [0, 360]).
+            pitch_range: [min, max] pitch in degrees.
+            roll_range: [min, max] roll in degrees.
+            scale_range: [min, max] uniform scale.
+            align_to_normal: Tilt each instance to the surface normal.
+            project: Trace down onto geometry (box: from the top of the box to its bottom).
+            max_slope: Drop samples on surfaces steeper than this many degrees.
+            max_instances: Upper bound on generated instances; poisson fills the whole region and keeps a random subset.
+            actor: Name of an existing host actor to extend (a label works when exactly one actor has it).
+            label: Label for a newly spawned host actor (also used to find an existing one).
+            hierarchical: Create a HierarchicalInstancedStaticMeshComponent when a new component is needed.
+            replace: Clear the component's existing instances first.
+        """
+        try:
+            params = {
+                "mesh": mesh,
+                "region": region,
+                "method": method,
+                "jitter": jitter,
+                "seed": seed,
+                "align_to_normal": align_to_normal,
+                "project": project,
+                "max_instances": max_instances,
+                "hierarchical": hierarchical,
+                "replace": replace,
+            }
+            if bounds_min and bounds_max:
+                params["bounds"] = {"min": bounds_min, "max": bounds_max}
+            optional = {
+                "source_actor": source_actor,
+                "width": width,
+                "density": density,
+                "min_distance": min_distance,
+                "yaw_range": yaw_range,
+                "pitch_range": pitch_range,
+                "roll_range": roll_range,
+                "scale_range": scale_range,
+                "max_slope": max_slope,
+                "actor": actor,
+                "label": label,
+            }
+            params.update({key: value for key, value in optional.items() if value is not None})
+
+            response = send_command("scatter", params)
+            if response["status"] == "success":
+                result = response["result"]
+                summary = (
+                    f"Scattered {result['instances_added']} instances ({result['samples']} samples, "
+                    f"{result['dropped']} dropped) into {result['component']} on {result['label']} "
+                    f"(total {result['instance_count']})."
+                )
+                for warning in result.get("warnings", []):
+                    summary += f"\nWarning: {warning}"
+                return summary
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error scattering instances: {str(e)}"
+
+    @mcp.tool()
+    def consolidate_instances(
+        ctx: Context,
+        bounds_min: Optional[List[float]] = None,
+        bounds_max: Optional[List[float]] = None,
+        folder: Optional[str] = None,
+        mesh: Optional[str] = None,
+        min_group_size: int = 2,
+        hierarchical: bool = True,
+        dry_run: bool = False,
+        cell_size: Optional[float] = None,
+    ) -> str:
+        """Replace StaticMeshActors that share a mesh and material set with one HISM component per group.
+
+        Actors are only grouped when they also agree on collision, shadow and render flags, mobility,
+        tags, custom primitive data, LOD and cull distances, runtime grid and data layers; the new
+        host copies those settings. In World Partition levels, spatially loaded actors are also split
+        by streaming cell. The whole conversion is a single undo transaction.
+
+        Args:
+            bounds_min: Minimum corner [x, y, z] of a region the actor locations must be inside.
+            bounds_max: Maximum corner [x, y, z] of that region.
+            folder: Only consider actors whose outliner folder starts with this path.
+            mesh: Only consider actors using this mesh (object path or asset name).
+            min_group_size: Groups smaller than this are left as individual actors.
+            hierarchical: Use HierarchicalInstancedStaticMeshComponents (False for plain ISM).
+            dry_run: Report the groups and primitive counts without changing the level.
+            cell_size: World Partition cell size used to split groups (default 12800; 0 disables).
+        """
+        try:
+            params = {"min_group_size": min_group_size, "hierarchical": hierarchical, "dry_run": dry_run}
+            if bounds_min and bounds_max:
+                params["bounds"] = {"min": bounds_min, "max": bounds_max}
+            if folder:
+                params["folder"] = folder
+            if mesh:
+                params["mesh"] = mesh
+            if cell_size is not None:
+                params["cell_size"] = cell_size
+
+            response = send_command("consolidate_instances", params)
+            if response["status"] == "success":
+                result = response["result"]
+                prefix = "Would replace" if result["dry_run"] else "Replaced"
+                return (
+                    f"{prefix} {result['actors_replaced']} actors with {result['group_count']} instanced components; "
+                    f"primitives {result['primitives_before']} -> {result['primitives_after']} "
+                    f"({result['actors_skipped']} actors skipped)."
+                )
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error consolidating instances: {str(e)}"
@@ -0,0 +1,55 @@
+"""Job tracking commands for the UnrealMCP bridge.
+
+Long-running commands (mesh merging, LOD generation, ...) return a job id straight away;
+these tools poll and cancel those jobs.
+"""
+
+import json
+import os
+import sys
+from typing import Optional
+
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+
+def register_all(mcp):
+    """Register all job tracking commands with the MCP server."""
+
+    @mcp.tool()
+    def get_job_status(ctx: Context, job_id: Optional[str] = None, output_from: Optional[int] = None) -> str:
+        """Get the state, progress and result of a job, or list all retained jobs when no id is given.
+
+        Args:
+            job_id: Id returned by a job-based command such as merge_actors.
+            output_from: Also return the job's output lines from this line on. Pass the previous
+                `output_lines` value to stream only new lines.
+        """
+        try:
+            params = {"job_id": job_id} if job_id else {}
+            if job_id and output_from is not None:
+                params["output_from"] = output_from
+            response = send_command("get_job_status", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting job status: {str(e)}"
+
+    @mcp.tool()
+    def cancel_job(ctx: Context, job_id: str) -> str:
+        """Ask a running job to stop. Jobs stop between steps, so work already done is kept.
+
+        Args:
+            job_id: Id of the job to cancel.
+        """
+        try:
+            response = send_command("cancel_job", {"job_id": job_id})
+            if response["status"] == "success":
+                return f"Cancellation requested for job {job_id}."
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error cancelling job: {str(e)}"
@@ -0,0 +1,207 @@
+"""Static mesh processing commands for the UnrealMCP bridge.
+
+These tools reduce draw calls and fix up mesh assets. Heavy operations run as tracked jobs;
+poll them with get_job_status.
+"""
+
+import json
+import os
+import sys
+from typing import Dict, List, Optional
+
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+
+def register_all(mcp):
+    """Register all static mesh processing commands with the MCP server."""
+
+    @mcp.tool()
+    def merge_actors(
+        ctx: Context,
+        actors: Optional[List[str]] = None,
+        bounds_min: Optional[List[float]] = None,
+        bounds_max: Optional[List[float]] = None,
+        folder: Optional[str] = None,
+        asset_path: Optional[str] = None,
+        merge_materials: bool = False,
+        lod: int = -1,
+        pivot_at_zero: bool = False,
+        generate_lightmap_uvs: bool = True,
+        replace_sources: bool = True,
+        wait: bool = False,
+    ) -> str:
+        """Merge the static meshes of several actors into one static mesh asset.
+
+        Returns a job id unless wait is True; poll it with get_job_status. Only actors made up
+        entirely of static mesh components are merged, since replacing a source destroys the actor.
+
+        Args:
+            actors: Names or labels of actors to merge.
+            bounds_min: Minimum corner [x, y, z] of a region whose actors are merged.
+            bounds_max: Maximum corner [x, y, z] of that region.
+            folder: Merge actors whose outliner folder starts with this path.
+            asset_path: Package path for the merged mesh (e.g. "/Game/Merged/SM_Block"); defaults to a
+                unique /Game/MCP/Merged/SM_Merged_<label>.
+            merge_materials: Bake the source materials into a single atlas material.
+            lod: Source LOD to merge, or -1 to keep every LOD.
+            pivot_at_zero: Put the merged mesh pivot at the world origin instead of the sources' centre.
+            generate_lightmap_uvs: Generate lightmap UVs for the merged mesh.
+            replace_sources: Replace the source actors with one actor using the merged mesh.
+            wait: Run the merge before returning instead of as a background job.
+        """
+        try:
+            params = {
+                "merge_materials": merge_materials,
+                "lod": lod,
+                "pivot_at_zero": pivot_at_zero,
+                "generate_lightmap_uvs": generate_lightmap_uvs,
+                "replace_sources": replace_sources,
+                "wait": wait,
+            }
+            if actors:
+                params["actors"] = actors
+            if bounds_min and bounds_max:
+                params["bounds"] = {"min": bounds_min, "max": bounds_max}
+            if folder:
+                params["folder"] = folder
+            if asset_path:
+                params["asset_path"] = asset_path
+
+            response = send_command("merge_actors", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error merging actors: {str(e)}"
+
+    @mcp.tool()
+    def generate_lods(
+        ctx: Context,
+        meshes: Optional[List[str]] = None,
+        path: Optional[str] = None,
+        recursive: bool = True,
+        name_contains: Optional[str] = None,
+        num_lods: int = 4,
+        percent_triangles: Optional[List[float]] = None,
+        screen_sizes: Optional[List[float]] = None,
+        overwrite_existing: bool = False,
+    ) -> str:
+        """Generate reduced LODs for many static meshes and rebuild them as a tracked job.
+
+        Poll the returned job id with get_job_status for per-asset progress and triangle counts.
+
+        Args:
+            meshes: Object paths of static meshes to process.
+            path: Content folder (e.g. "/Game/Props"); every static mesh under it is processed.
+            recursive: Include sub-folders of path.
+            name_contains: Only process meshes under path whose name contains this text.
+            num_lods: Total number of LODs including LOD0 (1-8).
+            percent_triangles: Triangle fraction for LOD1, LOD2, ... (0-1); default halves each level.
+            screen_sizes: Screen size for LOD1, LOD2, ...; omitted means computed automatically.
+            overwrite_existing: Also process meshes that already have more than one LOD.
+        """
+        try:
+            params = {"num_lods": num_lods, "recursive": recursive, "overwrite_existing": overwrite_existing}
+            if meshes:
+                params["meshes"] = meshes
+            if path:
+                params["path"] = path
+            if name_contains:
+                params["name_contains"] = name_contains
+            if percent_triangles:
+                params["percent_triangles"] = percent_triangles
+            if screen_sizes:
+                params["screen_sizes"] = screen_sizes
+
+            response = send_command("generate_lods", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error generating LODs: {str(e)}"
+
+    @mcp.tool()
+    def generate_mesh(
+        ctx: Context,
+        shape: Optional[str] = None,
+        size: Optional[List[float]] = None,
+        radius: Optional[float] = None,
+        top_radius: Optional[float] = None,
+        height: Optional[float] = None,
+        segments: Optional[int] = None,
+        rings: Optional[int] = None,
+        edge_segments: Optional[int] = None,
+        subdivisions: Optional[List[int]] = None,
+        spline_actor: Optional[str] = None,
+        profile: Optional[str] = None,
+        profile_points: Optional[List[List[float]]] = None,
+        width: Optional[float] = None,
+        samples: Optional[int] = None,
+        location: Optional[List[float]] = None,
+        rotation: Optional[List[float]] = None,
+        scale: Optional[List[float]] = None,
+        label: Optional[str] = None,
+        material: Optional[str] = None,
+        asset_path: Optional[str] = None,
+        shapes: Optional[List[Dict]] = None,
+        spawn_actor: bool = True,
+        overwrite: bool = False,
+    ) -> str:
+        """Generate parametric meshes in the editor and optionally place them.
+
+        Without asset_path the mesh is a transient preview (not saved, and its actor is not saved with the level).
+        Pass `shapes` (a list of dicts using the same keys) to build many meshes in one call; shapes with
+        identical geometry share one mesh, and different shapes may not share an asset_path.
+
+        Args:
+            shape: "box", "rounded_box", "sphere", "cylinder", "cone", "plane" or "sweep".
+            size: [x, y, z] for boxes, [x, y] (or [x, y, 0]) for planes.
+            radius: Sphere/cylinder radius, rounded box edge radius, or circle profile radius.
+            top_radius: Cylinder top radius (cones default to 0).
+            height: Cylinder/cone height, or rect profile height for sweeps.
+            segments: Radial segments for spheres and cylinders.
+            rings: Latitude rings for spheres.
+            edge_segments: Arc segments per rounded box edge.
+            subdivisions: [x, y] quad count for planes.
+            spline_actor: Actor whose spline a sweep follows.
+            profile: Sweep cross-section: "circle" or "rect".
+            profile_points: Custom closed sweep cross-section as [[x, y], ...] (counter-clockwise).
+            width: Rect profile width.
+            samples: Rings along the spline for sweeps.
+            location: Actor location [x, y, z].
+            rotation: Actor rotation [pitch, yaw, roll].
+            scale: Actor scale [x, y, z].
+            label: Actor label.
+            material: Material path for the mesh.
+            asset_path: Package path to save the mesh as an asset (e.g. "/Game/Blockout/SM_Wall").
+            shapes: Batch of shape dicts; top-level shape fields are ignored when given.
+            spawn_actor: Place a StaticMeshActor using each generated mesh.
+            overwrite: Rebuild an existing static mesh at asset_path in place; otherwise a unique name is used.
+        """
+        try:
+            params = {"spawn_actor": spawn_actor, "overwrite": overwrite}
+            if shapes:
+                params["shapes"] = shapes
+            else:
+                if not shape:
+                    return "Error: provide shape or shapes"
+                fields = {
+                    "shape": shape, "size": size, "radius": radius, "top_radius": top_radius,
+                    "height": height, "segments": segments, "rings": rings,
+                    "edge_segments": edge_segments, "subdivisions": subdivisions,
+                    "spline_actor": spline_actor, "profile": profile, "profile_points": profile_points,
+                    "width": width, "samples": samples, "location": location, "rotation": rotation,
+                    "scale": scale, "label": label, "material": material, "asset_path": asset_path,
+                }
+                params.update({key: value for key, value in fields.items() if value is not None})
+
+            response = send_command("generate_mesh", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error generating mesh: {str(e)}"
@@ -3,19 +3,55 @@
 This module contains commands for executing Python code in Unreal Engine.
 """
 
+import hashlib
+import json
 import sys
 import os
+import uuid
+from typing import Dict, Optional
 from mcp.server.fastmcp import Context
 
 # Import send_command from the parent module
 sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 from unreal_mcp_bridge import send_command
 
+# Hashes of code the editor has already compiled; only the hash is resent for these
+_sent_code_hashes = set()
+
+# Identifies this bridge process, so its Python sessions and cached code survive the per-command connections
+_client_id = uuid.uuid4().hex
+
+
+def _send_python(params: dict, code: Optional[str]) -> dict:
+    """Send execute_python, replacing known code by its hash and resending the code on a cache miss."""
+    if code:
+        code_hash = hashlib.sha1(code.encode("utf-8")).hexdigest()
+        if code_hash in _sent_code_hashes:
+            response = send_command("execute_python", {**params, "code_hash": code_hash})
+            if not (response["status"] == "error" and "Unknown code_hash" in response.get("message", "")):
+                return response
+            _sent_code_hashes.discard(code_hash)
+        params = {**params, "code": code}
+        response = send_command("execute_python", params)
+        if "code_hash" in response.get("result", {}):
+            _sent_code_hashes.add(code_hash)
+        return response
+    return send_command("execute_python", params)
+
+
 def register_all(mcp):
     """Register all Python execution commands with the MCP server."""
     
     @mcp.tool()
-    def execute_python(ctx: Context, code: str = None, file: str = None) -> str:
+    def execute_python(
+        ctx: Context,
+        code: str = None,
+        file: str = None,
+        snippet: str = None,
+        args: Optional[Dict] = None,
+        session: str = None,
+        job: bool = False,
+    ) -> str:
         """Execute Python code or a Python script file in Unreal Engine.
         
         This function allows you to execute arbitrary Python code directly in the Unreal Engine
@@ -28,9 +64,20 @@ def register_all(mcp):
         Args:
             code: Python code to execute as a string. Can be multiple lines.
             file: Path to a Python script file to execute.
+            snippet: Name of a snippet stored with register_python_snippet.
+            args: Dictionary exposed to the script as the global `args`.
+            session: Run in a persistent namespace with this id. Imports, variables and loaded assets
+                stay available to later calls with the same session (see python_session).
+            job: Run as a background job and return its id straight away. If the script defines
+                main(), it is called; a generator main() is resumed across editor ticks, and each
+                `yield` lets the editor breathe and may report progress (0-1), a message, or both
+                as a tuple. Poll with get_job_status(job_id, output_from=N) to stream printed lines;
+                cancel_job raises JobCancelled at the current yield.
             
         Note: 
-            - You must provide either code or file, but not both.
+            - You must provide either code, file or snippet, and only one of them.
+            - Compiled code is cached in the editor by source hash, so repeated code is only sent once
+              per bridge process (hashes are not shared between clients).
             - The output of the Python code will be visible in the Unreal Engine log.
             - The Python code runs in the Unreal Engine process, so it has full access to the engine.
             - Be careful with destructive operations as they can affect your project.
@@ -52,19 +99,28 @@ def register_all(mcp):
             execute_python(file="D:/my_scripts/create_assets.py")
         """
         try:
-            if not code and not file:
-                return "Error: You must provide either 'code' or 'file' parameter"
+            if not code and not file and not snippet:
+                return "Error: You must provide either 'code', 'file' or 'snippet' parameter"
             
-            if code and file:
-                return "Error: You can only provide either 'code' or 'file', not both"
+            if sum(1 for value in (code, file, snippet) if value) > 1:
+                return "Error: You can only provide one of 'code', 'file' or 'snippet'"
             
             params = {}
-            if code:
-                params["code"] = code
             if file:
                 params["file"] = file
+            if snippet:
+                params["snippet"] = snippet
+            if args:
+                params["args"] = args
+            params["client_id"] = _client_id
+            if session:
+                params["session"] = session
+            if job:
+                params["job"] = True
                 
-            response = send_command("execute_python", params)
+            response = _send_python(params, code)
+            if job and response["status"] == "success":
+                return f"Started Python job {response['result']['job_id']}. Poll it with get_job_status."
             
             # Handle the response
             if response["status"] == "success":
@@ -88,4 +144,51 @@ def register_all(mcp):
             else:
                 return f"Error: {response['message']}"
         except Exception as e:
-            return f"Error executing Python: {str(e)}" 
\ No newline at end of file
+            return f"Error executing Python: {str(e)}" 
+
+    @mcp.tool()
+    def register_python_snippet(ctx: Context, name: str, code: str = None, remove: bool = False) -> str:
+        """Store Python code in the editor under a name so execute_python(snippet=name, args={...}) can run it.
+
+        The snippet is compiled once; later calls only send the name and arguments. The script reads
+        its arguments from the global `args` dictionary.
+
+        Args:
+            name: Snippet name.
+            code: Python source of the snippet (not needed with remove=True).
+            remove: Delete the snippet instead of registering it.
+        """
+        try:
+            params = {"name": name, "remove": remove}
+            if code:
+                params["code"] = code
+            response = send_command("register_python_snippet", params)
+            if response["status"] == "success":
+                result = response["result"]
+                if remove:
+                    return f"Snippet '{name}' {'removed' if result['removed'] else 'was not registered'}."
+                return f"Registered snippet '{name}' ({result['code_hash']}). Snippets: {', '.join(result['snippets'])}"
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error registering snippet: {str(e)}"
+
+    @mcp.tool()
+    def python_session(ctx: Context, action: str = "list", session: str = None) -> str:
+        """List, reset or drop the persistent Python sessions used by execute_python(session=...).
+
+        Sessions are created on first use. Sessions that stay idle for an hour are dropped automatically.
+
+        Args:
+            action: "list", "reset" (clear the session's globals) or "drop" (delete the session).
+            session: Session id for reset and drop.
+        """
+        try:
+            params = {"action": action, "client_id": _client_id}
+            if session:
+                params["session"] = session
+            response = send_command("python_session", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error managing Python session: {str(e)}"
@@ -4,8 +4,11 @@ This module contains all scene-related commands for the UnrealMCP bridge,
 including getting scene information, creating, modifying, and deleting objects.
 """
 
+import json
 import sys
 import os
+from typing import Dict, List, Optional
+
 from mcp.server.fastmcp import Context
 
 # Import send_command from the parent module
@@ -16,10 +19,46 @@ def register_all(mcp):
     """Register all scene-related commands with the MCP server."""
     
     @mcp.tool()
-    def get_scene_info(ctx: Context) -> str:
-        """Get detailed information about the current Unreal scene."""
+    def get_scene_info(
+        ctx: Context,
+        fields: Optional[List[str]] = None,
+        format: Optional[str] = None,
+        encoding: Optional[str] = None,
+        max_actors: Optional[int] = None,
+        cache: bool = False,
+    ) -> str:
+        """Get detailed information about the current Unreal scene.
+
+        Args:
+            fields: Optional list of fields to return per actor. Built-in fields are
+                name, type, class_path, label, location, rotation, scale, bounds, mobility,
+                folder, tags, guid, hidden, parent and components. Any other entry is treated
+                as a dotted UPROPERTY path on the actor (e.g. "RootComponent.Mobility",
+                "StaticMeshComponent.StaticMesh"). Defaults to name, type, label and location.
+            format: "columnar" returns struct-of-arrays data instead of one object per actor:
+                a class dictionary with class_ids, a string table with name_ids/label_ids, and
+                flat positions/rotations/scales (3 values per actor) and bounds (6 values per actor).
+                The "fields" argument is ignored in this mode.
+            encoding: With format="columnar", "base64" sends each column as little-endian bytes
+                of the type named in "dtypes" (float64 positions and bounds, float32 rotations and
+                scales, int32 ids) and the string table as NUL-separated UTF-8.
+            max_actors: Maximum number of actors returned in columnar mode.
+            cache: Reuse the serialized rows of actors that have not changed since an earlier
+                call with the same fields. Useful when re-reading a mostly static level.
+        """
         try:
-            response = send_command("get_scene_info")
+            params = {}
+            if fields:
+                params["fields"] = fields
+            if format:
+                params["format"] = format
+            if encoding:
+                params["encoding"] = encoding
+            if max_actors is not None:
+                params["max_actors"] = max_actors
+            if cache:
+                params["cache"] = True
+            response = send_command("get_scene_info", params)
             if response["status"] == "success":
                 return json.dumps(response["result"], indent=2)
             else:
@@ -90,4 +129,141 @@ def register_all(mcp):
             else:
                 return f"Error: {response['message']}"
         except Exception as e:
-            return f"Error deleting object: {str(e)}" 
\ No newline at end of file
+            return f"Error deleting object: {str(e)}"
+
+    @mcp.tool()
+    def export_scene_snapshot(
+        ctx: Context,
+        properties: Optional[List[str]] = None,
+        since_snapshot: Optional[int] = None,
+    ) -> str:
+        """Write the scene to a binary snapshot file under Saved/MCP/Snapshots and return its path.
+
+        The file holds one fixed-size record per actor (GUID, class, name, label, folder,
+        transform and bounds) plus a string table; read it with utils.scene_snapshot.
+
+        Args:
+            properties: Optional dotted UPROPERTY paths to export as text for every actor.
+            since_snapshot: Id of an earlier snapshot; only actors added or changed since then
+                are written, along with the GUIDs of removed actors.
+        """
+        try:
+            params = {}
+            if properties:
+                params["properties"] = properties
+            if since_snapshot:
+                params["since_snapshot"] = since_snapshot
+            response = send_command("export_scene_snapshot", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error exporting scene snapshot: {str(e)}"
+
+    @mcp.tool()
+    def get_scene_hash(
+        ctx: Context,
+        group_by: str = "folder",
+        known_root_hash: Optional[str] = None,
+        known_hashes: Optional[Dict[str, str]] = None,
+    ) -> str:
+        """Get a Merkle hash of the scene to detect changes without re-reading it.
+
+        Actors are hashed over identity (GUID, name, label, class) and transform, grouped by
+        outliner folder or class, and combined into a root hash.
+
+        Args:
+            group_by: "folder" or "class".
+            known_root_hash: Root hash from an earlier call; the result reports "unchanged": true
+                and omits the groups when it still matches.
+            known_hashes: Group hashes from an earlier call (group name -> hash); only groups whose
+                hash differs are returned, plus "removed_groups".
+        """
+        try:
+            params = {"group_by": group_by}
+            if known_root_hash:
+                params["known_root_hash"] = known_root_hash
+            if known_hashes:
+                params["known_hashes"] = known_hashes
+            response = send_command("get_scene_hash", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting scene hash: {str(e)}"
+
+    @mcp.tool()
+    def scene_stats(ctx: Context, top_n: int = 10, max_meshes: int = 100) -> str:
+        """Get aggregate statistics for the whole scene without downloading every actor.
+
+        Returns actor counts by class, mobility and folder, the total bounds, triangle and
+        material-slot totals (overall and per static mesh), light counts and the actors with
+        the most primitive components.
+
+        Args:
+            top_n: Number of actors to list by primitive component count.
+            max_meshes: Maximum number of static meshes listed (heaviest total triangle count first).
+        """
+        try:
+            response = send_command("scene_stats", {"top_n": top_n, "max_meshes": max_meshes})
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting scene stats: {str(e)}"
+
+    @mcp.tool()
+    def query_scene(
+        ctx: Context,
+        class_name: Optional[str] = None,
+        label: Optional[str] = None,
+        tag: Optional[str] = None,
+        folder: Optional[str] = None,
+        bounds_min: Optional[List[float]] = None,
+        bounds_max: Optional[List[float]] = None,
+        center: Optional[List[float]] = None,
+        radius: Optional[float] = None,
+        max_results: int = 1000,
+    ) -> str:
+        """Find actors by class, label, tag, folder or region.
+
+        The query runs on a worker thread against a read-only snapshot of the scene, so it does
+        not wait for or slow down the editor. Results include the snapshot version they came from.
+
+        Args:
+            class_name: Exact actor class name (e.g. "StaticMeshActor").
+            label: Substring the actor label must contain.
+            tag: Actor tag the actor must have.
+            folder: Outliner folder path prefix.
+            bounds_min: Minimum corner [x, y, z] of a box the actor bounds must overlap.
+            bounds_max: Maximum corner [x, y, z] of that box.
+            center: Sphere center [x, y, z]; with radius, keeps actors whose location is inside
+                the sphere and sorts them by distance.
+            radius: Sphere radius.
+            max_results: Maximum number of actors returned.
+        """
+        try:
+            params = {"max_results": max_results}
+            if class_name:
+                params["class"] = class_name
+            if label:
+                params["label"] = label
+            if tag:
+                params["tag"] = tag
+            if folder:
+                params["folder"] = folder
+            if bounds_min and bounds_max:
+                params["bounds"] = {"min": bounds_min, "max": bounds_max}
+            if center and radius is not None:
+                params["center"] = center
+                params["radius"] = radius
+            response = send_command("query_scene", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error querying scene: {str(e)}"
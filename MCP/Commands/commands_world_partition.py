@@ -0,0 +1,122 @@
+"""World Partition commands for the UnrealMCP bridge.
+
+These tools read the World Partition actor descriptors of open-world maps without loading
+the actors, and stream in or pin only the parts of the world a targeted edit needs.
+"""
+
+import json
+import os
+import sys
+from typing import List, Optional
+
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+
+def _add_box(params: dict, bounds_min: Optional[List[float]], bounds_max: Optional[List[float]]):
+    if bounds_min and bounds_max:
+        params["bounds"] = {"min": bounds_min, "max": bounds_max}
+
+
+def register_all(mcp):
+    """Register all World Partition commands with the MCP server."""
+
+    @mcp.tool()
+    def query_world_partition(
+        ctx: Context,
+        class_name: Optional[str] = None,
+        label: Optional[str] = None,
+        data_layer: Optional[str] = None,
+        bounds_min: Optional[List[float]] = None,
+        bounds_max: Optional[List[float]] = None,
+        loaded: Optional[bool] = None,
+        max_results: int = 1000,
+    ) -> str:
+        """List World Partition actor descriptors (GUID, class, label, bounds, data layers) without loading actors.
+
+        Args:
+            class_name: Native class name, or part of a Blueprint class path.
+            label: Substring the actor label must contain.
+            data_layer: Substring of a data layer instance name the actor must belong to.
+            bounds_min: Minimum corner [x, y, z] of a box the actor bounds must overlap.
+            bounds_max: Maximum corner [x, y, z] of that box.
+            loaded: True for currently loaded actors only, False for unloaded actors only.
+            max_results: Maximum number of descriptors returned.
+        """
+        try:
+            params = {"max_results": max_results}
+            if class_name:
+                params["class"] = class_name
+            if label:
+                params["label"] = label
+            if data_layer:
+                params["data_layer"] = data_layer
+            if loaded is not None:
+                params["loaded"] = loaded
+            _add_box(params, bounds_min, bounds_max)
+            response = send_command("query_world_partition", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error querying World Partition: {str(e)}"
+
+    @mcp.tool()
+    def load_world_partition_region(
+        ctx: Context,
+        bounds_min: Optional[List[float]] = None,
+        bounds_max: Optional[List[float]] = None,
+        region_id: Optional[str] = None,
+        actor_guids: Optional[List[str]] = None,
+    ) -> str:
+        """Load the World Partition cells overlapping a box and/or pin individual actors.
+
+        Args:
+            bounds_min: Minimum corner [x, y, z] of the region to load.
+            bounds_max: Maximum corner [x, y, z] of the region to load.
+            region_id: Optional id for the region; one is generated otherwise.
+            actor_guids: Actor GUIDs (from query_world_partition) to pin so they stay loaded.
+        """
+        try:
+            params = {}
+            _add_box(params, bounds_min, bounds_max)
+            if region_id:
+                params["region_id"] = region_id
+            if actor_guids:
+                params["actor_guids"] = actor_guids
+            response = send_command("load_world_partition_region", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error loading World Partition region: {str(e)}"
+
+    @mcp.tool()
+    def unload_world_partition_region(
+        ctx: Context,
+        region_id: Optional[str] = None,
+        all: bool = False,
+        actor_guids: Optional[List[str]] = None,
+    ) -> str:
+        """Unload a region loaded by load_world_partition_region and/or unpin actors.
+
+        Args:
+            region_id: Region to unload.
+            all: Unload every region loaded through MCP.
+            actor_guids: Actor GUIDs to unpin.
+        """
+        try:
+            params = {"all": all}
+            if region_id:
+                params["region_id"] = region_id
+            if actor_guids:
+                params["actor_guids"] = actor_guids
+            response = send_command("unload_world_partition_region", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error unloading World Partition region: {str(e)}"
@@ -0,0 +1,103 @@
+"""Reader for the binary files written by the export_scene_snapshot command.
+
+The file is memory-mapped and records are decoded lazily, so large scenes can be
+scanned without loading the whole snapshot. The layout mirrors
+FMCPSceneSnapshotHeader and FMCPSceneSnapshotRecord in MCPCommandHandlers_Scene.h.
+"""
+
+import mmap
+import struct
+import uuid
+from typing import Dict, Iterator, List, Optional
+
+HEADER_FORMAT = "<4sIQQIIIIII7Q"
+RECORD_FORMAT = "<4I4I3d3d4f3f3f"
+SUPPORTED_VERSION = 2
+FLAG_INCREMENTAL = 1 << 0
+
+
+def _guid_to_string(a: int, b: int, c: int, d: int) -> str:
+    """Format the four FGuid components the way FGuid::ToString(DigitsWithHyphens) does."""
+    return str(uuid.UUID(bytes=struct.pack(">4I", a, b, c, d))).upper()
+
+
+class SceneSnapshot:
+    """Memory-mapped view of a .mcpsnap file."""
+
+    def __init__(self, path: str):
+        self._file = open(path, "rb")
+        self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+
+        (magic, self.version, self.snapshot_id, self.base_snapshot_id, self.flags,
+         self.record_size, self.record_count, self.class_count, self.property_count,
+         self.removed_count, self._records_offset, self._class_table_offset,
+         self._property_names_offset, self._property_values_offset, self._removed_offset,
+         self._string_table_offset, self._string_table_size) = struct.unpack_from(HEADER_FORMAT, self._map, 0)
+
+        if magic != b"MCPS":
+            raise ValueError(f"{path} is not a scene snapshot")
+        if self.version != SUPPORTED_VERSION:
+            raise ValueError(f"Unsupported scene snapshot version {self.version}")
+
+        self.class_names = [self._string(o) for o in self._uint32_array(self._class_table_offset, self.class_count)]
+        self.property_names = [self._string(o) for o in self._uint32_array(self._property_names_offset, self.property_count)]
+
+    @property
+    def incremental(self) -> bool:
+        return bool(self.flags & FLAG_INCREMENTAL)
+
+    def _uint32_array(self, offset: int, count: int) -> List[int]:
+        return list(struct.unpack_from(f"<{count}I", self._map, offset)) if count else []
+
+    def _string(self, offset: int) -> str:
+        if offset == 0:
+            return ""
+        start = self._string_table_offset + offset
+        end = self._map.find(b"\0", start)
+        return self._map[start:end].decode("utf-8")
+
+    def record(self, index: int) -> Dict:
+        """Decode one actor record."""
+        if not 0 <= index < self.record_count:
+            raise IndexError(index)
+        values = struct.unpack_from(RECORD_FORMAT, self._map, self._records_offset + index * self.record_size)
+        record = {
+            "guid": _guid_to_string(*values[0:4]),
+            "class": self.class_names[values[4]],
+            "name": self._string(values[5]),
+            "label": self._string(values[6]),
+            "folder": self._string(values[7]),
+            "location": list(values[8:11]),
+            "bounds_origin": list(values[11:14]),
+            "rotation_quat": list(values[14:18]),
+            "scale": list(values[18:21]),
+            "bounds_extent": list(values[21:24]),
+        }
+        if self.property_count:
+            value_offsets = self._uint32_array(self._property_values_offset + index * self.property_count * 4, self.property_count)
+            record["properties"] = {name: self._string(o) for name, o in zip(self.property_names, value_offsets)}
+        return record
+
+    def records(self) -> Iterator[Dict]:
+        for index in range(self.record_count):
+            yield self.record(index)
+
+    def removed_guids(self) -> List[str]:
+        """GUIDs of actors removed since the base snapshot (incremental snapshots only)."""
+        values = self._uint32_array(self._removed_offset, self.removed_count * 4)
+        return [_guid_to_string(*values[i:i + 4]) for i in range(0, len(values), 4)]
+
+    def close(self):
+        self._map.close()
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def open_snapshot(path: str) -> Optional[SceneSnapshot]:
+    """Open a snapshot file returned by export_scene_snapshot."""
+    return SceneSnapshot(path)
@@ -1,4 +1,5 @@
 #include "MCPCommandHandlers.h"
+#include "MCPCommandHandlers_Scene.h"
 
 #include "ActorEditorUtils.h"
 #include "Editor.h"
@@ -17,68 +18,114 @@
 #include "Misc/PackageName.h"
 #include "Modules/ModuleManager.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/Async.h"
+#include "MCPPythonRuntime.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
 
 
 //
 // FMCPGetSceneInfoHandler
 //
+namespace
+{
+    /** Options of a get_scene_info request */
+    struct FSceneInfoRequest
+    {
+        bool bColumnar = false;
+        bool bBinary = false;
+        bool bCacheFragments = false;
+        int32 MaxActors = 0;
+        TArray<FString> Fields;
+    };
+
+    FSceneInfoRequest ReadSceneInfoRequest(const TSharedPtr<FJsonObject>& Params)
+    {
+        FSceneInfoRequest Request;
+
+        FString Format;
+        Params->TryGetStringField(FStringView(TEXT("format")), Format);
+        Request.bColumnar = Format.Equals(TEXT("columnar"), ESearchCase::IgnoreCase);
+        if (Request.bColumnar)
+        {
+            Request.MaxActors = MCPConstants::MAX_ACTORS_IN_COLUMNAR_SCENE_INFO;
+            Params->TryGetNumberField(FStringView(TEXT("max_actors")), Request.MaxActors);
+            Request.MaxActors = FMath::Clamp(Request.MaxActors, 0, MCPConstants::MAX_ACTORS_IN_COLUMNAR_SCENE_INFO);
+
+            FString Encoding;
+            Params->TryGetStringField(FStringView(TEXT("encoding")), Encoding);
+            Request.bBinary = Encoding.Equals(TEXT("base64"), ESearchCase::IgnoreCase);
+        }
+        else
+        {
+            Request.MaxActors = MCPConstants::MAX_ACTORS_IN_SCENE_INFO;
+            Request.Fields = FMCPSceneQueryUtils::ReadRequestedFields(Params);
+            Params->TryGetBoolField(FStringView(TEXT("cache")), Request.bCacheFragments);
+        }
+        return Request;
+    }
+}
+
 TSharedPtr<FJsonObject> FMCPGetSceneInfoHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
 {
     MCP_LOG_INFO("Handling get_scene_info command");
 
     UWorld *World = GEditor->GetEditorWorldContext().World();
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    const FSceneInfoRequest Request = ReadSceneInfoRequest(Params);
 
-    int32 ActorCount = 0;
-    int32 TotalActorCount = 0;
-    bool bLimitReached = false;
-
-    // First count the total number of actors
-    for (TActorIterator<AActor> CountIt(World); CountIt; ++CountIt)
+    // Columnar mode: one struct-of-arrays pass instead of one JSON object per actor
+    if (Request.bColumnar)
     {
-        TotalActorCount++;
+        FMCPSceneColumns Columns;
+        FMCPSceneQueryUtils::GatherColumns(World, Request.MaxActors, Columns);
+
+        MCP_LOG_INFO("Sending columnar get_scene_info response with %d/%d actors", Columns.Num(), Columns.TotalActorCount);
+        return CreateSuccessResponse(FMCPSceneQueryUtils::BuildColumnarResult(Columns, Request.bBinary));
     }
 
-    // Then collect actor info up to the limit
-    for (TActorIterator<AActor> It(World); It; ++It)
+    FMCPSceneRows Rows;
+    FMCPSceneQueryUtils::GatherRows(World, Request.Fields, Request.MaxActors, Rows, Request.bCacheFragments);
+
+    MCP_LOG_INFO("Sending get_scene_info response with %d/%d actors", Rows.Actors.Num(), Rows.TotalActorCount);
+    return CreateSuccessResponse(FMCPSceneQueryUtils::BuildRowsResult(Rows));
+}
+
+bool FMCPGetSceneInfoHandler::ExecuteDeferred(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, TFuture<FString> &OutResponse)
+{
+    MCP_LOG_INFO("Handling get_scene_info command (deferred)");
+
+    UWorld *World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
     {
-        AActor *Actor = *It;
-        TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
-        ActorInfo->SetStringField("name", Actor->GetName());
-        ActorInfo->SetStringField("type", Actor->GetClass()->GetName());
+        return false;
+    }
 
-        // Add the actor label (user-facing friendly name)
-        ActorInfo->SetStringField("label", Actor->GetActorLabel());
+    const FSceneInfoRequest Request = ReadSceneInfoRequest(Params);
 
-        // Add location
-        FVector Location = Actor->GetActorLocation();
-        TArray<TSharedPtr<FJsonValue>> LocationArray;
-        LocationArray.Add(MakeShared<FJsonValueNumber>(Location.X));
-        LocationArray.Add(MakeShared<FJsonValueNumber>(Location.Y));
-        LocationArray.Add(MakeShared<FJsonValueNumber>(Location.Z));
-        ActorInfo->SetArrayField("location", LocationArray);
+    // Only the gather runs on the game thread; encoding and JSON writing happen on the thread pool
+    if (Request.bColumnar)
+    {
+        TSharedRef<FMCPSceneColumns> Columns = MakeShared<FMCPSceneColumns>();
+        FMCPSceneQueryUtils::GatherColumns(World, Request.MaxActors, *Columns);
 
-        ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
-        ActorCount++;
-        if (ActorCount >= MCPConstants::MAX_ACTORS_IN_SCENE_INFO)
+        MCP_LOG_INFO("Serializing columnar get_scene_info response with %d/%d actors off the game thread", Columns->Num(), Columns->TotalActorCount);
+        const bool bBinary = Request.bBinary;
+        OutResponse = Async(EAsyncExecution::ThreadPool, [Columns, bBinary]()
         {
-            bLimitReached = true;
-            MCP_LOG_WARNING("Actor limit reached (%d). Only returning %d of %d actors.",
-                            MCPConstants::MAX_ACTORS_IN_SCENE_INFO, ActorCount, TotalActorCount);
-            break; // Limit for performance
-        }
+            return FMCPSceneQueryUtils::SerializeSuccessResponse(FMCPSceneQueryUtils::BuildColumnarResult(*Columns, bBinary));
+        });
+        return true;
     }
 
-    Result->SetStringField("level", World->GetName());
-    Result->SetNumberField("actor_count", TotalActorCount);
-    Result->SetNumberField("returned_actor_count", ActorCount);
-    Result->SetBoolField("limit_reached", bLimitReached);
-    Result->SetArrayField("actors", ActorsArray);
+    TSharedRef<FMCPSceneRows> Rows = MakeShared<FMCPSceneRows>();
+    FMCPSceneQueryUtils::GatherRows(World, Request.Fields, Request.MaxActors, *Rows, Request.bCacheFragments);
 
-    MCP_LOG_INFO("Sending get_scene_info response with %d/%d actors", ActorCount, TotalActorCount);
-
-    return CreateSuccessResponse(Result);
+    MCP_LOG_INFO("Serializing get_scene_info response with %d/%d actors off the game thread", Rows->Actors.Num(), Rows->TotalActorCount);
+    OutResponse = Async(EAsyncExecution::ThreadPool, [Rows]()
+    {
+        return FMCPSceneQueryUtils::SerializeRowsResponse(*Rows);
+    });
+    return true;
 }
 
 //
@@ -126,6 +173,9 @@ TSharedPtr<FJsonObject> FMCPCreateObjectHandler::Execute(const TSharedPtr<FJsonO
 
         if (Result.Value)
         {
+            // The mesh and label are set after the spawn event, so the tracker would hash the bare actor
+            FMCPSceneChangeTracker::Get().MarkActorDirty(Result.Key);
+
             TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
             ResultObj->SetStringField("name", Result.Key->GetName());
             ResultObj->SetStringField("label", Result.Key->GetActorLabel());
@@ -145,6 +195,8 @@ TSharedPtr<FJsonObject> FMCPCreateObjectHandler::Execute(const TSharedPtr<FJsonO
 
         if (Result.Value)
         {
+            FMCPSceneChangeTracker::Get().MarkActorDirty(Result.Key);
+
             TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
             ResultObj->SetStringField("name", Result.Key->GetName());
             ResultObj->SetStringField("label", Result.Key->GetActorLabel());
@@ -341,6 +393,9 @@ TSharedPtr<FJsonObject> FMCPModifyObjectHandler::Execute(const TSharedPtr<FJsonO
 
     if (bModified)
     {
+        // SetActorLocation and friends do not fire OnActorMoved
+        FMCPSceneChangeTracker::Get().MarkActorDirty(Actor);
+
         // Create a result object with the actor name
         TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
         Result->SetStringField("name", Actor->GetName());
@@ -413,13 +468,47 @@ TSharedPtr<FJsonObject> FMCPDeleteObjectHandler::Execute(const TSharedPtr<FJsonO
 //
 // FMCPExecutePythonHandler
 //
+namespace
+{
+    /** Serialize the optional 'args' object that scripts see as the global 'args'. */
+    FString ReadPythonArgs(const TSharedPtr<FJsonObject>& Params)
+    {
+        FString ArgsJson;
+        const TSharedPtr<FJsonObject>* ArgsObject = nullptr;
+        if (Params->TryGetObjectField(FStringView(TEXT("args")), ArgsObject))
+        {
+            TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ArgsJson);
+            FJsonSerializer::Serialize((*ArgsObject).ToSharedRef(), Writer);
+        }
+        return ArgsJson;
+    }
+
+    /**
+     * Owner of the request's Python sessions and cached code: the client id when one was sent (both then
+     * survive reconnects, as with clients that open a connection per command), otherwise the connection itself.
+     */
+    FString GetPythonOwner(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+    {
+        FString ClientId;
+        if (Params->TryGetStringField(FStringView(TEXT("client_id")), ClientId) && !ClientId.IsEmpty())
+        {
+            return TEXT("client:") + ClientId;
+        }
+        return FMCPPythonRuntime::GetConnectionOwner(ClientSocket);
+    }
+}
+
 TSharedPtr<FJsonObject> FMCPExecutePythonHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
 {
     // Check if we have code or file parameter
     FString PythonCode;
     FString PythonFile;
+    FString CodeHash;
+    FString SnippetName;
     bool hasCode = Params->TryGetStringField(FStringView(TEXT("code")), PythonCode);
     bool hasFile = Params->TryGetStringField(FStringView(TEXT("file")), PythonFile);
+    const bool hasHash = Params->TryGetStringField(FStringView(TEXT("code_hash")), CodeHash) && !CodeHash.IsEmpty();
+    const bool hasSnippet = Params->TryGetStringField(FStringView(TEXT("snippet")), SnippetName) && !SnippetName.IsEmpty();
 
     // If code/file not found directly, check if they're in a 'data' object
     if (!hasCode && !hasFile)
@@ -432,160 +521,203 @@ TSharedPtr<FJsonObject> FMCPExecutePythonHandler::Execute(const TSharedPtr<FJson
         }
     }
 
-    if (!hasCode && !hasFile)
+    if (!hasCode && !hasFile && !hasHash && !hasSnippet)
     {
         MCP_LOG_WARNING("Missing 'code' or 'file' field in execute_python command");
-        return CreateErrorResponse("Missing 'code' or 'file' field. You must provide either Python code or a file path.");
+        return CreateErrorResponse("Missing 'code' or 'file' field. You must provide either Python code or a file path (or a 'code_hash' or 'snippet' sent earlier).");
     }
 
-    FString Result;
-    bool bSuccess = false;
-    FString ErrorMessage;
-
-    if (hasCode)
+    FMCPPythonRequest Request;
+    Request.ArgsJson = ReadPythonArgs(Params);
+    Request.Owner = GetPythonOwner(Params, ClientSocket);
+    Params->TryGetStringField(FStringView(TEXT("session")), Request.SessionId);
+    if (hasSnippet)
     {
-        // For code execution, we'll create a temporary file and execute that
-        MCP_LOG_INFO("Executing Python code via temporary file");
-
-        // Create a temporary file in the project's Saved/Temp directory
-        FString TempDir = FPaths::ProjectSavedDir() / MCPConstants::PYTHON_TEMP_DIR_NAME;
-        IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-        // Ensure the directory exists
-        if (!PlatformFile.DirectoryExists(*TempDir))
+        MCP_LOG_INFO("Executing Python snippet: %s", *SnippetName);
+        if (!FMCPPythonRuntime::FindSnippet(SnippetName, Request.Code))
         {
-            PlatformFile.CreateDirectory(*TempDir);
+            MCP_LOG_WARNING("Unknown Python snippet: %s", *SnippetName);
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown snippet '%s'. Register it with register_python_snippet first."), *SnippetName));
         }
+        Request.DisplayName = FString::Printf(TEXT("<snippet:%s>"), *SnippetName);
+    }
+    else if (hasFile && !hasCode)
+    {
+        MCP_LOG_INFO("Executing Python file: %s", *PythonFile);
+        Request.FilePath = PythonFile;
+    }
+    else
+    {
+        MCP_LOG_INFO("Executing Python code in-process");
+        Request.Code = PythonCode;
+        Request.CodeHash = CodeHash;
+    }
 
-        // Create a unique filename for the temporary Python script
-        FString TempFilePath = TempDir / FString::Printf(TEXT("%s%s.py"), MCPConstants::PYTHON_TEMP_FILE_PREFIX, *FGuid::NewGuid().ToString());
-
-        // Add error handling wrapper to the Python code
-        FString WrappedPythonCode = TEXT("import sys\n")
-                                        TEXT("import traceback\n")
-                                            TEXT("import unreal\n\n")
-                                                TEXT("# Create output capture file\n")
-                                                    TEXT("output_file = open('") +
-                                    TempDir + TEXT("/output.txt', 'w')\n") TEXT("error_file = open('") + TempDir + TEXT("/error.txt', 'w')\n\n") TEXT("# Store original stdout and stderr\n") TEXT("original_stdout = sys.stdout\n") TEXT("original_stderr = sys.stderr\n\n") TEXT("# Redirect stdout and stderr\n") TEXT("sys.stdout = output_file\n") TEXT("sys.stderr = error_file\n\n") TEXT("success = True\n") TEXT("try:\n")
-                                    // Instead of directly embedding the code, we'll compile it first to catch syntax errors
-                                    TEXT("    # Compile the code to catch syntax errors\n") TEXT("    user_code = '''") +
-                                    PythonCode + TEXT("'''\n") TEXT("    try:\n") TEXT("        code_obj = compile(user_code, '<string>', 'exec')\n") TEXT("        # Execute the compiled code\n") TEXT("        exec(code_obj)\n") TEXT("    except SyntaxError as e:\n") TEXT("        traceback.print_exc()\n") TEXT("        success = False\n") TEXT("    except Exception as e:\n") TEXT("        traceback.print_exc()\n") TEXT("        success = False\n") TEXT("except Exception as e:\n") TEXT("    traceback.print_exc()\n") TEXT("    success = False\n") TEXT("finally:\n") TEXT("    # Restore original stdout and stderr\n") TEXT("    sys.stdout = original_stdout\n") TEXT("    sys.stderr = original_stderr\n") TEXT("    output_file.close()\n") TEXT("    error_file.close()\n") TEXT("    # Write success status\n") TEXT("    with open('") + TempDir + TEXT("/status.txt', 'w') as f:\n") TEXT("        f.write('1' if success else '0')\n");
-
-        // Write the Python code to the temporary file
-        if (FFileHelper::SaveStringToFile(WrappedPythonCode, *TempFilePath))
+    bool bAsJob = false;
+    Params->TryGetBoolField(FStringView(TEXT("job")), bAsJob);
+    if (bAsJob)
+    {
+        FString JobId;
+        FString RequestError;
+        if (!FMCPPythonRuntime::StartJob(Request, JobId, RequestError))
         {
-            // Execute the temporary file
-            FString Command = FString::Printf(TEXT("py \"%s\""), *TempFilePath);
-            GEngine->Exec(nullptr, *Command);
-
-            // Read the output, error, and status files
-            FString OutputContent;
-            FString ErrorContent;
-            FString StatusContent;
+            MCP_LOG_ERROR("Python job could not start: %s", *RequestError);
+            return CreateErrorResponse(RequestError);
+        }
 
-            FFileHelper::LoadFileToString(OutputContent, *(TempDir / TEXT("output.txt")));
-            FFileHelper::LoadFileToString(ErrorContent, *(TempDir / TEXT("error.txt")));
-            FFileHelper::LoadFileToString(StatusContent, *(TempDir / TEXT("status.txt")));
+        TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+        ResultObj->SetStringField("job_id", JobId);
+        return CreateSuccessResponse(ResultObj);
+    }
 
-            bSuccess = StatusContent.TrimStartAndEnd().Equals(TEXT("1"));
+    FMCPPythonResult PythonResult;
+    FString RequestError;
+    if (!FMCPPythonRuntime::Execute(Request, PythonResult, RequestError))
+    {
+        MCP_LOG_ERROR("Python execution could not start: %s", *RequestError);
+        return CreateErrorResponse(RequestError);
+    }
 
-            // Combine output and error for the result
-            Result = OutputContent;
-            ErrorMessage = ErrorContent;
+    // Create the response
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetStringField("output", PythonResult.Output);
+    ResultObj->SetStringField("code_hash", PythonResult.CodeHash);
+    ResultObj->SetBoolField("cached", PythonResult.bCacheHit);
+    if (!Request.SessionId.IsEmpty())
+    {
+        ResultObj->SetStringField("session", Request.SessionId);
+    }
 
-            // Clean up the temporary files
-            PlatformFile.DeleteFile(*TempFilePath);
-            PlatformFile.DeleteFile(*(TempDir / TEXT("output.txt")));
-            PlatformFile.DeleteFile(*(TempDir / TEXT("error.txt")));
-            PlatformFile.DeleteFile(*(TempDir / TEXT("status.txt")));
-        }
-        else
+    if (PythonResult.bSuccess)
+    {
+        MCP_LOG_INFO("Python execution successful");
+        if (!PythonResult.Error.IsEmpty())
         {
-            MCP_LOG_ERROR("Failed to create temporary Python file at %s", *TempFilePath);
-            return CreateErrorResponse(FString::Printf(TEXT("Failed to create temporary Python file at %s"), *TempFilePath));
+            ResultObj->SetStringField("error", PythonResult.Error);
         }
+        return CreateSuccessResponse(ResultObj);
     }
-    else if (hasFile)
+    else
     {
-        // Execute Python file
-        MCP_LOG_INFO("Executing Python file: %s", *PythonFile);
+        MCP_LOG_ERROR("Python execution failed: %s", *PythonResult.Error);
+        ResultObj->SetStringField("error", PythonResult.Error);
 
-        // Create a temporary directory for output capture
-        FString TempDir = FPaths::ProjectSavedDir() / MCPConstants::PYTHON_TEMP_DIR_NAME;
-        IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        // We're returning a success response with error details rather than an error response
+        // This allows the client to still access the output and error information
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField("status", "error");
+        Response->SetStringField("message", "Python execution failed with errors");
+        Response->SetObjectField("result", ResultObj);
+        return Response;
+    }
+}
 
-        // Ensure the directory exists
-        if (!PlatformFile.DirectoryExists(*TempDir))
-        {
-            PlatformFile.CreateDirectory(*TempDir);
-        }
+//
+// FMCPRegisterPythonSnippetHandler
+//
+TSharedPtr<FJsonObject> FMCPRegisterPythonSnippetHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    FString Name;
+    if (!Params->TryGetStringField(FStringView(TEXT("name")), Name) || Name.IsEmpty())
+    {
+        MCP_LOG_WARNING("Missing 'name' field in register_python_snippet command");
+        return CreateErrorResponse("Missing 'name' field");
+    }
 
-        // Create a wrapper script that executes the file and captures output
-        FString WrapperFilePath = TempDir / FString::Printf(TEXT("%s_wrapper_%s.py"), MCPConstants::PYTHON_TEMP_FILE_PREFIX, *FGuid::NewGuid().ToString());
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetStringField("name", Name);
 
-        FString WrapperCode = TEXT("import sys\n")
-                                  TEXT("import traceback\n")
-                                      TEXT("import unreal\n\n")
-                                          TEXT("# Create output capture file\n")
-                                              TEXT("output_file = open('") +
-                              TempDir + TEXT("/output.txt', 'w')\n") TEXT("error_file = open('") + TempDir + TEXT("/error.txt', 'w')\n\n") TEXT("# Store original stdout and stderr\n") TEXT("original_stdout = sys.stdout\n") TEXT("original_stderr = sys.stderr\n\n") TEXT("# Redirect stdout and stderr\n") TEXT("sys.stdout = output_file\n") TEXT("sys.stderr = error_file\n\n") TEXT("success = True\n") TEXT("try:\n") TEXT("    # Read the file content\n") TEXT("    with open('") + PythonFile.Replace(TEXT("\\"), TEXT("\\\\")) + TEXT("', 'r') as f:\n") TEXT("        file_content = f.read()\n") TEXT("    # Compile the code to catch syntax errors\n") TEXT("    try:\n") TEXT("        code_obj = compile(file_content, '") + PythonFile.Replace(TEXT("\\"), TEXT("\\\\")) + TEXT("', 'exec')\n") TEXT("        # Execute the compiled code\n") TEXT("        exec(code_obj)\n") TEXT("    except SyntaxError as e:\n") TEXT("        traceback.print_exc()\n") TEXT("        success = False\n") TEXT("    except Exception as e:\n") TEXT("        traceback.print_exc()\n") TEXT("        success = False\n") TEXT("except Exception as e:\n") TEXT("    traceback.print_exc()\n") TEXT("    success = False\n") TEXT("finally:\n") TEXT("    # Restore original stdout and stderr\n") TEXT("    sys.stdout = original_stdout\n") TEXT("    sys.stderr = original_stderr\n") TEXT("    output_file.close()\n") TEXT("    error_file.close()\n") TEXT("    # Write success status\n") TEXT("    with open('") + TempDir + TEXT("/status.txt', 'w') as f:\n") TEXT("        f.write('1' if success else '0')\n");
+    bool bRemove = false;
+    Params->TryGetBoolField(FStringView(TEXT("remove")), bRemove);
+    if (bRemove)
+    {
+        ResultObj->SetBoolField("removed", FMCPPythonRuntime::RemoveSnippet(Name));
+    }
+    else
+    {
+        FString Code;
+        if (!Params->TryGetStringField(FStringView(TEXT("code")), Code) || Code.IsEmpty())
+        {
+            MCP_LOG_WARNING("Missing 'code' field in register_python_snippet command");
+            return CreateErrorResponse("Missing 'code' field");
+        }
 
-        if (FFileHelper::SaveStringToFile(WrapperCode, *WrapperFilePath))
+        FMCPPythonResult PythonResult;
+        FString RequestError;
+        if (!FMCPPythonRuntime::RegisterSnippet(Name, Code, PythonResult, RequestError))
+        {
+            MCP_LOG_ERROR("Failed to register Python snippet %s: %s", *Name, *RequestError);
+            return CreateErrorResponse(RequestError);
+        }
+        if (!PythonResult.bSuccess)
         {
-            // Execute the wrapper script
-            FString Command = FString::Printf(TEXT("py \"%s\""), *WrapperFilePath);
-            GEngine->Exec(nullptr, *Command);
+            MCP_LOG_WARNING("Python snippet %s does not compile", *Name);
+            return CreateErrorResponse(FString::Printf(TEXT("Snippet '%s' does not compile:\n%s"), *Name, *PythonResult.Error));
+        }
 
-            // Read the output, error, and status files
-            FString OutputContent;
-            FString ErrorContent;
-            FString StatusContent;
+        MCP_LOG_INFO("Registered Python snippet %s (%s)", *Name, *PythonResult.CodeHash);
+        ResultObj->SetStringField("code_hash", PythonResult.CodeHash);
+    }
 
-            FFileHelper::LoadFileToString(OutputContent, *(TempDir / TEXT("output.txt")));
-            FFileHelper::LoadFileToString(ErrorContent, *(TempDir / TEXT("error.txt")));
-            FFileHelper::LoadFileToString(StatusContent, *(TempDir / TEXT("status.txt")));
+    TArray<TSharedPtr<FJsonValue>> SnippetNames;
+    for (const FString& SnippetName : FMCPPythonRuntime::GetSnippetNames())
+    {
+        SnippetNames.Add(MakeShared<FJsonValueString>(SnippetName));
+    }
+    ResultObj->SetArrayField("snippets", SnippetNames);
+    return CreateSuccessResponse(ResultObj);
+}
 
-            bSuccess = StatusContent.TrimStartAndEnd().Equals(TEXT("1"));
+//
+// FMCPPythonSessionHandler
+//
+TSharedPtr<FJsonObject> FMCPPythonSessionHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    FString Action = TEXT("list");
+    Params->TryGetStringField(FStringView(TEXT("action")), Action);
+    Action = Action.ToLower();
 
-            // Combine output and error for the result
-            Result = OutputContent;
-            ErrorMessage = ErrorContent;
+    const FString Owner = GetPythonOwner(Params, ClientSocket);
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetStringField("action", Action);
 
-            // Clean up the temporary files
-            PlatformFile.DeleteFile(*WrapperFilePath);
-            PlatformFile.DeleteFile(*(TempDir / TEXT("output.txt")));
-            PlatformFile.DeleteFile(*(TempDir / TEXT("error.txt")));
-            PlatformFile.DeleteFile(*(TempDir / TEXT("status.txt")));
-        }
-        else
+    if (Action == TEXT("reset") || Action == TEXT("drop"))
+    {
+        FString SessionId;
+        if (!Params->TryGetStringField(FStringView(TEXT("session")), SessionId) || SessionId.IsEmpty())
         {
-            MCP_LOG_ERROR("Failed to create wrapper Python file at %s", *WrapperFilePath);
-            return CreateErrorResponse(FString::Printf(TEXT("Failed to create wrapper Python file at %s"), *WrapperFilePath));
+            MCP_LOG_WARNING("Missing 'session' field in python_session command");
+            return CreateErrorResponse("Missing 'session' field");
         }
-    }
 
-    // Create the response
-    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
-    ResultObj->SetStringField("output", Result);
+        const bool bFound = Action == TEXT("reset")
+            ? FMCPPythonRuntime::ResetSession(Owner, SessionId)
+            : FMCPPythonRuntime::DropSession(Owner, SessionId);
+        if (!bFound)
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown Python session '%s'"), *SessionId));
+        }
 
-    if (bSuccess)
-    {
-        MCP_LOG_INFO("Python execution successful");
-        return CreateSuccessResponse(ResultObj);
+        MCP_LOG_INFO("Python session %s: %s", *SessionId, *Action);
+        ResultObj->SetStringField("session", SessionId);
     }
-    else
+    else if (Action != TEXT("list"))
     {
-        MCP_LOG_ERROR("Python execution failed: %s", *ErrorMessage);
-        ResultObj->SetStringField("error", ErrorMessage);
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown action '%s'. Expected list, reset or drop."), *Action));
+    }
 
-        // We're returning a success response with error details rather than an error response
-        // This allows the client to still access the output and error information
-        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
-        Response->SetStringField("status", "error");
-        Response->SetStringField("message", "Python execution failed with errors");
-        Response->SetObjectField("result", ResultObj);
-        return Response;
+    TArray<TSharedPtr<FJsonValue>> SessionValues;
+    for (const FMCPPythonSessionInfo& Info : FMCPPythonRuntime::GetSessions(Owner))
+    {
+        TSharedPtr<FJsonObject> SessionObj = MakeShared<FJsonObject>();
+        SessionObj->SetStringField("session", Info.Id);
+        SessionObj->SetNumberField("globals", Info.NumGlobals);
+        SessionObj->SetNumberField("runs", Info.RunCount);
+        SessionObj->SetNumberField("idle_seconds", Info.IdleSeconds);
+        SessionValues.Add(MakeShared<FJsonValueObject>(SessionObj));
     }
+    ResultObj->SetArrayField("sessions", SessionValues);
+    return CreateSuccessResponse(ResultObj);
 }
 
 TSharedPtr<FJsonObject> FMCPImportTemplateHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
@@ -1,4 +1,5 @@
 #include "MCPCommandHandlers_CelestialVault.h"
+#include "MCPCommandHandlers_Scene.h"
 
 #include "Editor.h"
 #include "Engine/World.h"
@@ -400,6 +401,8 @@ TSharedPtr<FJsonObject> FMCPSetupCelestialVaultHandler::Execute(const TSharedPtr
         }
     }
 
+    FMCPSceneChangeTracker::Get().MarkActorDirty(SkyActor);
+
     // Build response payload
     TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
     Result->SetStringField(TEXT("actor_name"), SkyActor->GetName());
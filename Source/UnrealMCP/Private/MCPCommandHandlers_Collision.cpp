@@ -0,0 +1,310 @@
+#include "MCPCommandHandlers_Collision.h"
+
+#include "MCPCommandHandlers_Instancing.h"
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "Editor.h"
+#include "Engine/World.h"
+#include "Misc/Base64.h"
+
+namespace
+{
+    template <typename T>
+    FString EncodeArrayBase64(const TArray<T>& Values)
+    {
+        return FBase64::Encode(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(T));
+    }
+
+    template <typename T>
+    TArray<TSharedPtr<FJsonValue>> ToJsonNumbers(const TArray<T>& Values)
+    {
+        TArray<TSharedPtr<FJsonValue>> JsonValues;
+        JsonValues.Reserve(Values.Num());
+        for (const T Value : Values)
+        {
+            JsonValues.Add(MakeShared<FJsonValueNumber>(Value));
+        }
+        return JsonValues;
+    }
+
+    bool ParseCollisionChannel(const FString& Name, ECollisionChannel& OutChannel)
+    {
+        static const TMap<FString, ECollisionChannel> Channels = {
+            { TEXT("visibility"), ECC_Visibility },
+            { TEXT("camera"), ECC_Camera },
+            { TEXT("worldstatic"), ECC_WorldStatic },
+            { TEXT("worlddynamic"), ECC_WorldDynamic },
+            { TEXT("pawn"), ECC_Pawn },
+            { TEXT("physicsbody"), ECC_PhysicsBody },
+            { TEXT("vehicle"), ECC_Vehicle },
+            { TEXT("destructible"), ECC_Destructible }
+        };
+
+        if (const ECollisionChannel* Channel = Channels.Find(Name.ToLower()))
+        {
+            OutChannel = *Channel;
+            return true;
+        }
+        return false;
+    }
+
+    /** Build the sweep shape from the request; a zero shape means plain line traces. */
+    bool ParseTraceShape(const TSharedPtr<FJsonObject>& Params, FCollisionShape& OutShape, FString& OutErrorMessage)
+    {
+        FString ShapeName = TEXT("line");
+        Params->TryGetStringField(FStringView(TEXT("shape")), ShapeName);
+
+        double Radius = 0.0;
+        Params->TryGetNumberField(FStringView(TEXT("radius")), Radius);
+
+        if (ShapeName.Equals(TEXT("line"), ESearchCase::IgnoreCase))
+        {
+            OutShape = FCollisionShape();
+            return true;
+        }
+
+        if (ShapeName.Equals(TEXT("sphere"), ESearchCase::IgnoreCase))
+        {
+            if (Radius <= 0.0)
+            {
+                OutErrorMessage = TEXT("Sphere sweeps require a positive 'radius'");
+                return false;
+            }
+            OutShape = FCollisionShape::MakeSphere(Radius);
+            return true;
+        }
+
+        if (ShapeName.Equals(TEXT("capsule"), ESearchCase::IgnoreCase))
+        {
+            double HalfHeight = 0.0;
+            Params->TryGetNumberField(FStringView(TEXT("half_height")), HalfHeight);
+            if (Radius <= 0.0 || HalfHeight < Radius)
+            {
+                OutErrorMessage = TEXT("Capsule sweeps require a positive 'radius' and a 'half_height' of at least the radius");
+                return false;
+            }
+            OutShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+            return true;
+        }
+
+        if (ShapeName.Equals(TEXT("box"), ESearchCase::IgnoreCase))
+        {
+            const TArray<TSharedPtr<FJsonValue>>* ExtentValues = nullptr;
+            if (!Params->TryGetArrayField(FStringView(TEXT("half_extent")), ExtentValues) || !ExtentValues || ExtentValues->Num() != 3)
+            {
+                OutErrorMessage = TEXT("Box sweeps require 'half_extent' [x, y, z]");
+                return false;
+            }
+            OutShape = FCollisionShape::MakeBox(FVector((*ExtentValues)[0]->AsNumber(), (*ExtentValues)[1]->AsNumber(), (*ExtentValues)[2]->AsNumber()));
+            return true;
+        }
+
+        OutErrorMessage = FString::Printf(TEXT("Unknown shape '%s' (expected line, sphere, capsule or box)"), *ShapeName);
+        return false;
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPBatchTracesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling batch_traces command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    // Rays: origins plus either end points or directions scaled by max_distance
+    TArray<double> Origins;
+    FString ParseError;
+    if (!FMCPInstancingUtils::ParsePackedDoubles(Params, TEXT("origins"), TEXT("origins_base64"), Origins, ParseError))
+    {
+        return CreateErrorResponse(ParseError);
+    }
+
+    if (Origins.Num() == 0 || Origins.Num() % 3 != 0)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Expected 3 values per origin, got %d values"), Origins.Num()));
+    }
+
+    const int32 NumRays = Origins.Num() / 3;
+    if (NumRays > MCPConstants::MAX_BATCH_TRACES)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Too many rays (%d); the limit is %d per call"), NumRays, MCPConstants::MAX_BATCH_TRACES));
+    }
+
+    TArray<double> Ends;
+    TArray<double> Directions;
+    const bool bHasEnds = Params->HasField(TEXT("ends")) || Params->HasField(TEXT("ends_base64")) || Params->HasField(TEXT("ends_f64_base64"));
+    if (bHasEnds
+        ? !FMCPInstancingUtils::ParsePackedDoubles(Params, TEXT("ends"), TEXT("ends_base64"), Ends, ParseError)
+        : !FMCPInstancingUtils::ParsePackedDoubles(Params, TEXT("directions"), TEXT("directions_base64"), Directions, ParseError))
+    {
+        return CreateErrorResponse(bHasEnds ? ParseError : FString(TEXT("Provide 'ends' or 'directions' for each origin")));
+    }
+
+    // A single direction or end point is shared by every ray
+    const TArray<double>& Targets = bHasEnds ? Ends : Directions;
+    if (Targets.Num() != Origins.Num() && Targets.Num() != 3)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Expected %d or 3 target values, got %d"), Origins.Num(), Targets.Num()));
+    }
+    const bool bSharedTarget = Targets.Num() == 3;
+
+    double MaxDistance = MCPConstants::DEFAULT_TRACE_DISTANCE;
+    Params->TryGetNumberField(FStringView(TEXT("max_distance")), MaxDistance);
+
+    FString ChannelName = TEXT("visibility");
+    Params->TryGetStringField(FStringView(TEXT("channel")), ChannelName);
+    ECollisionChannel Channel = ECC_Visibility;
+    if (!ParseCollisionChannel(ChannelName, Channel))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown collision channel '%s'"), *ChannelName));
+    }
+
+    FCollisionShape Shape;
+    if (!ParseTraceShape(Params, Shape, ParseError))
+    {
+        return CreateErrorResponse(ParseError);
+    }
+
+    FQuat ShapeRotation = FQuat::Identity;
+    const TArray<TSharedPtr<FJsonValue>>* RotationValues = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("shape_rotation")), RotationValues) && RotationValues && RotationValues->Num() == 3)
+    {
+        ShapeRotation = FRotator((*RotationValues)[0]->AsNumber(), (*RotationValues)[1]->AsNumber(), (*RotationValues)[2]->AsNumber()).Quaternion();
+    }
+
+    bool bTraceComplex = true;
+    Params->TryGetBoolField(FStringView(TEXT("trace_complex")), bTraceComplex);
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MCPBatchTraces), bTraceComplex);
+    const TArray<TSharedPtr<FJsonValue>>* IgnoreValues = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("ignore_actors")), IgnoreValues) && IgnoreValues)
+    {
+        for (const TSharedPtr<FJsonValue>& IgnoreValue : *IgnoreValues)
+        {
+            FString LookupError;
+            if (AActor* IgnoredActor = FMCPInstancingUtils::FindActorByNameOrLabel(World, IgnoreValue->AsString(), LookupError))
+            {
+                QueryParams.AddIgnoredActor(IgnoredActor);
+            }
+            else if (!LookupError.IsEmpty())
+            {
+                return CreateErrorResponse(LookupError);
+            }
+        }
+    }
+
+    FString Encoding = TEXT("base64");
+    Params->TryGetStringField(FStringView(TEXT("encoding")), Encoding);
+    const bool bBase64 = !Encoding.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+
+    // Scene queries are read-only, so the rays are split across worker threads
+    TArray<uint8> Hits;
+    TArray<double> Positions;
+    TArray<float> Normals;
+    TArray<float> Distances;
+    TArray<AActor*> HitActors;
+    Hits.SetNumZeroed(NumRays);
+    Positions.SetNumZeroed(NumRays * 3);
+    Normals.SetNumZeroed(NumRays * 3);
+    Distances.SetNumZeroed(NumRays);
+    HitActors.SetNumZeroed(NumRays);
+
+    const bool bLineTrace = Shape.IsLine();
+    ParallelFor(NumRays, [&](int32 Index)
+    {
+        const double* Origin = Origins.GetData() + Index * 3;
+        const double* Target = Targets.GetData() + (bSharedTarget ? 0 : Index * 3);
+        const FVector Start(Origin[0], Origin[1], Origin[2]);
+        const FVector End = bHasEnds
+            ? FVector(Target[0], Target[1], Target[2])
+            : Start + FVector(Target[0], Target[1], Target[2]).GetSafeNormal() * MaxDistance;
+
+        FHitResult Hit;
+        const bool bHit = bLineTrace
+            ? World->LineTraceSingleByChannel(Hit, Start, End, Channel, QueryParams)
+            : World->SweepSingleByChannel(Hit, Start, End, ShapeRotation, Channel, Shape, QueryParams);
+        if (!bHit)
+        {
+            return;
+        }
+
+        Hits[Index] = 1;
+        Positions[Index * 3] = Hit.Location.X;
+        Positions[Index * 3 + 1] = Hit.Location.Y;
+        Positions[Index * 3 + 2] = Hit.Location.Z;
+        Normals[Index * 3] = Hit.ImpactNormal.X;
+        Normals[Index * 3 + 1] = Hit.ImpactNormal.Y;
+        Normals[Index * 3 + 2] = Hit.ImpactNormal.Z;
+        Distances[Index] = Hit.Distance;
+        HitActors[Index] = Hit.GetActor();
+    });
+
+    // Actor handles are indices into a deduplicated actor table
+    TArray<int32> ActorIds;
+    ActorIds.Init(INDEX_NONE, NumRays);
+    TMap<AActor*, int32> ActorToId;
+    TArray<TSharedPtr<FJsonValue>> ActorTable;
+    int32 HitCount = 0;
+    for (int32 Index = 0; Index < NumRays; ++Index)
+    {
+        HitCount += Hits[Index];
+        AActor* HitActor = HitActors[Index];
+        if (!HitActor)
+        {
+            continue;
+        }
+
+        if (const int32* ExistingId = ActorToId.Find(HitActor))
+        {
+            ActorIds[Index] = *ExistingId;
+            continue;
+        }
+
+        TSharedPtr<FJsonObject> ActorObject = MakeShared<FJsonObject>();
+        ActorObject->SetStringField(TEXT("name"), HitActor->GetName());
+        ActorObject->SetStringField(TEXT("label"), HitActor->GetActorLabel());
+        ActorObject->SetStringField(TEXT("class"), HitActor->GetClass()->GetName());
+        ActorIds[Index] = ActorToId.Add(HitActor, ActorTable.Add(MakeShared<FJsonValueObject>(ActorObject)));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("ray_count"), NumRays);
+    Result->SetNumberField(TEXT("hit_count"), HitCount);
+    Result->SetStringField(TEXT("shape"), bLineTrace ? TEXT("line") : TEXT("sweep"));
+    Result->SetArrayField(TEXT("actors"), ActorTable);
+    Result->SetStringField(TEXT("encoding"), bBase64 ? TEXT("base64") : TEXT("json"));
+
+    // Positions keep double precision so hits far from the origin are not quantised
+    TSharedPtr<FJsonObject> DTypes = MakeShared<FJsonObject>();
+    DTypes->SetStringField(TEXT("hits"), TEXT("uint8"));
+    DTypes->SetStringField(TEXT("positions"), TEXT("float64"));
+    DTypes->SetStringField(TEXT("normals"), TEXT("float32"));
+    DTypes->SetStringField(TEXT("distances"), TEXT("float32"));
+    DTypes->SetStringField(TEXT("actor_ids"), TEXT("int32"));
+    Result->SetObjectField(TEXT("dtypes"), DTypes);
+    if (bBase64)
+    {
+        Result->SetStringField(TEXT("hits_base64"), EncodeArrayBase64(Hits));
+        Result->SetStringField(TEXT("positions_base64"), EncodeArrayBase64(Positions));
+        Result->SetStringField(TEXT("normals_base64"), EncodeArrayBase64(Normals));
+        Result->SetStringField(TEXT("distances_base64"), EncodeArrayBase64(Distances));
+        Result->SetStringField(TEXT("actor_ids_base64"), EncodeArrayBase64(ActorIds));
+    }
+    else
+    {
+        Result->SetArrayField(TEXT("hits"), ToJsonNumbers(Hits));
+        Result->SetArrayField(TEXT("positions"), ToJsonNumbers(Positions));
+        Result->SetArrayField(TEXT("normals"), ToJsonNumbers(Normals));
+        Result->SetArrayField(TEXT("distances"), ToJsonNumbers(Distances));
+        Result->SetArrayField(TEXT("actor_ids"), ToJsonNumbers(ActorIds));
+    }
+
+    MCP_LOG_INFO("batch_traces: %d of %d rays hit (%d distinct actors)", HitCount, NumRays, ActorTable.Num());
+    return CreateSuccessResponse(Result);
+}
@@ -1,16 +1,24 @@
 #include "MCPCommandHandlers_DataTables.h"
 
+#include "MCPConstants.h"
 #include "MCPFileLogger.h"
 
+#include "Algo/AllOf.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "DataTableUtils.h"
 #include "Dom/JsonValue.h"
 #include "Editor.h"
+#include "HAL/FileManager.h"
 #include "JsonObjectConverter.h"
 #include "Misc/PackageName.h"
+#include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
+#include "Serialization/JsonReader.h"
 #include "UObject/Package.h"
 #include "UObject/SavePackage.h"
-#include "UObject/StructOnScope.h"
 
 namespace
 {
@@ -37,85 +45,1501 @@ namespace
 
         return FString::Printf(TEXT("/Game/%s"), *Sanitised);
     }
+
+    constexpr int32 MaxJsonDepth = 64;
+
+    /**
+     * Reads a UTF-8 text file a chunk at a time and hands it out as TCHARs, so memory is bounded by
+     * the chunk size rather than the file. It is also the FArchive TJsonReader pulls characters from;
+     * a few characters of the previous chunk are kept so the reader can step back over a chunk edge.
+     */
+    class FMCPTextFileStream : public FArchive
+    {
+    public:
+        explicit FMCPTextFileStream(TUniquePtr<FArchive>&& InFile)
+            : File(MoveTemp(InFile))
+        {
+            SetIsLoading(true);
+        }
+
+        /** Next character, counting lines; false at the end of the file */
+        bool ReadChar(TCHAR& OutChar)
+        {
+            if (!EnsureAvailable())
+            {
+                return false;
+            }
+
+            OutChar = Chars[CharIndex++];
+            if (OutChar == TEXT('\n'))
+            {
+                ++Line;
+            }
+            return true;
+        }
+
+        bool PeekChar(TCHAR& OutChar)
+        {
+            if (!EnsureAvailable())
+            {
+                return false;
+            }
+
+            OutChar = Chars[CharIndex];
+            return true;
+        }
+
+        int32 GetLine() const
+        {
+            return Line;
+        }
+
+        /** Why the stream stopped early (read failure, unsupported encoding); empty otherwise */
+        const FString& GetStreamError() const
+        {
+            return StreamError;
+        }
+
+        virtual void Serialize(void* Data, int64 Num) override
+        {
+            TCHAR* Out = static_cast<TCHAR*>(Data);
+            const int64 NumChars = Num / static_cast<int64>(sizeof(TCHAR));
+            for (int64 Index = 0; Index < NumChars; ++Index)
+            {
+                if (!EnsureAvailable())
+                {
+                    FMemory::Memzero(Out + Index, (NumChars - Index) * sizeof(TCHAR));
+                    SetError();
+                    return;
+                }
+
+                Out[Index] = Chars[CharIndex++];
+            }
+        }
+
+        virtual int64 Tell() override
+        {
+            return (CharsBefore + CharIndex) * sizeof(TCHAR);
+        }
+
+        virtual void Seek(int64 InPos) override
+        {
+            const int64 Target = InPos / static_cast<int64>(sizeof(TCHAR)) - CharsBefore;
+            if (Target < 0 || Target > Chars.Num())
+            {
+                SetError();
+                return;
+            }
+
+            CharIndex = static_cast<int32>(Target);
+        }
+
+        virtual bool AtEnd() override
+        {
+            return !EnsureAvailable();
+        }
+
+        virtual FString GetArchiveName() const override
+        {
+            return TEXT("FMCPTextFileStream");
+        }
+
+    private:
+        static constexpr int32 RetainedChars = 16;
+
+        bool EnsureAvailable()
+        {
+            while (CharIndex >= Chars.Num())
+            {
+                if (!Refill())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /** Decode the next chunk; a UTF-8 sequence cut by the chunk edge is completed by the following read */
+        bool Refill()
+        {
+            if (!StreamError.IsEmpty())
+            {
+                return false;
+            }
+
+            const int64 Remaining = File->TotalSize() - File->Tell();
+            if (Remaining <= 0)
+            {
+                return false;
+            }
+
+            const int32 ReadSize = static_cast<int32>(FMath::Min<int64>(Remaining, MCPConstants::DATA_TABLE_IMPORT_CHUNK_BYTES));
+            const int32 Offset = PendingBytes.Num();
+            PendingBytes.SetNumUninitialized(Offset + ReadSize);
+            File->Serialize(PendingBytes.GetData() + Offset, ReadSize);
+            if (File->IsError())
+            {
+                StreamError = TEXT("Failed to read the rows file.");
+                SetError();
+                return false;
+            }
+
+            if (bAtStart && PendingBytes.Num() >= 2
+                && ((PendingBytes[0] == 0xFF && PendingBytes[1] == 0xFE) || (PendingBytes[0] == 0xFE && PendingBytes[1] == 0xFF)))
+            {
+                StreamError = TEXT("Rows file is UTF-16; save it as UTF-8.");
+                SetError();
+                return false;
+            }
+
+            int32 Complete = PendingBytes.Num();
+            if (File->Tell() < File->TotalSize())
+            {
+                for (int32 Back = 1; Back <= FMath::Min(3, Complete); ++Back)
+                {
+                    const uint8 Byte = PendingBytes[PendingBytes.Num() - Back];
+                    if ((Byte & 0xC0) == 0x80)
+                    {
+                        continue;
+                    }
+
+                    const int32 SequenceLength = Byte >= 0xF0 ? 4 : Byte >= 0xE0 ? 3 : Byte >= 0xC0 ? 2 : 1;
+                    if (SequenceLength > Back)
+                    {
+                        Complete -= Back;
+                    }
+                    break;
+                }
+            }
+
+            const int32 Keep = FMath::Min(RetainedChars, Chars.Num());
+            const int32 Dropped = Chars.Num() - Keep;
+            Chars.RemoveAt(0, Dropped, false);
+            CharsBefore += Dropped;
+            CharIndex -= Dropped;
+
+            if (Complete > 0)
+            {
+                const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(PendingBytes.GetData()), Complete);
+                const TCHAR* Text = Converted.Get();
+                int32 Length = Converted.Length();
+                if (bAtStart && Length > 0 && Text[0] == 0xFEFF)
+                {
+                    ++Text;
+                    --Length;
+                }
+
+                bAtStart = false;
+                Chars.Append(Text, Length);
+                PendingBytes.RemoveAt(0, Complete, false);
+            }
+
+            return true;
+        }
+
+        TUniquePtr<FArchive> File;
+        TArray<uint8> PendingBytes;
+        TArray<TCHAR> Chars;
+        int64 CharsBefore = 0;
+        int32 CharIndex = 0;
+        int32 Line = 1;
+        bool bAtStart = true;
+        FString StreamError;
+    };
+
+    enum class ECsvRecord : uint8
+    {
+        Record,
+        End,
+        Error
+    };
+
+    /**
+     * Read one RFC 4180 record: comma separated fields, optionally double-quoted with "" standing for
+     * a quote; quoted fields may span lines. Blank lines between records are skipped.
+     */
+    ECsvRecord ReadCsvRecord(FMCPTextFileStream& Stream, TArray<FString>& OutFields, int32& OutLine, FString& OutErrorMessage)
+    {
+        OutFields.Reset();
+
+        TCHAR Char;
+        while (Stream.PeekChar(Char) && (Char == TEXT('\r') || Char == TEXT('\n')))
+        {
+            Stream.ReadChar(Char);
+        }
+
+        if (!Stream.PeekChar(Char))
+        {
+            return ECsvRecord::End;
+        }
+
+        OutLine = Stream.GetLine();
+
+        FString Field;
+        bool bInQuotes = false;
+        bool bFieldQuoted = false;
+        int32 RecordChars = 0;
+
+        while (Stream.ReadChar(Char))
+        {
+            if (++RecordChars > MCPConstants::MAX_DATA_TABLE_IMPORT_RECORD_CHARS)
+            {
+                OutErrorMessage = FString::Printf(TEXT("Record on line %d is longer than %d characters."),
+                    OutLine, MCPConstants::MAX_DATA_TABLE_IMPORT_RECORD_CHARS);
+                return ECsvRecord::Error;
+            }
+
+            if (bInQuotes)
+            {
+                TCHAR Next;
+                if (Char != TEXT('"'))
+                {
+                    Field.AppendChar(Char);
+                }
+                else if (Stream.PeekChar(Next) && Next == TEXT('"'))
+                {
+                    Stream.ReadChar(Next);
+                    Field.AppendChar(TEXT('"'));
+                }
+                else
+                {
+                    bInQuotes = false;
+                }
+            }
+            else if (Char == TEXT('"') && Field.IsEmpty() && !bFieldQuoted)
+            {
+                bInQuotes = true;
+                bFieldQuoted = true;
+            }
+            else if (Char == TEXT(','))
+            {
+                OutFields.Add(MoveTemp(Field));
+                Field.Reset();
+                bFieldQuoted = false;
+            }
+            else if (Char == TEXT('\n'))
+            {
+                break;
+            }
+            else if (Char != TEXT('\r'))
+            {
+                Field.AppendChar(Char);
+            }
+        }
+
+        if (bInQuotes)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Quoted field starting on line %d is never closed."), OutLine);
+            return ECsvRecord::Error;
+        }
+
+        OutFields.Add(MoveTemp(Field));
+        return ECsvRecord::Record;
+    }
+
+    TSharedPtr<FJsonValue> ReadJsonValue(TJsonReader<TCHAR>& Reader, EJsonNotation Notation, int32 Depth, FString& OutErrorMessage);
+
+    /** Build the object or array whose start token the reader has just returned */
+    TSharedPtr<FJsonValue> ReadJsonContainer(TJsonReader<TCHAR>& Reader, bool bObject, int32 Depth, FString& OutErrorMessage)
+    {
+        if (Depth > MaxJsonDepth)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Rows nest deeper than %d levels."), MaxJsonDepth);
+            return nullptr;
+        }
+
+        TSharedPtr<FJsonObject> Object = bObject ? MakeShared<FJsonObject>() : nullptr;
+        TArray<TSharedPtr<FJsonValue>> Array;
+
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == (bObject ? EJsonNotation::ObjectEnd : EJsonNotation::ArrayEnd))
+            {
+                if (bObject)
+                {
+                    return MakeShared<FJsonValueObject>(Object);
+                }
+                return MakeShared<FJsonValueArray>(Array);
+            }
+
+            const FString Key = Reader.GetIdentifier();
+            TSharedPtr<FJsonValue> Value = ReadJsonValue(Reader, Notation, Depth + 1, OutErrorMessage);
+            if (!Value.IsValid())
+            {
+                return nullptr;
+            }
+
+            if (bObject)
+            {
+                Object->SetField(Key, Value);
+            }
+            else
+            {
+                Array.Add(Value);
+            }
+        }
+
+        OutErrorMessage = Reader.GetErrorMessage();
+        return nullptr;
+    }
+
+    TSharedPtr<FJsonValue> ReadJsonValue(TJsonReader<TCHAR>& Reader, EJsonNotation Notation, int32 Depth, FString& OutErrorMessage)
+    {
+        switch (Notation)
+        {
+        case EJsonNotation::String:
+            return MakeShared<FJsonValueString>(Reader.GetValueAsString());
+        case EJsonNotation::Number:
+            return MakeShared<FJsonValueNumberString>(Reader.GetValueAsNumberString());
+        case EJsonNotation::Boolean:
+            return MakeShared<FJsonValueBoolean>(Reader.GetValueAsBoolean());
+        case EJsonNotation::Null:
+            return MakeShared<FJsonValueNull>();
+        case EJsonNotation::ObjectStart:
+            return ReadJsonContainer(Reader, true, Depth, OutErrorMessage);
+        case EJsonNotation::ArrayStart:
+            return ReadJsonContainer(Reader, false, Depth, OutErrorMessage);
+        default:
+            OutErrorMessage = Reader.GetErrorMessage();
+            return nullptr;
+        }
+    }
+
+    bool IsValidRowName(const FString& RowName, FString& OutErrorMessage)
+    {
+        if (RowName.IsEmpty())
+        {
+            OutErrorMessage = TEXT("Row has no name.");
+            return false;
+        }
+
+        if (RowName.Len() >= NAME_SIZE)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Row name is longer than %d characters."), NAME_SIZE - 1);
+            return false;
+        }
+
+        return true;
+    }
+
+    void RecordRowError(FMCPDataTableImportStats& Stats, const FString& RowName, int32 Line, const FString& Message)
+    {
+        ++Stats.RowsFailed;
+        if (Stats.Errors.Num() < MCPConstants::MAX_DATA_TABLE_IMPORT_ERRORS)
+        {
+            FMCPDataTableRowError& Error = Stats.Errors.AddDefaulted_GetRef();
+            Error.RowName = RowName;
+            Error.Line = Line;
+            Error.Message = Message;
+        }
+    }
+
+    /** A row read from the source, waiting to be decoded */
+    struct FPendingRow
+    {
+        FString Name;
+        int32 Line = 0;
+
+        /** JSON source; CSV rows carry Fields instead */
+        TSharedPtr<FJsonObject> Json;
+        TArray<FString> Fields;
+    };
+
+    /** CSV header names and the property each column imports into (null for the name column and unknown columns) */
+    struct FCsvColumns
+    {
+        TArray<FString> Names;
+        TArray<FProperty*> Properties;
+    };
+
+    /** Below this many rows a batch is decoded on the calling thread */
+    constexpr int32 MinParallelDecodeRows = 64;
+
+    /**
+     * Decode a batch of rows into one block of row struct memory, on worker threads when the plan
+     * allows it, then add them to the table in source order on the calling thread.
+     * @param OutErrors - Receives the decode error of each row, empty for rows that decoded
+     * @param bStopAtFirstError - Add only the rows before the first failure
+     * @return Number of rows added
+     */
+    int32 DecodeAndAddRows(
+        UDataTable* DataTable,
+        const FMCPRowConversionPlan& Plan,
+        const TArray<FPendingRow>& Rows,
+        const FCsvColumns* CsvColumns,
+        bool bStopAtFirstError,
+        TArray<FString>& OutErrors)
+    {
+        OutErrors.Reset();
+        OutErrors.SetNum(Rows.Num());
+        if (Rows.Num() == 0)
+        {
+            return 0;
+        }
+
+        const UScriptStruct* RowStruct = DataTable->RowStruct;
+        const SIZE_T Stride = RowStruct->GetStructureSize();
+        uint8* RowMemory = static_cast<uint8*>(FMemory::Malloc(Stride * Rows.Num(), RowStruct->GetMinAlignment()));
+        RowStruct->InitializeStruct(RowMemory, Rows.Num());
+
+        const bool bParallel = Plan.IsParallelSafe() && Rows.Num() >= MinParallelDecodeRows;
+        ParallelFor(Rows.Num(), [&Rows, &OutErrors, &Plan, CsvColumns, RowMemory, Stride](int32 Index)
+        {
+            const FPendingRow& Row = Rows[Index];
+            uint8* RowData = RowMemory + Stride * Index;
+
+            if (Row.Json.IsValid())
+            {
+                Plan.Decode(*Row.Json, RowData, OutErrors[Index]);
+                return;
+            }
+
+            for (int32 Column = 0; Column < Row.Fields.Num(); ++Column)
+            {
+                const FProperty* Property = CsvColumns->Properties[Column];
+                if (!Property)
+                {
+                    continue;
+                }
+
+                const FString CellError = DataTableUtils::AssignStringToProperty(Row.Fields[Column], Property, RowData);
+                if (!CellError.IsEmpty())
+                {
+                    OutErrors[Index] = FString::Printf(TEXT("Column '%s': %s"), *CsvColumns->Names[Column], *CellError);
+                    return;
+                }
+            }
+        }, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+        int32 RowsAdded = 0;
+        for (int32 Index = 0; Index < Rows.Num(); ++Index)
+        {
+            if (!OutErrors[Index].IsEmpty())
+            {
+                if (bStopAtFirstError)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            DataTable->AddRow(FName(*Rows[Index].Name), RowMemory + Stride * Index, RowStruct);
+            ++RowsAdded;
+        }
+
+        RowStruct->DestroyStruct(RowMemory, Rows.Num());
+        FMemory::Free(RowMemory);
+        return RowsAdded;
+    }
+
+    /** Decode and add the pending rows of an import, recording the ones that fail */
+    void FlushImportBatch(
+        UDataTable* DataTable,
+        const FMCPRowConversionPlan& Plan,
+        TArray<FPendingRow>& Rows,
+        const FCsvColumns* CsvColumns,
+        FMCPDataTableImportStats& Stats)
+    {
+        TArray<FString> Errors;
+        Stats.RowsApplied += DecodeAndAddRows(DataTable, Plan, Rows, CsvColumns, false, Errors);
+
+        for (int32 Index = 0; Index < Rows.Num(); ++Index)
+        {
+            if (!Errors[Index].IsEmpty())
+            {
+                RecordRowError(Stats, Rows[Index].Name, Rows[Index].Line, Errors[Index]);
+            }
+        }
+
+        Rows.Reset();
+    }
+
+    bool ImportCsvRows(
+        FMCPTextFileStream& Stream,
+        UDataTable* DataTable,
+        const FMCPRowConversionPlan& Plan,
+        const FString& NameColumn,
+        FMCPDataTableImportStats& Stats,
+        FString& OutErrorMessage)
+    {
+        FCsvColumns Columns;
+        int32 Line = 0;
+        const ECsvRecord HeaderRecord = ReadCsvRecord(Stream, Columns.Names, Line, OutErrorMessage);
+        if (HeaderRecord == ECsvRecord::Error)
+        {
+            return false;
+        }
+
+        if (HeaderRecord == ECsvRecord::End)
+        {
+            OutErrorMessage = TEXT("Rows file has no header row.");
+            return false;
+        }
+
+        for (FString& ColumnName : Columns.Names)
+        {
+            ColumnName.TrimStartAndEndInline();
+        }
+
+        int32 NameIndex = 0;
+        if (!NameColumn.IsEmpty())
+        {
+            NameIndex = Columns.Names.IndexOfByPredicate([&NameColumn](const FString& ColumnName)
+            {
+                return ColumnName.Equals(NameColumn, ESearchCase::IgnoreCase);
+            });
+
+            if (NameIndex == INDEX_NONE)
+            {
+                OutErrorMessage = FString::Printf(TEXT("Name column '%s' is not in the CSV header."), *NameColumn);
+                return false;
+            }
+        }
+
+        // Resolve columns once; cells of unknown columns are skipped on every row
+        Columns.Properties.SetNumZeroed(Columns.Names.Num());
+        for (int32 Column = 0; Column < Columns.Names.Num(); ++Column)
+        {
+            if (Column == NameIndex)
+            {
+                continue;
+            }
+
+            Columns.Properties[Column] = DataTable->FindTableProperty(FName(*Columns.Names[Column]));
+            if (!Columns.Properties[Column])
+            {
+                Stats.IgnoredColumns.Add(Columns.Names[Column]);
+            }
+        }
+
+        TArray<FPendingRow> Pending;
+        Pending.Reserve(MCPConstants::DATA_TABLE_DECODE_BATCH_ROWS);
+
+        TArray<FString> Fields;
+        while (true)
+        {
+            const ECsvRecord Record = ReadCsvRecord(Stream, Fields, Line, OutErrorMessage);
+            if (Record != ECsvRecord::Record)
+            {
+                // Rows read before a malformed record are still added
+                FlushImportBatch(DataTable, Plan, Pending, &Columns, Stats);
+                return Record == ECsvRecord::End;
+            }
+
+            const FString RowName = Fields.IsValidIndex(NameIndex) ? Fields[NameIndex].TrimStartAndEnd() : FString();
+            FString RowError;
+            if (!IsValidRowName(RowName, RowError))
+            {
+                RecordRowError(Stats, RowName, Line, RowError);
+                continue;
+            }
+
+            if (Fields.Num() > Columns.Names.Num())
+            {
+                RecordRowError(Stats, RowName, Line,
+                    FString::Printf(TEXT("Row has %d fields but the header has %d."), Fields.Num(), Columns.Names.Num()));
+                continue;
+            }
+
+            FPendingRow& Row = Pending.AddDefaulted_GetRef();
+            Row.Name = RowName;
+            Row.Line = Line;
+            Row.Fields = MoveTemp(Fields);
+
+            if (Pending.Num() >= MCPConstants::DATA_TABLE_DECODE_BATCH_ROWS)
+            {
+                FlushImportBatch(DataTable, Plan, Pending, &Columns, Stats);
+            }
+        }
+    }
+
+    bool ImportJsonRows(
+        FMCPTextFileStream& Stream,
+        UDataTable* DataTable,
+        const FMCPRowConversionPlan& Plan,
+        const FString& NameColumn,
+        FMCPDataTableImportStats& Stats,
+        FString& OutErrorMessage)
+    {
+        const TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(&Stream);
+        const FString NameField = NameColumn.IsEmpty() ? FString(TEXT("Name")) : NameColumn;
+
+        EJsonNotation Notation;
+        if (!Reader->ReadNext(Notation) || (Notation != EJsonNotation::ObjectStart && Notation != EJsonNotation::ArrayStart))
+        {
+            OutErrorMessage = TEXT("Rows file must hold a JSON object keyed by row name or an array of row objects.");
+            return false;
+        }
+
+        const bool bKeyedByName = Notation == EJsonNotation::ObjectStart;
+        const EJsonNotation EndNotation = bKeyedByName ? EJsonNotation::ObjectEnd : EJsonNotation::ArrayEnd;
+
+        TArray<FPendingRow> Pending;
+        Pending.Reserve(MCPConstants::DATA_TABLE_DECODE_BATCH_ROWS);
+
+        // Only the current batch of rows is materialised; the rest of the document stays on disk
+        while (true)
+        {
+            if (!Reader->ReadNext(Notation))
+            {
+                FlushImportBatch(DataTable, Plan, Pending, nullptr, Stats);
+                OutErrorMessage = FString::Printf(TEXT("Invalid JSON on line %d: %s"), static_cast<int32>(Reader->GetLineNumber()), *Reader->GetErrorMessage());
+                return false;
+            }
+
+            if (Notation == EndNotation)
+            {
+                FlushImportBatch(DataTable, Plan, Pending, nullptr, Stats);
+                return true;
+            }
+
+            const int32 Line = static_cast<int32>(Reader->GetLineNumber());
+            FString RowName = bKeyedByName ? Reader->GetIdentifier() : FString();
+
+            FString ReadError;
+            const TSharedPtr<FJsonValue> RowValue = ReadJsonValue(*Reader, Notation, 1, ReadError);
+            if (!RowValue.IsValid())
+            {
+                FlushImportBatch(DataTable, Plan, Pending, nullptr, Stats);
+                OutErrorMessage = FString::Printf(TEXT("Invalid JSON on line %d: %s"), static_cast<int32>(Reader->GetLineNumber()), *ReadError);
+                return false;
+            }
+
+            const TSharedPtr<FJsonObject> RowJson = RowValue->Type == EJson::Object ? RowValue->AsObject() : nullptr;
+            if (!RowJson.IsValid())
+            {
+                RecordRowError(Stats, RowName, Line, TEXT("Row must be a JSON object."));
+                continue;
+            }
+
+            if (!bKeyedByName)
+            {
+                RowJson->TryGetStringField(NameField, RowName);
+                RowJson->RemoveField(NameField);
+            }
+
+            FString RowError;
+            if (!IsValidRowName(RowName, RowError))
+            {
+                RecordRowError(Stats, RowName, Line, RowError);
+                continue;
+            }
+
+            FPendingRow& Row = Pending.AddDefaulted_GetRef();
+            Row.Name = MoveTemp(RowName);
+            Row.Line = Line;
+            Row.Json = RowJson;
+
+            if (Pending.Num() >= MCPConstants::DATA_TABLE_DECODE_BATCH_ROWS)
+            {
+                FlushImportBatch(DataTable, Plan, Pending, nullptr, Stats);
+            }
+        }
+    }
+
+    /** Query column that stands for the row name, as in the editor's JSON export */
+    constexpr const TCHAR* RowNameColumn = TEXT("Name");
+
+    enum class EQueryOp : uint8
+    {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Contains
+    };
+
+    bool ParseQueryOp(const FString& Text, EQueryOp& OutOp)
+    {
+        static const TPair<const TCHAR*, EQueryOp> Ops[] = {
+            { TEXT("eq"), EQueryOp::Equal },
+            { TEXT("ne"), EQueryOp::NotEqual },
+            { TEXT("lt"), EQueryOp::Less },
+            { TEXT("lte"), EQueryOp::LessEqual },
+            { TEXT("gt"), EQueryOp::Greater },
+            { TEXT("gte"), EQueryOp::GreaterEqual },
+            { TEXT("contains"), EQueryOp::Contains },
+        };
+
+        for (const TPair<const TCHAR*, EQueryOp>& Op : Ops)
+        {
+            if (Text.Equals(Op.Key, ESearchCase::IgnoreCase))
+            {
+                OutOp = Op.Value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Column a query refers to; a null property stands for the row name */
+    struct FQueryColumn
+    {
+        FString Key;
+        const FProperty* Property = nullptr;
+        bool bNumeric = false;
+    };
+
+    struct FQueryFilter
+    {
+        FQueryColumn Column;
+        EQueryOp Op = EQueryOp::Equal;
+        double Number = 0.0;
+        FString Text;
+    };
+
+    /** Numeric and bool columns compare as numbers; everything else compares as case-insensitive text */
+    bool IsNumericColumn(const FProperty* Property)
+    {
+        if (!Property || Property->ArrayDim != 1)
+        {
+            return false;
+        }
+
+        const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property);
+        return Property->IsA<FBoolProperty>() || (NumericProperty && !NumericProperty->IsEnum());
+    }
+
+    bool ResolveQueryColumn(UDataTable* DataTable, const FString& Name, FQueryColumn& OutColumn, FString& OutErrorMessage)
+    {
+        if (Name.Equals(RowNameColumn, ESearchCase::IgnoreCase))
+        {
+            OutColumn.Key = RowNameColumn;
+            OutColumn.Property = nullptr;
+            OutColumn.bNumeric = false;
+            return true;
+        }
+
+        const FProperty* Property = DataTable->FindTableProperty(FName(*Name));
+        if (!Property)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Column '%s' is not a property of '%s'."), *Name, *DataTable->RowStruct->GetName());
+            return false;
+        }
+
+        OutColumn.Key = DataTableUtils::GetPropertyExportName(Property);
+        OutColumn.Property = Property;
+        OutColumn.bNumeric = IsNumericColumn(Property);
+        return true;
+    }
+
+    double ReadColumnNumber(const FProperty* Property, const uint8* RowData)
+    {
+        const void* ValuePtr = Property->ContainerPtrToValuePtr<void>(RowData);
+        if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+        {
+            return BoolProperty->GetPropertyValue(ValuePtr) ? 1.0 : 0.0;
+        }
+
+        const FNumericProperty* NumericProperty = CastFieldChecked<FNumericProperty>(Property);
+        return NumericProperty->IsFloatingPoint()
+            ? NumericProperty->GetFloatingPointPropertyValue(ValuePtr)
+            : static_cast<double>(NumericProperty->GetSignedIntPropertyValue(ValuePtr));
+    }
+
+    FString ReadColumnText(const FQueryColumn& Column, FName RowName, const uint8* RowData)
+    {
+        return Column.Property
+            ? DataTableUtils::GetPropertyValueAsString(Column.Property, RowData, EDataTableExportFlags::None)
+            : RowName.ToString();
+    }
+
+    /** Arrays and sets contain a value when one element equals it; other columns when their text contains it */
+    bool ColumnContains(const FQueryColumn& Column, FName RowName, const uint8* RowData, const FString& Needle)
+    {
+        if (Column.Property)
+        {
+            const void* ValuePtr = Column.Property->ContainerPtrToValuePtr<void>(RowData);
+            if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Column.Property))
+            {
+                FScriptArrayHelper Elements(ArrayProperty, ValuePtr);
+                for (int32 Index = 0; Index < Elements.Num(); ++Index)
+                {
+                    if (DataTableUtils::GetPropertyValueAsStringDirect(ArrayProperty->Inner, Elements.GetRawPtr(Index), EDataTableExportFlags::None).Equals(Needle, ESearchCase::IgnoreCase))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            if (const FSetProperty* SetProperty = CastField<FSetProperty>(Column.Property))
+            {
+                FScriptSetHelper Elements(SetProperty, ValuePtr);
+                for (int32 Index = 0; Index < Elements.GetMaxIndex(); ++Index)
+                {
+                    if (Elements.IsValidIndex(Index)
+                        && DataTableUtils::GetPropertyValueAsStringDirect(SetProperty->ElementProp, Elements.GetElementPtr(Index), EDataTableExportFlags::None).Equals(Needle, ESearchCase::IgnoreCase))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+
+        return ReadColumnText(Column, RowName, RowData).Contains(Needle, ESearchCase::IgnoreCase);
+    }
+
+    bool MatchesFilter(const FQueryFilter& Filter, FName RowName, const uint8* RowData)
+    {
+        if (Filter.Op == EQueryOp::Contains)
+        {
+            return ColumnContains(Filter.Column, RowName, RowData, Filter.Text);
+        }
+
+        int32 Order = 0;
+        if (Filter.Column.bNumeric)
+        {
+            const double Value = ReadColumnNumber(Filter.Column.Property, RowData);
+            Order = Value < Filter.Number ? -1 : (Value > Filter.Number ? 1 : 0);
+        }
+        else
+        {
+            Order = ReadColumnText(Filter.Column, RowName, RowData).Compare(Filter.Text, ESearchCase::IgnoreCase);
+        }
+
+        switch (Filter.Op)
+        {
+        case EQueryOp::Equal:
+            return Order == 0;
+        case EQueryOp::NotEqual:
+            return Order != 0;
+        case EQueryOp::Less:
+            return Order < 0;
+        case EQueryOp::LessEqual:
+            return Order <= 0;
+        case EQueryOp::Greater:
+            return Order > 0;
+        case EQueryOp::GreaterEqual:
+            return Order >= 0;
+        default:
+            return false;
+        }
+    }
+
+    /** Range of index entries an equality or range filter selects, as [begin, end) */
+    TPair<int32, int32> GetIndexRange(const FMCPDataTableColumnIndex& Index, const FQueryFilter& Filter)
+    {
+        const int32 Lower = Index.bNumeric
+            ? Algo::LowerBoundBy(Index.Entries, Filter.Number, &FMCPDataTableColumnIndex::FEntry::Number)
+            : Algo::LowerBoundBy(Index.Entries, Filter.Text, &FMCPDataTableColumnIndex::FEntry::Text);
+        const int32 Upper = Index.bNumeric
+            ? Algo::UpperBoundBy(Index.Entries, Filter.Number, &FMCPDataTableColumnIndex::FEntry::Number)
+            : Algo::UpperBoundBy(Index.Entries, Filter.Text, &FMCPDataTableColumnIndex::FEntry::Text);
+
+        switch (Filter.Op)
+        {
+        case EQueryOp::Equal:
+            return TPair<int32, int32>(Lower, Upper);
+        case EQueryOp::Less:
+            return TPair<int32, int32>(0, Lower);
+        case EQueryOp::LessEqual:
+            return TPair<int32, int32>(0, Upper);
+        case EQueryOp::Greater:
+            return TPair<int32, int32>(Upper, Index.Entries.Num());
+        case EQueryOp::GreaterEqual:
+            return TPair<int32, int32>(Lower, Index.Entries.Num());
+        default:
+            return TPair<int32, int32>(0, Index.Entries.Num());
+        }
+    }
+}
+
+//
+// FMCPRowConversionPlan
+//
+FMCPRowConversionPlan::FMCPRowConversionPlan(const UScriptStruct* Struct)
+    : LayoutHash(ComputeLayoutHash(Struct))
+{
+    for (TFieldIterator<FProperty> It(Struct); It; ++It)
+    {
+        FProperty* Property = *It;
+
+        FMCPRowField& Field = Fields.AddDefaulted_GetRef();
+        Field.Property = Property;
+        Field.Offset = Property->GetOffset_ForInternal();
+
+        if (Property->ArrayDim == 1)
+        {
+            const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property);
+            if (Property->IsA<FBoolProperty>())
+            {
+                Field.Setter = EMCPRowFieldSetter::Bool;
+            }
+            else if (NumericProperty && !NumericProperty->IsEnum())
+            {
+                Field.Setter = NumericProperty->IsFloatingPoint() ? EMCPRowFieldSetter::FloatingPoint : EMCPRowFieldSetter::Integer;
+            }
+            else if (Property->IsA<FStrProperty>())
+            {
+                Field.Setter = EMCPRowFieldSetter::String;
+            }
+            else if (Property->IsA<FNameProperty>())
+            {
+                Field.Setter = EMCPRowFieldSetter::Name;
+            }
+        }
+
+        // User structs name properties with a GUID suffix; their exports use the authored name
+        const int32 FieldIndex = Fields.Num() - 1;
+        FieldIndices.Add(Property->GetName(), FieldIndex);
+        FieldIndices.FindOrAdd(DataTableUtils::GetPropertyExportName(Property), FieldIndex);
+        FieldIndices.FindOrAdd(Property->GetDisplayNameText().ToString(), FieldIndex);
+
+        bParallelSafe = bParallelSafe && IsParallelSafeProperty(Property);
+    }
+}
+
+uint32 FMCPRowConversionPlan::ComputeLayoutHash(const UScriptStruct* Struct)
+{
+    uint32 Hash = GetTypeHash(Struct->GetStructureSize());
+    for (TFieldIterator<FProperty> It(Struct); It; ++It)
+    {
+        Hash = HashCombine(Hash, HashCombine(PointerHash(*It), GetTypeHash(It->GetOffset_ForInternal())));
+    }
+    return Hash;
+}
+
+bool FMCPRowConversionPlan::IsParallelSafeProperty(const FProperty* Property)
+{
+    // Soft references are plain paths; other references are looked up or loaded while converting
+    if (Property->IsA<FSoftObjectProperty>())
+    {
+        return true;
+    }
+
+    if (Property->IsA<FObjectPropertyBase>() || Property->IsA<FInterfaceProperty>() || Property->IsA<FFieldPathProperty>()
+        || Property->IsA<FDelegateProperty>() || Property->IsA<FMulticastDelegateProperty>())
+    {
+        return false;
+    }
+
+    if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+    {
+        for (TFieldIterator<FProperty> It(StructProperty->Struct); It; ++It)
+        {
+            if (!IsParallelSafeProperty(*It))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+    {
+        return IsParallelSafeProperty(ArrayProperty->Inner);
+    }
+
+    if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+    {
+        return IsParallelSafeProperty(SetProperty->ElementProp);
+    }
+
+    if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+    {
+        return IsParallelSafeProperty(MapProperty->KeyProp) && IsParallelSafeProperty(MapProperty->ValueProp);
+    }
+
+    return true;
+}
+
+bool FMCPRowConversionPlan::Decode(const FJsonObject& RowJson, uint8* RowData, FString& OutErrorMessage) const
+{
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : RowJson.Values)
+    {
+        const int32* FieldIndex = FieldIndices.Find(Pair.Key);
+        if (!FieldIndex || !Pair.Value.IsValid())
+        {
+            continue;
+        }
+
+        const FMCPRowField& Field = Fields[*FieldIndex];
+        const FJsonValue& Value = *Pair.Value;
+        void* ValuePtr = RowData + Field.Offset;
+
+        bool bWritten = false;
+        switch (Field.Setter)
+        {
+        case EMCPRowFieldSetter::Bool:
+            if (Value.Type == EJson::Boolean)
+            {
+                static_cast<const FBoolProperty*>(Field.Property)->SetPropertyValue(ValuePtr, Value.AsBool());
+                bWritten = true;
+            }
+            break;
+        case EMCPRowFieldSetter::Integer:
+        {
+            int64 IntValue = 0;
+            if (Value.Type == EJson::Number && Value.TryGetNumber(IntValue))
+            {
+                static_cast<const FNumericProperty*>(Field.Property)->SetIntPropertyValue(ValuePtr, IntValue);
+                bWritten = true;
+            }
+            break;
+        }
+        case EMCPRowFieldSetter::FloatingPoint:
+        {
+            double DoubleValue = 0.0;
+            if (Value.Type == EJson::Number && Value.TryGetNumber(DoubleValue))
+            {
+                static_cast<const FNumericProperty*>(Field.Property)->SetFloatingPointPropertyValue(ValuePtr, DoubleValue);
+                bWritten = true;
+            }
+            break;
+        }
+        case EMCPRowFieldSetter::String:
+            if (Value.Type == EJson::String)
+            {
+                *static_cast<FString*>(ValuePtr) = Value.AsString();
+                bWritten = true;
+            }
+            break;
+        case EMCPRowFieldSetter::Name:
+            if (Value.Type == EJson::String)
+            {
+                *static_cast<FName*>(ValuePtr) = FName(*Value.AsString());
+                bWritten = true;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // Values the direct setters do not take (numbers as strings, enums, containers...) convert as before
+        if (!bWritten && !FJsonObjectConverter::JsonValueToUProperty(Pair.Value, Field.Property, ValuePtr, 0, 0))
+        {
+            OutErrorMessage = FString::Printf(TEXT("Field '%s' could not be converted to %s."), *Pair.Key, *Field.Property->GetCPPType());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// FMCPRowConversionPlanCache
+//
+FMCPRowConversionPlanCache& FMCPRowConversionPlanCache::Get()
+{
+    static FMCPRowConversionPlanCache Instance;
+    return Instance;
+}
+
+TSharedRef<const FMCPRowConversionPlan> FMCPRowConversionPlanCache::FindOrCompile(const UScriptStruct* Struct)
+{
+    check(IsInGameThread());
+
+    const FObjectKey Key(Struct);
+    if (const TSharedRef<const FMCPRowConversionPlan>* Existing = Plans.Find(Key))
+    {
+        if ((*Existing)->Matches(Struct))
+        {
+            return *Existing;
+        }
+    }
+    else if (Plans.Num() >= MaxCachedPlans)
+    {
+        MCP_LOG_VERBOSE("Row conversion plan cache reached %d entries, flushing", MaxCachedPlans);
+        Plans.Reset();
+    }
+
+    TSharedRef<const FMCPRowConversionPlan> Plan = MakeShared<const FMCPRowConversionPlan>(Struct);
+    Plans.Add(Key, Plan);
+    return Plan;
+}
+
+void FMCPRowConversionPlanCache::Reset()
+{
+    Plans.Reset();
+}
+
+//
+// FMCPDataTableIndexCache
+//
+FMCPDataTableIndexCache& FMCPDataTableIndexCache::Get()
+{
+    static FMCPDataTableIndexCache Instance;
+    return Instance;
+}
+
+uint32 FMCPDataTableIndexCache::ComputeRowMapHash(const UDataTable* DataTable)
+{
+    uint32 Hash = GetTypeHash(DataTable->GetRowMap().Num());
+    for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+    {
+        Hash = HashCombine(Hash, HashCombine(GetTypeHash(Row.Key), PointerHash(Row.Value)));
+    }
+    return Hash;
+}
+
+FMCPDataTableIndexCache::FTableIndexes& FMCPDataTableIndexCache::FindOrAddTable(UDataTable* DataTable)
+{
+    check(IsInGameThread());
+
+    const FObjectKey Key(DataTable);
+    const uint32 RowMapHash = ComputeRowMapHash(DataTable);
+
+    FTableIndexes* Indexes = Tables.Find(Key);
+    if (Indexes && Indexes->RowMapHash == RowMapHash)
+    {
+        return *Indexes;
+    }
+
+    if (!Indexes)
+    {
+        if (Tables.Num() >= MaxIndexedTables)
+        {
+            MCP_LOG_VERBOSE("Data table index cache reached %d tables, flushing", MaxIndexedTables);
+            Shutdown();
+        }
+
+        Indexes = &Tables.Add(Key);
+        Indexes->Table = DataTable;
+        Indexes->ChangedHandle = DataTable->OnDataTableChanged().AddRaw(this, &FMCPDataTableIndexCache::HandleTableChanged, Key);
+    }
+
+    TSharedRef<FMCPDataTableRows> Rows = MakeShared<FMCPDataTableRows>();
+    Rows->Names.Reserve(DataTable->GetRowMap().Num());
+    Rows->Data.Reserve(DataTable->GetRowMap().Num());
+    Rows->Ordinals.Reserve(DataTable->GetRowMap().Num());
+    for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+    {
+        Rows->Ordinals.Add(Row.Key, Rows->Names.Add(Row.Key));
+        Rows->Data.Add(Row.Value);
+    }
+
+    Indexes->RowMapHash = RowMapHash;
+    Indexes->Rows = Rows;
+    Indexes->Columns.Reset();
+    return *Indexes;
+}
+
+TSharedRef<const FMCPDataTableRows> FMCPDataTableIndexCache::GetRows(UDataTable* DataTable)
+{
+    return FindOrAddTable(DataTable).Rows.ToSharedRef();
+}
+
+TSharedRef<const FMCPDataTableColumnIndex> FMCPDataTableIndexCache::FindOrBuild(UDataTable* DataTable, const FProperty* Column)
+{
+    FTableIndexes& Indexes = FindOrAddTable(DataTable);
+    if (const TSharedRef<const FMCPDataTableColumnIndex>* Existing = Indexes.Columns.Find(Column))
+    {
+        return *Existing;
+    }
+
+    const FMCPDataTableRows& Rows = *Indexes.Rows;
+    FQueryColumn QueryColumn;
+    QueryColumn.Property = Column;
+
+    TSharedRef<FMCPDataTableColumnIndex> Index = MakeShared<FMCPDataTableColumnIndex>();
+    Index->bNumeric = IsNumericColumn(Column);
+    Index->Entries.SetNum(Rows.Names.Num());
+
+    for (int32 Ordinal = 0; Ordinal < Rows.Names.Num(); ++Ordinal)
+    {
+        FMCPDataTableColumnIndex::FEntry& Entry = Index->Entries[Ordinal];
+        Entry.RowOrdinal = Ordinal;
+        if (Index->bNumeric)
+        {
+            Entry.Number = ReadColumnNumber(Column, Rows.Data[Ordinal]);
+        }
+        else
+        {
+            Entry.Text = ReadColumnText(QueryColumn, Rows.Names[Ordinal], Rows.Data[Ordinal]);
+        }
+    }
+
+    if (Index->bNumeric)
+    {
+        Algo::Sort(Index->Entries, [](const FMCPDataTableColumnIndex::FEntry& A, const FMCPDataTableColumnIndex::FEntry& B)
+        {
+            return A.Number != B.Number ? A.Number < B.Number : A.RowOrdinal < B.RowOrdinal;
+        });
+    }
+    else
+    {
+        Algo::Sort(Index->Entries, [](const FMCPDataTableColumnIndex::FEntry& A, const FMCPDataTableColumnIndex::FEntry& B)
+        {
+            const int32 Order = A.Text.Compare(B.Text, ESearchCase::IgnoreCase);
+            return Order != 0 ? Order < 0 : A.RowOrdinal < B.RowOrdinal;
+        });
+    }
+
+    MCP_LOG_VERBOSE("Built index on '%s' of data table '%s' (%d rows)", *Column->GetName(), *DataTable->GetName(), Rows.Names.Num());
+
+    Indexes.Columns.Add(Column, Index);
+    return Index;
+}
+
+void FMCPDataTableIndexCache::Invalidate(const UDataTable* DataTable)
+{
+    HandleTableChanged(FObjectKey(DataTable));
+}
+
+void FMCPDataTableIndexCache::HandleTableChanged(FObjectKey TableKey)
+{
+    FTableIndexes Indexes;
+    if (!Tables.RemoveAndCopyValue(TableKey, Indexes))
+    {
+        return;
+    }
+
+    if (UDataTable* DataTable = Indexes.Table.Get())
+    {
+        DataTable->OnDataTableChanged().Remove(Indexes.ChangedHandle);
+    }
+}
+
+void FMCPDataTableIndexCache::Shutdown()
+{
+    for (TPair<FObjectKey, FTableIndexes>& Entry : Tables)
+    {
+        if (UDataTable* DataTable = Entry.Value.Table.Get())
+        {
+            DataTable->OnDataTableChanged().Remove(Entry.Value.ChangedHandle);
+        }
+    }
+    Tables.Reset();
+}
+
+//
+// FMCPDataTableUtils
+//
+bool FMCPDataTableUtils::NormaliseAssetPaths(
+    const FString& InPackagePath,
+    const FString& AssetName,
+    FString& OutPackageName,
+    FString& OutObjectPath,
+    FString& OutErrorMessage)
+{
+    FString TrimmedName = AssetName;
+    TrimmedName.TrimStartAndEndInline();
+
+    if (TrimmedName.IsEmpty())
+    {
+        OutErrorMessage = TEXT("Data table name cannot be empty.");
+        return false;
+    }
+
+    FString PackagePath = EnsureGameRoot(InPackagePath);
+    PackagePath.TrimEndInline();
+
+    while (PackagePath.EndsWith(TEXT("/")))
+    {
+        PackagePath.RemoveFromEnd(TEXT("/"));
+    }
+
+    const FString PackageName = FString::Printf(TEXT("%s/%s"), *PackagePath, *TrimmedName);
+
+    if (!FPackageName::IsValidLongPackageName(PackageName))
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid package name '%s'."), *PackageName);
+        return false;
+    }
+
+    OutPackageName = PackageName;
+    OutObjectPath = FString::Printf(TEXT("%s.%s"), *PackageName, *TrimmedName);
+    return true;
+}
+
+bool FMCPDataTableUtils::ConvertJsonToStruct(
+    const TSharedPtr<FJsonObject>& JsonObject,
+    UScriptStruct* StructType,
+    uint8* StructData,
+    FString& OutErrorMessage)
+{
+    if (!JsonObject.IsValid())
+    {
+        OutErrorMessage = TEXT("Row data must be a JSON object.");
+        return false;
+    }
+
+    if (!StructType)
+    {
+        OutErrorMessage = TEXT("Row struct type is invalid.");
+        return false;
+    }
+
+    if (!StructData)
+    {
+        OutErrorMessage = TEXT("Internal error: Struct data pointer is null.");
+        return false;
+    }
+
+    FString FieldError;
+    if (!FMCPRowConversionPlanCache::Get().FindOrCompile(StructType)->Decode(*JsonObject, StructData, FieldError))
+    {
+        OutErrorMessage = FString::Printf(TEXT("Failed to convert JSON to struct '%s': %s"), *StructType->GetName(), *FieldError);
+        return false;
+    }
+
+    return true;
+}
+
+bool FMCPDataTableUtils::ApplyRowsToDataTable(
+    UDataTable* DataTable,
+    const TSharedPtr<FJsonObject>& RowsObject,
+    int32& OutRowsApplied,
+    FString& OutErrorMessage)
+{
+    OutRowsApplied = 0;
+
+    if (!DataTable)
+    {
+        OutErrorMessage = TEXT("Data table is null.");
+        return false;
+    }
+
+    if (!RowsObject.IsValid())
+    {
+        // Nothing to apply; treat as success.
+        return true;
+    }
+
+    if (!DataTable->RowStruct)
+    {
+        OutErrorMessage = TEXT("Data table has no row struct assigned.");
+        return false;
+    }
+
+    const TSharedRef<const FMCPRowConversionPlan> Plan = FMCPRowConversionPlanCache::Get().FindOrCompile(DataTable->RowStruct);
+
+    TArray<FPendingRow> Pending;
+    Pending.Reserve(FMath::Min(RowsObject->Values.Num(), MCPConstants::DATA_TABLE_DECODE_BATCH_ROWS));
+
+    // Rows before a failing row are added, as when rows were applied one at a time
+    auto FlushPending = [&]() -> bool
+    {
+        TArray<FString> Errors;
+        OutRowsApplied += DecodeAndAddRows(DataTable, *Plan, Pending, nullptr, true, Errors);
+
+        for (int32 Index = 0; Index < Pending.Num(); ++Index)
+        {
+            if (!Errors[Index].IsEmpty())
+            {
+                OutErrorMessage = FString::Printf(TEXT("Row '%s': %s"), *Pending[Index].Name, *Errors[Index]);
+                return false;
+            }
+        }
+
+        Pending.Reset();
+        return true;
+    };
+
+    for (const auto& RowPair : RowsObject->Values)
+    {
+        const FString RowNameString = RowPair.Key;
+        TSharedPtr<FJsonValue> RowValue = RowPair.Value;
+        TSharedPtr<FJsonObject> RowJson = RowValue.IsValid() ? RowValue->AsObject() : nullptr;
+        if (!RowJson.IsValid())
+        {
+            if (FlushPending())
+            {
+                OutErrorMessage = RowValue.IsValid()
+                    ? FString::Printf(TEXT("Row '%s' must be a JSON object."), *RowNameString)
+                    : FString::Printf(TEXT("Row '%s' has invalid data."), *RowNameString);
+            }
+            return false;
+        }
+
+        FPendingRow& Row = Pending.AddDefaulted_GetRef();
+        Row.Name = RowNameString;
+        Row.Json = RowJson;
+
+        if (Pending.Num() >= MCPConstants::DATA_TABLE_DECODE_BATCH_ROWS && !FlushPending())
+        {
+            return false;
+        }
+    }
+
+    return FlushPending();
 }
 
-bool FMCPDataTableUtils::NormaliseAssetPaths(
-    const FString& InPackagePath,
-    const FString& AssetName,
-    FString& OutPackageName,
-    FString& OutObjectPath,
-    FString& OutErrorMessage)
+UDataTable* FMCPDataTableUtils::LoadDataTable(const FString& InPath, FString& OutErrorMessage)
 {
-    FString TrimmedName = AssetName;
-    TrimmedName.TrimStartAndEndInline();
+    FString NormalisedPath = InPath;
+    NormalisedPath.TrimStartAndEndInline();
 
-    if (TrimmedName.IsEmpty())
+    FString PackagePathPart;
+    FString ObjectNamePart;
+
+    if (NormalisedPath.Split(TEXT("."), &PackagePathPart, &ObjectNamePart, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
     {
-        OutErrorMessage = TEXT("Data table name cannot be empty.");
-        return false;
+        PackagePathPart = EnsureGameRoot(PackagePathPart);
+        if (ObjectNamePart.IsEmpty())
+        {
+            ObjectNamePart = FPackageName::GetLongPackageAssetName(PackagePathPart);
+        }
     }
-
-    FString PackagePath = EnsureGameRoot(InPackagePath);
-    PackagePath.TrimEndInline();
-
-    while (PackagePath.EndsWith(TEXT("/")))
+    else
     {
-        PackagePath.RemoveFromEnd(TEXT("/"));
+        PackagePathPart = EnsureGameRoot(NormalisedPath);
+        ObjectNamePart = FPackageName::GetLongPackageAssetName(PackagePathPart);
     }
 
-    const FString PackageName = FString::Printf(TEXT("%s/%s"), *PackagePath, *TrimmedName);
+    NormalisedPath = FString::Printf(TEXT("%s.%s"), *PackagePathPart, *ObjectNamePart);
 
-    if (!FPackageName::IsValidLongPackageName(PackageName))
+    UDataTable* DataTable = LoadObject<UDataTable>(nullptr, *NormalisedPath);
+    if (!DataTable)
     {
-        OutErrorMessage = FString::Printf(TEXT("Invalid package name '%s'."), *PackageName);
-        return false;
+        OutErrorMessage = FString::Printf(TEXT("Failed to load data table '%s'."), *NormalisedPath);
     }
-
-    OutPackageName = PackageName;
-    OutObjectPath = FString::Printf(TEXT("%s.%s"), *PackageName, *TrimmedName);
-    return true;
+    return DataTable;
 }
 
-bool FMCPDataTableUtils::ConvertJsonToStruct(
-    const TSharedPtr<FJsonObject>& JsonObject,
-    UScriptStruct* StructType,
-    uint8* StructData,
+bool FMCPDataTableUtils::ResolveRowsFile(
+    const FString& InFilePath,
+    FString& InOutFormat,
+    FString& OutFullPath,
     FString& OutErrorMessage)
 {
-    if (!JsonObject.IsValid())
+    const FString FilePath = InFilePath.TrimStartAndEnd();
+    if (FilePath.IsEmpty())
     {
-        OutErrorMessage = TEXT("Row data must be a JSON object.");
+        OutErrorMessage = TEXT("Rows file path cannot be empty.");
         return false;
     }
 
-    if (!StructType)
+    OutFullPath = FPaths::IsRelative(FilePath)
+        ? FPaths::ConvertRelativePathToFull(MCPConstants::ProjectRootPath, FilePath)
+        : FilePath;
+
+    if (!IFileManager::Get().FileExists(*OutFullPath))
     {
-        OutErrorMessage = TEXT("Row struct type is invalid.");
+        OutErrorMessage = FString::Printf(TEXT("Rows file '%s' does not exist."), *OutFullPath);
         return false;
     }
 
-    if (!StructData)
+    FString Format = InOutFormat.TrimStartAndEnd().ToLower();
+    if (Format.IsEmpty())
     {
-        OutErrorMessage = TEXT("Internal error: Struct data pointer is null.");
-        return false;
+        Format = FPaths::GetExtension(OutFullPath).ToLower();
     }
 
-    if (!FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), StructType, StructData, 0, 0))
+    if (Format != TEXT("csv") && Format != TEXT("json"))
     {
-        OutErrorMessage = FString::Printf(TEXT("Failed to convert JSON to struct '%s'."), *StructType->GetName());
+        OutErrorMessage = FString::Printf(TEXT("Unsupported rows file format '%s'; use 'csv' or 'json'."), *Format);
         return false;
     }
 
+    InOutFormat = Format;
     return true;
 }
 
-bool FMCPDataTableUtils::ApplyRowsToDataTable(
+bool FMCPDataTableUtils::ImportRowsFromFile(
     UDataTable* DataTable,
-    const TSharedPtr<FJsonObject>& RowsObject,
-    int32& OutRowsApplied,
+    const FString& FullPath,
+    const FString& Format,
+    const FString& NameColumn,
+    FMCPDataTableImportStats& OutStats,
     FString& OutErrorMessage)
 {
-    OutRowsApplied = 0;
+    OutStats = FMCPDataTableImportStats();
 
     if (!DataTable)
     {
@@ -123,49 +1547,64 @@ bool FMCPDataTableUtils::ApplyRowsToDataTable(
         return false;
     }
 
-    if (!RowsObject.IsValid())
+    if (!DataTable->RowStruct)
     {
-        // Nothing to apply; treat as success.
-        return true;
+        OutErrorMessage = TEXT("Data table has no row struct assigned.");
+        return false;
     }
 
-    if (!DataTable->RowStruct)
+    TUniquePtr<FArchive> File(IFileManager::Get().CreateFileReader(*FullPath));
+    if (!File)
     {
-        OutErrorMessage = TEXT("Data table has no row struct assigned.");
+        OutErrorMessage = FString::Printf(TEXT("Failed to open rows file '%s'."), *FullPath);
         return false;
     }
 
-    for (const auto& RowPair : RowsObject->Values)
+    const TSharedRef<const FMCPRowConversionPlan> Plan = FMCPRowConversionPlanCache::Get().FindOrCompile(DataTable->RowStruct);
+
+    FMCPTextFileStream Stream(MoveTemp(File));
+    const bool bImported = Format == TEXT("csv")
+        ? ImportCsvRows(Stream, DataTable, *Plan, NameColumn, OutStats, OutErrorMessage)
+        : ImportJsonRows(Stream, DataTable, *Plan, NameColumn, OutStats, OutErrorMessage);
+
+    // A read failure ends the stream early and would otherwise pass for the end of the file
+    if (!Stream.GetStreamError().IsEmpty())
     {
-        const FString RowNameString = RowPair.Key;
-        TSharedPtr<FJsonValue> RowValue = RowPair.Value;
-        if (!RowValue.IsValid())
-        {
-            OutErrorMessage = FString::Printf(TEXT("Row '%s' has invalid data."), *RowNameString);
-            return false;
-        }
+        OutErrorMessage = Stream.GetStreamError();
+        return false;
+    }
 
-        TSharedPtr<FJsonObject> RowJson = RowValue->AsObject();
-        if (!RowJson.IsValid())
+    return bImported;
+}
+
+void FMCPDataTableUtils::WriteImportStats(const FMCPDataTableImportStats& Stats, const TSharedPtr<FJsonObject>& Result)
+{
+    Result->SetNumberField(TEXT("rows_failed"), Stats.RowsFailed);
+
+    if (Stats.Errors.Num() > 0)
+    {
+        TArray<TSharedPtr<FJsonValue>> ErrorValues;
+        ErrorValues.Reserve(Stats.Errors.Num());
+        for (const FMCPDataTableRowError& Error : Stats.Errors)
         {
-            OutErrorMessage = FString::Printf(TEXT("Row '%s' must be a JSON object."), *RowNameString);
-            return false;
+            TSharedPtr<FJsonObject> ErrorObject = MakeShared<FJsonObject>();
+            ErrorObject->SetStringField(TEXT("row"), Error.RowName);
+            ErrorObject->SetNumberField(TEXT("line"), Error.Line);
+            ErrorObject->SetStringField(TEXT("error"), Error.Message);
+            ErrorValues.Add(MakeShared<FJsonValueObject>(ErrorObject));
         }
+        Result->SetArrayField(TEXT("row_errors"), ErrorValues);
+    }
 
-        FStructOnScope RowStruct(DataTable->RowStruct);
-        FString ConversionError;
-        if (!ConvertJsonToStruct(RowJson, DataTable->RowStruct, RowStruct.GetStructMemory(), ConversionError))
+    if (Stats.IgnoredColumns.Num() > 0)
+    {
+        TArray<TSharedPtr<FJsonValue>> ColumnValues;
+        for (const FString& Column : Stats.IgnoredColumns)
         {
-            OutErrorMessage = ConversionError;
-            return false;
+            ColumnValues.Add(MakeShared<FJsonValueString>(Column));
         }
-
-        const FName RowName(*RowNameString);
-        DataTable->AddRow(RowName, RowStruct.GetStructMemory());
-        ++OutRowsApplied;
+        Result->SetArrayField(TEXT("ignored_columns"), ColumnValues);
     }
-
-    return true;
 }
 
 bool FMCPDataTableUtils::RemoveRowsFromDataTable(
@@ -206,6 +1645,14 @@ bool FMCPDataTableUtils::RemoveRowsFromDataTable(
     return true;
 }
 
+FString FMCPDataTableUtils::NotifyPartialRowsChange(UDataTable* DataTable, int32 RowsApplied, const FString& ErrorMessage)
+{
+    DataTable->MarkPackageDirty();
+    DataTable->PostEditChange();
+
+    return FString::Printf(TEXT("%s (rows_applied: %d; the table keeps those changes but was not saved)"), *ErrorMessage, RowsApplied);
+}
+
 bool FMCPDataTableUtils::SaveAssetPackage(
     UPackage* Package,
     UObject* Asset,
@@ -263,6 +1710,25 @@ TSharedPtr<FJsonObject> FMCPCreateDataTableHandler::Execute(const TSharedPtr<FJs
     bool bOverwriteExisting = false;
     Params->TryGetBoolField(FStringView(TEXT("overwrite")), bOverwriteExisting);
 
+    FString RowsFile;
+    FString RowsFormat;
+    FString RowsFilePath;
+    FString NameColumn;
+    const bool bImportRowsFile = Params->TryGetStringField(FStringView(TEXT("rows_file")), RowsFile);
+    if (bImportRowsFile)
+    {
+        Params->TryGetStringField(FStringView(TEXT("rows_format")), RowsFormat);
+        Params->TryGetStringField(FStringView(TEXT("name_column")), NameColumn);
+
+        // Checked before the table is created or emptied
+        FString FileError;
+        if (!FMCPDataTableUtils::ResolveRowsFile(RowsFile, RowsFormat, RowsFilePath, FileError))
+        {
+            MCP_LOG_WARNING(TEXT("%s"), *FileError);
+            return CreateErrorResponse(FileError);
+        }
+    }
+
     FString PackageName;
     FString ObjectPath;
     FString PathError;
@@ -328,8 +1794,22 @@ TSharedPtr<FJsonObject> FMCPCreateDataTableHandler::Execute(const TSharedPtr<FJs
     FString RowsError;
     if (RowsObject && !FMCPDataTableUtils::ApplyRowsToDataTable(DataTable, *RowsObject, RowsApplied, RowsError))
     {
-        MCP_LOG_ERROR(TEXT("%s"), *RowsError);
-        return CreateErrorResponse(RowsError);
+        const FString Message = FMCPDataTableUtils::NotifyPartialRowsChange(DataTable, RowsApplied, RowsError);
+        MCP_LOG_ERROR(TEXT("%s"), *Message);
+        return CreateErrorResponse(Message);
+    }
+
+    FMCPDataTableImportStats ImportStats;
+    if (bImportRowsFile)
+    {
+        if (!FMCPDataTableUtils::ImportRowsFromFile(DataTable, RowsFilePath, RowsFormat, NameColumn, ImportStats, RowsError))
+        {
+            const FString Message = FMCPDataTableUtils::NotifyPartialRowsChange(DataTable, RowsApplied + ImportStats.RowsApplied, RowsError);
+            MCP_LOG_ERROR(TEXT("%s"), *Message);
+            return CreateErrorResponse(Message);
+        }
+
+        RowsApplied += ImportStats.RowsApplied;
     }
 
     DataTable->MarkPackageDirty();
@@ -355,8 +1835,12 @@ TSharedPtr<FJsonObject> FMCPCreateDataTableHandler::Execute(const TSharedPtr<FJs
     Result->SetNumberField(TEXT("row_count"), DataTable->GetRowMap().Num());
     Result->SetBoolField(TEXT("overwrote_existing"), !bCreatedNewAsset);
     Result->SetNumberField(TEXT("rows_applied"), RowsApplied);
+    if (bImportRowsFile)
+    {
+        FMCPDataTableUtils::WriteImportStats(ImportStats, Result);
+    }
 
-    MCP_LOG_INFO(TEXT("Created data table '%s' with %d rows."), *DataTable->GetPathName(), RowsApplied);
+    MCP_LOG_INFO(TEXT("Created data table '%s' with %d rows (%d failed)."), *DataTable->GetPathName(), RowsApplied, ImportStats.RowsFailed);
     return CreateSuccessResponse(Result);
 }
 
@@ -371,34 +1855,12 @@ TSharedPtr<FJsonObject> FMCPModifyDataTableHandler::Execute(const TSharedPtr<FJs
         return CreateErrorResponse(TEXT("Missing 'path' field"));
     }
 
-    FString NormalisedPath = DataTablePath;
-    NormalisedPath.TrimStartAndEndInline();
-
-    FString PackagePathPart;
-    FString ObjectNamePart;
-
-    if (NormalisedPath.Split(TEXT("."), &PackagePathPart, &ObjectNamePart, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
-    {
-        PackagePathPart = EnsureGameRoot(PackagePathPart);
-        if (ObjectNamePart.IsEmpty())
-        {
-            ObjectNamePart = FPackageName::GetLongPackageAssetName(PackagePathPart);
-        }
-    }
-    else
-    {
-        PackagePathPart = EnsureGameRoot(NormalisedPath);
-        ObjectNamePart = FPackageName::GetLongPackageAssetName(PackagePathPart);
-    }
-
-    NormalisedPath = FString::Printf(TEXT("%s.%s"), *PackagePathPart, *ObjectNamePart);
-
-    UDataTable* DataTable = LoadObject<UDataTable>(nullptr, *NormalisedPath);
+    FString LoadError;
+    UDataTable* DataTable = FMCPDataTableUtils::LoadDataTable(DataTablePath, LoadError);
     if (!DataTable)
     {
-        FString Message = FString::Printf(TEXT("Failed to load data table '%s'."), *NormalisedPath);
-        MCP_LOG_ERROR(TEXT("%s"), *Message);
-        return CreateErrorResponse(Message);
+        MCP_LOG_ERROR(TEXT("%s"), *LoadError);
+        return CreateErrorResponse(LoadError);
     }
 
     bool bClearExisting = false;
@@ -410,6 +1872,24 @@ TSharedPtr<FJsonObject> FMCPModifyDataTableHandler::Execute(const TSharedPtr<FJs
     const TArray<TSharedPtr<FJsonValue>>* RemoveRowsArray = nullptr;
     Params->TryGetArrayField(FStringView(TEXT("remove_rows")), RemoveRowsArray);
 
+    FString RowsFile;
+    FString RowsFormat;
+    FString RowsFilePath;
+    FString NameColumn;
+    const bool bImportRowsFile = Params->TryGetStringField(FStringView(TEXT("rows_file")), RowsFile);
+    if (bImportRowsFile)
+    {
+        Params->TryGetStringField(FStringView(TEXT("rows_format")), RowsFormat);
+        Params->TryGetStringField(FStringView(TEXT("name_column")), NameColumn);
+
+        FString FileError;
+        if (!FMCPDataTableUtils::ResolveRowsFile(RowsFile, RowsFormat, RowsFilePath, FileError))
+        {
+            MCP_LOG_WARNING(TEXT("%s"), *FileError);
+            return CreateErrorResponse(FileError);
+        }
+    }
+
     DataTable->Modify();
 
     if (bClearExisting)
@@ -421,15 +1901,30 @@ TSharedPtr<FJsonObject> FMCPModifyDataTableHandler::Execute(const TSharedPtr<FJs
     FString OperationError;
     if (RowsObject && !FMCPDataTableUtils::ApplyRowsToDataTable(DataTable, *RowsObject, RowsApplied, OperationError))
     {
-        MCP_LOG_ERROR(TEXT("%s"), *OperationError);
-        return CreateErrorResponse(OperationError);
+        const FString Message = FMCPDataTableUtils::NotifyPartialRowsChange(DataTable, RowsApplied, OperationError);
+        MCP_LOG_ERROR(TEXT("%s"), *Message);
+        return CreateErrorResponse(Message);
+    }
+
+    FMCPDataTableImportStats ImportStats;
+    if (bImportRowsFile)
+    {
+        if (!FMCPDataTableUtils::ImportRowsFromFile(DataTable, RowsFilePath, RowsFormat, NameColumn, ImportStats, OperationError))
+        {
+            const FString Message = FMCPDataTableUtils::NotifyPartialRowsChange(DataTable, RowsApplied + ImportStats.RowsApplied, OperationError);
+            MCP_LOG_ERROR(TEXT("%s"), *Message);
+            return CreateErrorResponse(Message);
+        }
+
+        RowsApplied += ImportStats.RowsApplied;
     }
 
     int32 RowsRemoved = 0;
     if (RemoveRowsArray && !FMCPDataTableUtils::RemoveRowsFromDataTable(DataTable, *RemoveRowsArray, RowsRemoved, OperationError))
     {
-        MCP_LOG_ERROR(TEXT("%s"), *OperationError);
-        return CreateErrorResponse(OperationError);
+        const FString Message = FMCPDataTableUtils::NotifyPartialRowsChange(DataTable, RowsApplied, OperationError);
+        MCP_LOG_ERROR(TEXT("%s"), *Message);
+        return CreateErrorResponse(Message);
     }
 
     DataTable->MarkPackageDirty();
@@ -449,8 +1944,322 @@ TSharedPtr<FJsonObject> FMCPModifyDataTableHandler::Execute(const TSharedPtr<FJs
     Result->SetNumberField(TEXT("rows_applied"), RowsApplied);
     Result->SetNumberField(TEXT("rows_removed"), RowsRemoved);
     Result->SetBoolField(TEXT("cleared_existing"), bClearExisting);
+    if (bImportRowsFile)
+    {
+        FMCPDataTableUtils::WriteImportStats(ImportStats, Result);
+    }
 
     MCP_LOG_INFO(TEXT("Modified data table '%s' (applied: %d, removed: %d)."), *DataTable->GetPathName(), RowsApplied, RowsRemoved);
     return CreateSuccessResponse(Result);
 }
 
+
+TSharedPtr<FJsonObject> FMCPQueryDataTableHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling query_data_table command");
+
+    FString DataTablePath;
+    if (!Params->TryGetStringField(FStringView(TEXT("path")), DataTablePath))
+    {
+        MCP_LOG_WARNING("Missing 'path' field in query_data_table command");
+        return CreateErrorResponse(TEXT("Missing 'path' field"));
+    }
+
+    FString LoadError;
+    UDataTable* DataTable = FMCPDataTableUtils::LoadDataTable(DataTablePath, LoadError);
+    if (!DataTable)
+    {
+        MCP_LOG_ERROR(TEXT("%s"), *LoadError);
+        return CreateErrorResponse(LoadError);
+    }
+
+    if (!DataTable->RowStruct)
+    {
+        return CreateErrorResponse(TEXT("Data table has no row struct assigned."));
+    }
+
+    FString QueryError;
+
+    // Projection; every property when no columns are listed. The row name is always returned.
+    TArray<FQueryColumn> Columns;
+    const TArray<TSharedPtr<FJsonValue>>* ColumnValues = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("columns")), ColumnValues))
+    {
+        for (const TSharedPtr<FJsonValue>& ColumnValue : *ColumnValues)
+        {
+            FString ColumnName;
+            FQueryColumn Column;
+            if (!ColumnValue.IsValid() || !ColumnValue->TryGetString(ColumnName))
+            {
+                return CreateErrorResponse(TEXT("Columns must be strings."));
+            }
+
+            if (!ResolveQueryColumn(DataTable, ColumnName, Column, QueryError))
+            {
+                return CreateErrorResponse(QueryError);
+            }
+
+            if (Column.Property)
+            {
+                Columns.Add(MoveTemp(Column));
+            }
+        }
+    }
+    else
+    {
+        for (TFieldIterator<FProperty> It(DataTable->RowStruct); It; ++It)
+        {
+            FQueryColumn& Column = Columns.AddDefaulted_GetRef();
+            Column.Key = DataTableUtils::GetPropertyExportName(*It);
+            Column.Property = *It;
+        }
+    }
+
+    TArray<FQueryFilter> Filters;
+    const TArray<TSharedPtr<FJsonValue>>* FilterValues = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("filters")), FilterValues))
+    {
+        for (const TSharedPtr<FJsonValue>& FilterValue : *FilterValues)
+        {
+            const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+            if (!FilterValue.IsValid() || !FilterValue->TryGetObject(FilterObject))
+            {
+                return CreateErrorResponse(TEXT("Filters must be objects with 'column', 'op' and 'value'."));
+            }
+
+            FString ColumnName;
+            if (!(*FilterObject)->TryGetStringField(FStringView(TEXT("column")), ColumnName))
+            {
+                return CreateErrorResponse(TEXT("Filter is missing 'column'."));
+            }
+
+            FQueryFilter& Filter = Filters.AddDefaulted_GetRef();
+            if (!ResolveQueryColumn(DataTable, ColumnName, Filter.Column, QueryError))
+            {
+                return CreateErrorResponse(QueryError);
+            }
+
+            FString OpName = TEXT("eq");
+            (*FilterObject)->TryGetStringField(FStringView(TEXT("op")), OpName);
+            if (!ParseQueryOp(OpName, Filter.Op))
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Unknown filter op '%s'; use eq, ne, lt, lte, gt, gte or contains."), *OpName));
+            }
+
+            const TSharedPtr<FJsonValue> Value = (*FilterObject)->TryGetField(TEXT("value"));
+            if (!Value.IsValid())
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Filter on '%s' is missing 'value'."), *ColumnName));
+            }
+
+            if (Filter.Column.bNumeric && Filter.Op != EQueryOp::Contains)
+            {
+                if (Value->Type == EJson::Boolean)
+                {
+                    Filter.Number = Value->AsBool() ? 1.0 : 0.0;
+                }
+                else if (!Value->TryGetNumber(Filter.Number))
+                {
+                    return CreateErrorResponse(FString::Printf(TEXT("Filter on '%s' needs a number."), *ColumnName));
+                }
+            }
+            else if (!Value->TryGetString(Filter.Text))
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Filter on '%s' needs a string or number."), *ColumnName));
+            }
+        }
+    }
+
+    FQueryColumn OrderColumn;
+    FString OrderBy;
+    const bool bOrdered = Params->TryGetStringField(FStringView(TEXT("order_by")), OrderBy) && !OrderBy.IsEmpty();
+    if (bOrdered && !ResolveQueryColumn(DataTable, OrderBy, OrderColumn, QueryError))
+    {
+        return CreateErrorResponse(QueryError);
+    }
+
+    bool bDescending = false;
+    Params->TryGetBoolField(FStringView(TEXT("descending")), bDescending);
+
+    int32 Offset = 0;
+    Params->TryGetNumberField(FStringView(TEXT("offset")), Offset);
+    Offset = FMath::Max(0, Offset);
+
+    int32 Limit = MCPConstants::DEFAULT_DATA_TABLE_QUERY_ROWS;
+    Params->TryGetNumberField(FStringView(TEXT("limit")), Limit);
+    Limit = FMath::Clamp(Limit, 0, MCPConstants::MAX_DATA_TABLE_QUERY_ROWS);
+
+    bool bUseIndexes = true;
+    Params->TryGetBoolField(FStringView(TEXT("use_indexes")), bUseIndexes);
+
+    FMCPDataTableIndexCache& IndexCache = FMCPDataTableIndexCache::Get();
+    const TSharedRef<const FMCPDataTableRows> Rows = IndexCache.GetRows(DataTable);
+
+    // Narrow the candidates with the most selective filter that can be answered without a scan
+    TArray<int32> Candidates;
+    FString IndexUsed;
+    bool bNarrowed = false;
+
+    for (const FQueryFilter& Filter : Filters)
+    {
+        if (!Filter.Column.Property && Filter.Op == EQueryOp::Equal)
+        {
+            const FName RowName(*Filter.Text, FNAME_Find);
+            const int32* Ordinal = RowName.IsNone() ? nullptr : Rows->Ordinals.Find(RowName);
+            Candidates.Reset();
+            if (Ordinal)
+            {
+                Candidates.Add(*Ordinal);
+            }
+            IndexUsed = RowNameColumn;
+            bNarrowed = true;
+            break;
+        }
+    }
+
+    if (!bNarrowed && bUseIndexes && Rows->Names.Num() >= MCPConstants::DATA_TABLE_INDEX_MIN_ROWS)
+    {
+        TSharedPtr<const FMCPDataTableColumnIndex> BestIndex;
+        TPair<int32, int32> BestRange(0, 0);
+
+        for (const FQueryFilter& Filter : Filters)
+        {
+            if (!Filter.Column.Property || Filter.Op == EQueryOp::NotEqual || Filter.Op == EQueryOp::Contains)
+            {
+                continue;
+            }
+
+            const TSharedRef<const FMCPDataTableColumnIndex> Index = IndexCache.FindOrBuild(DataTable, Filter.Column.Property);
+            const TPair<int32, int32> Range = GetIndexRange(*Index, Filter);
+            if (!BestIndex.IsValid() || Range.Value - Range.Key < BestRange.Value - BestRange.Key)
+            {
+                BestIndex = Index;
+                BestRange = Range;
+                IndexUsed = Filter.Column.Key;
+            }
+        }
+
+        if (BestIndex.IsValid())
+        {
+            Candidates.Reserve(BestRange.Value - BestRange.Key);
+            for (int32 EntryIndex = BestRange.Key; EntryIndex < BestRange.Value; ++EntryIndex)
+            {
+                Candidates.Add(BestIndex->Entries[EntryIndex].RowOrdinal);
+            }
+
+            // Back to table order
+            Algo::Sort(Candidates);
+            bNarrowed = true;
+        }
+    }
+
+    if (!bNarrowed)
+    {
+        Candidates.Reserve(Rows->Names.Num());
+        for (int32 Ordinal = 0; Ordinal < Rows->Names.Num(); ++Ordinal)
+        {
+            Candidates.Add(Ordinal);
+        }
+    }
+
+    TArray<int32> Matches;
+    for (int32 Ordinal : Candidates)
+    {
+        const bool bMatches = Algo::AllOf(Filters, [&Rows, Ordinal](const FQueryFilter& Filter)
+        {
+            return MatchesFilter(Filter, Rows->Names[Ordinal], Rows->Data[Ordinal]);
+        });
+
+        if (bMatches)
+        {
+            Matches.Add(Ordinal);
+        }
+    }
+
+    if (bOrdered)
+    {
+        struct FSortKey
+        {
+            double Number = 0.0;
+            FString Text;
+            int32 Ordinal = 0;
+        };
+
+        TArray<FSortKey> SortKeys;
+        SortKeys.SetNum(Matches.Num());
+        for (int32 Index = 0; Index < Matches.Num(); ++Index)
+        {
+            const int32 Ordinal = Matches[Index];
+            SortKeys[Index].Ordinal = Ordinal;
+            if (OrderColumn.bNumeric)
+            {
+                SortKeys[Index].Number = ReadColumnNumber(OrderColumn.Property, Rows->Data[Ordinal]);
+            }
+            else
+            {
+                SortKeys[Index].Text = ReadColumnText(OrderColumn, Rows->Names[Ordinal], Rows->Data[Ordinal]);
+            }
+        }
+
+        const bool bNumeric = OrderColumn.bNumeric;
+        Algo::Sort(SortKeys, [bNumeric, bDescending](const FSortKey& A, const FSortKey& B)
+        {
+            int32 Order = 0;
+            if (bNumeric)
+            {
+                Order = A.Number < B.Number ? -1 : (A.Number > B.Number ? 1 : 0);
+            }
+            else
+            {
+                Order = A.Text.Compare(B.Text, ESearchCase::IgnoreCase);
+            }
+
+            if (Order == 0)
+            {
+                return A.Ordinal < B.Ordinal;
+            }
+            return bDescending ? Order > 0 : Order < 0;
+        });
+
+        for (int32 Index = 0; Index < SortKeys.Num(); ++Index)
+        {
+            Matches[Index] = SortKeys[Index].Ordinal;
+        }
+    }
+
+    const int32 Start = FMath::Min(Offset, Matches.Num());
+    const int32 End = FMath::Min(Start + Limit, Matches.Num());
+
+    TArray<TSharedPtr<FJsonValue>> RowValues;
+    RowValues.Reserve(End - Start);
+    for (int32 Index = Start; Index < End; ++Index)
+    {
+        const int32 Ordinal = Matches[Index];
+        TSharedPtr<FJsonObject> RowObject = MakeShared<FJsonObject>();
+        RowObject->SetStringField(RowNameColumn, Rows->Names[Ordinal].ToString());
+
+        for (const FQueryColumn& Column : Columns)
+        {
+            FProperty* Property = const_cast<FProperty*>(Column.Property);
+            const TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(Property, Property->ContainerPtrToValuePtr<void>(Rows->Data[Ordinal]));
+            RowObject->SetField(Column.Key, Value.IsValid() ? Value : MakeShared<FJsonValueNull>());
+        }
+
+        RowValues.Add(MakeShared<FJsonValueObject>(RowObject));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("name"), DataTable->GetName());
+    Result->SetStringField(TEXT("path"), DataTable->GetPathName());
+    Result->SetNumberField(TEXT("row_count"), Rows->Names.Num());
+    Result->SetNumberField(TEXT("total_matches"), Matches.Num());
+    Result->SetNumberField(TEXT("offset"), Start);
+    Result->SetArrayField(TEXT("rows"), RowValues);
+    if (!IndexUsed.IsEmpty())
+    {
+        Result->SetStringField(TEXT("index"), IndexUsed);
+    }
+
+    MCP_LOG_INFO(TEXT("Queried data table '%s': %d of %d rows matched, %d returned."), *DataTable->GetPathName(), Matches.Num(), Rows->Names.Num(), RowValues.Num());
+    return CreateSuccessResponse(Result);
+}
@@ -0,0 +1,1560 @@
+#include "MCPCommandHandlers_Instancing.h"
+#include "MCPCommandHandlers_Scene.h"
+
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "Editor.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Materials/MaterialInterface.h"
+#include "Math/RandomStream.h"
+#include "Misc/Base64.h"
+#include "ScopedTransaction.h"
+#include "StaticMeshResources.h"
+#include "WorldPartition/DataLayer/DataLayerInstance.h"
+
+namespace
+{
+    /** Read a little-endian buffer of T (float32 or float64) out of a base64 string. */
+    template <typename T>
+    bool DecodeBase64Values(const FString& Encoded, TArray<T>& OutValues, FString& OutErrorMessage)
+    {
+        TArray<uint8> Bytes;
+        if (!FBase64::Decode(Encoded, Bytes))
+        {
+            OutErrorMessage = TEXT("Failed to decode base64 float data.");
+            return false;
+        }
+
+        if (Bytes.Num() % sizeof(T) != 0)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Base64 float data has %d bytes, which is not a multiple of %d."), Bytes.Num(), static_cast<int32>(sizeof(T)));
+            return false;
+        }
+
+        OutValues.SetNumUninitialized(Bytes.Num() / sizeof(T));
+        FMemory::Memcpy(OutValues.GetData(), Bytes.GetData(), Bytes.Num());
+        return true;
+    }
+
+    /** Read a flat JSON number array, converting each element to T. */
+    template <typename T>
+    bool ParseJsonNumbers(const TSharedPtr<FJsonObject>& Params, const FString& ArrayFieldName, TArray<T>& OutValues, FString& OutErrorMessage)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* ValuesArray = nullptr;
+        if (!Params->TryGetArrayField(ArrayFieldName, ValuesArray) || !ValuesArray)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Missing '%s' field"), *ArrayFieldName);
+            return false;
+        }
+
+        OutValues.SetNumUninitialized(ValuesArray->Num());
+        for (int32 Index = 0; Index < ValuesArray->Num(); ++Index)
+        {
+            double Number = 0.0;
+            const TSharedPtr<FJsonValue>& Value = (*ValuesArray)[Index];
+            if (!Value.IsValid() || !Value->TryGetNumber(Number))
+            {
+                OutErrorMessage = FString::Printf(TEXT("'%s' element %d is not a number"), *ArrayFieldName, Index);
+                return false;
+            }
+            OutValues[Index] = static_cast<T>(Number);
+        }
+
+        return true;
+    }
+
+    /** Region the scatter command distributes samples over */
+    enum class EScatterRegion : uint8
+    {
+        Box,
+        Spline,
+        Surface
+    };
+
+    /** Why a scatter sample was dropped during projection */
+    enum class EScatterDrop : uint8
+    {
+        None,
+        NoHit,
+        Slope
+    };
+
+    /** A generated sample before rotation/scale are applied */
+    struct FScatterSample
+    {
+        FVector Location = FVector::ZeroVector;
+        FVector Normal = FVector::UpVector;
+        EScatterDrop Drop = EScatterDrop::None;
+    };
+
+    /** Approximate density of a maximal Poisson disk set is 0.7 / r^2 points per unit area */
+    constexpr double PoissonPackingDensity = 0.7;
+
+    /** Candidates tried around each active Poisson sample before it is retired */
+    constexpr int32 PoissonAttemptsPerSample = 30;
+
+    bool TryGetVectorField(const TSharedPtr<FJsonObject>& Object, const TCHAR* FieldName, FVector& OutVector)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (!Object->TryGetArrayField(FStringView(FieldName), Values) || !Values || Values->Num() != 3)
+        {
+            return false;
+        }
+
+        OutVector = FVector((*Values)[0]->AsNumber(), (*Values)[1]->AsNumber(), (*Values)[2]->AsNumber());
+        return true;
+    }
+
+    /** Read an optional [min, max] pair; leaves OutRange untouched when the field is absent. */
+    bool TryGetRangeField(const TSharedPtr<FJsonObject>& Object, const TCHAR* FieldName, FVector2D& OutRange)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (!Object->TryGetArrayField(FStringView(FieldName), Values) || !Values || Values->Num() != 2)
+        {
+            return false;
+        }
+
+        const double A = (*Values)[0]->AsNumber();
+        const double B = (*Values)[1]->AsNumber();
+        OutRange = FVector2D(FMath::Min(A, B), FMath::Max(A, B));
+        return true;
+    }
+
+    /** Deterministic per-sample stream so parallel generation does not depend on scheduling. */
+    FRandomStream MakeSampleStream(int32 Seed, int32 Index)
+    {
+        return FRandomStream(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(Index))));
+    }
+
+    /**
+     * Bridson's Poisson disk sampling over [0, Size). The background grid holds at most one sample per
+     * cell, so each candidate only checks the 5x5 neighbouring cells.
+     * The whole region is filled before MaxPoints are picked at random, so a truncated result still
+     * covers the region evenly instead of growing out from the first sample.
+     * @param bOutLimitReached - Set when the fill produced more than MaxPoints samples
+     * @return False if the acceleration grid would be too large for the instance budget
+     */
+    bool SamplePoissonDisk2D(const FVector2D& Size, double Radius, int32 MaxPoints, int32 Seed, TArray<FVector2D>& OutPoints, bool& bOutLimitReached, FString& OutErrorMessage)
+    {
+        const double CellSize = Radius / UE_SQRT_2;
+        const int64 GridX = FMath::Max<int64>(1, FMath::CeilToInt64(Size.X / CellSize));
+        const int64 GridY = FMath::Max<int64>(1, FMath::CeilToInt64(Size.Y / CellSize));
+        const int64 MaxGridCells = FMath::Max(MCPConstants::MIN_SCATTER_GRID_CELLS, MaxPoints * MCPConstants::SCATTER_GRID_CELLS_PER_INSTANCE);
+        if (GridX * GridY > MaxGridCells)
+        {
+            const int64 ExpectedPoints = FMath::RoundToInt64(Size.X * Size.Y * PoissonPackingDensity / (Radius * Radius));
+            OutErrorMessage = FString::Printf(
+                TEXT("Region holds about %lld samples at min_distance %.2f, far more than max_instances %d; increase the distance, shrink the region or use method 'grid'"),
+                ExpectedPoints, Radius, MaxPoints);
+            return false;
+        }
+
+        TArray<int32> Grid;
+        Grid.Init(INDEX_NONE, static_cast<int32>(GridX * GridY));
+
+        auto CellOf = [CellSize, GridX, GridY](const FVector2D& Point)
+        {
+            return FIntPoint(
+                FMath::Clamp(static_cast<int32>(Point.X / CellSize), 0, static_cast<int32>(GridX) - 1),
+                FMath::Clamp(static_cast<int32>(Point.Y / CellSize), 0, static_cast<int32>(GridY) - 1));
+        };
+
+        FRandomStream Random(Seed);
+        TArray<int32> Active;
+
+        auto AddPoint = [&OutPoints, &Grid, &Active, &CellOf, GridX](const FVector2D& Point)
+        {
+            const FIntPoint Cell = CellOf(Point);
+            const int32 PointIndex = OutPoints.Add(Point);
+            Grid[Cell.Y * GridX + Cell.X] = PointIndex;
+            Active.Add(PointIndex);
+        };
+
+        AddPoint(FVector2D(Random.FRand() * Size.X, Random.FRand() * Size.Y));
+
+        const double RadiusSquared = Radius * Radius;
+        while (Active.Num() > 0)
+        {
+            const int32 ActiveSlot = Random.RandHelper(Active.Num());
+            const FVector2D Origin = OutPoints[Active[ActiveSlot]];
+
+            bool bPlaced = false;
+            for (int32 Attempt = 0; Attempt < PoissonAttemptsPerSample && !bPlaced; ++Attempt)
+            {
+                const double Angle = Random.FRand() * UE_TWO_PI;
+                const double Distance = Radius * (1.0 + Random.FRand());
+                const FVector2D Candidate = Origin + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Distance;
+                if (Candidate.X < 0.0 || Candidate.Y < 0.0 || Candidate.X >= Size.X || Candidate.Y >= Size.Y)
+                {
+                    continue;
+                }
+
+                const FIntPoint Cell = CellOf(Candidate);
+                bool bTooClose = false;
+                for (int32 Y = FMath::Max(0, Cell.Y - 2); Y <= FMath::Min(static_cast<int32>(GridY) - 1, Cell.Y + 2) && !bTooClose; ++Y)
+                {
+                    for (int32 X = FMath::Max(0, Cell.X - 2); X <= FMath::Min(static_cast<int32>(GridX) - 1, Cell.X + 2); ++X)
+                    {
+                        const int32 Neighbour = Grid[Y * GridX + X];
+                        if (Neighbour != INDEX_NONE && FVector2D::DistSquared(OutPoints[Neighbour], Candidate) < RadiusSquared)
+                        {
+                            bTooClose = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (!bTooClose)
+                {
+                    AddPoint(Candidate);
+                    bPlaced = true;
+                }
+            }
+
+            if (!bPlaced)
+            {
+                Active.RemoveAtSwap(ActiveSlot);
+            }
+        }
+
+        // Partial Fisher-Yates shuffle: the first MaxPoints entries become a uniform random subset
+        bOutLimitReached = OutPoints.Num() > MaxPoints;
+        if (bOutLimitReached)
+        {
+            for (int32 Index = 0; Index < MaxPoints; ++Index)
+            {
+                OutPoints.Swap(Index, Index + Random.RandHelper(OutPoints.Num() - Index));
+            }
+            OutPoints.SetNum(MaxPoints);
+        }
+        return true;
+    }
+
+    /**
+     * One sample per grid cell, offset by up to Jitter * Spacing. Rows are filled in parallel.
+     * @return True if the grid was truncated to MaxPoints
+     */
+    bool SampleJitteredGrid2D(const FVector2D& Size, double Spacing, double Jitter, int32 MaxPoints, int32 Seed, TArray<FVector2D>& OutPoints)
+    {
+        const int32 Columns = FMath::Clamp(FMath::FloorToInt(Size.X / Spacing), 1, MaxPoints);
+        const int64 FullRows = FMath::Max<int64>(1, FMath::FloorToInt64(Size.Y / Spacing));
+        const int32 Rows = static_cast<int32>(FMath::Min<int64>(FullRows, MaxPoints / Columns));
+
+        // Centre the grid in the region so the leftover margin is split evenly
+        const FVector2D Margin((Size.X - Columns * Spacing) * 0.5, (Size.Y - Rows * Spacing) * 0.5);
+
+        OutPoints.SetNumUninitialized(Columns * Rows);
+        ParallelFor(Rows, [&OutPoints, &Margin, Columns, Spacing, Jitter, Seed](int32 Row)
+        {
+            FRandomStream Random = MakeSampleStream(Seed, Row);
+            FVector2D* RowPoints = OutPoints.GetData() + Row * Columns;
+            for (int32 Column = 0; Column < Columns; ++Column)
+            {
+                RowPoints[Column] = Margin + FVector2D(
+                    (Column + 0.5 + Jitter * (Random.FRand() - 0.5)) * Spacing,
+                    (Row + 0.5 + Jitter * (Random.FRand() - 0.5)) * Spacing);
+            }
+        });
+
+        return Rows < FullRows;
+    }
+
+    /**
+     * Area-weighted samples on the LOD0 triangles of an actor's static meshes. Triangles steeper than
+     * MinNormalZ are skipped. The sample count comes from Density (per square metre) when positive,
+     * otherwise from Spacing. With a positive MinDistance samples are dart-thrown against a hash grid.
+     */
+    bool SampleActorSurface(
+        AActor* SourceActor,
+        double Density,
+        double Spacing,
+        double MinDistance,
+        double MinNormalZ,
+        int32 MaxPoints,
+        int32 Seed,
+        TArray<FScatterSample>& OutSamples,
+        bool& bOutLimitReached,
+        FString& OutErrorMessage)
+    {
+        TArray<FVector> Corners;
+        TArray<FVector> Normals;
+        TArray<double> CumulativeArea;
+        double TotalArea = 0.0;
+
+        TInlineComponentArray<UStaticMeshComponent*> MeshComponents(SourceActor);
+        for (const UStaticMeshComponent* MeshComponent : MeshComponents)
+        {
+            // Instances would only be sampled at the component transform, so skip ISM components
+            const UStaticMesh* Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+            if (!Mesh || MeshComponent->IsA<UInstancedStaticMeshComponent>() || !Mesh->GetRenderData() || Mesh->GetRenderData()->LODResources.Num() == 0)
+            {
+                continue;
+            }
+
+            const FStaticMeshLODResources& LOD = Mesh->GetRenderData()->LODResources[0];
+            const FTransform& ComponentTransform = MeshComponent->GetComponentTransform();
+            TArray<uint32> Indices;
+            LOD.IndexBuffer.GetCopy(Indices);
+
+            for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+            {
+                const FVector A = ComponentTransform.TransformPosition(FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Indices[Index])));
+                const FVector B = ComponentTransform.TransformPosition(FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Indices[Index + 1])));
+                const FVector C = ComponentTransform.TransformPosition(FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Indices[Index + 2])));
+                const FVector Cross = (C - A) ^ (B - A);
+                const double DoubleArea = Cross.Size();
+                if (DoubleArea <= UE_SMALL_NUMBER)
+                {
+                    continue;
+                }
+
+                const FVector Normal = Cross / DoubleArea;
+                if (Normal.Z < MinNormalZ)
+                {
+                    continue;
+                }
+
+                Corners.Append({ A, B, C });
+                Normals.Add(Normal);
+                TotalArea += DoubleArea * 0.5;
+                CumulativeArea.Add(TotalArea);
+            }
+        }
+
+        if (Normals.Num() == 0)
+        {
+            OutErrorMessage = FString::Printf(TEXT("Actor '%s' has no static mesh triangles to scatter on"), *SourceActor->GetActorLabel());
+            return false;
+        }
+
+        if (Density <= 0.0 && Spacing <= 0.0)
+        {
+            OutErrorMessage = TEXT("Surface scatter needs a positive density or spacing");
+            return false;
+        }
+
+        const double PointsPerArea = Density > 0.0 ? Density / 10000.0 : PoissonPackingDensity / (Spacing * Spacing);
+        const int64 TargetCount = FMath::Max<int64>(1, FMath::RoundToInt64(TotalArea * PointsPerArea));
+        const int32 Count = static_cast<int32>(FMath::Min<int64>(TargetCount, MaxPoints));
+        bOutLimitReached = TargetCount > MaxPoints;
+
+        auto SampleTriangle = [&Corners, &Normals, &CumulativeArea, TotalArea](FRandomStream& Random)
+        {
+            const int32 Triangle = FMath::Min(Algo::UpperBound(CumulativeArea, Random.FRand() * TotalArea), CumulativeArea.Num() - 1);
+            const double SqrtU = FMath::Sqrt(Random.FRand());
+            const double V = Random.FRand();
+            const FVector& A = Corners[Triangle * 3];
+            const FVector& B = Corners[Triangle * 3 + 1];
+            const FVector& C = Corners[Triangle * 3 + 2];
+
+            FScatterSample Sample;
+            Sample.Location = A * (1.0 - SqrtU) + B * (SqrtU * (1.0 - V)) + C * (SqrtU * V);
+            Sample.Normal = Normals[Triangle];
+            return Sample;
+        };
+
+        if (MinDistance <= 0.0)
+        {
+            OutSamples.SetNum(Count);
+            ParallelFor(Count, [&OutSamples, &SampleTriangle, Seed](int32 Index)
+            {
+                FRandomStream Random = MakeSampleStream(Seed, Index);
+                OutSamples[Index] = SampleTriangle(Random);
+            });
+            return true;
+        }
+
+        // Dart throwing: cells are MinDistance wide so conflicts can only be in the 27 surrounding cells
+        TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+        auto CellOf = [MinDistance](const FVector& Location)
+        {
+            return FIntVector(
+                FMath::FloorToInt(Location.X / MinDistance),
+                FMath::FloorToInt(Location.Y / MinDistance),
+                FMath::FloorToInt(Location.Z / MinDistance));
+        };
+
+        const double MinDistanceSquared = MinDistance * MinDistance;
+        const int64 MaxAttempts = static_cast<int64>(Count) * PoissonAttemptsPerSample;
+        FRandomStream Random(Seed);
+        OutSamples.Reserve(Count);
+        for (int64 Attempt = 0; Attempt < MaxAttempts && OutSamples.Num() < Count; ++Attempt)
+        {
+            const FScatterSample Candidate = SampleTriangle(Random);
+            const FIntVector Cell = CellOf(Candidate.Location);
+
+            bool bTooClose = false;
+            for (int32 Z = -1; Z <= 1 && !bTooClose; ++Z)
+            {
+                for (int32 Y = -1; Y <= 1 && !bTooClose; ++Y)
+                {
+                    for (int32 X = -1; X <= 1 && !bTooClose; ++X)
+                    {
+                        if (const TArray<int32, TInlineAllocator<4>>* Neighbours = Cells.Find(Cell + FIntVector(X, Y, Z)))
+                        {
+                            for (const int32 Neighbour : *Neighbours)
+                            {
+                                if (FVector::DistSquared(OutSamples[Neighbour].Location, Candidate.Location) < MinDistanceSquared)
+                                {
+                                    bTooClose = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (!bTooClose)
+            {
+                Cells.FindOrAdd(Cell).Add(OutSamples.Add(Candidate));
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * StaticMeshActors that render the same mesh with the same materials, and agree on every
+     * setting a single instanced component can only hold once (see BuildConsolidationSignature)
+     */
+    struct FConsolidationGroup
+    {
+        UStaticMesh* Mesh = nullptr;
+        TArray<UMaterialInterface*> Materials;
+        FString Signature;
+        bool bHasCell = false;
+        FIntPoint Cell = FIntPoint::ZeroValue;
+        TArray<AStaticMeshActor*> Actors;
+    };
+
+    /**
+     * Key of the per-component and per-actor state that instances of one component cannot differ in:
+     * collision, shadow and render flags, mobility, tags, custom primitive data, LOD and cull
+     * distances, and the World Partition grid and data layers the actor streams with.
+     */
+    FString BuildConsolidationSignature(const AStaticMeshActor* Actor, const UStaticMeshComponent* Component)
+    {
+        FString Signature = FString::Printf(TEXT("%s|%d|%d|"),
+            *Component->GetCollisionProfileName().ToString(),
+            static_cast<int32>(Component->GetCollisionEnabled()),
+            static_cast<int32>(Component->GetCollisionObjectType()));
+        for (int32 Channel = 0; Channel < ECC_MAX; ++Channel)
+        {
+            Signature.AppendInt(static_cast<int32>(Component->GetCollisionResponseToChannel(static_cast<ECollisionChannel>(Channel))));
+        }
+
+        const bool RenderFlags[] = {
+            !!Component->CastShadow, !!Component->bCastDynamicShadow, !!Component->bCastStaticShadow, !!Component->bCastHiddenShadow,
+            !!Component->bAffectDistanceFieldLighting, !!Component->bVisibleInRayTracing, !!Component->bRenderInMainPass,
+            !!Component->bRenderInDepthPass, !!Component->bReceivesDecals, Component->GetVisibleFlag(), !!Component->bHiddenInGame,
+            !!Component->LightingChannels.bChannel0, !!Component->LightingChannels.bChannel1, !!Component->LightingChannels.bChannel2,
+            !!Component->bOverrideMinLOD };
+        Signature += TEXT('|');
+        for (const bool bFlag : RenderFlags)
+        {
+            Signature += bFlag ? TEXT('1') : TEXT('0');
+        }
+
+        Signature.Appendf(TEXT("|%d|%g|%g|%d|%d|cpd"),
+            static_cast<int32>(Component->Mobility.GetValue()), Component->LDMaxDrawDistance, Component->MinDrawDistance,
+            Component->ForcedLodModel, Component->MinLOD);
+        for (const float Value : Component->GetDefaultCustomPrimitiveData().Data)
+        {
+            Signature.Appendf(TEXT(",%g"), Value);
+        }
+
+        auto AppendSortedNames = [&Signature](const TCHAR* Section, TArray<FName> Names)
+        {
+            Names.Sort(FNameLexicalLess());
+            Signature += Section;
+            for (const FName& Name : Names)
+            {
+                Signature += TEXT(',');
+                Signature += Name.ToString();
+            }
+        };
+        AppendSortedNames(TEXT("|tags"), Actor->Tags);
+        AppendSortedNames(TEXT("|component_tags"), Component->ComponentTags);
+        AppendSortedNames(TEXT("|data_layers"), Actor->GetDataLayerInstanceNames());
+
+        Signature.Appendf(TEXT("|%s|%d"), *Actor->GetRuntimeGrid().ToString(), Actor->GetIsSpatiallyLoaded() ? 1 : 0);
+        return Signature;
+    }
+
+    /** Apply the state captured by BuildConsolidationSignature from a replaced actor to its instanced host */
+    void CopyConsolidatedSettings(const AStaticMeshActor* Source, AActor* HostActor, UInstancedStaticMeshComponent* Target)
+    {
+        const UStaticMeshComponent* Component = Source->GetStaticMeshComponent();
+
+        Target->SetMobility(Component->Mobility);
+        Target->SetCollisionProfileName(Component->GetCollisionProfileName());
+        if (Component->GetCollisionProfileName() == UCollisionProfile::CustomCollisionProfileName)
+        {
+            Target->SetCollisionEnabled(Component->GetCollisionEnabled());
+            Target->SetCollisionObjectType(Component->GetCollisionObjectType());
+            Target->SetCollisionResponseToChannels(Component->GetCollisionResponseToChannels());
+        }
+
+        Target->SetCastShadow(Component->CastShadow);
+        Target->bCastDynamicShadow = Component->bCastDynamicShadow;
+        Target->bCastStaticShadow = Component->bCastStaticShadow;
+        Target->bCastHiddenShadow = Component->bCastHiddenShadow;
+        Target->bAffectDistanceFieldLighting = Component->bAffectDistanceFieldLighting;
+        Target->bVisibleInRayTracing = Component->bVisibleInRayTracing;
+        Target->bRenderInMainPass = Component->bRenderInMainPass;
+        Target->bRenderInDepthPass = Component->bRenderInDepthPass;
+        Target->bReceivesDecals = Component->bReceivesDecals;
+        Target->LightingChannels = Component->LightingChannels;
+        Target->SetVisibility(Component->GetVisibleFlag());
+        Target->SetHiddenInGame(Component->bHiddenInGame);
+
+        // Instances fade per instance rather than per component, so the actor's max draw distance becomes the instance end cull distance
+        Target->SetCullDistance(Component->LDMaxDrawDistance);
+        Target->MinDrawDistance = Component->MinDrawDistance;
+        Target->SetCullDistances(0, FMath::RoundToInt(Component->LDMaxDrawDistance));
+        Target->SetForcedLodModel(Component->ForcedLodModel);
+        Target->bOverrideMinLOD = Component->bOverrideMinLOD;
+        Target->MinLOD = Component->MinLOD;
+
+        const TArray<float>& CustomData = Component->GetDefaultCustomPrimitiveData().Data;
+        for (int32 DataIndex = 0; DataIndex < CustomData.Num(); ++DataIndex)
+        {
+            Target->SetDefaultCustomPrimitiveDataFloat(DataIndex, CustomData[DataIndex]);
+        }
+
+        Target->ComponentTags = Component->ComponentTags;
+        HostActor->Tags = Source->Tags;
+
+        HostActor->SetRuntimeGrid(Source->GetRuntimeGrid());
+        HostActor->SetIsSpatiallyLoaded(Source->GetIsSpatiallyLoaded());
+        for (const UDataLayerInstance* DataLayer : Source->GetDataLayerInstances())
+        {
+            HostActor->AddDataLayer(DataLayer);
+        }
+
+        Target->MarkRenderStateDirty();
+    }
+
+    /** Registered primitive components in the world, the figure consolidation is meant to reduce */
+    int32 CountPrimitiveComponents(UWorld* World)
+    {
+        int32 Count = 0;
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            TInlineComponentArray<UPrimitiveComponent*> Primitives(*It);
+            for (const UPrimitiveComponent* Primitive : Primitives)
+            {
+                Count += Primitive && Primitive->IsRegistered() ? 1 : 0;
+            }
+        }
+        return Count;
+    }
+}
+
+AActor* FMCPInstancingUtils::FindActorByNameOrLabel(UWorld* World, const FString& NameOrLabel, FString& OutErrorMessage)
+{
+    OutErrorMessage.Reset();
+    if (!World || NameOrLabel.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    // Names and paths are unique; labels are not, so a label only resolves when a single actor has it
+    const bool bIsPath = NameOrLabel.Contains(TEXT("."));
+    AActor* LabelMatch = nullptr;
+    int32 NumLabelMatches = 0;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        if (It->GetName() == NameOrLabel || (bIsPath && It->GetPathName() == NameOrLabel))
+        {
+            return *It;
+        }
+        if (It->GetActorLabel() == NameOrLabel)
+        {
+            LabelMatch = *It;
+            ++NumLabelMatches;
+        }
+    }
+
+    if (NumLabelMatches > 1)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Label '%s' matches %d actors; pass the actor's object name instead"), *NameOrLabel, NumLabelMatches);
+        return nullptr;
+    }
+    return LabelMatch;
+}
+
+AActor* FMCPInstancingUtils::SpawnInstanceHostActor(UWorld* World, const FVector& Location, const FString& Label)
+{
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Name = NAME_None;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AActor* HostActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location), SpawnParams);
+    if (!HostActor)
+    {
+        MCP_LOG_ERROR("Failed to spawn instance host actor");
+        return nullptr;
+    }
+
+    USceneComponent* RootComponent = NewObject<USceneComponent>(HostActor, TEXT("Root"), RF_Transactional);
+    RootComponent->SetMobility(EComponentMobility::Static);
+    RootComponent->SetWorldTransform(FTransform(Location));
+    HostActor->SetRootComponent(RootComponent);
+    HostActor->AddInstanceComponent(RootComponent);
+    RootComponent->RegisterComponent();
+
+    if (!Label.IsEmpty())
+    {
+        HostActor->SetActorLabel(Label);
+    }
+
+    return HostActor;
+}
+
+UInstancedStaticMeshComponent* FMCPInstancingUtils::FindOrCreateInstanceComponent(
+    AActor* HostActor,
+    UStaticMesh* Mesh,
+    bool bHierarchical,
+    bool& bOutCreated)
+{
+    bOutCreated = false;
+
+    if (!HostActor || !Mesh)
+    {
+        return nullptr;
+    }
+
+    // Reuse a component that already renders this mesh so repeated calls extend it.
+    TArray<UInstancedStaticMeshComponent*> ExistingComponents;
+    HostActor->GetComponents<UInstancedStaticMeshComponent>(ExistingComponents);
+    for (UInstancedStaticMeshComponent* Existing : ExistingComponents)
+    {
+        if (Existing && Existing->GetStaticMesh() == Mesh)
+        {
+            return Existing;
+        }
+    }
+
+    UClass* ComponentClass = bHierarchical
+        ? UHierarchicalInstancedStaticMeshComponent::StaticClass()
+        : UInstancedStaticMeshComponent::StaticClass();
+
+    const FName ComponentName = MakeUniqueObjectName(HostActor, ComponentClass, FName(*FString::Printf(TEXT("ISM_%s"), *Mesh->GetName())));
+    UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(HostActor, ComponentClass, ComponentName, RF_Transactional);
+    if (!Component)
+    {
+        return nullptr;
+    }
+
+    Component->SetMobility(EComponentMobility::Static);
+    Component->SetStaticMesh(Mesh);
+    if (USceneComponent* Root = HostActor->GetRootComponent())
+    {
+        Component->SetupAttachment(Root);
+    }
+    else
+    {
+        HostActor->SetRootComponent(Component);
+    }
+
+    HostActor->AddInstanceComponent(Component);
+    Component->RegisterComponent();
+
+    bOutCreated = true;
+    return Component;
+}
+
+bool FMCPInstancingUtils::ParsePackedFloats(
+    const TSharedPtr<FJsonObject>& Params,
+    const FString& ArrayFieldName,
+    const FString& Base64FieldName,
+    TArray<float>& OutValues,
+    FString& OutErrorMessage)
+{
+    OutValues.Reset();
+
+    FString Encoded;
+    if (!Base64FieldName.IsEmpty() && Params->TryGetStringField(Base64FieldName, Encoded))
+    {
+        return DecodeBase64Values(Encoded, OutValues, OutErrorMessage);
+    }
+
+    return ParseJsonNumbers(Params, ArrayFieldName, OutValues, OutErrorMessage);
+}
+
+bool FMCPInstancingUtils::ParsePackedDoubles(
+    const TSharedPtr<FJsonObject>& Params,
+    const FString& ArrayFieldName,
+    const FString& Base64FieldName,
+    TArray<double>& OutValues,
+    FString& OutErrorMessage)
+{
+    OutValues.Reset();
+
+    FString Encoded;
+    if (Params->TryGetStringField(ArrayFieldName + TEXT("_f64_base64"), Encoded))
+    {
+        return DecodeBase64Values(Encoded, OutValues, OutErrorMessage);
+    }
+
+    if (!Base64FieldName.IsEmpty() && Params->TryGetStringField(Base64FieldName, Encoded))
+    {
+        TArray<float> Floats;
+        if (!DecodeBase64Values(Encoded, Floats, OutErrorMessage))
+        {
+            return false;
+        }
+        OutValues.SetNumUninitialized(Floats.Num());
+        for (int32 Index = 0; Index < Floats.Num(); ++Index)
+        {
+            OutValues[Index] = Floats[Index];
+        }
+        return true;
+    }
+
+    return ParseJsonNumbers(Params, ArrayFieldName, OutValues, OutErrorMessage);
+}
+
+bool FMCPInstancingUtils::ParsePackedTransforms(
+    const TSharedPtr<FJsonObject>& Params,
+    const FString& ArrayFieldName,
+    const FString& Base64FieldName,
+    TArray<FTransform>& OutTransforms,
+    FString& OutErrorMessage)
+{
+    OutTransforms.Reset();
+
+    int32 Stride = 9;
+    Params->TryGetNumberField(FStringView(TEXT("stride")), Stride);
+    if (Stride != 3 && Stride != 6 && Stride != 9)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Unsupported transform stride %d. Expected 3, 6 or 9."), Stride);
+        return false;
+    }
+
+    TArray<double> Values;
+    if (!ParsePackedDoubles(Params, ArrayFieldName, Base64FieldName, Values, OutErrorMessage))
+    {
+        return false;
+    }
+
+    if (Values.Num() % Stride != 0)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Transform data has %d values, which is not a multiple of the stride %d."), Values.Num(), Stride);
+        return false;
+    }
+
+    const int32 NumTransforms = Values.Num() / Stride;
+    OutTransforms.SetNumUninitialized(NumTransforms);
+
+    const double* Data = Values.GetData();
+    for (int32 Index = 0; Index < NumTransforms; ++Index, Data += Stride)
+    {
+        const FVector Location(Data[0], Data[1], Data[2]);
+        const FRotator Rotation = Stride >= 6 ? FRotator(Data[3], Data[4], Data[5]) : FRotator::ZeroRotator;
+        const FVector Scale = Stride >= 9 ? FVector(Data[6], Data[7], Data[8]) : FVector::OneVector;
+        OutTransforms[Index] = FTransform(Rotation, Location, Scale);
+    }
+
+    return true;
+}
+
+int32 FMCPInstancingUtils::AddInstances(
+    UInstancedStaticMeshComponent* Component,
+    const TArray<FTransform>& Transforms,
+    bool bWorldSpace,
+    const TArray<float>& CustomData,
+    int32 NumCustomDataFloats)
+{
+    if (!Component)
+    {
+        return INDEX_NONE;
+    }
+
+    const int32 FirstIndex = Component->GetInstanceCount();
+
+    if (NumCustomDataFloats > Component->NumCustomDataFloats)
+    {
+        Component->SetNumCustomDataFloats(NumCustomDataFloats);
+    }
+
+    // Navigation is rebuilt once by the editor after the transaction rather than per instance.
+    Component->AddInstances(Transforms, /*bShouldReturnIndices*/ false, bWorldSpace, /*bUpdateNavigation*/ false);
+
+    if (NumCustomDataFloats > 0 && CustomData.Num() >= Transforms.Num() * NumCustomDataFloats)
+    {
+        for (int32 Offset = 0; Offset < Transforms.Num(); ++Offset)
+        {
+            const TArrayView<const float> InstanceData(CustomData.GetData() + Offset * NumCustomDataFloats, NumCustomDataFloats);
+            Component->SetCustomData(FirstIndex + Offset, InstanceData, /*bMarkRenderStateDirty*/ false);
+        }
+        Component->MarkRenderStateDirty();
+    }
+
+    return FirstIndex;
+}
+
+TSharedPtr<FJsonObject> FMCPCreateInstancesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling create_instances command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    FString MeshPath;
+    if (!Params->TryGetStringField(FStringView(TEXT("mesh")), MeshPath) || MeshPath.IsEmpty())
+    {
+        MCP_LOG_WARNING("Missing 'mesh' field in create_instances command");
+        return CreateErrorResponse(TEXT("Missing 'mesh' field"));
+    }
+
+    UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, *MeshPath);
+    if (!Mesh)
+    {
+        MCP_LOG_WARNING("Failed to load mesh %s", *MeshPath);
+        return CreateErrorResponse(FString::Printf(TEXT("Failed to load mesh '%s'"), *MeshPath));
+    }
+
+    TArray<FTransform> Transforms;
+    FString ParseError;
+    if (!FMCPInstancingUtils::ParsePackedTransforms(Params, TEXT("transforms"), TEXT("transforms_base64"), Transforms, ParseError))
+    {
+        MCP_LOG_WARNING("Invalid transforms in create_instances command: %s", *ParseError);
+        return CreateErrorResponse(ParseError);
+    }
+
+    if (Transforms.Num() == 0)
+    {
+        return CreateErrorResponse(TEXT("No transforms supplied"));
+    }
+
+    int32 NumCustomDataFloats = 0;
+    Params->TryGetNumberField(FStringView(TEXT("num_custom_data")), NumCustomDataFloats);
+
+    TArray<float> CustomData;
+    if (NumCustomDataFloats > 0)
+    {
+        if (!FMCPInstancingUtils::ParsePackedFloats(Params, TEXT("custom_data"), TEXT("custom_data_base64"), CustomData, ParseError))
+        {
+            return CreateErrorResponse(ParseError);
+        }
+
+        if (CustomData.Num() != Transforms.Num() * NumCustomDataFloats)
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Expected %d custom data values (%d per instance), got %d"),
+                Transforms.Num() * NumCustomDataFloats, NumCustomDataFloats, CustomData.Num()));
+        }
+    }
+
+    bool bHierarchical = true;
+    Params->TryGetBoolField(FStringView(TEXT("hierarchical")), bHierarchical);
+
+    bool bWorldSpace = true;
+    Params->TryGetBoolField(FStringView(TEXT("world_space")), bWorldSpace);
+
+    FString HostName;
+    Params->TryGetStringField(FStringView(TEXT("actor")), HostName);
+
+    FString Label;
+    Params->TryGetStringField(FStringView(TEXT("label")), Label);
+
+    const FScopedTransaction Transaction(NSLOCTEXT("UnrealMCP", "CreateInstances", "Create Instances"));
+
+    bool bCreatedHost = false;
+    FString LookupError;
+    AActor* HostActor = FMCPInstancingUtils::FindActorByNameOrLabel(World, HostName.IsEmpty() ? Label : HostName, LookupError);
+    if (!LookupError.IsEmpty())
+    {
+        return CreateErrorResponse(LookupError);
+    }
+    if (!HostActor)
+    {
+        if (!HostName.IsEmpty())
+        {
+            MCP_LOG_WARNING("Instance host actor not found: %s", *HostName);
+            return CreateErrorResponse(FString::Printf(TEXT("Actor not found: %s"), *HostName));
+        }
+
+        if (Label.IsEmpty())
+        {
+            Label = FString::Printf(TEXT("MCP_Instances_%s"), *Mesh->GetName());
+        }
+
+        HostActor = FMCPInstancingUtils::SpawnInstanceHostActor(World, Transforms[0].GetLocation(), Label);
+        if (!HostActor)
+        {
+            return CreateErrorResponse(TEXT("Failed to spawn instance host actor"));
+        }
+        bCreatedHost = true;
+    }
+
+    HostActor->Modify();
+
+    bool bCreatedComponent = false;
+    UInstancedStaticMeshComponent* Component = FMCPInstancingUtils::FindOrCreateInstanceComponent(HostActor, Mesh, bHierarchical, bCreatedComponent);
+    if (!Component)
+    {
+        return CreateErrorResponse(TEXT("Failed to create instanced static mesh component"));
+    }
+
+    Component->Modify();
+    const int32 FirstIndex = FMCPInstancingUtils::AddInstances(Component, Transforms, bWorldSpace, CustomData, NumCustomDataFloats);
+    FMCPSceneChangeTracker::Get().MarkActorDirty(HostActor);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("actor"), HostActor->GetName());
+    Result->SetStringField(TEXT("label"), HostActor->GetActorLabel());
+    Result->SetStringField(TEXT("component"), Component->GetName());
+    Result->SetBoolField(TEXT("hierarchical"), Component->IsA<UHierarchicalInstancedStaticMeshComponent>());
+    Result->SetBoolField(TEXT("created_actor"), bCreatedHost);
+    Result->SetBoolField(TEXT("created_component"), bCreatedComponent);
+    Result->SetNumberField(TEXT("first_index"), FirstIndex);
+    Result->SetNumberField(TEXT("instances_added"), Transforms.Num());
+    Result->SetNumberField(TEXT("instance_count"), Component->GetInstanceCount());
+
+    MCP_LOG_INFO("Added %d instances of %s to %s", Transforms.Num(), *Mesh->GetName(), *HostActor->GetActorLabel());
+    return CreateSuccessResponse(Result);
+}
+
+TSharedPtr<FJsonObject> FMCPScatterHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling scatter command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    FString MeshPath;
+    if (!Params->TryGetStringField(FStringView(TEXT("mesh")), MeshPath) || MeshPath.IsEmpty())
+    {
+        MCP_LOG_WARNING("Missing 'mesh' field in scatter command");
+        return CreateErrorResponse(TEXT("Missing 'mesh' field"));
+    }
+
+    UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, *MeshPath);
+    if (!Mesh)
+    {
+        MCP_LOG_WARNING("Failed to load mesh %s", *MeshPath);
+        return CreateErrorResponse(FString::Printf(TEXT("Failed to load mesh '%s'"), *MeshPath));
+    }
+
+    // Region
+    FString RegionName = TEXT("box");
+    Params->TryGetStringField(FStringView(TEXT("region")), RegionName);
+
+    EScatterRegion Region;
+    if (RegionName.Equals(TEXT("box"), ESearchCase::IgnoreCase))
+    {
+        Region = EScatterRegion::Box;
+    }
+    else if (RegionName.Equals(TEXT("spline"), ESearchCase::IgnoreCase))
+    {
+        Region = EScatterRegion::Spline;
+    }
+    else if (RegionName.Equals(TEXT("surface"), ESearchCase::IgnoreCase))
+    {
+        Region = EScatterRegion::Surface;
+    }
+    else
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown region '%s' (expected box, spline or surface)"), *RegionName));
+    }
+
+    FBox Box(ForceInit);
+    if (Region == EScatterRegion::Box)
+    {
+        const TSharedPtr<FJsonObject>* BoundsObject = nullptr;
+        FVector Min;
+        FVector Max;
+        FVector Center;
+        FVector Extent;
+        if (Params->TryGetObjectField(FStringView(TEXT("bounds")), BoundsObject) && BoundsObject && BoundsObject->IsValid()
+            && TryGetVectorField(*BoundsObject, TEXT("min"), Min) && TryGetVectorField(*BoundsObject, TEXT("max"), Max))
+        {
+            Box = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+        }
+        else if (TryGetVectorField(Params, TEXT("center"), Center) && TryGetVectorField(Params, TEXT("extent"), Extent))
+        {
+            Box = FBox::BuildAABB(Center, Extent.GetAbs());
+        }
+        else
+        {
+            return CreateErrorResponse(TEXT("Box region requires 'bounds' {min, max} or 'center' and 'extent'"));
+        }
+    }
+
+    AActor* SourceActor = nullptr;
+    USplineComponent* Spline = nullptr;
+    if (Region != EScatterRegion::Box)
+    {
+        FString SourceName;
+        Params->TryGetStringField(FStringView(TEXT("source_actor")), SourceName);
+        FString LookupError;
+        SourceActor = FMCPInstancingUtils::FindActorByNameOrLabel(World, SourceName, LookupError);
+        if (!LookupError.IsEmpty())
+        {
+            return CreateErrorResponse(LookupError);
+        }
+        if (!SourceActor)
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Region '%s' requires 'source_actor'; actor not found: %s"), *RegionName, *SourceName));
+        }
+
+        if (Region == EScatterRegion::Spline)
+        {
+            Spline = SourceActor->FindComponentByClass<USplineComponent>();
+            if (!Spline)
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Actor '%s' has no spline component"), *SourceActor->GetActorLabel()));
+            }
+        }
+    }
+
+    // Distribution: density is instances per square metre, min_distance is in world units
+    FString Method = TEXT("poisson");
+    Params->TryGetStringField(FStringView(TEXT("method")), Method);
+    const bool bPoisson = Method.Equals(TEXT("poisson"), ESearchCase::IgnoreCase);
+    if (!bPoisson && !Method.Equals(TEXT("grid"), ESearchCase::IgnoreCase))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown method '%s' (expected poisson or grid)"), *Method));
+    }
+
+    double Density = 0.0;
+    double MinDistance = 0.0;
+    Params->TryGetNumberField(FStringView(TEXT("density")), Density);
+    Params->TryGetNumberField(FStringView(TEXT("min_distance")), MinDistance);
+    if (Density <= 0.0 && MinDistance <= 0.0)
+    {
+        return CreateErrorResponse(TEXT("Provide a positive 'density' (instances per square metre) or 'min_distance'"));
+    }
+
+    double Jitter = 1.0;
+    Params->TryGetNumberField(FStringView(TEXT("jitter")), Jitter);
+    Jitter = FMath::Clamp(Jitter, 0.0, 1.0);
+
+    int32 MaxInstances = MCPConstants::DEFAULT_SCATTER_MAX_INSTANCES;
+    Params->TryGetNumberField(FStringView(TEXT("max_instances")), MaxInstances);
+    MaxInstances = FMath::Clamp(MaxInstances, 1, MCPConstants::MAX_SCATTER_INSTANCES);
+
+    int32 Seed = 0;
+    Params->TryGetNumberField(FStringView(TEXT("seed")), Seed);
+
+    FVector2D YawRange(0.0, 360.0);
+    FVector2D PitchRange(0.0, 0.0);
+    FVector2D RollRange(0.0, 0.0);
+    FVector2D ScaleRange(1.0, 1.0);
+    TryGetRangeField(Params, TEXT("yaw_range"), YawRange);
+    TryGetRangeField(Params, TEXT("pitch_range"), PitchRange);
+    TryGetRangeField(Params, TEXT("roll_range"), RollRange);
+    TryGetRangeField(Params, TEXT("scale_range"), ScaleRange);
+
+    bool bAlignToNormal = false;
+    Params->TryGetBoolField(FStringView(TEXT("align_to_normal")), bAlignToNormal);
+
+    bool bProject = false;
+    Params->TryGetBoolField(FStringView(TEXT("project")), bProject);
+    bProject = bProject && Region != EScatterRegion::Surface;
+
+    double TraceDistance = MCPConstants::DEFAULT_SCATTER_TRACE_DISTANCE;
+    Params->TryGetNumberField(FStringView(TEXT("trace_distance")), TraceDistance);
+
+    double MaxSlope = 90.0;
+    Params->TryGetNumberField(FStringView(TEXT("max_slope")), MaxSlope);
+    const double MinNormalZ = MaxSlope >= 90.0 ? -1.0 : FMath::Cos(FMath::DegreesToRadians(FMath::Max(MaxSlope, 0.0)));
+
+    FString HostName;
+    Params->TryGetStringField(FStringView(TEXT("actor")), HostName);
+
+    FString Label;
+    Params->TryGetStringField(FStringView(TEXT("label")), Label);
+
+    FString LookupError;
+    AActor* HostActor = FMCPInstancingUtils::FindActorByNameOrLabel(World, HostName.IsEmpty() ? Label : HostName, LookupError);
+    if (!LookupError.IsEmpty())
+    {
+        return CreateErrorResponse(LookupError);
+    }
+    if (!HostActor && !HostName.IsEmpty())
+    {
+        MCP_LOG_WARNING("Instance host actor not found: %s", *HostName);
+        return CreateErrorResponse(FString::Printf(TEXT("Actor not found: %s"), *HostName));
+    }
+
+    // Generate samples
+    TArray<FScatterSample> Samples;
+    bool bLimitReached = false;
+    FString SampleError;
+
+    if (Region == EScatterRegion::Surface)
+    {
+        // Grid has no meaning on an arbitrary surface, so 'grid' samples uniformly without a spacing constraint;
+        // min_distance then only sets the sample count
+        const double SurfaceMinDistance = !bPoisson ? 0.0 : MinDistance > 0.0 ? MinDistance : 100.0 * FMath::Sqrt(PoissonPackingDensity / Density);
+        if (!SampleActorSurface(SourceActor, Density, MinDistance, SurfaceMinDistance, MinNormalZ, MaxInstances, Seed, Samples, bLimitReached, SampleError))
+        {
+            return CreateErrorResponse(SampleError);
+        }
+    }
+    else
+    {
+        double SplineWidth = MCPConstants::DEFAULT_SCATTER_SPLINE_WIDTH;
+        Params->TryGetNumberField(FStringView(TEXT("width")), SplineWidth);
+        SplineWidth = FMath::Max(SplineWidth, 1.0);
+
+        // Samples are generated in a flat 2D domain: the box footprint, or (distance, offset) along the spline
+        const FVector2D DomainSize = Region == EScatterRegion::Box
+            ? FVector2D(Box.GetSize().X, Box.GetSize().Y)
+            : FVector2D(Spline->GetSplineLength(), SplineWidth);
+
+        TArray<FVector2D> Points;
+        if (bPoisson)
+        {
+            const double Radius = MinDistance > 0.0 ? MinDistance : 100.0 * FMath::Sqrt(PoissonPackingDensity / Density);
+            if (!SamplePoissonDisk2D(DomainSize, Radius, MaxInstances, Seed, Points, bLimitReached, SampleError))
+            {
+                return CreateErrorResponse(SampleError);
+            }
+        }
+        else
+        {
+            const double Spacing = Density > 0.0 ? 100.0 / FMath::Sqrt(Density) : MinDistance;
+            bLimitReached = SampleJitteredGrid2D(DomainSize, Spacing, Jitter, MaxInstances, Seed, Points);
+        }
+
+        Samples.SetNum(Points.Num());
+        ParallelFor(Points.Num(), [&Samples, &Points, &Box, Spline, Region, bProject, SplineWidth](int32 Index)
+        {
+            const FVector2D& Point = Points[Index];
+            FScatterSample& Sample = Samples[Index];
+            if (Region == EScatterRegion::Box)
+            {
+                Sample.Location = FVector(Box.Min.X + Point.X, Box.Min.Y + Point.Y, bProject ? Box.Max.Z : Box.Min.Z);
+            }
+            else
+            {
+                const FVector Right = Spline->GetRightVectorAtDistanceAlongSpline(Point.X, ESplineCoordinateSpace::World);
+                Sample.Location = Spline->GetLocationAtDistanceAlongSpline(Point.X, ESplineCoordinateSpace::World) + Right * (Point.Y - SplineWidth * 0.5);
+                Sample.Normal = Spline->GetUpVectorAtDistanceAlongSpline(Point.X, ESplineCoordinateSpace::World);
+            }
+        });
+    }
+
+    // Project onto geometry and build the final transforms in parallel
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MCPScatter), /*bTraceComplex*/ true);
+    if (HostActor)
+    {
+        QueryParams.AddIgnoredActor(HostActor);
+    }
+
+    TArray<FTransform> Transforms;
+    Transforms.SetNum(Samples.Num());
+    ParallelFor(Samples.Num(), [&](int32 Index)
+    {
+        FScatterSample& Sample = Samples[Index];
+        if (bProject)
+        {
+            const FVector Start = Region == EScatterRegion::Box ? Sample.Location : Sample.Location + FVector::UpVector * TraceDistance;
+            const FVector End = Region == EScatterRegion::Box
+                ? FVector(Sample.Location.X, Sample.Location.Y, Box.Min.Z)
+                : Sample.Location - FVector::UpVector * TraceDistance;
+
+            FHitResult Hit;
+            if (!World->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, QueryParams))
+            {
+                Sample.Drop = EScatterDrop::NoHit;
+                return;
+            }
+            if (Hit.ImpactNormal.Z < MinNormalZ)
+            {
+                Sample.Drop = EScatterDrop::Slope;
+                return;
+            }
+
+            Sample.Location = Hit.ImpactPoint;
+            Sample.Normal = Hit.ImpactNormal;
+        }
+
+        FRandomStream Random = MakeSampleStream(Seed ^ 0x5CA77E12, Index);
+        FQuat Rotation = FRotator(
+            Random.FRandRange(PitchRange.X, PitchRange.Y),
+            Random.FRandRange(YawRange.X, YawRange.Y),
+            Random.FRandRange(RollRange.X, RollRange.Y)).Quaternion();
+        if (bAlignToNormal)
+        {
+            Rotation = FQuat::FindBetweenNormals(FVector::UpVector, Sample.Normal) * Rotation;
+        }
+
+        Transforms[Index] = FTransform(Rotation, Sample.Location, FVector(Random.FRandRange(ScaleRange.X, ScaleRange.Y)));
+    });
+
+    int32 DroppedNoHit = 0;
+    int32 DroppedSlope = 0;
+    if (bProject)
+    {
+        int32 WriteIndex = 0;
+        for (int32 Index = 0; Index < Samples.Num(); ++Index)
+        {
+            switch (Samples[Index].Drop)
+            {
+            case EScatterDrop::None:
+                Transforms[WriteIndex++] = Transforms[Index];
+                break;
+            case EScatterDrop::NoHit:
+                ++DroppedNoHit;
+                break;
+            case EScatterDrop::Slope:
+                ++DroppedSlope;
+                break;
+            }
+        }
+        Transforms.SetNum(WriteIndex);
+    }
+    const int32 DroppedCount = DroppedNoHit + DroppedSlope;
+
+    // Samples that hit nothing usually mean the region has no collision below it, or the trace is too short
+    TArray<FString> Warnings;
+    if (DroppedNoHit > 0)
+    {
+        Warnings.Add(FString::Printf(TEXT("%d of %d samples found no visibility collision within the projection trace (trace_distance %.0f)"),
+            DroppedNoHit, Samples.Num(), Region == EScatterRegion::Box ? Box.GetSize().Z : TraceDistance));
+    }
+    if (DroppedSlope > 0)
+    {
+        Warnings.Add(FString::Printf(TEXT("%d of %d samples hit surfaces steeper than max_slope %.1f"), DroppedSlope, Samples.Num(), MaxSlope));
+    }
+    if (bLimitReached)
+    {
+        Warnings.Add(FString::Printf(TEXT("The region holds more than max_instances %d samples; a random subset was kept"), MaxInstances));
+    }
+
+    if (Transforms.Num() == 0)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Scatter produced no instances (%d samples): %s"), Samples.Num(),
+            Warnings.Num() > 0 ? *FString::Join(Warnings, TEXT("; ")) : TEXT("no samples were generated")));
+    }
+
+    bool bHierarchical = true;
+    Params->TryGetBoolField(FStringView(TEXT("hierarchical")), bHierarchical);
+
+    bool bReplace = false;
+    Params->TryGetBoolField(FStringView(TEXT("replace")), bReplace);
+
+    const FScopedTransaction Transaction(NSLOCTEXT("UnrealMCP", "ScatterInstances", "Scatter Instances"));
+
+    bool bCreatedHost = false;
+    if (!HostActor)
+    {
+        if (Label.IsEmpty())
+        {
+            Label = FString::Printf(TEXT("MCP_Scatter_%s"), *Mesh->GetName());
+        }
+
+        HostActor = FMCPInstancingUtils::SpawnInstanceHostActor(World, Transforms[0].GetLocation(), Label);
+        if (!HostActor)
+        {
+            return CreateErrorResponse(TEXT("Failed to spawn instance host actor"));
+        }
+        bCreatedHost = true;
+    }
+
+    HostActor->Modify();
+
+    bool bCreatedComponent = false;
+    UInstancedStaticMeshComponent* Component = FMCPInstancingUtils::FindOrCreateInstanceComponent(HostActor, Mesh, bHierarchical, bCreatedComponent);
+    if (!Component)
+    {
+        return CreateErrorResponse(TEXT("Failed to create instanced static mesh component"));
+    }
+
+    Component->Modify();
+    if (bReplace)
+    {
+        Component->ClearInstances();
+    }
+
+    const int32 FirstIndex = FMCPInstancingUtils::AddInstances(Component, Transforms, /*bWorldSpace*/ true, TArray<float>(), 0);
+    FMCPSceneChangeTracker::Get().MarkActorDirty(HostActor);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("actor"), HostActor->GetName());
+    Result->SetStringField(TEXT("label"), HostActor->GetActorLabel());
+    Result->SetStringField(TEXT("component"), Component->GetName());
+    Result->SetStringField(TEXT("region"), RegionName.ToLower());
+    Result->SetStringField(TEXT("method"), bPoisson ? TEXT("poisson") : TEXT("grid"));
+    Result->SetBoolField(TEXT("created_actor"), bCreatedHost);
+    Result->SetBoolField(TEXT("created_component"), bCreatedComponent);
+    Result->SetNumberField(TEXT("samples"), Samples.Num());
+    Result->SetNumberField(TEXT("dropped"), DroppedCount);
+    Result->SetNumberField(TEXT("dropped_no_hit"), DroppedNoHit);
+    Result->SetNumberField(TEXT("dropped_slope"), DroppedSlope);
+    Result->SetBoolField(TEXT("limit_reached"), bLimitReached);
+    Result->SetNumberField(TEXT("first_index"), FirstIndex);
+    Result->SetNumberField(TEXT("instances_added"), Transforms.Num());
+    Result->SetNumberField(TEXT("instance_count"), Component->GetInstanceCount());
+    if (Warnings.Num() > 0)
+    {
+        TArray<TSharedPtr<FJsonValue>> WarningArray;
+        for (const FString& Warning : Warnings)
+        {
+            WarningArray.Add(MakeShared<FJsonValueString>(Warning));
+        }
+        Result->SetArrayField(TEXT("warnings"), WarningArray);
+    }
+
+    MCP_LOG_INFO("Scattered %d instances of %s on %s (%d samples, %d dropped)",
+        Transforms.Num(), *Mesh->GetName(), *HostActor->GetActorLabel(), Samples.Num(), DroppedCount);
+    return CreateSuccessResponse(Result);
+}
+
+TSharedPtr<FJsonObject> FMCPConsolidateInstancesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling consolidate_instances command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    // Optional filters: region box, folder prefix and mesh path
+    FBox Region(ForceInit);
+    const TSharedPtr<FJsonObject>* BoundsObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("bounds")), BoundsObject) && BoundsObject && BoundsObject->IsValid())
+    {
+        FVector Min;
+        FVector Max;
+        if (!TryGetVectorField(*BoundsObject, TEXT("min"), Min) || !TryGetVectorField(*BoundsObject, TEXT("max"), Max))
+        {
+            return CreateErrorResponse(TEXT("'bounds' requires 'min' and 'max' [x, y, z]"));
+        }
+        Region = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+    }
+
+    FString Folder;
+    Params->TryGetStringField(FStringView(TEXT("folder")), Folder);
+
+    FString MeshFilter;
+    Params->TryGetStringField(FStringView(TEXT("mesh")), MeshFilter);
+
+    int32 MinGroupSize = 2;
+    Params->TryGetNumberField(FStringView(TEXT("min_group_size")), MinGroupSize);
+    MinGroupSize = FMath::Max(MinGroupSize, 1);
+
+    bool bHierarchical = true;
+    Params->TryGetBoolField(FStringView(TEXT("hierarchical")), bHierarchical);
+
+    bool bDryRun = false;
+    Params->TryGetBoolField(FStringView(TEXT("dry_run")), bDryRun);
+
+    // In a World Partition level, one host spanning the whole map would be streamed as a single
+    // huge actor, so spatially loaded candidates are also split by streaming cell
+    double CellSize = MCPConstants::DEFAULT_CONSOLIDATE_CELL_SIZE;
+    Params->TryGetNumberField(FStringView(TEXT("cell_size")), CellSize);
+    const bool bSplitByCell = World->GetWorldPartition() != nullptr && CellSize > 0.0;
+
+    // Group candidates by mesh + material set + consolidation signature. Actors with attached
+    // children, or whose component has been edited away from a plain static mesh, are left alone.
+    TArray<FConsolidationGroup> Groups;
+    TMap<uint32, TArray<int32, TInlineAllocator<1>>> GroupsByHash;
+    int32 SkippedCount = 0;
+
+    for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
+    {
+        AStaticMeshActor* Actor = *It;
+        UStaticMeshComponent* MeshComponent = Actor->GetStaticMeshComponent();
+        UStaticMesh* Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+        if (!Mesh || Actor->IsTemplate() || Actor->IsChildActor())
+        {
+            continue;
+        }
+
+        if (Region.IsValid && !Region.IsInsideOrOn(Actor->GetActorLocation()))
+        {
+            continue;
+        }
+
+        if (!Folder.IsEmpty() && !Actor->GetFolderPath().ToString().StartsWith(Folder))
+        {
+            continue;
+        }
+
+        if (!MeshFilter.IsEmpty() && Mesh->GetPathName() != MeshFilter && Mesh->GetName() != MeshFilter)
+        {
+            continue;
+        }
+
+        TArray<AActor*> AttachedActors;
+        Actor->GetAttachedActors(AttachedActors);
+        if (AttachedActors.Num() > 0 || Actor->GetComponents().Num() > 1)
+        {
+            ++SkippedCount;
+            continue;
+        }
+
+        TArray<UMaterialInterface*> Materials;
+        uint32 Hash = GetTypeHash(Mesh);
+        for (int32 MaterialIndex = 0; MaterialIndex < MeshComponent->GetNumMaterials(); ++MaterialIndex)
+        {
+            UMaterialInterface* Material = MeshComponent->GetMaterial(MaterialIndex);
+            Materials.Add(Material);
+            Hash = HashCombine(Hash, GetTypeHash(Material));
+        }
+
+        FString Signature = BuildConsolidationSignature(Actor, MeshComponent);
+        Hash = HashCombine(Hash, GetTypeHash(Signature));
+
+        const bool bHasCell = bSplitByCell && Actor->GetIsSpatiallyLoaded();
+        const FIntPoint Cell = bHasCell
+            ? FIntPoint(FMath::FloorToInt(Actor->GetActorLocation().X / CellSize), FMath::FloorToInt(Actor->GetActorLocation().Y / CellSize))
+            : FIntPoint::ZeroValue;
+        Hash = HashCombine(Hash, GetTypeHash(Cell));
+
+        TArray<int32, TInlineAllocator<1>>& Candidates = GroupsByHash.FindOrAdd(Hash);
+        int32 GroupIndex = INDEX_NONE;
+        for (const int32 Candidate : Candidates)
+        {
+            const FConsolidationGroup& Group = Groups[Candidate];
+            if (Group.Mesh == Mesh && Group.bHasCell == bHasCell && Group.Cell == Cell && Group.Materials == Materials && Group.Signature == Signature)
+            {
+                GroupIndex = Candidate;
+                break;
+            }
+        }
+
+        if (GroupIndex == INDEX_NONE)
+        {
+            GroupIndex = Groups.AddDefaulted();
+            Groups[GroupIndex].Mesh = Mesh;
+            Groups[GroupIndex].Materials = MoveTemp(Materials);
+            Groups[GroupIndex].Signature = MoveTemp(Signature);
+            Groups[GroupIndex].bHasCell = bHasCell;
+            Groups[GroupIndex].Cell = Cell;
+            Candidates.Add(GroupIndex);
+        }
+        Groups[GroupIndex].Actors.Add(Actor);
+    }
+
+    Groups.RemoveAll([MinGroupSize](const FConsolidationGroup& Group) { return Group.Actors.Num() < MinGroupSize; });
+
+    const int32 PrimitivesBefore = CountPrimitiveComponents(World);
+    int32 ActorsReplaced = 0;
+    TArray<TSharedPtr<FJsonValue>> GroupResults;
+
+    {
+        const FScopedTransaction Transaction(NSLOCTEXT("UnrealMCP", "ConsolidateInstances", "Consolidate Static Mesh Actors"), !bDryRun);
+
+        for (FConsolidationGroup& Group : Groups)
+        {
+            TArray<FTransform> Transforms;
+            Transforms.Reserve(Group.Actors.Num());
+            FVector Centroid = FVector::ZeroVector;
+            FName GroupFolder = Group.Actors[0]->GetFolderPath();
+            for (const AStaticMeshActor* Actor : Group.Actors)
+            {
+                Transforms.Add(Actor->GetActorTransform());
+                Centroid += Actor->GetActorLocation();
+                if (Actor->GetFolderPath() != GroupFolder)
+                {
+                    GroupFolder = NAME_None;
+                }
+            }
+            Centroid /= Group.Actors.Num();
+
+            TSharedPtr<FJsonObject> GroupResult = MakeShared<FJsonObject>();
+            GroupResult->SetStringField(TEXT("mesh"), Group.Mesh->GetPathName());
+            GroupResult->SetNumberField(TEXT("material_count"), Group.Materials.Num());
+            GroupResult->SetNumberField(TEXT("actor_count"), Group.Actors.Num());
+            if (Group.bHasCell)
+            {
+                TArray<TSharedPtr<FJsonValue>> CellValues;
+                CellValues.Add(MakeShared<FJsonValueNumber>(Group.Cell.X));
+                CellValues.Add(MakeShared<FJsonValueNumber>(Group.Cell.Y));
+                GroupResult->SetArrayField(TEXT("cell"), CellValues);
+            }
+
+            if (!bDryRun)
+            {
+                AActor* HostActor = FMCPInstancingUtils::SpawnInstanceHostActor(World, Centroid, FString::Printf(TEXT("MCP_HISM_%s"), *Group.Mesh->GetName()));
+                if (!HostActor)
+                {
+                    MCP_LOG_WARNING("Failed to spawn host for %s; leaving %d actors in place", *Group.Mesh->GetName(), Group.Actors.Num());
+                    continue;
+                }
+                if (!GroupFolder.IsNone())
+                {
+                    HostActor->SetFolderPath(GroupFolder);
+                }
+
+                bool bCreatedComponent = false;
+                UInstancedStaticMeshComponent* Component = FMCPInstancingUtils::FindOrCreateInstanceComponent(HostActor, Group.Mesh, bHierarchical, bCreatedComponent);
+                if (!Component)
+                {
+                    World->EditorDestroyActor(HostActor, true);
+                    continue;
+                }
+
+                for (int32 MaterialIndex = 0; MaterialIndex < Group.Materials.Num(); ++MaterialIndex)
+                {
+                    if (Group.Materials[MaterialIndex] != Group.Mesh->GetMaterial(MaterialIndex))
+                    {
+                        Component->SetMaterial(MaterialIndex, Group.Materials[MaterialIndex]);
+                    }
+                }
+
+                // Every actor in the group shares these settings, so the first one speaks for all of them
+                CopyConsolidatedSettings(Group.Actors[0], HostActor, Component);
+                FMCPInstancingUtils::AddInstances(Component, Transforms, /*bWorldSpace*/ true, TArray<float>(), 0);
+                FMCPSceneChangeTracker::Get().MarkActorDirty(HostActor);
+
+                for (AStaticMeshActor* Actor : Group.Actors)
+                {
+                    World->EditorDestroyActor(Actor, true);
+                }
+
+                GroupResult->SetStringField(TEXT("actor"), HostActor->GetName());
+                GroupResult->SetStringField(TEXT("label"), HostActor->GetActorLabel());
+                GroupResult->SetStringField(TEXT("component"), Component->GetName());
+            }
+
+            ActorsReplaced += Group.Actors.Num();
+            GroupResults.Add(MakeShared<FJsonValueObject>(GroupResult));
+        }
+    }
+
+    const int32 PrimitivesAfter = bDryRun ? PrimitivesBefore - ActorsReplaced + GroupResults.Num() : CountPrimitiveComponents(World);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetBoolField(TEXT("dry_run"), bDryRun);
+    Result->SetNumberField(TEXT("group_count"), GroupResults.Num());
+    Result->SetNumberField(TEXT("actors_replaced"), ActorsReplaced);
+    Result->SetNumberField(TEXT("actors_skipped"), SkippedCount);
+    Result->SetNumberField(TEXT("primitives_before"), PrimitivesBefore);
+    Result->SetNumberField(TEXT("primitives_after"), PrimitivesAfter);
+    Result->SetArrayField(TEXT("groups"), GroupResults);
+
+    MCP_LOG_INFO("consolidate_instances: %d actors in %d groups, primitives %d -> %d%s",
+        ActorsReplaced, GroupResults.Num(), PrimitivesBefore, PrimitivesAfter, bDryRun ? TEXT(" (dry run)") : TEXT(""));
+    return CreateSuccessResponse(Result);
+}
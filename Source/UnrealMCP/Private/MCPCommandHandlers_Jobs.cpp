@@ -0,0 +1,372 @@
+#include "MCPCommandHandlers_Jobs.h"
+
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/Guid.h"
+
+namespace
+{
+    const TCHAR* JobStateToString(EMCPJobState State)
+    {
+        switch (State)
+        {
+        case EMCPJobState::Running:
+            return TEXT("running");
+        case EMCPJobState::Succeeded:
+            return TEXT("succeeded");
+        case EMCPJobState::Failed:
+            return TEXT("failed");
+        case EMCPJobState::Cancelled:
+            return TEXT("cancelled");
+        }
+        return TEXT("unknown");
+    }
+
+    TSharedPtr<FJsonObject> JobStatusToJson(const FMCPJobStatus& Status, int32 OutputFrom = INDEX_NONE)
+    {
+        const double EndTime = Status.State == EMCPJobState::Running ? FPlatformTime::Seconds() : Status.FinishTime;
+
+        TSharedPtr<FJsonObject> JobObject = MakeShared<FJsonObject>();
+        JobObject->SetStringField(TEXT("job_id"), Status.Id);
+        JobObject->SetStringField(TEXT("type"), Status.Type);
+        JobObject->SetStringField(TEXT("state"), JobStateToString(Status.State));
+        JobObject->SetNumberField(TEXT("progress"), Status.Progress);
+        JobObject->SetStringField(TEXT("message"), Status.Message);
+        JobObject->SetBoolField(TEXT("cancel_requested"), Status.bCancelRequested);
+        JobObject->SetNumberField(TEXT("elapsed_seconds"), EndTime - Status.StartTime);
+        if (Status.Result.IsValid())
+        {
+            JobObject->SetObjectField(TEXT("result"), Status.Result);
+        }
+
+        // Line numbers count dropped lines too, so a client's offset stays valid
+        const int32 OutputLineCount = Status.DroppedOutputLines + Status.Output.Num();
+        JobObject->SetNumberField(TEXT("output_lines"), OutputLineCount);
+        if (OutputFrom >= 0)
+        {
+            TArray<TSharedPtr<FJsonValue>> Lines;
+            for (int32 Index = FMath::Max(OutputFrom - Status.DroppedOutputLines, 0); Index < Status.Output.Num(); ++Index)
+            {
+                Lines.Add(MakeShared<FJsonValueString>(Status.Output[Index]));
+            }
+            JobObject->SetArrayField(TEXT("output"), Lines);
+            JobObject->SetNumberField(TEXT("output_from"), FMath::Max(OutputFrom, Status.DroppedOutputLines));
+        }
+        return JobObject;
+    }
+}
+
+//
+// FMCPJobRegistry
+//
+
+FMCPJobRegistry& FMCPJobRegistry::Get()
+{
+    static FMCPJobRegistry Instance;
+    return Instance;
+}
+
+FString FMCPJobRegistry::CreateJob(const FString& Type)
+{
+    FMCPJobStatus Status;
+    Status.Id = FGuid::NewGuid().ToString(EGuidFormats::Digits).ToLower();
+    Status.Type = Type;
+    Status.StartTime = FPlatformTime::Seconds();
+
+    const FString JobId = Status.Id;
+    {
+        FScopeLock ScopeLock(&JobsLock);
+        Jobs.Add(JobId, MoveTemp(Status));
+        PruneFinishedJobs();
+    }
+
+    MCP_LOG_INFO("Started %s job %s", *Type, *JobId);
+    return JobId;
+}
+
+FString FMCPJobRegistry::StartTickedJob(const FString& Type, FJobStep Step, FJobCancel OnCancel)
+{
+    check(IsInGameThread());
+
+    const FString JobId = CreateJob(Type);
+    TSharedPtr<FTickedJob> TickedJob = MakeShared<FTickedJob>();
+    TickedJob->Step = MoveTemp(Step);
+    TickedJob->OnCancel = MoveTemp(OnCancel);
+    TickedJobs.Add(JobId, TickedJob);
+
+    if (!TickerHandle.IsValid())
+    {
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMCPJobRegistry::Tick));
+    }
+    return JobId;
+}
+
+void FMCPJobRegistry::SetProgress(const FString& JobId, float Progress, const FString& Message)
+{
+    FScopeLock ScopeLock(&JobsLock);
+    if (FMCPJobStatus* Status = Jobs.Find(JobId))
+    {
+        Status->Progress = FMath::Clamp(Progress, 0.0f, 1.0f);
+        Status->Message = Message;
+    }
+}
+
+void FMCPJobRegistry::AppendOutput(const FString& JobId, const TArray<FString>& Lines)
+{
+    if (Lines.Num() == 0)
+    {
+        return;
+    }
+
+    FScopeLock ScopeLock(&JobsLock);
+    if (FMCPJobStatus* Status = Jobs.Find(JobId))
+    {
+        Status->Output.Append(Lines);
+        const int32 ExcessCount = Status->Output.Num() - MCPConstants::MAX_JOB_OUTPUT_LINES;
+        if (ExcessCount > 0)
+        {
+            Status->Output.RemoveAt(0, ExcessCount);
+            Status->DroppedOutputLines += ExcessCount;
+        }
+    }
+}
+
+void FMCPJobRegistry::CompleteJob(const FString& JobId, const TSharedPtr<FJsonObject>& Result)
+{
+    FinishJob(JobId, EMCPJobState::Succeeded, TEXT("Completed"), Result);
+}
+
+void FMCPJobRegistry::FailJob(const FString& JobId, const FString& Error)
+{
+    MCP_LOG_WARNING("Job %s failed: %s", *JobId, *Error);
+    FinishJob(JobId, EMCPJobState::Failed, Error, nullptr);
+}
+
+void FMCPJobRegistry::MarkCancelled(const FString& JobId)
+{
+    FinishJob(JobId, EMCPJobState::Cancelled, TEXT("Cancelled"), nullptr);
+}
+
+bool FMCPJobRegistry::RequestCancel(const FString& JobId)
+{
+    FScopeLock ScopeLock(&JobsLock);
+    FMCPJobStatus* Status = Jobs.Find(JobId);
+    if (!Status || Status->State != EMCPJobState::Running)
+    {
+        return false;
+    }
+
+    Status->bCancelRequested = true;
+    return true;
+}
+
+bool FMCPJobRegistry::IsCancelRequested(const FString& JobId) const
+{
+    FScopeLock ScopeLock(&JobsLock);
+    const FMCPJobStatus* Status = Jobs.Find(JobId);
+    return Status && Status->bCancelRequested;
+}
+
+bool FMCPJobRegistry::IsFinished(const FString& JobId) const
+{
+    FScopeLock ScopeLock(&JobsLock);
+    const FMCPJobStatus* Status = Jobs.Find(JobId);
+    return !Status || Status->State != EMCPJobState::Running;
+}
+
+TSharedPtr<FJsonObject> FMCPJobRegistry::GetJobJson(const FString& JobId, int32 OutputFrom) const
+{
+    FScopeLock ScopeLock(&JobsLock);
+    const FMCPJobStatus* Status = Jobs.Find(JobId);
+    return Status ? JobStatusToJson(*Status, OutputFrom) : nullptr;
+}
+
+TArray<TSharedPtr<FJsonValue>> FMCPJobRegistry::ListJobsJson() const
+{
+    FScopeLock ScopeLock(&JobsLock);
+
+    TArray<const FMCPJobStatus*> Sorted;
+    for (const TPair<FString, FMCPJobStatus>& Pair : Jobs)
+    {
+        Sorted.Add(&Pair.Value);
+    }
+    Sorted.Sort([](const FMCPJobStatus& A, const FMCPJobStatus& B) { return A.StartTime < B.StartTime; });
+
+    TArray<TSharedPtr<FJsonValue>> JobValues;
+    for (const FMCPJobStatus* Status : Sorted)
+    {
+        JobValues.Add(MakeShared<FJsonValueObject>(JobStatusToJson(*Status)));
+    }
+    return JobValues;
+}
+
+void FMCPJobRegistry::Shutdown()
+{
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+
+    TMap<FString, TSharedPtr<FTickedJob>> PendingJobs = MoveTemp(TickedJobs);
+    TickedJobs.Empty();
+    for (const TPair<FString, TSharedPtr<FTickedJob>>& Pair : PendingJobs)
+    {
+        if (Pair.Value->OnCancel)
+        {
+            Pair.Value->OnCancel(Pair.Key);
+        }
+        MarkCancelled(Pair.Key);
+    }
+}
+
+bool FMCPJobRegistry::Tick(float DeltaTime)
+{
+    // Steps may start new jobs, so iterate over a copy of the ids
+    TArray<FString> JobIds;
+    TickedJobs.GetKeys(JobIds);
+
+    for (const FString& JobId : JobIds)
+    {
+        const TSharedPtr<FTickedJob> TickedJob = TickedJobs.FindRef(JobId);
+        if (IsCancelRequested(JobId))
+        {
+            TickedJobs.Remove(JobId);
+            if (TickedJob.IsValid() && TickedJob->OnCancel)
+            {
+                // Unwinding may run script code, so treat it like a step that edited the scene
+                TickedJob->OnCancel(JobId);
+                FMCPSceneChangeTracker::Get().MarkFullRescan();
+                FMCPSceneSnapshotPublisher::Get().MarkDirty();
+            }
+            MarkCancelled(JobId);
+            continue;
+        }
+
+        bool bEditedScene = false;
+        const bool bDone = !TickedJob.IsValid() || TickedJob->Step(JobId, bEditedScene) || IsFinished(JobId);
+
+        // Steps that only poll (e.g. for compiling meshes) leave the scene caches alone
+        if (bEditedScene)
+        {
+            FMCPSceneChangeTracker::Get().MarkFullRescan();
+            FMCPSceneSnapshotPublisher::Get().MarkDirty();
+        }
+
+        if (bDone)
+        {
+            TickedJobs.Remove(JobId);
+            if (!IsFinished(JobId))
+            {
+                CompleteJob(JobId, nullptr);
+            }
+        }
+    }
+
+    if (TickedJobs.Num() == 0)
+    {
+        TickerHandle.Reset();
+        return false;
+    }
+    return true;
+}
+
+void FMCPJobRegistry::FinishJob(const FString& JobId, EMCPJobState State, const FString& Message, const TSharedPtr<FJsonObject>& Result)
+{
+    FScopeLock ScopeLock(&JobsLock);
+    FMCPJobStatus* Status = Jobs.Find(JobId);
+    if (!Status || Status->State != EMCPJobState::Running)
+    {
+        return;
+    }
+
+    Status->State = State;
+    Status->Message = Message;
+    Status->Result = Result;
+    Status->FinishTime = FPlatformTime::Seconds();
+    if (State == EMCPJobState::Succeeded)
+    {
+        Status->Progress = 1.0f;
+    }
+}
+
+void FMCPJobRegistry::PruneFinishedJobs()
+{
+    // Caller holds JobsLock
+    TArray<const FMCPJobStatus*> Finished;
+    for (const TPair<FString, FMCPJobStatus>& Pair : Jobs)
+    {
+        if (Pair.Value.State != EMCPJobState::Running)
+        {
+            Finished.Add(&Pair.Value);
+        }
+    }
+
+    const int32 ExcessCount = Finished.Num() - MCPConstants::MAX_RETAINED_JOBS;
+    if (ExcessCount <= 0)
+    {
+        return;
+    }
+
+    Finished.Sort([](const FMCPJobStatus& A, const FMCPJobStatus& B) { return A.FinishTime < B.FinishTime; });
+    TArray<FString> ExpiredIds;
+    for (int32 Index = 0; Index < ExcessCount; ++Index)
+    {
+        ExpiredIds.Add(Finished[Index]->Id);
+    }
+    for (const FString& JobId : ExpiredIds)
+    {
+        Jobs.Remove(JobId);
+    }
+}
+
+//
+// FMCPGetJobStatusHandler
+//
+
+TSharedPtr<FJsonObject> FMCPGetJobStatusHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    FString JobId;
+    Params->TryGetStringField(FStringView(TEXT("job_id")), JobId);
+
+    int32 OutputFrom = INDEX_NONE;
+    Params->TryGetNumberField(FStringView(TEXT("output_from")), OutputFrom);
+
+    if (JobId.IsEmpty())
+    {
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetArrayField(TEXT("jobs"), FMCPJobRegistry::Get().ListJobsJson());
+        return CreateSuccessResponse(Result);
+    }
+
+    TSharedPtr<FJsonObject> JobObject = FMCPJobRegistry::Get().GetJobJson(JobId, OutputFrom);
+    if (!JobObject.IsValid())
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown or expired job: %s"), *JobId));
+    }
+    return CreateSuccessResponse(JobObject);
+}
+
+//
+// FMCPCancelJobHandler
+//
+
+TSharedPtr<FJsonObject> FMCPCancelJobHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    FString JobId;
+    if (!Params->TryGetStringField(FStringView(TEXT("job_id")), JobId) || JobId.IsEmpty())
+    {
+        return CreateErrorResponse(TEXT("Missing 'job_id' field"));
+    }
+
+    if (!FMCPJobRegistry::Get().RequestCancel(JobId))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Job %s is not running"), *JobId));
+    }
+
+    MCP_LOG_INFO("Cancellation requested for job %s", *JobId);
+    return CreateSuccessResponse(FMCPJobRegistry::Get().GetJobJson(JobId));
+}
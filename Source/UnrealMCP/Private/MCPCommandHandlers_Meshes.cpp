@@ -0,0 +1,1527 @@
+#include "MCPCommandHandlers_Meshes.h"
+
+#include "MCPCommandHandlers_Instancing.h"
+#include "MCPCommandHandlers_Jobs.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetToolsModule.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Editor.h"
+#include "Engine/MeshMerging.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "IMeshMergeUtilities.h"
+#include "Materials/MaterialInterface.h"
+#include "Math/VectorRegister.h"
+#include "MeshDescription.h"
+#include "MeshMergeModule.h"
+#include "ObjectTools.h"
+#include "Misc/PackageName.h"
+#include "Modules/ModuleManager.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "ScopedTransaction.h"
+#include "Serialization/JsonSerializer.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshResources.h"
+
+namespace
+{
+    bool TryGetVectorField(const TSharedPtr<FJsonObject>& Object, const TCHAR* FieldName, FVector& OutVector)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (!Object->TryGetArrayField(FStringView(FieldName), Values) || !Values || Values->Num() != 3)
+        {
+            return false;
+        }
+
+        OutVector = FVector((*Values)[0]->AsNumber(), (*Values)[1]->AsNumber(), (*Values)[2]->AsNumber());
+        return true;
+    }
+
+    /**
+     * Resolve the actors a mesh command operates on: an explicit 'actors' list of names or labels,
+     * and/or every actor inside 'bounds' or under 'folder'.
+     */
+    bool CollectTargetActors(UWorld* World, const TSharedPtr<FJsonObject>& Params, TArray<AActor*>& OutActors, FString& OutErrorMessage)
+    {
+        TSet<FString> RequestedNames;
+        const TArray<TSharedPtr<FJsonValue>>* ActorValues = nullptr;
+        if (Params->TryGetArrayField(FStringView(TEXT("actors")), ActorValues) && ActorValues)
+        {
+            for (const TSharedPtr<FJsonValue>& ActorValue : *ActorValues)
+            {
+                RequestedNames.Add(ActorValue->AsString());
+            }
+        }
+
+        FBox Region(ForceInit);
+        const TSharedPtr<FJsonObject>* BoundsObject = nullptr;
+        if (Params->TryGetObjectField(FStringView(TEXT("bounds")), BoundsObject) && BoundsObject && BoundsObject->IsValid())
+        {
+            FVector Min;
+            FVector Max;
+            if (!TryGetVectorField(*BoundsObject, TEXT("min"), Min) || !TryGetVectorField(*BoundsObject, TEXT("max"), Max))
+            {
+                OutErrorMessage = TEXT("'bounds' requires 'min' and 'max' [x, y, z]");
+                return false;
+            }
+            Region = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+        }
+
+        FString Folder;
+        Params->TryGetStringField(FStringView(TEXT("folder")), Folder);
+
+        if (RequestedNames.Num() == 0 && !Region.IsValid && Folder.IsEmpty())
+        {
+            OutErrorMessage = TEXT("Specify 'actors', 'bounds' or 'folder'");
+            return false;
+        }
+
+        TSet<FString> FoundNames;
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            AActor* Actor = *It;
+            const bool bNamed = RequestedNames.Contains(Actor->GetName()) || RequestedNames.Contains(Actor->GetActorLabel());
+            const bool bInRegion = Region.IsValid && Region.IsInsideOrOn(Actor->GetActorLocation());
+            const bool bInFolder = !Folder.IsEmpty() && Actor->GetFolderPath().ToString().StartsWith(Folder);
+
+            // Filters combine: a named actor is always included, region and folder must both match when both are given
+            const bool bFiltered = (Region.IsValid || !Folder.IsEmpty())
+                && (!Region.IsValid || bInRegion)
+                && (Folder.IsEmpty() || bInFolder);
+            if (bNamed || bFiltered)
+            {
+                OutActors.Add(Actor);
+            }
+            if (bNamed)
+            {
+                FoundNames.Add(Actor->GetName());
+                FoundNames.Add(Actor->GetActorLabel());
+            }
+        }
+
+        for (const FString& RequestedName : RequestedNames)
+        {
+            if (!FoundNames.Contains(RequestedName))
+            {
+                MCP_LOG_WARNING("Actor not found: %s", *RequestedName);
+            }
+        }
+
+        if (OutActors.Num() == 0)
+        {
+            OutErrorMessage = TEXT("No actors matched");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Merged sources are replaced by destroying the whole actor, so only actors made up entirely of
+     * mergeable static mesh components (plus bare scene roots and editor-only helpers) qualify.
+     * Anything else on the actor - lights, audio, other primitives, gameplay components or attached
+     * actors - would be lost with it.
+     */
+    bool CollectMergeableComponents(AActor* Actor, TArray<UStaticMeshComponent*>& OutComponents)
+    {
+        TArray<AActor*> AttachedActors;
+        Actor->GetAttachedActors(AttachedActors);
+        if (AttachedActors.Num() > 0)
+        {
+            return false;
+        }
+
+        OutComponents.Reset();
+        for (UActorComponent* Component : Actor->GetComponents())
+        {
+            if (!Component || Component->IsEditorOnly() || Component->GetClass() == USceneComponent::StaticClass())
+            {
+                continue;
+            }
+
+            // Instanced components are left to consolidate_instances
+            UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component);
+            if (!MeshComponent || !MeshComponent->GetStaticMesh() || MeshComponent->IsA<UInstancedStaticMeshComponent>())
+            {
+                return false;
+            }
+            OutComponents.Add(MeshComponent);
+        }
+        return OutComponents.Num() > 0;
+    }
+
+    /** State shared by the steps of one merge job */
+    struct FMergeJobState
+    {
+        TArray<TWeakObjectPtr<AActor>> SourceActors;
+        TArray<TWeakObjectPtr<UStaticMeshComponent>> Components;
+        FMeshMergingSettings Settings;
+        FString PackageName;
+        bool bReplaceSources = true;
+        int32 Phase = 0;
+
+        UStaticMesh* MergedMesh = nullptr;
+        TArray<FString> CreatedAssets;
+        FVector MergedLocation = FVector::ZeroVector;
+    };
+
+    /**
+     * One phase per editor tick so status polls and cancellation are serviced between them:
+     * validate sources, merge, then swap the sources for the merged actor.
+     */
+    bool RunMergeStep(const FString& JobId, FMergeJobState& State)
+    {
+        FMCPJobRegistry& Jobs = FMCPJobRegistry::Get();
+        UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+        if (!World)
+        {
+            Jobs.FailJob(JobId, TEXT("Editor world is not available"));
+            return true;
+        }
+
+        switch (State.Phase++)
+        {
+        case 0:
+        {
+            const int32 MissingCount = State.Components.RemoveAll([](const TWeakObjectPtr<UStaticMeshComponent>& Component) { return !Component.IsValid(); });
+            if (State.Components.Num() == 0)
+            {
+                Jobs.FailJob(JobId, TEXT("None of the source components exist any more"));
+                return true;
+            }
+            Jobs.SetProgress(JobId, 0.1f, FString::Printf(TEXT("Merging %d components (%d no longer exist)"), State.Components.Num(), MissingCount));
+            return false;
+        }
+
+        case 1:
+        {
+            TArray<UPrimitiveComponent*> ComponentsToMerge;
+            for (const TWeakObjectPtr<UStaticMeshComponent>& Component : State.Components)
+            {
+                if (Component.IsValid())
+                {
+                    ComponentsToMerge.Add(Component.Get());
+                }
+            }
+
+            const IMeshMergeUtilities& MergeUtilities = FModuleManager::Get().LoadModuleChecked<IMeshMergeModule>("MeshMergeUtilities").GetUtilities();
+            TArray<UObject*> AssetsToSync;
+            MergeUtilities.MergeComponentsToStaticMesh(ComponentsToMerge, World, State.Settings, nullptr, nullptr, State.PackageName,
+                AssetsToSync, State.MergedLocation, TNumericLimits<float>::Max(), /*bSilent*/ true);
+
+            for (UObject* Asset : AssetsToSync)
+            {
+                FAssetRegistryModule::AssetCreated(Asset);
+                Asset->MarkPackageDirty();
+                State.CreatedAssets.Add(Asset->GetPathName());
+                if (UStaticMesh* Mesh = Cast<UStaticMesh>(Asset))
+                {
+                    State.MergedMesh = Mesh;
+                }
+            }
+
+            if (!State.MergedMesh)
+            {
+                Jobs.FailJob(JobId, TEXT("Mesh merge did not produce a static mesh"));
+                return true;
+            }
+
+            Jobs.SetProgress(JobId, 0.8f, FString::Printf(TEXT("Created %s"), *State.MergedMesh->GetPathName()));
+            return false;
+        }
+
+        default:
+        {
+            TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+            Result->SetStringField(TEXT("mesh"), State.MergedMesh->GetPathName());
+            Result->SetNumberField(TEXT("component_count"), State.Components.Num());
+            Result->SetNumberField(TEXT("source_actor_count"), State.SourceActors.Num());
+
+            TArray<TSharedPtr<FJsonValue>> AssetValues;
+            for (const FString& AssetPath : State.CreatedAssets)
+            {
+                AssetValues.Add(MakeShared<FJsonValueString>(AssetPath));
+            }
+            Result->SetArrayField(TEXT("assets"), AssetValues);
+
+            if (State.bReplaceSources)
+            {
+                const FScopedTransaction Transaction(NSLOCTEXT("UnrealMCP", "MergeActors", "Merge Actors"));
+
+                FActorSpawnParameters SpawnParams;
+                SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+                AStaticMeshActor* MergedActor = World->SpawnActor<AStaticMeshActor>(State.MergedLocation, FRotator::ZeroRotator, SpawnParams);
+                if (!MergedActor)
+                {
+                    Jobs.FailJob(JobId, TEXT("Failed to spawn the merged actor; source actors were left in place"));
+                    return true;
+                }
+
+                MergedActor->GetStaticMeshComponent()->SetStaticMesh(State.MergedMesh);
+                MergedActor->SetActorLabel(State.MergedMesh->GetName());
+                FMCPSceneChangeTracker::Get().MarkActorDirty(MergedActor);
+
+                // Actors may have gained components while the merge ran; those are kept rather than destroyed
+                int32 RemovedCount = 0;
+                int32 KeptCount = 0;
+                TArray<UStaticMeshComponent*> ActorComponents;
+                for (const TWeakObjectPtr<AActor>& SourceActor : State.SourceActors)
+                {
+                    if (AActor* Actor = SourceActor.Get())
+                    {
+                        if (!CollectMergeableComponents(Actor, ActorComponents))
+                        {
+                            MCP_LOG_WARNING("merge_actors: %s changed during the merge and was left in place", *Actor->GetActorLabel());
+                            ++KeptCount;
+                            continue;
+                        }
+                        if (RemovedCount == 0)
+                        {
+                            MergedActor->SetFolderPath(Actor->GetFolderPath());
+                        }
+                        World->EditorDestroyActor(Actor, true);
+                        ++RemovedCount;
+                    }
+                }
+
+                Result->SetStringField(TEXT("actor"), MergedActor->GetName());
+                Result->SetStringField(TEXT("label"), MergedActor->GetActorLabel());
+                Result->SetNumberField(TEXT("removed_actor_count"), RemovedCount);
+                Result->SetNumberField(TEXT("kept_actor_count"), KeptCount);
+            }
+
+            MCP_LOG_INFO("merge_actors: merged %d components into %s", State.Components.Num(), *State.MergedMesh->GetPathName());
+            Jobs.CompleteJob(JobId, Result);
+            return true;
+        }
+        }
+    }
+
+    /** A mesh queued for LOD generation and what happened to it; the mesh is loaded by the job, not the request */
+    struct FLODTarget
+    {
+        TWeakObjectPtr<UStaticMesh> Mesh;
+        FSoftObjectPath Path;
+        int32 LODsBefore = 0;
+        FString SkipReason;
+        bool bReported = false;
+    };
+
+    /** State shared by the steps of one generate_lods job */
+    struct FLODJobState
+    {
+        TArray<FLODTarget> Targets;
+        int32 NumLODs = 4;
+        TArray<float> PercentTriangles;
+        TArray<float> ScreenSizes;
+        bool bOverwriteExisting = false;
+        int32 NextToConfigure = 0;
+        bool bBuildStarted = false;
+        TArray<TSharedPtr<FJsonValue>> AssetResults;
+    };
+
+    TSharedPtr<FJsonObject> MakeLODAssetResult(const FLODTarget& Target)
+    {
+        TSharedPtr<FJsonObject> AssetResult = MakeShared<FJsonObject>();
+        AssetResult->SetStringField(TEXT("mesh"), Target.Path.ToString());
+        AssetResult->SetNumberField(TEXT("lods_before"), Target.LODsBefore);
+
+        const UStaticMesh* Mesh = Target.Mesh.Get();
+        if (!Target.SkipReason.IsEmpty() || !Mesh)
+        {
+            AssetResult->SetStringField(TEXT("skipped"), Mesh ? Target.SkipReason : FString(TEXT("Mesh was unloaded")));
+            return AssetResult;
+        }
+
+        AssetResult->SetNumberField(TEXT("lods_after"), Mesh->GetNumLODs());
+        TArray<TSharedPtr<FJsonValue>> Triangles;
+        if (const FStaticMeshRenderData* RenderData = Mesh->GetRenderData())
+        {
+            for (const FStaticMeshLODResources& LOD : RenderData->LODResources)
+            {
+                Triangles.Add(MakeShared<FJsonValueNumber>(LOD.GetNumTriangles()));
+            }
+        }
+        AssetResult->SetArrayField(TEXT("triangles"), Triangles);
+        return AssetResult;
+    }
+
+    /** Write the reduction settings into the mesh's source models; the build happens later in one batch. */
+    void ConfigureLODs(UStaticMesh* Mesh, const FLODJobState& State)
+    {
+        Mesh->Modify();
+        Mesh->SetNumSourceModels(State.NumLODs);
+        Mesh->bAutoComputeLODScreenSize = State.ScreenSizes.Num() == 0;
+
+        for (int32 LODIndex = 1; LODIndex < State.NumLODs; ++LODIndex)
+        {
+            FStaticMeshSourceModel& SourceModel = Mesh->GetSourceModel(LODIndex);
+
+            // Generated LODs are reduced from LOD0 rather than imported
+            if (Mesh->IsMeshDescriptionValid(LODIndex))
+            {
+                Mesh->ClearMeshDescription(LODIndex);
+            }
+
+            SourceModel.ReductionSettings.PercentTriangles = State.PercentTriangles.IsValidIndex(LODIndex - 1)
+                ? State.PercentTriangles[LODIndex - 1]
+                : FMath::Pow(0.5f, static_cast<float>(LODIndex));
+            SourceModel.ReductionSettings.BaseLODModel = 0;
+            if (State.ScreenSizes.IsValidIndex(LODIndex - 1))
+            {
+                SourceModel.ScreenSize = State.ScreenSizes[LODIndex - 1];
+            }
+        }
+    }
+
+    /**
+     * Load and configure a batch of meshes per tick, hand them all to UStaticMesh::BatchBuild (which compiles
+     * on worker threads when async mesh compilation is enabled), then report meshes as they finish.
+     */
+    bool RunGenerateLODsStep(const FString& JobId, FLODJobState& State)
+    {
+        FMCPJobRegistry& Jobs = FMCPJobRegistry::Get();
+        const int32 NumTargets = State.Targets.Num();
+
+        if (State.NextToConfigure < NumTargets)
+        {
+            const int32 End = FMath::Min(State.NextToConfigure + MCPConstants::LOD_MESHES_CONFIGURED_PER_TICK, NumTargets);
+            for (; State.NextToConfigure < End; ++State.NextToConfigure)
+            {
+                FLODTarget& Target = State.Targets[State.NextToConfigure];
+                UStaticMesh* Mesh = Cast<UStaticMesh>(Target.Path.TryLoad());
+                if (!Mesh)
+                {
+                    Target.SkipReason = TEXT("Failed to load mesh");
+                    continue;
+                }
+                Target.Mesh = Mesh;
+
+                Target.LODsBefore = Mesh->GetNumSourceModels();
+                if (Target.LODsBefore > 1 && !State.bOverwriteExisting)
+                {
+                    Target.SkipReason = FString::Printf(TEXT("Already has %d LODs"), Target.LODsBefore);
+                    continue;
+                }
+                ConfigureLODs(Mesh, State);
+            }
+
+            Jobs.SetProgress(JobId, 0.1f * State.NextToConfigure / NumTargets,
+                FString::Printf(TEXT("Loaded and configured %d/%d meshes"), State.NextToConfigure, NumTargets));
+            return false;
+        }
+
+        if (!State.bBuildStarted)
+        {
+            TArray<UStaticMesh*> MeshesToBuild;
+            for (const FLODTarget& Target : State.Targets)
+            {
+                if (Target.SkipReason.IsEmpty() && Target.Mesh.IsValid())
+                {
+                    MeshesToBuild.Add(Target.Mesh.Get());
+                }
+            }
+
+            UStaticMesh::BatchBuild(MeshesToBuild, /*bInSilent*/ true);
+            State.bBuildStarted = true;
+            Jobs.SetProgress(JobId, 0.1f, FString::Printf(TEXT("Building %d meshes"), MeshesToBuild.Num()));
+            return false;
+        }
+
+        int32 FinishedCount = 0;
+        for (FLODTarget& Target : State.Targets)
+        {
+            const UStaticMesh* Mesh = Target.Mesh.Get();
+            const bool bDone = !Target.SkipReason.IsEmpty() || !Mesh || !Mesh->IsCompiling();
+            if (!bDone)
+            {
+                continue;
+            }
+
+            ++FinishedCount;
+            if (!Target.bReported)
+            {
+                Target.bReported = true;
+                if (Mesh && Target.SkipReason.IsEmpty())
+                {
+                    // BatchBuild already rebuilt the render data; PostEditChange here would build again
+                    Target.Mesh->MarkPackageDirty();
+                    MCP_LOG_VERBOSE("generate_lods: built %s with %d LODs", *Target.Path.ToString(), Mesh->GetNumLODs());
+                }
+                State.AssetResults.Add(MakeShared<FJsonValueObject>(MakeLODAssetResult(Target)));
+            }
+        }
+
+        Jobs.SetProgress(JobId, 0.1f + 0.9f * FinishedCount / NumTargets,
+            FString::Printf(TEXT("Built %d/%d meshes"), FinishedCount, NumTargets));
+
+        if (FinishedCount < NumTargets)
+        {
+            return false;
+        }
+
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetNumberField(TEXT("mesh_count"), NumTargets);
+        Result->SetNumberField(TEXT("num_lods"), State.NumLODs);
+        Result->SetArrayField(TEXT("assets"), State.AssetResults);
+        Jobs.CompleteJob(JobId, Result);
+        return true;
+    }
+
+    /** Read an optional number array, e.g. per-LOD percentages */
+    TArray<float> ReadFloatArray(const TSharedPtr<FJsonObject>& Params, const TCHAR* FieldName)
+    {
+        TArray<float> Values;
+        const TArray<TSharedPtr<FJsonValue>>* JsonValues = nullptr;
+        if (Params->TryGetArrayField(FStringView(FieldName), JsonValues) && JsonValues)
+        {
+            for (const TSharedPtr<FJsonValue>& Value : *JsonValues)
+            {
+                Values.Add(static_cast<float>(Value->AsNumber()));
+            }
+        }
+        return Values;
+    }
+
+    /** Geometry produced by the generate_mesh kernels, one vertex per vertex instance */
+    struct FGeneratedMesh
+    {
+        TArray<FVector3f> Positions;
+        TArray<FVector3f> Normals;
+        TArray<FVector2f> UVs;
+        TArray<uint32> Indices;
+
+        int32 NumVertices() const { return Positions.Num(); }
+
+        /** Append NumNew uninitialized vertices and return the index of the first one */
+        int32 AddVertices(int32 NumNew)
+        {
+            const int32 Base = Positions.Num();
+            Positions.AddUninitialized(NumNew);
+            Normals.AddUninitialized(NumNew);
+            UVs.AddUninitialized(NumNew);
+            return Base;
+        }
+    };
+
+    /** Writes the position, normal and UV of grid vertex (U, V) of a patch */
+    using FPatchKernel = TFunctionRef<void(int32 U, int32 V, FVector3f& OutPosition, FVector3f& OutNormal, FVector2f& OutUV)>;
+
+    /**
+     * Triangulate a (NumU + 1) x (NumV + 1) vertex grid starting at Base. The winding is chosen so the
+     * triangles face along the vertex normals: the engine treats (P0, P1, P2) as facing (P2 - P0) ^ (P1 - P0).
+     */
+    void AddPatchIndices(FGeneratedMesh& Mesh, int32 Base, int32 NumU, int32 NumV)
+    {
+        const int32 RowLength = NumU + 1;
+        auto VertexIndex = [Base, RowLength](int32 U, int32 V) { return Base + V * RowLength + U; };
+
+        bool bFlip = false;
+        for (int32 V = 0; V < NumV; ++V)
+        {
+            bool bFound = false;
+            for (int32 U = 0; U < NumU && !bFound; ++U)
+            {
+                const int32 A = VertexIndex(U, V);
+                const int32 B = VertexIndex(U + 1, V);
+                const int32 C = VertexIndex(U, V + 1);
+                const FVector3f Facing = (Mesh.Positions[C] - Mesh.Positions[A]) ^ (Mesh.Positions[B] - Mesh.Positions[A]);
+                if (Facing.SizeSquared() > UE_KINDA_SMALL_NUMBER)
+                {
+                    bFlip = (Facing | (Mesh.Normals[A] + Mesh.Normals[B] + Mesh.Normals[C])) < 0.0f;
+                    bFound = true;
+                }
+            }
+            if (bFound)
+            {
+                break;
+            }
+        }
+
+        Mesh.Indices.Reserve(Mesh.Indices.Num() + NumU * NumV * 6);
+        for (int32 V = 0; V < NumV; ++V)
+        {
+            for (int32 U = 0; U < NumU; ++U)
+            {
+                const uint32 A = VertexIndex(U, V);
+                const uint32 B = VertexIndex(U + 1, V);
+                const uint32 C = VertexIndex(U, V + 1);
+                const uint32 D = VertexIndex(U + 1, V + 1);
+                if (bFlip)
+                {
+                    Mesh.Indices.Append({ A, C, B, B, C, D });
+                }
+                else
+                {
+                    Mesh.Indices.Append({ A, B, C, B, D, C });
+                }
+            }
+        }
+    }
+
+    /** Evaluate a grid patch. Rows are independent, so large grids are filled in parallel. */
+    void AddPatch(FGeneratedMesh& Mesh, int32 NumU, int32 NumV, FPatchKernel Kernel)
+    {
+        const int32 RowLength = NumU + 1;
+        const int32 Base = Mesh.AddVertices(RowLength * (NumV + 1));
+        FVector3f* Positions = Mesh.Positions.GetData() + Base;
+        FVector3f* Normals = Mesh.Normals.GetData() + Base;
+        FVector2f* UVs = Mesh.UVs.GetData() + Base;
+
+        ParallelFor(NumV + 1, [&](int32 V)
+        {
+            for (int32 U = 0; U < RowLength; ++U)
+            {
+                const int32 Offset = V * RowLength + U;
+                Kernel(U, V, Positions[Offset], Normals[Offset], UVs[Offset]);
+            }
+        }, RowLength * (NumV + 1) < 4096 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+        AddPatchIndices(Mesh, Base, NumU, NumV);
+    }
+
+    /** Flat disc cap: a centre vertex fanned to a ring */
+    void AddCap(FGeneratedMesh& Mesh, const FVector3f& Center, float Radius, int32 Segments, const FVector3f& Normal)
+    {
+        const int32 Base = Mesh.AddVertices(Segments + 2);
+        Mesh.Positions[Base] = Center;
+        Mesh.Normals[Base] = Normal;
+        Mesh.UVs[Base] = FVector2f(0.5f, 0.5f);
+        for (int32 Segment = 0; Segment <= Segments; ++Segment)
+        {
+            const float Angle = UE_TWO_PI * Segment / Segments;
+            const FVector2f Direction(FMath::Cos(Angle), FMath::Sin(Angle));
+            Mesh.Positions[Base + 1 + Segment] = Center + FVector3f(Direction.X, Direction.Y, 0.0f) * Radius;
+            Mesh.Normals[Base + 1 + Segment] = Normal;
+            Mesh.UVs[Base + 1 + Segment] = FVector2f(0.5f, 0.5f) + Direction * 0.5f;
+        }
+
+        const FVector3f Facing = (Mesh.Positions[Base + 2] - Mesh.Positions[Base]) ^ (Mesh.Positions[Base + 1] - Mesh.Positions[Base]);
+        const bool bFlip = (Facing | Normal) < 0.0f;
+        for (int32 Segment = 0; Segment < Segments; ++Segment)
+        {
+            const uint32 Center0 = Base;
+            const uint32 A = Base + 1 + Segment;
+            const uint32 B = Base + 2 + Segment;
+            if (bFlip)
+            {
+                Mesh.Indices.Append({ Center0, B, A });
+            }
+            else
+            {
+                Mesh.Indices.Append({ Center0, A, B });
+            }
+        }
+    }
+
+    /** Axis frames of the six box faces: outward normal, then the two in-plane axes */
+    const FVector3f BoxFaceAxes[6][3] = {
+        { FVector3f(1, 0, 0), FVector3f(0, 1, 0), FVector3f(0, 0, 1) },
+        { FVector3f(-1, 0, 0), FVector3f(0, 1, 0), FVector3f(0, 0, 1) },
+        { FVector3f(0, 1, 0), FVector3f(1, 0, 0), FVector3f(0, 0, 1) },
+        { FVector3f(0, -1, 0), FVector3f(1, 0, 0), FVector3f(0, 0, 1) },
+        { FVector3f(0, 0, 1), FVector3f(1, 0, 0), FVector3f(0, 1, 0) },
+        { FVector3f(0, 0, -1), FVector3f(1, 0, 0), FVector3f(0, 1, 0) }
+    };
+
+    /**
+     * Box with optionally rounded edges. Each face is a grid whose coordinates are spaced so that,
+     * after pushing vertices out from the inner box by Radius, the edge arcs are sampled at even angles.
+     */
+    void GenerateBox(FGeneratedMesh& Mesh, const FVector3f& HalfSize, float Radius, int32 Segments)
+    {
+        const FVector3f Inner = HalfSize - FVector3f(Radius);
+
+        // Per-axis face coordinates: the edge arc on either side of the flat middle
+        auto AxisCoordinates = [Radius, Segments](float Half, float InnerHalf)
+        {
+            TArray<float> Coordinates;
+            if (Radius <= 0.0f)
+            {
+                Coordinates = { -Half, Half };
+                return Coordinates;
+            }
+
+            for (int32 Step = 0; Step <= Segments; ++Step)
+            {
+                Coordinates.Add(-InnerHalf - Radius * FMath::Tan(UE_HALF_PI * 0.5f * (Segments - Step) / Segments));
+            }
+            for (int32 Step = 0; Step <= Segments; ++Step)
+            {
+                Coordinates.Add(InnerHalf + Radius * FMath::Tan(UE_HALF_PI * 0.5f * Step / Segments));
+            }
+            return Coordinates;
+        };
+
+        for (const FVector3f (&Axes)[3] : BoxFaceAxes)
+        {
+            const FVector3f& FaceNormal = Axes[0];
+            const FVector3f& AxisU = Axes[1];
+            const FVector3f& AxisV = Axes[2];
+            const float HalfU = FVector3f::DotProduct(AxisU, HalfSize);
+            const float HalfV = FVector3f::DotProduct(AxisV, HalfSize);
+            const TArray<float> CoordinatesU = AxisCoordinates(HalfU, FVector3f::DotProduct(AxisU, Inner));
+            const TArray<float> CoordinatesV = AxisCoordinates(HalfV, FVector3f::DotProduct(AxisV, Inner));
+            const FVector3f FaceCenter = FaceNormal * FMath::Abs(FVector3f::DotProduct(FaceNormal, HalfSize));
+
+            AddPatch(Mesh, CoordinatesU.Num() - 1, CoordinatesV.Num() - 1,
+                [&](int32 U, int32 V, FVector3f& OutPosition, FVector3f& OutNormal, FVector2f& OutUV)
+                {
+                    const FVector3f Point = FaceCenter + AxisU * CoordinatesU[U] + AxisV * CoordinatesV[V];
+                    const FVector3f Clamped(
+                        FMath::Clamp(Point.X, -Inner.X, Inner.X),
+                        FMath::Clamp(Point.Y, -Inner.Y, Inner.Y),
+                        FMath::Clamp(Point.Z, -Inner.Z, Inner.Z));
+                    OutNormal = Radius > 0.0f ? (Point - Clamped).GetSafeNormal() : FaceNormal;
+                    OutPosition = Radius > 0.0f ? Clamped + OutNormal * Radius : Point;
+                    OutUV = FVector2f(CoordinatesU[U] / (2.0f * HalfU) + 0.5f, 0.5f - CoordinatesV[V] / (2.0f * HalfV));
+                });
+        }
+    }
+
+    void GenerateSphere(FGeneratedMesh& Mesh, float Radius, int32 Segments, int32 Rings)
+    {
+        AddPatch(Mesh, Segments, Rings, [Radius, Segments, Rings](int32 U, int32 V, FVector3f& OutPosition, FVector3f& OutNormal, FVector2f& OutUV)
+        {
+            float SinTheta, CosTheta, SinPhi, CosPhi;
+            FMath::SinCos(&SinTheta, &CosTheta, UE_TWO_PI * U / Segments);
+            FMath::SinCos(&SinPhi, &CosPhi, UE_PI * V / Rings);
+            OutNormal = FVector3f(SinPhi * CosTheta, SinPhi * SinTheta, CosPhi);
+            OutPosition = OutNormal * Radius;
+            OutUV = FVector2f(static_cast<float>(U) / Segments, static_cast<float>(V) / Rings);
+        });
+    }
+
+    /** Cylinder, or a cone / truncated cone when the radii differ. Centred on the origin. */
+    void GenerateCylinder(FGeneratedMesh& Mesh, float BottomRadius, float TopRadius, float Height, int32 Segments, int32 HeightSegments, bool bCaps)
+    {
+        const float HalfHeight = Height * 0.5f;
+        const float Slope = (BottomRadius - TopRadius) / FMath::Max(Height, UE_KINDA_SMALL_NUMBER);
+
+        AddPatch(Mesh, Segments, HeightSegments, [=](int32 U, int32 V, FVector3f& OutPosition, FVector3f& OutNormal, FVector2f& OutUV)
+        {
+            float Sin, Cos;
+            FMath::SinCos(&Sin, &Cos, UE_TWO_PI * U / Segments);
+            const float Alpha = static_cast<float>(V) / HeightSegments;
+            const float Radius = FMath::Lerp(BottomRadius, TopRadius, Alpha);
+            OutPosition = FVector3f(Cos * Radius, Sin * Radius, -HalfHeight + Height * Alpha);
+            OutNormal = FVector3f(Cos, Sin, Slope).GetSafeNormal();
+            OutUV = FVector2f(static_cast<float>(U) / Segments, 1.0f - Alpha);
+        });
+
+        if (bCaps)
+        {
+            if (BottomRadius > 0.0f)
+            {
+                AddCap(Mesh, FVector3f(0.0f, 0.0f, -HalfHeight), BottomRadius, Segments, FVector3f(0.0f, 0.0f, -1.0f));
+            }
+            if (TopRadius > 0.0f)
+            {
+                AddCap(Mesh, FVector3f(0.0f, 0.0f, HalfHeight), TopRadius, Segments, FVector3f(0.0f, 0.0f, 1.0f));
+            }
+        }
+    }
+
+    /** Subdivided plane in XY facing +Z, centred on the origin */
+    void GeneratePlane(FGeneratedMesh& Mesh, const FVector2f& Size, int32 SubdivisionsX, int32 SubdivisionsY)
+    {
+        AddPatch(Mesh, SubdivisionsX, SubdivisionsY, [=](int32 U, int32 V, FVector3f& OutPosition, FVector3f& OutNormal, FVector2f& OutUV)
+        {
+            const FVector2f Alpha(static_cast<float>(U) / SubdivisionsX, static_cast<float>(V) / SubdivisionsY);
+            OutPosition = FVector3f((Alpha.X - 0.5f) * Size.X, (Alpha.Y - 0.5f) * Size.Y, 0.0f);
+            OutNormal = FVector3f(0.0f, 0.0f, 1.0f);
+            OutUV = Alpha;
+        });
+    }
+
+    /** 2D cross-section for sweeps: X maps to the spline's right vector, Y to its up vector */
+    struct FSweepProfile
+    {
+        TArray<FVector2f> Points;
+        TArray<FVector2f> Normals;
+    };
+
+    bool ReadSweepProfile(const TSharedPtr<FJsonObject>& Spec, FSweepProfile& OutProfile, FString& OutErrorMessage)
+    {
+        FString ProfileType = TEXT("circle");
+        Spec->TryGetStringField(FStringView(TEXT("profile")), ProfileType);
+
+        const TArray<TSharedPtr<FJsonValue>>* PointValues = nullptr;
+        if (Spec->TryGetArrayField(FStringView(TEXT("profile_points")), PointValues) && PointValues)
+        {
+            for (const TSharedPtr<FJsonValue>& PointValue : *PointValues)
+            {
+                const TArray<TSharedPtr<FJsonValue>>& Pair = PointValue->AsArray();
+                if (Pair.Num() != 2)
+                {
+                    OutErrorMessage = TEXT("'profile_points' must be a list of [x, y] pairs");
+                    return false;
+                }
+                OutProfile.Points.Add(FVector2f(static_cast<float>(Pair[0]->AsNumber()), static_cast<float>(Pair[1]->AsNumber())));
+            }
+
+            // Closed loop with smooth normals from the neighbouring edges; counter-clockwise points face outwards
+            const int32 NumPoints = OutProfile.Points.Num();
+            if (NumPoints < 3)
+            {
+                OutErrorMessage = TEXT("'profile_points' needs at least three points");
+                return false;
+            }
+            for (int32 Index = 0; Index < NumPoints; ++Index)
+            {
+                const FVector2f Tangent = OutProfile.Points[(Index + 1) % NumPoints] - OutProfile.Points[(Index + NumPoints - 1) % NumPoints];
+                OutProfile.Normals.Add(FVector2f(Tangent.Y, -Tangent.X).GetSafeNormal());
+            }
+            OutProfile.Points.Add(OutProfile.Points[0]);
+            OutProfile.Normals.Add(OutProfile.Normals[0]);
+            return true;
+        }
+
+        if (ProfileType.Equals(TEXT("rect"), ESearchCase::IgnoreCase))
+        {
+            double Width = 100.0;
+            double Height = 100.0;
+            Spec->TryGetNumberField(FStringView(TEXT("width")), Width);
+            Spec->TryGetNumberField(FStringView(TEXT("height")), Height);
+            const FVector2f Half(static_cast<float>(Width * 0.5), static_cast<float>(Height * 0.5));
+            const FVector2f Corners[4] = { FVector2f(Half.X, -Half.Y), FVector2f(Half.X, Half.Y), FVector2f(-Half.X, Half.Y), FVector2f(-Half.X, -Half.Y) };
+            const FVector2f EdgeNormals[4] = { FVector2f(1, 0), FVector2f(0, 1), FVector2f(-1, 0), FVector2f(0, -1) };
+
+            // Corners are duplicated per edge so the sides stay flat shaded; the last point closes the loop
+            for (int32 Edge = 0; Edge < 4; ++Edge)
+            {
+                OutProfile.Points.Append({ Corners[Edge], Corners[(Edge + 1) % 4] });
+                OutProfile.Normals.Append({ EdgeNormals[Edge], EdgeNormals[Edge] });
+            }
+            return true;
+        }
+
+        if (ProfileType.Equals(TEXT("circle"), ESearchCase::IgnoreCase))
+        {
+            double Radius = 50.0;
+            int32 Sides = 16;
+            Spec->TryGetNumberField(FStringView(TEXT("radius")), Radius);
+            Spec->TryGetNumberField(FStringView(TEXT("sides")), Sides);
+            Sides = FMath::Clamp(Sides, 3, 256);
+            for (int32 Side = 0; Side <= Sides; ++Side)
+            {
+                float Sin, Cos;
+                FMath::SinCos(&Sin, &Cos, UE_TWO_PI * Side / Sides);
+                OutProfile.Points.Add(FVector2f(Cos, Sin) * static_cast<float>(Radius));
+                OutProfile.Normals.Add(FVector2f(Cos, Sin));
+            }
+            return true;
+        }
+
+        OutErrorMessage = FString::Printf(TEXT("Unknown profile '%s' (expected circle, rect or profile_points)"), *ProfileType);
+        return false;
+    }
+
+    /**
+     * Sweep a profile along a spline. Frames are sampled from the spline on the game thread, then each
+     * ring is placed with vector-register multiply-adds: P = Origin + Right * x + Up * y.
+     */
+    void GenerateSweep(FGeneratedMesh& Mesh, const USplineComponent* Spline, const FTransform& MeshFrame, const FSweepProfile& Profile, int32 Samples)
+    {
+        const float Length = Spline->GetSplineLength();
+        TArray<FVector4f> Origins;
+        TArray<FVector4f> Rights;
+        TArray<FVector4f> Ups;
+        Origins.SetNumUninitialized(Samples + 1);
+        Rights.SetNumUninitialized(Samples + 1);
+        Ups.SetNumUninitialized(Samples + 1);
+        for (int32 Sample = 0; Sample <= Samples; ++Sample)
+        {
+            // Frames are expressed relative to the spawned actor so the mesh pivot sits at the spline start
+            const float Distance = Length * Sample / Samples;
+            Origins[Sample] = FVector4f(FVector3f(MeshFrame.InverseTransformPosition(Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World))), 0.0f);
+            Rights[Sample] = FVector4f(FVector3f(MeshFrame.InverseTransformVector(Spline->GetRightVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World))), 0.0f);
+            Ups[Sample] = FVector4f(FVector3f(MeshFrame.InverseTransformVector(Spline->GetUpVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World))), 0.0f);
+        }
+
+        // Profile U coordinate: distance around the cross-section
+        const int32 NumProfile = Profile.Points.Num();
+        TArray<float> ProfileU;
+        ProfileU.Add(0.0f);
+        for (int32 Index = 1; Index < NumProfile; ++Index)
+        {
+            ProfileU.Add(ProfileU.Last() + FVector2f::Distance(Profile.Points[Index], Profile.Points[Index - 1]));
+        }
+
+        const int32 Base = Mesh.AddVertices(NumProfile * (Samples + 1));
+        ParallelFor(Samples + 1, [&](int32 Sample)
+        {
+            const VectorRegister4Float Origin = VectorLoad(&Origins[Sample].X);
+            const VectorRegister4Float Right = VectorLoad(&Rights[Sample].X);
+            const VectorRegister4Float Up = VectorLoad(&Ups[Sample].X);
+            const float V = Length * Sample / Samples;
+
+            for (int32 Index = 0; Index < NumProfile; ++Index)
+            {
+                const FVector2f& Point = Profile.Points[Index];
+                const FVector2f& Normal = Profile.Normals[Index];
+                const VectorRegister4Float Position = VectorMultiplyAdd(Up, VectorSetFloat1(Point.Y), VectorMultiplyAdd(Right, VectorSetFloat1(Point.X), Origin));
+                const VectorRegister4Float Direction = VectorMultiplyAdd(Up, VectorSetFloat1(Normal.Y), VectorMultiply(Right, VectorSetFloat1(Normal.X)));
+
+                const int32 Offset = Base + Sample * NumProfile + Index;
+                VectorStoreFloat3(Position, &Mesh.Positions[Offset].X);
+                VectorStoreFloat3(Direction, &Mesh.Normals[Offset].X);
+                Mesh.Normals[Offset].Normalize();
+                Mesh.UVs[Offset] = FVector2f(ProfileU[Index] / 100.0f, V / 100.0f);
+            }
+        }, (Samples + 1) * NumProfile < 4096 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+        // Duplicated rect corners leave zero-width strips between edges, which keeps the sides flat shaded
+        AddPatchIndices(Mesh, Base, NumProfile - 1, Samples);
+    }
+
+    /** Read an optional [x, y, z] array into a float vector */
+    FVector3f ReadVector3f(const TSharedPtr<FJsonObject>& Spec, const TCHAR* FieldName, const FVector3f& Default)
+    {
+        FVector Value;
+        return TryGetVectorField(Spec, FieldName, Value) ? FVector3f(Value) : Default;
+    }
+
+    /**
+     * Run the kernel for one shape spec. Sweeps are generated relative to MeshFrame, the transform
+     * of the actor that will display them.
+     */
+    bool GenerateShape(UWorld* World, const TSharedPtr<FJsonObject>& Spec, const FTransform& MeshFrame, FGeneratedMesh& OutMesh, FString& OutErrorMessage)
+    {
+        FString Shape;
+        if (!Spec->TryGetStringField(FStringView(TEXT("shape")), Shape) || Shape.IsEmpty())
+        {
+            OutErrorMessage = TEXT("Missing 'shape' field");
+            return false;
+        }
+
+        int32 Segments = 24;
+        Spec->TryGetNumberField(FStringView(TEXT("segments")), Segments);
+        Segments = FMath::Clamp(Segments, 3, MCPConstants::MAX_GENERATED_MESH_SEGMENTS);
+
+        if (Shape.Equals(TEXT("box"), ESearchCase::IgnoreCase) || Shape.Equals(TEXT("rounded_box"), ESearchCase::IgnoreCase))
+        {
+            const FVector3f HalfSize = ReadVector3f(Spec, TEXT("size"), FVector3f(100.0f)).GetAbs() * 0.5f;
+            double Radius = 0.0;
+            Spec->TryGetNumberField(FStringView(TEXT("radius")), Radius);
+
+            // Keep a sliver of flat face so the inner box never collapses
+            Radius = FMath::Clamp(Radius, 0.0, 0.99 * HalfSize.GetMin());
+            int32 EdgeSegments = 4;
+            Spec->TryGetNumberField(FStringView(TEXT("edge_segments")), EdgeSegments);
+            GenerateBox(OutMesh, HalfSize, static_cast<float>(Radius), FMath::Clamp(EdgeSegments, 1, 64));
+            return true;
+        }
+
+        if (Shape.Equals(TEXT("sphere"), ESearchCase::IgnoreCase))
+        {
+            double Radius = 50.0;
+            Spec->TryGetNumberField(FStringView(TEXT("radius")), Radius);
+            int32 Rings = Segments / 2;
+            Spec->TryGetNumberField(FStringView(TEXT("rings")), Rings);
+            GenerateSphere(OutMesh, static_cast<float>(Radius), Segments, FMath::Clamp(Rings, 2, MCPConstants::MAX_GENERATED_MESH_SEGMENTS));
+            return true;
+        }
+
+        if (Shape.Equals(TEXT("cylinder"), ESearchCase::IgnoreCase) || Shape.Equals(TEXT("cone"), ESearchCase::IgnoreCase))
+        {
+            double Radius = 50.0;
+            double Height = 100.0;
+            Spec->TryGetNumberField(FStringView(TEXT("radius")), Radius);
+            Spec->TryGetNumberField(FStringView(TEXT("height")), Height);
+            double TopRadius = Shape.Equals(TEXT("cone"), ESearchCase::IgnoreCase) ? 0.0 : Radius;
+            Spec->TryGetNumberField(FStringView(TEXT("top_radius")), TopRadius);
+            int32 HeightSegments = 1;
+            Spec->TryGetNumberField(FStringView(TEXT("height_segments")), HeightSegments);
+            bool bCaps = true;
+            Spec->TryGetBoolField(FStringView(TEXT("caps")), bCaps);
+            GenerateCylinder(OutMesh, static_cast<float>(Radius), static_cast<float>(TopRadius), static_cast<float>(Height), Segments, FMath::Clamp(HeightSegments, 1, MCPConstants::MAX_GENERATED_MESH_SEGMENTS), bCaps);
+            return true;
+        }
+
+        if (Shape.Equals(TEXT("plane"), ESearchCase::IgnoreCase))
+        {
+            const FVector3f Size = ReadVector3f(Spec, TEXT("size"), FVector3f(1000.0f, 1000.0f, 0.0f));
+            int32 SubdivisionsX = 1;
+            int32 SubdivisionsY = 1;
+            const TArray<TSharedPtr<FJsonValue>>* SubdivisionValues = nullptr;
+            if (Spec->TryGetArrayField(FStringView(TEXT("subdivisions")), SubdivisionValues) && SubdivisionValues && SubdivisionValues->Num() == 2)
+            {
+                SubdivisionsX = static_cast<int32>((*SubdivisionValues)[0]->AsNumber());
+                SubdivisionsY = static_cast<int32>((*SubdivisionValues)[1]->AsNumber());
+            }
+            GeneratePlane(OutMesh, FVector2f(Size.X, Size.Y),
+                FMath::Clamp(SubdivisionsX, 1, MCPConstants::MAX_GENERATED_MESH_SEGMENTS),
+                FMath::Clamp(SubdivisionsY, 1, MCPConstants::MAX_GENERATED_MESH_SEGMENTS));
+            return true;
+        }
+
+        if (Shape.Equals(TEXT("sweep"), ESearchCase::IgnoreCase))
+        {
+            FString SplineActorName;
+            Spec->TryGetStringField(FStringView(TEXT("spline_actor")), SplineActorName);
+            const AActor* SplineActor = FMCPInstancingUtils::FindActorByNameOrLabel(World, SplineActorName, OutErrorMessage);
+            if (!OutErrorMessage.IsEmpty())
+            {
+                return false;
+            }
+            const USplineComponent* Spline = SplineActor ? SplineActor->FindComponentByClass<USplineComponent>() : nullptr;
+            if (!Spline)
+            {
+                OutErrorMessage = FString::Printf(TEXT("Sweep requires 'spline_actor' with a spline component; not found: %s"), *SplineActorName);
+                return false;
+            }
+
+            FSweepProfile Profile;
+            if (!ReadSweepProfile(Spec, Profile, OutErrorMessage))
+            {
+                return false;
+            }
+
+            // Default to a ring every metre of spline
+            int32 Samples = FMath::CeilToInt(Spline->GetSplineLength() / 100.0f);
+            Spec->TryGetNumberField(FStringView(TEXT("samples")), Samples);
+            GenerateSweep(OutMesh, Spline, MeshFrame, Profile, FMath::Clamp(Samples, 1, MCPConstants::MAX_GENERATED_MESH_SEGMENTS));
+            return true;
+        }
+
+        OutErrorMessage = FString::Printf(TEXT("Unknown shape '%s' (expected box, rounded_box, sphere, cylinder, cone, plane or sweep)"), *Shape);
+        return false;
+    }
+
+    /** Copy generated geometry into a MeshDescription with one polygon group */
+    void BuildMeshDescription(const FGeneratedMesh& Mesh, FMeshDescription& OutDescription)
+    {
+        FStaticMeshAttributes Attributes(OutDescription);
+        Attributes.Register();
+
+        const int32 NumVertices = Mesh.NumVertices();
+        OutDescription.ReserveNewVertices(NumVertices);
+        OutDescription.ReserveNewVertexInstances(NumVertices);
+        OutDescription.ReserveNewTriangles(Mesh.Indices.Num() / 3);
+
+        TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+        TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+        TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+
+        const FPolygonGroupID PolygonGroup = OutDescription.CreatePolygonGroup();
+        Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = TEXT("Material");
+
+        TArray<FVertexInstanceID> Instances;
+        Instances.SetNumUninitialized(NumVertices);
+        for (int32 Index = 0; Index < NumVertices; ++Index)
+        {
+            const FVertexID Vertex = OutDescription.CreateVertex();
+            Positions[Vertex] = Mesh.Positions[Index];
+            Instances[Index] = OutDescription.CreateVertexInstance(Vertex);
+            Normals[Instances[Index]] = Mesh.Normals[Index];
+            UVs[Instances[Index]] = Mesh.UVs[Index];
+        }
+
+        for (int32 Index = 0; Index + 2 < Mesh.Indices.Num(); Index += 3)
+        {
+            OutDescription.CreateTriangle(PolygonGroup, { Instances[Mesh.Indices[Index]], Instances[Mesh.Indices[Index + 1]], Instances[Mesh.Indices[Index + 2]] });
+        }
+    }
+
+    /**
+     * Create (or rebuild) the static mesh for generated geometry. With an asset path the mesh is a
+     * saved asset with its MeshDescription committed; without one it is a transient preview mesh.
+     * An existing static mesh at the path, loaded from disk if needed, is only rebuilt in place with
+     * bOverwrite; otherwise the new mesh gets a unique name next to it. An asset of another class is
+     * never replaced.
+     */
+    UStaticMesh* BuildStaticMesh(const FGeneratedMesh& Mesh, const FString& AssetPath, bool bOverwrite, UMaterialInterface* Material, FString& OutErrorMessage)
+    {
+        const bool bPersistent = !AssetPath.IsEmpty();
+        UStaticMesh* StaticMesh = nullptr;
+        if (bPersistent)
+        {
+            if (!FPackageName::IsValidLongPackageName(AssetPath))
+            {
+                OutErrorMessage = FString::Printf(TEXT("Invalid asset path '%s'"), *AssetPath);
+                return nullptr;
+            }
+
+            FString PackageName = AssetPath;
+            FString AssetName = FPackageName::GetLongPackageAssetName(AssetPath);
+            UObject* Existing = StaticLoadObject(UObject::StaticClass(), nullptr, *FString::Printf(TEXT("%s.%s"), *PackageName, *AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+            if (Existing && !Existing->IsA<UStaticMesh>())
+            {
+                OutErrorMessage = FString::Printf(TEXT("'%s' already exists as a %s"), *AssetPath, *Existing->GetClass()->GetName());
+                return nullptr;
+            }
+            if (Existing && !bOverwrite)
+            {
+                FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools")).Get().CreateUniqueAssetName(AssetPath, FString(), PackageName, AssetName);
+                Existing = nullptr;
+            }
+
+            StaticMesh = Cast<UStaticMesh>(Existing);
+            if (StaticMesh)
+            {
+                StaticMesh->Modify();
+            }
+            else
+            {
+                StaticMesh = NewObject<UStaticMesh>(CreatePackage(*PackageName), *AssetName, RF_Public | RF_Standalone | RF_Transactional);
+            }
+        }
+        else
+        {
+            StaticMesh = NewObject<UStaticMesh>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UStaticMesh::StaticClass(), TEXT("MCP_PreviewMesh")), RF_Transient);
+        }
+
+        StaticMesh->GetStaticMaterials().Reset();
+        StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Material, TEXT("Material")));
+
+        FMeshDescription Description;
+        BuildMeshDescription(Mesh, Description);
+
+        UStaticMesh::FBuildMeshDescriptionsParams BuildParams;
+        BuildParams.bBuildSimpleCollision = true;
+        BuildParams.bCommitMeshDescription = bPersistent;
+        BuildParams.bFastBuild = !bPersistent;
+        BuildParams.bMarkPackageDirty = bPersistent;
+        StaticMesh->BuildFromMeshDescriptions({ &Description }, BuildParams);
+
+        if (bPersistent)
+        {
+            // The kernels already produce the intended normals; keep later rebuilds from replacing them
+            FStaticMeshSourceModel& SourceModel = StaticMesh->GetSourceModel(0);
+            SourceModel.BuildSettings.bRecomputeNormals = false;
+            SourceModel.BuildSettings.bRecomputeTangents = true;
+            FAssetRegistryModule::AssetCreated(StaticMesh);
+        }
+        return StaticMesh;
+    }
+
+    /** Canonical JSON of the fields that shape the geometry; placement only matters to sweeps, which are built relative to the actor */
+    FString MakeGeometryKey(const TSharedPtr<FJsonObject>& Spec)
+    {
+        FString Shape;
+        Spec->TryGetStringField(FStringView(TEXT("shape")), Shape);
+
+        TSharedPtr<FJsonObject> GeometryKeyObject = MakeShared<FJsonObject>();
+        GeometryKeyObject->Values = Spec->Values;
+        GeometryKeyObject->RemoveField(TEXT("label"));
+        if (!Shape.Equals(TEXT("sweep"), ESearchCase::IgnoreCase))
+        {
+            GeometryKeyObject->RemoveField(TEXT("location"));
+            GeometryKeyObject->RemoveField(TEXT("rotation"));
+            GeometryKeyObject->RemoveField(TEXT("scale"));
+        }
+        FString GeometryKey;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> KeyWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&GeometryKey);
+        FJsonSerializer::Serialize(GeometryKeyObject.ToSharedRef(), KeyWriter);
+        return GeometryKey;
+    }
+}
+
+//
+// FMCPMergeActorsHandler
+//
+
+TSharedPtr<FJsonObject> FMCPMergeActorsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling merge_actors command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    TArray<AActor*> Actors;
+    FString ErrorMessage;
+    if (!CollectTargetActors(World, Params, Actors, ErrorMessage))
+    {
+        return CreateErrorResponse(ErrorMessage);
+    }
+
+    TSharedRef<FMergeJobState> State = MakeShared<FMergeJobState>();
+    TArray<UStaticMeshComponent*> ActorComponents;
+    int32 SkippedCount = 0;
+    for (AActor* Actor : Actors)
+    {
+        if (!CollectMergeableComponents(Actor, ActorComponents))
+        {
+            ++SkippedCount;
+            continue;
+        }
+        State->Components.Append(ActorComponents);
+        State->SourceActors.Add(Actor);
+    }
+    if (SkippedCount > 0)
+    {
+        MCP_LOG_INFO("merge_actors: skipped %d actors that hold more than static mesh components", SkippedCount);
+    }
+
+    if (State->Components.Num() < 2)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Need at least two static mesh components to merge, found %d (%d actors skipped because they hold other components)"),
+            State->Components.Num(), SkippedCount));
+    }
+
+    FString AssetPath;
+    Params->TryGetStringField(FStringView(TEXT("asset_path")), AssetPath);
+    if (AssetPath.IsEmpty())
+    {
+        // Labels may contain characters that are invalid in object names, and earlier merges may already own the name
+        const FString BaseName = FString::Printf(TEXT("/Game/MCP/Merged/SM_Merged_%s"), *ObjectTools::SanitizeObjectName(State->SourceActors[0]->GetActorLabel()));
+        FString UniqueAssetName;
+        FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools")).Get().CreateUniqueAssetName(BaseName, FString(), AssetPath, UniqueAssetName);
+    }
+    if (!FPackageName::IsValidLongPackageName(AssetPath))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Invalid asset path '%s'"), *AssetPath));
+    }
+    State->PackageName = AssetPath;
+
+    bool bMergeMaterials = false;
+    Params->TryGetBoolField(FStringView(TEXT("merge_materials")), bMergeMaterials);
+    State->Settings.bMergeMaterials = bMergeMaterials;
+
+    // lod < 0 keeps every LOD of the sources, otherwise only that LOD is merged
+    int32 LODIndex = -1;
+    Params->TryGetNumberField(FStringView(TEXT("lod")), LODIndex);
+    if (LODIndex >= 0)
+    {
+        State->Settings.LODSelectionType = EMeshLODSelectionType::SpecificLOD;
+        State->Settings.SpecificLOD = LODIndex;
+    }
+    else
+    {
+        State->Settings.LODSelectionType = EMeshLODSelectionType::AllLODs;
+    }
+
+    bool bPivotAtZero = false;
+    Params->TryGetBoolField(FStringView(TEXT("pivot_at_zero")), bPivotAtZero);
+    State->Settings.bPivotPointAtZero = bPivotAtZero;
+
+    bool bGenerateLightmapUVs = true;
+    Params->TryGetBoolField(FStringView(TEXT("generate_lightmap_uvs")), bGenerateLightmapUVs);
+    State->Settings.bGenerateLightMapUV = bGenerateLightmapUVs;
+
+    State->Settings.bMergePhysicsData = true;
+
+    Params->TryGetBoolField(FStringView(TEXT("replace_sources")), State->bReplaceSources);
+
+    bool bWait = false;
+    Params->TryGetBoolField(FStringView(TEXT("wait")), bWait);
+
+    FMCPJobRegistry& Jobs = FMCPJobRegistry::Get();
+    if (bWait)
+    {
+        const FString JobId = Jobs.CreateJob(TEXT("merge_actors"));
+        while (!RunMergeStep(JobId, *State))
+        {
+        }
+        return CreateSuccessResponse(Jobs.GetJobJson(JobId));
+    }
+
+    // The replace phase reports its merged actor to the change tracker itself
+    const FString JobId = Jobs.StartTickedJob(TEXT("merge_actors"), [State](const FString& Id, bool& /*bOutEditedScene*/)
+    {
+        return RunMergeStep(Id, *State);
+    });
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("job_id"), JobId);
+    Result->SetNumberField(TEXT("component_count"), State->Components.Num());
+    Result->SetNumberField(TEXT("source_actor_count"), State->SourceActors.Num());
+    Result->SetNumberField(TEXT("skipped_actor_count"), SkippedCount);
+    Result->SetStringField(TEXT("asset_path"), AssetPath);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPGenerateLODsHandler
+//
+
+TSharedPtr<FJsonObject> FMCPGenerateLODsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling generate_lods command");
+
+    TSharedRef<FLODJobState> State = MakeShared<FLODJobState>();
+
+    // Explicit mesh paths, validated against the asset registry; the job loads them a batch per tick
+    IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+    TSet<FSoftObjectPath> SeenPaths;
+    const TArray<TSharedPtr<FJsonValue>>* MeshValues = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("meshes")), MeshValues) && MeshValues)
+    {
+        for (const TSharedPtr<FJsonValue>& MeshValue : *MeshValues)
+        {
+            FString MeshPath = MeshValue->AsString();
+            if (!MeshPath.Contains(TEXT(".")) && FPackageName::IsValidLongPackageName(MeshPath))
+            {
+                MeshPath = FString::Printf(TEXT("%s.%s"), *MeshPath, *FPackageName::GetLongPackageAssetName(MeshPath));
+            }
+
+            const FAssetData Asset = AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(MeshPath));
+            if (!Asset.IsValid() || !Asset.IsInstanceOf(UStaticMesh::StaticClass()))
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("No static mesh asset at '%s'"), *MeshValue->AsString()));
+            }
+            if (!SeenPaths.Contains(Asset.GetSoftObjectPath()))
+            {
+                SeenPaths.Add(Asset.GetSoftObjectPath());
+                State->Targets.AddDefaulted_GetRef().Path = Asset.GetSoftObjectPath();
+            }
+        }
+    }
+
+    // Asset registry filter: every static mesh under a content path
+    FString ContentPath;
+    if (Params->TryGetStringField(FStringView(TEXT("path")), ContentPath) && !ContentPath.IsEmpty())
+    {
+        bool bRecursive = true;
+        Params->TryGetBoolField(FStringView(TEXT("recursive")), bRecursive);
+
+        FString NameFilter;
+        Params->TryGetStringField(FStringView(TEXT("name_contains")), NameFilter);
+
+        FARFilter Filter;
+        Filter.PackagePaths.Add(FName(*ContentPath));
+        Filter.bRecursivePaths = bRecursive;
+        Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+
+        TArray<FAssetData> Assets;
+        AssetRegistry.GetAssets(Filter, Assets);
+        for (const FAssetData& Asset : Assets)
+        {
+            if (!NameFilter.IsEmpty() && !Asset.AssetName.ToString().Contains(NameFilter))
+            {
+                continue;
+            }
+
+            const FSoftObjectPath AssetPath = Asset.GetSoftObjectPath();
+            if (!SeenPaths.Contains(AssetPath))
+            {
+                SeenPaths.Add(AssetPath);
+                State->Targets.AddDefaulted_GetRef().Path = AssetPath;
+            }
+        }
+    }
+
+    if (State->Targets.Num() == 0)
+    {
+        return CreateErrorResponse(TEXT("No static meshes matched; specify 'meshes' or 'path'"));
+    }
+
+    Params->TryGetNumberField(FStringView(TEXT("num_lods")), State->NumLODs);
+    State->NumLODs = FMath::Clamp(State->NumLODs, 1, MCPConstants::MAX_GENERATED_LODS);
+
+    // Per generated LOD (LOD1 onwards); missing entries halve the triangles each level
+    State->PercentTriangles = ReadFloatArray(Params, TEXT("percent_triangles"));
+    for (float& Percent : State->PercentTriangles)
+    {
+        Percent = FMath::Clamp(Percent > 1.0f ? Percent / 100.0f : Percent, 0.0f, 1.0f);
+    }
+    State->ScreenSizes = ReadFloatArray(Params, TEXT("screen_sizes"));
+
+    Params->TryGetBoolField(FStringView(TEXT("overwrite_existing")), State->bOverwriteExisting);
+
+    const FString JobId = FMCPJobRegistry::Get().StartTickedJob(TEXT("generate_lods"), [State](const FString& Id, bool& /*bOutEditedScene*/)
+    {
+        return RunGenerateLODsStep(Id, *State);
+    });
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("job_id"), JobId);
+    Result->SetNumberField(TEXT("mesh_count"), State->Targets.Num());
+    Result->SetNumberField(TEXT("num_lods"), State->NumLODs);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPGenerateMeshHandler
+//
+
+TSharedPtr<FJsonObject> FMCPGenerateMeshHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling generate_mesh command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    // Either one shape described by the top-level fields or a 'shapes' batch
+    TArray<TSharedPtr<FJsonObject>> Specs;
+    const TArray<TSharedPtr<FJsonValue>>* ShapeValues = nullptr;
+    const bool bBatch = Params->TryGetArrayField(FStringView(TEXT("shapes")), ShapeValues) && ShapeValues;
+    if (bBatch)
+    {
+        for (const TSharedPtr<FJsonValue>& ShapeValue : *ShapeValues)
+        {
+            const TSharedPtr<FJsonObject>* ShapeObject = nullptr;
+            if (!ShapeValue->TryGetObject(ShapeObject) || !ShapeObject)
+            {
+                return CreateErrorResponse(TEXT("Every entry of 'shapes' must be an object"));
+            }
+            Specs.Add(*ShapeObject);
+        }
+    }
+    else
+    {
+        Specs.Add(Params);
+    }
+
+    if (Specs.Num() == 0 || Specs.Num() > MCPConstants::MAX_GENERATED_MESHES_PER_REQUEST)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Expected between 1 and %d shapes, got %d"), MCPConstants::MAX_GENERATED_MESHES_PER_REQUEST, Specs.Num()));
+    }
+
+    bool bSpawnActors = true;
+    Params->TryGetBoolField(FStringView(TEXT("spawn_actor")), bSpawnActors);
+
+    bool bOverwrite = false;
+    Params->TryGetBoolField(FStringView(TEXT("overwrite")), bOverwrite);
+
+    // Shapes with identical geometry share one mesh, but two different shapes saved to the same
+    // path would silently replace each other
+    TMap<FString, FString> GeometryByAssetPath;
+    for (const TSharedPtr<FJsonObject>& Spec : Specs)
+    {
+        FString AssetPath;
+        Spec->TryGetStringField(FStringView(TEXT("asset_path")), AssetPath);
+        if (AssetPath.IsEmpty())
+        {
+            continue;
+        }
+        const FString GeometryKey = MakeGeometryKey(Spec);
+        if (const FString* ExistingKey = GeometryByAssetPath.Find(AssetPath))
+        {
+            if (*ExistingKey != GeometryKey)
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("asset_path '%s' is used by more than one shape"), *AssetPath));
+            }
+            continue;
+        }
+        GeometryByAssetPath.Add(AssetPath, GeometryKey);
+    }
+
+    const FScopedTransaction Transaction(NSLOCTEXT("UnrealMCP", "GenerateMesh", "Generate Mesh"));
+
+    // Shapes with identical geometry in one request share a mesh
+    TMap<FString, UStaticMesh*> MeshesByGeometry;
+    TArray<TSharedPtr<FJsonValue>> ShapeResults;
+    int32 GeneratedMeshCount = 0;
+    int32 SpawnedCount = 0;
+    int32 FailedCount = 0;
+
+    for (const TSharedPtr<FJsonObject>& Spec : Specs)
+    {
+        TSharedPtr<FJsonObject> ShapeResult = MakeShared<FJsonObject>();
+
+        FVector Location = FVector::ZeroVector;
+        FVector RotationValues = FVector::ZeroVector;
+        FVector Scale = FVector::OneVector;
+        TryGetVectorField(Spec, TEXT("location"), Location);
+        TryGetVectorField(Spec, TEXT("rotation"), RotationValues);
+        TryGetVectorField(Spec, TEXT("scale"), Scale);
+        const FTransform ActorTransform(FRotator(RotationValues.X, RotationValues.Y, RotationValues.Z), Location, Scale);
+
+        FString Shape;
+        Spec->TryGetStringField(FStringView(TEXT("shape")), Shape);
+        FString AssetPath;
+        Spec->TryGetStringField(FStringView(TEXT("asset_path")), AssetPath);
+        FString MaterialPath;
+        Spec->TryGetStringField(FStringView(TEXT("material")), MaterialPath);
+
+        const FString GeometryKey = MakeGeometryKey(Spec);
+        UStaticMesh* StaticMesh = MeshesByGeometry.FindRef(GeometryKey);
+        FString ErrorMessage;
+        if (!StaticMesh)
+        {
+            FGeneratedMesh Mesh;
+            if (GenerateShape(World, Spec, ActorTransform, Mesh, ErrorMessage))
+            {
+                UMaterialInterface* Material = MaterialPath.IsEmpty() ? nullptr : LoadObject<UMaterialInterface>(nullptr, *MaterialPath);
+                if (!MaterialPath.IsEmpty() && !Material)
+                {
+                    MCP_LOG_WARNING("Failed to load material %s; using the default material", *MaterialPath);
+                }
+
+                StaticMesh = BuildStaticMesh(Mesh, AssetPath, bOverwrite, Material, ErrorMessage);
+                if (StaticMesh)
+                {
+                    MeshesByGeometry.Add(GeometryKey, StaticMesh);
+                    ++GeneratedMeshCount;
+                    ShapeResult->SetNumberField(TEXT("vertex_count"), Mesh.NumVertices());
+                    ShapeResult->SetNumberField(TEXT("triangle_count"), Mesh.Indices.Num() / 3);
+                }
+            }
+        }
+
+        if (!StaticMesh)
+        {
+            if (!bBatch)
+            {
+                return CreateErrorResponse(ErrorMessage);
+            }
+            ++FailedCount;
+            ShapeResult->SetStringField(TEXT("error"), ErrorMessage);
+            ShapeResults.Add(MakeShared<FJsonValueObject>(ShapeResult));
+            continue;
+        }
+
+        ShapeResult->SetStringField(TEXT("mesh"), StaticMesh->GetPathName());
+        ShapeResult->SetBoolField(TEXT("preview"), AssetPath.IsEmpty());
+
+        if (bSpawnActors)
+        {
+            FActorSpawnParameters SpawnParams;
+            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+            AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), ActorTransform, SpawnParams);
+            if (Actor)
+            {
+                Actor->GetStaticMeshComponent()->SetStaticMesh(StaticMesh);
+
+                FString Label;
+                Spec->TryGetStringField(FStringView(TEXT("label")), Label);
+                Actor->SetActorLabel(Label.IsEmpty() ? FString::Printf(TEXT("MCP_%s"), *Shape) : Label);
+
+                // Preview meshes live in the transient package, so their actors are not saved with the level
+                if (AssetPath.IsEmpty())
+                {
+                    Actor->SetFlags(RF_Transient);
+                }
+                FMCPSceneChangeTracker::Get().MarkActorDirty(Actor);
+
+                ShapeResult->SetStringField(TEXT("actor"), Actor->GetName());
+                ShapeResult->SetStringField(TEXT("label"), Actor->GetActorLabel());
+                ++SpawnedCount;
+            }
+        }
+
+        ShapeResults.Add(MakeShared<FJsonValueObject>(ShapeResult));
+    }
+
+    if (!bBatch)
+    {
+        return CreateSuccessResponse(ShapeResults[0]->AsObject());
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("shape_count"), Specs.Num());
+    Result->SetNumberField(TEXT("meshes_generated"), GeneratedMeshCount);
+    Result->SetNumberField(TEXT("actors_spawned"), SpawnedCount);
+    Result->SetNumberField(TEXT("failed"), FailedCount);
+    Result->SetArrayField(TEXT("shapes"), ShapeResults);
+
+    MCP_LOG_INFO("generate_mesh: %d shapes, %d meshes, %d actors, %d failed", Specs.Num(), GeneratedMeshCount, SpawnedCount, FailedCount);
+    return CreateSuccessResponse(Result);
+}
@@ -0,0 +1,2486 @@
+#include "MCPCommandHandlers_Scene.h"
+
+#include "MCPFileLogger.h"
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/LightComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Dom/JsonValue.h"
+#include "Editor.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/CityHash.h"
+#include "JsonObjectConverter.h"
+#include "MCPConstants.h"
+#include "Misc/Base64.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+    /** Fields returned when the request does not specify any. */
+    const TCHAR* const DefaultSceneFields[] = { TEXT("name"), TEXT("type"), TEXT("label"), TEXT("location") };
+
+    /** Map a built-in field name to its enum value. */
+    bool TryParseBuiltInField(const FString& FieldName, EMCPSceneField& OutField)
+    {
+        static const TMap<FString, EMCPSceneField> BuiltInFields = {
+            { TEXT("name"), EMCPSceneField::Name },
+            { TEXT("type"), EMCPSceneField::Type },
+            { TEXT("class_path"), EMCPSceneField::ClassPath },
+            { TEXT("label"), EMCPSceneField::Label },
+            { TEXT("location"), EMCPSceneField::Location },
+            { TEXT("rotation"), EMCPSceneField::Rotation },
+            { TEXT("scale"), EMCPSceneField::Scale },
+            { TEXT("bounds"), EMCPSceneField::Bounds },
+            { TEXT("mobility"), EMCPSceneField::Mobility },
+            { TEXT("folder"), EMCPSceneField::Folder },
+            { TEXT("tags"), EMCPSceneField::Tags },
+            { TEXT("guid"), EMCPSceneField::Guid },
+            { TEXT("hidden"), EMCPSceneField::Hidden },
+            { TEXT("parent"), EMCPSceneField::Parent },
+            { TEXT("components"), EMCPSceneField::Components }
+        };
+
+        if (const EMCPSceneField* Found = BuiltInFields.Find(FieldName.ToLower()))
+        {
+            OutField = *Found;
+            return true;
+        }
+        return false;
+    }
+
+    /** Base64-encode the raw bytes of a POD array (floats and int32s are little-endian on every editor platform). */
+    template <typename T>
+    FString EncodeArrayBase64(const TArray<T>& Values)
+    {
+        return FBase64::Encode(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(T));
+    }
+
+    template <typename T>
+    TArray<TSharedPtr<FJsonValue>> ToJsonNumberArray(const TArray<T>& Values)
+    {
+        TArray<TSharedPtr<FJsonValue>> JsonValues;
+        JsonValues.Reserve(Values.Num());
+        for (const T Value : Values)
+        {
+            JsonValues.Add(MakeShared<FJsonValueNumber>(Value));
+        }
+        return JsonValues;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ToJsonStringArray(const TArray<FString>& Values)
+    {
+        TArray<TSharedPtr<FJsonValue>> JsonValues;
+        JsonValues.Reserve(Values.Num());
+        for (const FString& Value : Values)
+        {
+            JsonValues.Add(MakeShared<FJsonValueString>(Value));
+        }
+        return JsonValues;
+    }
+
+    /** Element type of a column, as listed in the "dtypes" object of a columnar result. */
+    const TCHAR* GetColumnDType(const TArray<int32>&) { return TEXT("int32"); }
+    const TCHAR* GetColumnDType(const TArray<float>&) { return TEXT("float32"); }
+    const TCHAR* GetColumnDType(const TArray<double>&) { return TEXT("float64"); }
+
+    /** Add a column either as a JSON number array or as a "<name>_base64" string, and record its element type. */
+    template <typename T>
+    void SetColumnField(const TSharedPtr<FJsonObject>& Object, const TSharedPtr<FJsonObject>& DTypes, const FString& Name, const TArray<T>& Values, bool bBinary)
+    {
+        DTypes->SetStringField(Name, GetColumnDType(Values));
+        if (bBinary)
+        {
+            Object->SetStringField(Name + TEXT("_base64"), EncodeArrayBase64(Values));
+        }
+        else
+        {
+            Object->SetArrayField(Name, ToJsonNumberArray(Values));
+        }
+    }
+
+    /** Continue a 64-bit hash over the characters of a string. */
+    uint64 HashString(const FString& Value, uint64 Seed)
+    {
+        return CityHash64WithSeed(reinterpret_cast<const char*>(*Value), Value.Len() * sizeof(TCHAR), Seed);
+    }
+
+    /** Format a scene hash the way get_scene_hash reports it. */
+    FString FormatSceneHash(uint64 Hash)
+    {
+        return FString::Printf(TEXT("%016llx"), Hash);
+    }
+
+    /** NUL-terminated UTF-8 string table of a snapshot file. Offset 0 is always the empty string. */
+    class FSnapshotStringTable
+    {
+    public:
+        FSnapshotStringTable()
+        {
+            Blob.Add(0);
+        }
+
+        uint32 Add(const FString& Value)
+        {
+            if (Value.IsEmpty())
+            {
+                return 0;
+            }
+
+            if (const uint32* Existing = Offsets.Find(Value))
+            {
+                return *Existing;
+            }
+
+            const uint32 Offset = static_cast<uint32>(Blob.Num());
+            FTCHARToUTF8 Converter(*Value);
+            Blob.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+            Blob.Add(0);
+            Offsets.Add(Value, Offset);
+            return Offset;
+        }
+
+        const TArray<uint8>& GetBlob() const { return Blob; }
+
+    private:
+        TArray<uint8> Blob;
+        TMap<FString, uint32> Offsets;
+    };
+
+    /** Append a section to the file buffer at an 8-byte aligned offset and return that offset. */
+    uint64 AppendSection(TArray<uint8>& Buffer, const void* Data, int64 NumBytes)
+    {
+        const int64 AlignedStart = Align(static_cast<int64>(Buffer.Num()), 8);
+        Buffer.SetNumZeroed(AlignedStart);
+        if (NumBytes > 0)
+        {
+            Buffer.Append(static_cast<const uint8*>(Data), NumBytes);
+        }
+        return static_cast<uint64>(AlignedStart);
+    }
+
+    /** Actors per get_scene_info serialization chunk */
+    constexpr int32 MinRowsPerSerializeChunk = 256;
+
+    /** Serialize a JSON object without whitespace. */
+    FString SerializeCondensed(const TSharedRef<FJsonObject>& Object)
+    {
+        FString Text;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Text);
+        FJsonSerializer::Serialize(Object, Writer);
+        return Text;
+    }
+
+    /** Actors per scene_stats reduction chunk below which splitting the work is not worth it */
+    constexpr int32 MinActorsPerStatsChunk = 1024;
+
+    /** Mobility slots of the scene_stats counters; the last one counts actors without a root component */
+    constexpr int32 NumStatsMobilitySlots = 4;
+
+    /** A static mesh used by an actor, with the number of instances it renders */
+    struct FStatsMeshRef
+    {
+        int32 MeshId;
+        int32 InstanceCount;
+    };
+
+    /** Per-actor data copied on the game thread for scene_stats */
+    struct FStatsActorRecord
+    {
+        int32 ClassId;
+        int32 FolderId;
+        int32 MobilitySlot;
+        int32 PrimitiveCount;
+        int32 LightCount;
+        int32 FirstMeshRef;
+        int32 NumMeshRefs;
+        bool bHasBounds;
+        FVector3f BoundsMin;
+        FVector3f BoundsMax;
+    };
+
+    struct FStatsMeshInfo
+    {
+        FString Path;
+        int32 TrianglesLOD0;
+        int32 MaterialSlots;
+    };
+
+    /** Everything the scene_stats reductions read; contains no UObject pointers */
+    struct FSceneStatsInput
+    {
+        TArray<FString> ClassNames;
+        TArray<FString> FolderNames;
+        TArray<FStatsMeshInfo> Meshes;
+        TArray<FStatsActorRecord> Actors;
+        TArray<FStatsMeshRef> MeshRefs;
+    };
+
+    /** Reduction result of one chunk of actors, merged on the calling thread */
+    struct FSceneStatsPartial
+    {
+        TArray<int32> ClassCounts;
+        TArray<int32> FolderCounts;
+        int32 MobilityCounts[NumStatsMobilitySlots] = {};
+        FBox Bounds = FBox(ForceInit);
+        int64 Triangles = 0;
+        int64 MaterialSlots = 0;
+        int64 PrimitiveComponents = 0;
+        int32 LightActors = 0;
+        int64 LightComponents = 0;
+        TArray<int32> MeshComponentCounts;
+        TArray<int64> MeshInstanceCounts;
+        /** Min-heap of actor indices by primitive count */
+        TArray<int32> TopActors;
+    };
+
+    int32 GetMobilitySlot(const AActor* Actor)
+    {
+        const USceneComponent* Root = Actor->GetRootComponent();
+        if (!Root)
+        {
+            return NumStatsMobilitySlots - 1;
+        }
+        return FMath::Clamp(static_cast<int32>(Root->Mobility.GetValue()), 0, NumStatsMobilitySlots - 2);
+    }
+
+    /** Copy the plain data of every actor; must run on the game thread. */
+    void GatherSceneStatsInput(UWorld* World, FSceneStatsInput& OutInput, TArray<const AActor*>& OutActors)
+    {
+        TMap<const UClass*, int32> ClassToId;
+        TMap<FName, int32> FolderToId;
+        TMap<const UStaticMesh*, int32> MeshToId;
+
+        OutInput.Actors.Reserve(World->GetActorCount());
+        OutActors.Reserve(World->GetActorCount());
+
+        TInlineComponentArray<UActorComponent*> Components;
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            const AActor* Actor = *It;
+
+            FStatsActorRecord& Record = OutInput.Actors.AddZeroed_GetRef();
+            OutActors.Add(Actor);
+
+            const UClass* Class = Actor->GetClass();
+            if (const int32* ExistingClassId = ClassToId.Find(Class))
+            {
+                Record.ClassId = *ExistingClassId;
+            }
+            else
+            {
+                Record.ClassId = OutInput.ClassNames.Add(Class->GetName());
+                ClassToId.Add(Class, Record.ClassId);
+            }
+
+            const FName Folder = Actor->GetFolderPath();
+            if (const int32* ExistingFolderId = FolderToId.Find(Folder))
+            {
+                Record.FolderId = *ExistingFolderId;
+            }
+            else
+            {
+                Record.FolderId = OutInput.FolderNames.Add(Folder.IsNone() ? FString(TEXT("/")) : Folder.ToString());
+                FolderToId.Add(Folder, Record.FolderId);
+            }
+
+            Record.MobilitySlot = GetMobilitySlot(Actor);
+            Record.FirstMeshRef = OutInput.MeshRefs.Num();
+
+            FBox ActorBounds(ForceInit);
+            Components.Reset();
+            Actor->GetComponents(Components);
+            for (const UActorComponent* Component : Components)
+            {
+                if (Component->IsA<ULightComponent>())
+                {
+                    ++Record.LightCount;
+                    continue;
+                }
+
+                const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+                if (!Primitive)
+                {
+                    continue;
+                }
+
+                ++Record.PrimitiveCount;
+                if (Primitive->IsRegistered())
+                {
+                    ActorBounds += Primitive->Bounds.GetBox();
+                }
+
+                const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Primitive);
+                const UStaticMesh* Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+                if (!Mesh)
+                {
+                    continue;
+                }
+
+                int32 MeshId = INDEX_NONE;
+                if (const int32* ExistingMeshId = MeshToId.Find(Mesh))
+                {
+                    MeshId = *ExistingMeshId;
+                }
+                else
+                {
+                    MeshId = OutInput.Meshes.Add({ Mesh->GetPathName(), Mesh->GetRenderData() ? Mesh->GetNumTriangles(0) : 0, Mesh->GetStaticMaterials().Num() });
+                    MeshToId.Add(Mesh, MeshId);
+                }
+
+                const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(MeshComponent);
+                OutInput.MeshRefs.Add({ MeshId, InstancedComponent ? InstancedComponent->GetInstanceCount() : 1 });
+            }
+
+            Record.NumMeshRefs = OutInput.MeshRefs.Num() - Record.FirstMeshRef;
+            Record.bHasBounds = ActorBounds.IsValid != 0;
+            if (Record.bHasBounds)
+            {
+                Record.BoundsMin = FVector3f(ActorBounds.Min);
+                Record.BoundsMax = FVector3f(ActorBounds.Max);
+            }
+        }
+    }
+
+    /** Reduce a range of actors into a partial result. Touches only the input and the partial. */
+    void ReduceSceneStats(const FSceneStatsInput& Input, int32 BeginIndex, int32 EndIndex, int32 TopN, FSceneStatsPartial& OutPartial)
+    {
+        OutPartial.ClassCounts.SetNumZeroed(Input.ClassNames.Num());
+        OutPartial.FolderCounts.SetNumZeroed(Input.FolderNames.Num());
+        OutPartial.MeshComponentCounts.SetNumZeroed(Input.Meshes.Num());
+        OutPartial.MeshInstanceCounts.SetNumZeroed(Input.Meshes.Num());
+        OutPartial.TopActors.Reserve(TopN + 1);
+
+        auto TopLess = [&Input](int32 A, int32 B)
+        {
+            return Input.Actors[A].PrimitiveCount < Input.Actors[B].PrimitiveCount;
+        };
+
+        for (int32 ActorIndex = BeginIndex; ActorIndex < EndIndex; ++ActorIndex)
+        {
+            const FStatsActorRecord& Record = Input.Actors[ActorIndex];
+            ++OutPartial.ClassCounts[Record.ClassId];
+            ++OutPartial.FolderCounts[Record.FolderId];
+            ++OutPartial.MobilityCounts[Record.MobilitySlot];
+            OutPartial.PrimitiveComponents += Record.PrimitiveCount;
+            OutPartial.LightComponents += Record.LightCount;
+            OutPartial.LightActors += Record.LightCount > 0 ? 1 : 0;
+
+            if (Record.bHasBounds)
+            {
+                OutPartial.Bounds += FBox(FVector(Record.BoundsMin), FVector(Record.BoundsMax));
+            }
+
+            for (int32 RefIndex = Record.FirstMeshRef; RefIndex < Record.FirstMeshRef + Record.NumMeshRefs; ++RefIndex)
+            {
+                const FStatsMeshRef& MeshRef = Input.MeshRefs[RefIndex];
+                const FStatsMeshInfo& Mesh = Input.Meshes[MeshRef.MeshId];
+                ++OutPartial.MeshComponentCounts[MeshRef.MeshId];
+                OutPartial.MeshInstanceCounts[MeshRef.MeshId] += MeshRef.InstanceCount;
+                OutPartial.Triangles += static_cast<int64>(Mesh.TrianglesLOD0) * MeshRef.InstanceCount;
+                OutPartial.MaterialSlots += Mesh.MaterialSlots;
+            }
+
+            if (TopN > 0 && Record.PrimitiveCount > 0)
+            {
+                if (OutPartial.TopActors.Num() < TopN)
+                {
+                    OutPartial.TopActors.HeapPush(ActorIndex, TopLess);
+                }
+                else if (Record.PrimitiveCount > Input.Actors[OutPartial.TopActors.HeapTop()].PrimitiveCount)
+                {
+                    OutPartial.TopActors.HeapPopDiscard(TopLess);
+                    OutPartial.TopActors.HeapPush(ActorIndex, TopLess);
+                }
+            }
+        }
+    }
+
+    /** Convert name-indexed counts into a JSON object, skipping zero entries. */
+    TSharedPtr<FJsonObject> CountsToJson(const TArray<FString>& Names, const TArray<int32>& Counts)
+    {
+        TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+        for (int32 Index = 0; Index < Names.Num(); ++Index)
+        {
+            if (Counts[Index] > 0)
+            {
+                Object->SetNumberField(Names[Index], Counts[Index]);
+            }
+        }
+        return Object;
+    }
+}
+
+//
+// FMCPSceneFieldPlan
+//
+FMCPSceneFieldPlan::FMCPSceneFieldPlan(const UClass* Class, const TArray<FString>& Fields)
+{
+    Accessors.Reserve(Fields.Num());
+
+    for (const FString& FieldName : Fields)
+    {
+        FMCPSceneFieldAccessor Accessor;
+        Accessor.Key = FieldName;
+
+        if (TryParseBuiltInField(FieldName, Accessor.Field))
+        {
+            Accessors.Add(MoveTemp(Accessor));
+            continue;
+        }
+
+        Accessor.Field = EMCPSceneField::Property;
+        if (!CompilePropertyPath(Class, FieldName, Accessor))
+        {
+            UnresolvedFields.Add(FieldName);
+        }
+        Accessors.Add(MoveTemp(Accessor));
+    }
+}
+
+bool FMCPSceneFieldPlan::CompilePropertyPath(const UStruct* Struct, const FString& Path, FMCPSceneFieldAccessor& OutAccessor)
+{
+    OutAccessor.Steps.Reset();
+    OutAccessor.LeafProperty = nullptr;
+
+    TArray<FString> Segments;
+    Path.ParseIntoArray(Segments, TEXT("."));
+    if (!Struct || Segments.Num() == 0)
+    {
+        return false;
+    }
+
+    const UStruct* CurrentStruct = Struct;
+    int32 Offset = 0;
+
+    for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+    {
+        const FProperty* Property = FindFProperty<FProperty>(CurrentStruct, *Segments[SegmentIndex]);
+        if (!Property)
+        {
+            return false;
+        }
+
+        Offset += Property->GetOffset_ForInternal();
+
+        if (SegmentIndex == Segments.Num() - 1)
+        {
+            FMCPPropertyPathStep& LeafStep = OutAccessor.Steps.AddDefaulted_GetRef();
+            LeafStep.Offset = Offset;
+            OutAccessor.LeafProperty = Property;
+            return true;
+        }
+
+        if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+        {
+            // Nested struct members live inline, so only the offset moves.
+            CurrentStruct = StructProperty->Struct;
+        }
+        else if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+        {
+            FMCPPropertyPathStep& DereferenceStep = OutAccessor.Steps.AddDefaulted_GetRef();
+            DereferenceStep.Offset = Offset;
+            DereferenceStep.ObjectProperty = ObjectProperty;
+
+            CurrentStruct = ObjectProperty->PropertyClass;
+            Offset = 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+const uint8* FMCPSceneFieldPlan::ResolveValuePtr(const AActor* Actor, const FMCPSceneFieldAccessor& Accessor)
+{
+    if (!Accessor.LeafProperty)
+    {
+        return nullptr;
+    }
+
+    const uint8* Container = reinterpret_cast<const uint8*>(Actor);
+    for (const FMCPPropertyPathStep& Step : Accessor.Steps)
+    {
+        if (!Step.ObjectProperty)
+        {
+            return Container + Step.Offset;
+        }
+
+        const UObject* Referenced = Step.ObjectProperty->GetObjectPropertyValue(Container + Step.Offset);
+        if (!Referenced)
+        {
+            return nullptr;
+        }
+        Container = reinterpret_cast<const uint8*>(Referenced);
+    }
+
+    return nullptr;
+}
+
+TSharedPtr<FJsonValue> FMCPSceneFieldPlan::ReadProperty(const AActor* Actor, const FMCPSceneFieldAccessor& Accessor)
+{
+    const uint8* ValuePtr = ResolveValuePtr(Actor, Accessor);
+    if (!ValuePtr)
+    {
+        return MakeShared<FJsonValueNull>();
+    }
+
+    TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(const_cast<FProperty*>(Accessor.LeafProperty), ValuePtr);
+    return Value.IsValid() ? Value : MakeShared<FJsonValueNull>();
+}
+
+bool FMCPSceneFieldPlan::ExportFieldText(const AActor* Actor, int32 FieldIndex, FString& OutText) const
+{
+    OutText.Reset();
+    if (!Actor || !Accessors.IsValidIndex(FieldIndex))
+    {
+        return false;
+    }
+
+    const FMCPSceneFieldAccessor& Accessor = Accessors[FieldIndex];
+    if (Accessor.Field == EMCPSceneField::Property)
+    {
+        const uint8* ValuePtr = ResolveValuePtr(Actor, Accessor);
+        if (!ValuePtr)
+        {
+            return false;
+        }
+        Accessor.LeafProperty->ExportTextItem_Direct(OutText, ValuePtr, nullptr, nullptr, PPF_None);
+        return true;
+    }
+
+    // Built-in fields go through their JSON form so both paths agree on formatting
+    FMCPSceneFieldValue FieldValue;
+    GatherField(Actor, Accessor, FieldValue);
+    TSharedPtr<FJsonObject> FieldObject = MakeShared<FJsonObject>();
+    WriteField(Accessor, FieldValue, FieldObject);
+    const TSharedPtr<FJsonValue> Value = FieldObject->TryGetField(Accessor.Key);
+    if (!Value.IsValid())
+    {
+        return false;
+    }
+
+    if (Value->Type == EJson::String)
+    {
+        OutText = Value->AsString();
+        return true;
+    }
+
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutText);
+    return FJsonSerializer::Serialize(Value, FString(), Writer);
+}
+
+void FMCPSceneFieldPlan::Extract(const AActor* Actor, const TSharedPtr<FJsonObject>& OutObject) const
+{
+    if (!Actor || !OutObject.IsValid())
+    {
+        return;
+    }
+
+    TArray<FMCPSceneFieldValue> Values;
+    Gather(Actor, Values);
+    WriteValues(Values, OutObject);
+}
+
+void FMCPSceneFieldPlan::Gather(const AActor* Actor, TArray<FMCPSceneFieldValue>& OutValues) const
+{
+    OutValues.Reset();
+    if (!Actor)
+    {
+        return;
+    }
+
+    OutValues.SetNum(Accessors.Num());
+    for (int32 FieldIndex = 0; FieldIndex < Accessors.Num(); ++FieldIndex)
+    {
+        GatherField(Actor, Accessors[FieldIndex], OutValues[FieldIndex]);
+    }
+}
+
+void FMCPSceneFieldPlan::WriteValues(TConstArrayView<FMCPSceneFieldValue> Values, const TSharedPtr<FJsonObject>& OutObject) const
+{
+    if (!OutObject.IsValid())
+    {
+        return;
+    }
+
+    const int32 NumValues = FMath::Min(Values.Num(), Accessors.Num());
+    for (int32 FieldIndex = 0; FieldIndex < NumValues; ++FieldIndex)
+    {
+        WriteField(Accessors[FieldIndex], Values[FieldIndex], OutObject);
+    }
+}
+
+void FMCPSceneFieldPlan::GatherField(const AActor* Actor, const FMCPSceneFieldAccessor& Accessor, FMCPSceneFieldValue& OutValue)
+{
+    switch (Accessor.Field)
+    {
+    case EMCPSceneField::Name:
+        OutValue.Text = Actor->GetName();
+        break;
+    case EMCPSceneField::Type:
+        OutValue.Text = Actor->GetClass()->GetName();
+        break;
+    case EMCPSceneField::ClassPath:
+        OutValue.Text = Actor->GetClass()->GetPathName();
+        break;
+    case EMCPSceneField::Label:
+        OutValue.Text = Actor->GetActorLabel();
+        break;
+    case EMCPSceneField::Location:
+        OutValue.Vectors[0] = Actor->GetActorLocation();
+        break;
+    case EMCPSceneField::Rotation:
+    {
+        const FRotator Rotation = Actor->GetActorRotation();
+        OutValue.Vectors[0] = FVector(Rotation.Pitch, Rotation.Yaw, Rotation.Roll);
+        break;
+    }
+    case EMCPSceneField::Scale:
+        OutValue.Vectors[0] = Actor->GetActorScale3D();
+        break;
+    case EMCPSceneField::Bounds:
+        Actor->GetActorBounds(false, OutValue.Vectors[0], OutValue.Vectors[1]);
+        break;
+    case EMCPSceneField::Mobility:
+    {
+        const USceneComponent* Root = Actor->GetRootComponent();
+        OutValue.Text = Root ? FMCPSceneQueryUtils::MobilityToString(Root->Mobility) : TEXT("none");
+        break;
+    }
+    case EMCPSceneField::Folder:
+        OutValue.Text = Actor->GetFolderPath().ToString();
+        break;
+    case EMCPSceneField::Tags:
+        OutValue.Strings.Reserve(Actor->Tags.Num());
+        for (const FName& Tag : Actor->Tags)
+        {
+            OutValue.Strings.Add(Tag.ToString());
+        }
+        break;
+    case EMCPSceneField::Guid:
+        OutValue.Text = Actor->GetActorGuid().ToString(EGuidFormats::DigitsWithHyphens);
+        break;
+    case EMCPSceneField::Hidden:
+        OutValue.bFlag = Actor->IsHiddenEd();
+        break;
+    case EMCPSceneField::Parent:
+    {
+        const AActor* Parent = Actor->GetAttachParentActor();
+        OutValue.Text = Parent ? Parent->GetName() : FString();
+        break;
+    }
+    case EMCPSceneField::Components:
+        for (const UActorComponent* Component : Actor->GetComponents())
+        {
+            if (!Component)
+            {
+                continue;
+            }
+            OutValue.Strings.Add(Component->GetName());
+            OutValue.Strings.Add(Component->GetClass()->GetName());
+        }
+        break;
+    case EMCPSceneField::Property:
+        OutValue.PropertyValue = ReadProperty(Actor, Accessor);
+        break;
+    }
+}
+
+void FMCPSceneFieldPlan::WriteField(const FMCPSceneFieldAccessor& Accessor, const FMCPSceneFieldValue& Value, const TSharedPtr<FJsonObject>& OutObject)
+{
+    switch (Accessor.Field)
+    {
+    case EMCPSceneField::Name:
+    case EMCPSceneField::Type:
+    case EMCPSceneField::ClassPath:
+    case EMCPSceneField::Label:
+    case EMCPSceneField::Mobility:
+    case EMCPSceneField::Folder:
+    case EMCPSceneField::Guid:
+    case EMCPSceneField::Parent:
+        OutObject->SetStringField(Accessor.Key, Value.Text);
+        break;
+    case EMCPSceneField::Location:
+    case EMCPSceneField::Scale:
+        OutObject->SetArrayField(Accessor.Key, FMCPSceneQueryUtils::VectorToJsonArray(Value.Vectors[0]));
+        break;
+    case EMCPSceneField::Rotation:
+        OutObject->SetArrayField(Accessor.Key, FMCPSceneQueryUtils::RotatorToJsonArray(FRotator(Value.Vectors[0].X, Value.Vectors[0].Y, Value.Vectors[0].Z)));
+        break;
+    case EMCPSceneField::Bounds:
+    {
+        TSharedPtr<FJsonObject> BoundsObject = MakeShared<FJsonObject>();
+        BoundsObject->SetArrayField(TEXT("origin"), FMCPSceneQueryUtils::VectorToJsonArray(Value.Vectors[0]));
+        BoundsObject->SetArrayField(TEXT("extent"), FMCPSceneQueryUtils::VectorToJsonArray(Value.Vectors[1]));
+        OutObject->SetObjectField(Accessor.Key, BoundsObject);
+        break;
+    }
+    case EMCPSceneField::Tags:
+    {
+        TArray<TSharedPtr<FJsonValue>> TagsArray;
+        TagsArray.Reserve(Value.Strings.Num());
+        for (const FString& Tag : Value.Strings)
+        {
+            TagsArray.Add(MakeShared<FJsonValueString>(Tag));
+        }
+        OutObject->SetArrayField(Accessor.Key, TagsArray);
+        break;
+    }
+    case EMCPSceneField::Hidden:
+        OutObject->SetBoolField(Accessor.Key, Value.bFlag);
+        break;
+    case EMCPSceneField::Components:
+    {
+        TArray<TSharedPtr<FJsonValue>> ComponentsArray;
+        ComponentsArray.Reserve(Value.Strings.Num() / 2);
+        for (int32 Index = 0; Index + 1 < Value.Strings.Num(); Index += 2)
+        {
+            TSharedPtr<FJsonObject> ComponentObject = MakeShared<FJsonObject>();
+            ComponentObject->SetStringField(TEXT("name"), Value.Strings[Index]);
+            ComponentObject->SetStringField(TEXT("type"), Value.Strings[Index + 1]);
+            ComponentsArray.Add(MakeShared<FJsonValueObject>(ComponentObject));
+        }
+        OutObject->SetArrayField(Accessor.Key, ComponentsArray);
+        break;
+    }
+    case EMCPSceneField::Property:
+        OutObject->SetField(Accessor.Key, Value.PropertyValue.IsValid() ? Value.PropertyValue : MakeShared<FJsonValueNull>());
+        break;
+    }
+}
+
+//
+// FMCPSceneFieldPlanCache
+//
+FMCPSceneFieldPlanCache& FMCPSceneFieldPlanCache::Get()
+{
+    static FMCPSceneFieldPlanCache Instance;
+    return Instance;
+}
+
+TSharedRef<const FMCPSceneFieldPlan> FMCPSceneFieldPlanCache::FindOrCompile(const UClass* Class, const TArray<FString>& Fields, const FString& FieldsSignature)
+{
+    EnsureInvalidation();
+
+    const TPair<FObjectKey, FString> Key(FObjectKey(Class), FieldsSignature);
+    if (const TSharedRef<const FMCPSceneFieldPlan>* Existing = Plans.Find(Key))
+    {
+        return *Existing;
+    }
+
+    if (Plans.Num() >= MaxCachedPlans)
+    {
+        MCP_LOG_VERBOSE("Scene field plan cache reached %d entries, flushing", MaxCachedPlans);
+        Plans.Reset();
+    }
+
+    TSharedRef<const FMCPSceneFieldPlan> Plan = MakeShared<const FMCPSceneFieldPlan>(Class, Fields);
+    Plans.Add(Key, Plan);
+    return Plan;
+}
+
+void FMCPSceneFieldPlanCache::Reset()
+{
+    Plans.Reset();
+}
+
+void FMCPSceneFieldPlanCache::Shutdown()
+{
+    if (bDelegatesBound)
+    {
+        if (GEditor)
+        {
+            GEditor->OnBlueprintCompiled().RemoveAll(this);
+        }
+        FCoreUObjectDelegates::OnObjectsReinstanced.RemoveAll(this);
+        FCoreUObjectDelegates::ReloadCompleteDelegate.RemoveAll(this);
+        bDelegatesBound = false;
+    }
+    Plans.Empty();
+}
+
+void FMCPSceneFieldPlanCache::EnsureInvalidation()
+{
+    if (bDelegatesBound || !GEditor)
+    {
+        return;
+    }
+
+    // Plans hold property pointers and offsets, which these events may free or move
+    GEditor->OnBlueprintCompiled().AddRaw(this, &FMCPSceneFieldPlanCache::Reset);
+    FCoreUObjectDelegates::OnObjectsReinstanced.AddRaw(this, &FMCPSceneFieldPlanCache::HandleObjectsReinstanced);
+    FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FMCPSceneFieldPlanCache::HandleReloadComplete);
+    bDelegatesBound = true;
+}
+
+void FMCPSceneFieldPlanCache::HandleObjectsReinstanced(const TMap<UObject*, UObject*>& ReplacedObjects)
+{
+    Reset();
+}
+
+void FMCPSceneFieldPlanCache::HandleReloadComplete(EReloadCompleteReason Reason)
+{
+    Reset();
+}
+
+//
+// FMCPSceneQueryUtils
+//
+TArray<FString> FMCPSceneQueryUtils::ReadRequestedFields(const TSharedPtr<FJsonObject>& Params)
+{
+    TArray<FString> Fields;
+
+    const TArray<TSharedPtr<FJsonValue>>* FieldsArray = nullptr;
+    if (Params.IsValid() && Params->TryGetArrayField(FStringView(TEXT("fields")), FieldsArray) && FieldsArray)
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *FieldsArray)
+        {
+            FString FieldName;
+            if (Value.IsValid() && Value->TryGetString(FieldName))
+            {
+                FieldName.TrimStartAndEndInline();
+                if (!FieldName.IsEmpty())
+                {
+                    Fields.AddUnique(FieldName);
+                }
+            }
+        }
+    }
+
+    if (Fields.Num() == 0)
+    {
+        for (const TCHAR* DefaultField : DefaultSceneFields)
+        {
+            Fields.Add(DefaultField);
+        }
+    }
+
+    return Fields;
+}
+
+FString FMCPSceneQueryUtils::GetFieldsSignature(const TArray<FString>& Fields)
+{
+    return FString::Join(Fields, TEXT(","));
+}
+
+TArray<TSharedPtr<FJsonValue>> FMCPSceneQueryUtils::VectorToJsonArray(const FVector& Vector)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    Array.Reserve(3);
+    Array.Add(MakeShared<FJsonValueNumber>(Vector.X));
+    Array.Add(MakeShared<FJsonValueNumber>(Vector.Y));
+    Array.Add(MakeShared<FJsonValueNumber>(Vector.Z));
+    return Array;
+}
+
+TArray<TSharedPtr<FJsonValue>> FMCPSceneQueryUtils::RotatorToJsonArray(const FRotator& Rotator)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    Array.Reserve(3);
+    Array.Add(MakeShared<FJsonValueNumber>(Rotator.Pitch));
+    Array.Add(MakeShared<FJsonValueNumber>(Rotator.Yaw));
+    Array.Add(MakeShared<FJsonValueNumber>(Rotator.Roll));
+    return Array;
+}
+
+FString FMCPSceneQueryUtils::MobilityToString(EComponentMobility::Type Mobility)
+{
+    switch (Mobility)
+    {
+    case EComponentMobility::Static:
+        return TEXT("static");
+    case EComponentMobility::Stationary:
+        return TEXT("stationary");
+    case EComponentMobility::Movable:
+        return TEXT("movable");
+    default:
+        return TEXT("unknown");
+    }
+}
+
+void FMCPSceneQueryUtils::GatherColumns(UWorld* World, int32 MaxActors, FMCPSceneColumns& OutColumns)
+{
+    OutColumns = FMCPSceneColumns();
+    if (!World)
+    {
+        return;
+    }
+
+    OutColumns.LevelName = World->GetName();
+
+    const int32 ActorEstimate = FMath::Min(World->GetActorCount(), MaxActors);
+    OutColumns.ClassIds.Reserve(ActorEstimate);
+    OutColumns.NameIds.Reserve(ActorEstimate);
+    OutColumns.LabelIds.Reserve(ActorEstimate);
+    OutColumns.Positions.Reserve(ActorEstimate * 3);
+    OutColumns.Rotations.Reserve(ActorEstimate * 3);
+    OutColumns.Scales.Reserve(ActorEstimate * 3);
+    OutColumns.Bounds.Reserve(ActorEstimate * 6);
+
+    TMap<const UClass*, int32> ClassToId;
+    TMap<FString, int32> StringToId;
+    auto InternString = [&StringToId, &OutColumns](const FString& Value) -> int32
+    {
+        if (const int32* Existing = StringToId.Find(Value))
+        {
+            return *Existing;
+        }
+        const int32 NewId = OutColumns.Strings.Add(Value);
+        StringToId.Add(Value, NewId);
+        return NewId;
+    };
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        ++OutColumns.TotalActorCount;
+        if (OutColumns.Num() >= MaxActors)
+        {
+            // Keep counting so the caller can report how many actors were left out
+            continue;
+        }
+
+        const AActor* Actor = *It;
+        const UClass* Class = Actor->GetClass();
+
+        int32 ClassId = INDEX_NONE;
+        if (const int32* ExistingClassId = ClassToId.Find(Class))
+        {
+            ClassId = *ExistingClassId;
+        }
+        else
+        {
+            ClassId = OutColumns.ClassNames.Add(Class->GetName());
+            ClassToId.Add(Class, ClassId);
+        }
+
+        OutColumns.ClassIds.Add(ClassId);
+        OutColumns.NameIds.Add(InternString(Actor->GetName()));
+        OutColumns.LabelIds.Add(InternString(Actor->GetActorLabel()));
+
+        const FTransform& Transform = Actor->GetActorTransform();
+        const FVector Location = Transform.GetLocation();
+        const FRotator Rotation = Transform.Rotator();
+        const FVector Scale = Transform.GetScale3D();
+        OutColumns.Positions.Append({ Location.X, Location.Y, Location.Z });
+        OutColumns.Rotations.Append({ static_cast<float>(Rotation.Pitch), static_cast<float>(Rotation.Yaw), static_cast<float>(Rotation.Roll) });
+        OutColumns.Scales.Append({ static_cast<float>(Scale.X), static_cast<float>(Scale.Y), static_cast<float>(Scale.Z) });
+
+        FVector Origin;
+        FVector Extent;
+        Actor->GetActorBounds(false, Origin, Extent);
+        OutColumns.Bounds.Append({ Origin.X, Origin.Y, Origin.Z, Extent.X, Extent.Y, Extent.Z });
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPSceneQueryUtils::BuildColumnarResult(const FMCPSceneColumns& Columns, bool bBinary)
+{
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("level"), Columns.LevelName);
+    Result->SetStringField(TEXT("format"), TEXT("columnar"));
+    Result->SetStringField(TEXT("encoding"), bBinary ? TEXT("base64") : TEXT("json"));
+    Result->SetNumberField(TEXT("actor_count"), Columns.TotalActorCount);
+    Result->SetNumberField(TEXT("returned_actor_count"), Columns.Num());
+    Result->SetBoolField(TEXT("limit_reached"), Columns.Num() < Columns.TotalActorCount);
+    Result->SetArrayField(TEXT("classes"), ToJsonStringArray(Columns.ClassNames));
+
+    if (bBinary)
+    {
+        // Packed string table: UTF-8 strings separated by NUL, in id order
+        TArray<uint8> StringBlob;
+        for (const FString& Value : Columns.Strings)
+        {
+            FTCHARToUTF8 Converter(*Value);
+            StringBlob.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+            StringBlob.Add(0);
+        }
+        Result->SetStringField(TEXT("strings_base64"), FBase64::Encode(StringBlob));
+        Result->SetNumberField(TEXT("string_count"), Columns.Strings.Num());
+    }
+    else
+    {
+        Result->SetArrayField(TEXT("strings"), ToJsonStringArray(Columns.Strings));
+    }
+
+    TSharedPtr<FJsonObject> DTypes = MakeShared<FJsonObject>();
+    SetColumnField(Result, DTypes, TEXT("class_ids"), Columns.ClassIds, bBinary);
+    SetColumnField(Result, DTypes, TEXT("name_ids"), Columns.NameIds, bBinary);
+    SetColumnField(Result, DTypes, TEXT("label_ids"), Columns.LabelIds, bBinary);
+    SetColumnField(Result, DTypes, TEXT("positions"), Columns.Positions, bBinary);
+    SetColumnField(Result, DTypes, TEXT("rotations"), Columns.Rotations, bBinary);
+    SetColumnField(Result, DTypes, TEXT("scales"), Columns.Scales, bBinary);
+    SetColumnField(Result, DTypes, TEXT("bounds"), Columns.Bounds, bBinary);
+    Result->SetObjectField(TEXT("dtypes"), DTypes);
+
+    return Result;
+}
+
+void FMCPSceneQueryUtils::GatherRows(UWorld* World, const TArray<FString>& Fields, int32 MaxActors, FMCPSceneRows& OutRows, bool bUseFragmentCache)
+{
+    OutRows = FMCPSceneRows();
+    if (!World)
+    {
+        return;
+    }
+
+    OutRows.LevelName = World->GetName();
+    OutRows.FieldsSignature = GetFieldsSignature(Fields);
+    OutRows.bUseFragmentCache = bUseFragmentCache;
+
+    TArray<const AActor*> Actors;
+    Actors.Reserve(FMath::Min(World->GetActorCount(), MaxActors));
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        ++OutRows.TotalActorCount;
+        if (Actors.Num() >= MaxActors)
+        {
+            // Keep counting so the caller can report how many actors were left out
+            OutRows.bLimitReached = true;
+            continue;
+        }
+        Actors.Add(*It);
+    }
+
+    if (OutRows.bLimitReached)
+    {
+        MCP_LOG_WARNING("Actor limit reached (%d). Only returning %d of %d actors.", MaxActors, Actors.Num(), OutRows.TotalActorCount);
+    }
+
+    if (bUseFragmentCache)
+    {
+        FMCPSceneChangeTracker& Tracker = FMCPSceneChangeTracker::Get();
+        Tracker.EnsureTracking();
+        OutRows.GatherSerial = Tracker.GetChangeSerial();
+        FMCPSceneFragmentCache::Get().FindFragments(OutRows.FieldsSignature, Actors, OutRows.Fragments);
+
+        OutRows.ActorKeys.Reserve(Actors.Num());
+        OutRows.ActorTransforms.Reserve(Actors.Num());
+        for (const AActor* Actor : Actors)
+        {
+            OutRows.ActorKeys.Add(FObjectKey(Actor));
+            OutRows.ActorTransforms.Add(Actor->GetActorTransform());
+        }
+    }
+
+    // Resolve the projection once; per-class plans are compiled on first use and cached
+    OutRows.Actors.SetNum(Actors.Num());
+    const UClass* LastClass = nullptr;
+    TSharedPtr<const FMCPSceneFieldPlan> Plan;
+    for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+    {
+        const AActor* Actor = Actors[ActorIndex];
+
+        // Actors of one class tend to be adjacent, so only hit the cache on class changes
+        if (Actor->GetClass() != LastClass)
+        {
+            LastClass = Actor->GetClass();
+            Plan = FMCPSceneFieldPlanCache::Get().FindOrCompile(LastClass, Fields, OutRows.FieldsSignature);
+            OutRows.UnresolvedFields.Append(Plan->GetUnresolvedFields());
+        }
+
+        if (bUseFragmentCache && OutRows.Fragments[ActorIndex].IsValid())
+        {
+            continue;
+        }
+
+        // Only plain values are read here; the row objects are built where the rows are serialized
+        FMCPSceneRow& Row = OutRows.Actors[ActorIndex];
+        Row.Plan = Plan;
+        Plan->Gather(Actor, Row.Values);
+    }
+}
+
+namespace
+{
+    /** Build the JSON object of a gathered row. */
+    TSharedPtr<FJsonObject> BuildRowObject(const FMCPSceneRow& Row)
+    {
+        TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+        Row.Plan->WriteValues(Row.Values, ActorInfo);
+        return ActorInfo;
+    }
+
+    /** Result fields of a rows response, without the actors array. */
+    TSharedPtr<FJsonObject> BuildRowsMetadata(const FMCPSceneRows& Rows)
+    {
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetStringField(TEXT("level"), Rows.LevelName);
+        Result->SetNumberField(TEXT("actor_count"), Rows.TotalActorCount);
+        Result->SetNumberField(TEXT("returned_actor_count"), Rows.Actors.Num());
+        Result->SetBoolField(TEXT("limit_reached"), Rows.bLimitReached);
+
+        if (Rows.UnresolvedFields.Num() > 0)
+        {
+            TArray<TSharedPtr<FJsonValue>> UnresolvedArray;
+            for (const FString& FieldName : Rows.UnresolvedFields)
+            {
+                UnresolvedArray.Add(MakeShared<FJsonValueString>(FieldName));
+            }
+            Result->SetArrayField(TEXT("unresolved_fields"), UnresolvedArray);
+        }
+        return Result;
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPSceneQueryUtils::BuildRowsResult(const FMCPSceneRows& Rows)
+{
+    TSharedPtr<FJsonObject> Result = BuildRowsMetadata(Rows);
+
+    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    ActorsArray.Reserve(Rows.Actors.Num());
+    for (int32 ActorIndex = 0; ActorIndex < Rows.Actors.Num(); ++ActorIndex)
+    {
+        TSharedPtr<FJsonObject> ActorInfo = Rows.Actors[ActorIndex].Plan.IsValid() ? BuildRowObject(Rows.Actors[ActorIndex]) : nullptr;
+        if (!ActorInfo.IsValid() && Rows.Fragments.IsValidIndex(ActorIndex) && Rows.Fragments[ActorIndex].IsValid())
+        {
+            // Only reached when cached rows are turned back into objects, e.g. by in-process callers
+            FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(*Rows.Fragments[ActorIndex]), ActorInfo);
+        }
+        if (ActorInfo.IsValid())
+        {
+            ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+        }
+    }
+    Result->SetArrayField(TEXT("actors"), ActorsArray);
+    return Result;
+}
+
+FString FMCPSceneQueryUtils::SerializeRowsResponse(const FMCPSceneRows& Rows)
+{
+    // Each chunk writes its slice of the actors array; the slices are joined afterwards
+    const int32 NumActors = Rows.Actors.Num();
+    const int32 NumChunks = FMath::Clamp(NumActors / MinRowsPerSerializeChunk, 1, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+    TArray<FString> Chunks;
+    Chunks.SetNum(NumChunks);
+    TArray<TSharedPtr<const FString>> NewFragments;
+    NewFragments.SetNum(Rows.bUseFragmentCache ? NumActors : 0);
+    ParallelFor(NumChunks, [&Rows, &Chunks, &NewFragments, NumActors, NumChunks](int32 ChunkIndex)
+    {
+        const int32 BeginIndex = static_cast<int32>(static_cast<int64>(NumActors) * ChunkIndex / NumChunks);
+        const int32 EndIndex = static_cast<int32>(static_cast<int64>(NumActors) * (ChunkIndex + 1) / NumChunks);
+        FString& ChunkText = Chunks[ChunkIndex];
+        for (int32 ActorIndex = BeginIndex; ActorIndex < EndIndex; ++ActorIndex)
+        {
+            if (ActorIndex > BeginIndex)
+            {
+                ChunkText.AppendChar(TEXT(','));
+            }
+
+            // Cached fragments are appended as-is; new rows are serialized and kept for the cache
+            if (Rows.bUseFragmentCache)
+            {
+                if (!Rows.Fragments[ActorIndex].IsValid())
+                {
+                    NewFragments[ActorIndex] = MakeShared<FString>(SerializeCondensed(BuildRowObject(Rows.Actors[ActorIndex]).ToSharedRef()));
+                    ChunkText += *NewFragments[ActorIndex];
+                }
+                else
+                {
+                    ChunkText += *Rows.Fragments[ActorIndex];
+                }
+                continue;
+            }
+
+            ChunkText += SerializeCondensed(BuildRowObject(Rows.Actors[ActorIndex]).ToSharedRef());
+        }
+    }, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    if (Rows.bUseFragmentCache)
+    {
+        FMCPSceneFragmentCache::Get().StoreFragments(Rows.FieldsSignature, Rows.GatherSerial, Rows.ActorKeys, Rows.ActorTransforms, NewFragments);
+    }
+
+    // The metadata object always has fields, so its closing brace can be replaced by the actors array
+    const FString Metadata = SerializeCondensed(BuildRowsMetadata(Rows).ToSharedRef());
+
+    int32 TotalLength = Metadata.Len() + 64;
+    for (const FString& Chunk : Chunks)
+    {
+        TotalLength += Chunk.Len() + 1;
+    }
+
+    FString Response;
+    Response.Reserve(TotalLength);
+    Response += TEXT("{\"status\":\"success\",\"result\":");
+    Response.AppendChars(*Metadata, Metadata.Len() - 1);
+    Response += TEXT(",\"actors\":[");
+    bool bFirstChunk = true;
+    for (const FString& Chunk : Chunks)
+    {
+        if (Chunk.IsEmpty())
+        {
+            continue;
+        }
+        if (!bFirstChunk)
+        {
+            Response.AppendChar(TEXT(','));
+        }
+        Response += Chunk;
+        bFirstChunk = false;
+    }
+    Response += TEXT("]}}");
+    return Response;
+}
+
+FString FMCPSceneQueryUtils::SerializeSuccessResponse(const TSharedPtr<FJsonObject>& Result)
+{
+    TSharedRef<FJsonObject> Response = MakeShared<FJsonObject>();
+    Response->SetStringField(TEXT("status"), TEXT("success"));
+    if (Result.IsValid())
+    {
+        Response->SetObjectField(TEXT("result"), Result);
+    }
+    return SerializeCondensed(Response);
+}
+
+namespace
+{
+    /** Delete the oldest snapshot files so that at most MAX_SCENE_SNAPSHOT_FILES remain. */
+    void PruneSnapshotFiles(IPlatformFile& PlatformFile, const FString& SnapshotDir)
+    {
+        TArray<FString> Files;
+        PlatformFile.FindFiles(Files, *SnapshotDir, MCPConstants::SCENE_SNAPSHOT_EXTENSION);
+        if (Files.Num() <= MCPConstants::MAX_SCENE_SNAPSHOT_FILES)
+        {
+            return;
+        }
+
+        TArray<TPair<FDateTime, FString>> DatedFiles;
+        DatedFiles.Reserve(Files.Num());
+        for (FString& File : Files)
+        {
+            DatedFiles.Emplace(PlatformFile.GetTimeStamp(*File), MoveTemp(File));
+        }
+        DatedFiles.Sort([](const TPair<FDateTime, FString>& A, const TPair<FDateTime, FString>& B)
+        {
+            return A.Key == B.Key ? A.Value < B.Value : A.Key < B.Key;
+        });
+
+        const int32 NumToDelete = DatedFiles.Num() - MCPConstants::MAX_SCENE_SNAPSHOT_FILES;
+        for (int32 Index = 0; Index < NumToDelete; ++Index)
+        {
+            if (!PlatformFile.DeleteFile(*DatedFiles[Index].Value))
+            {
+                MCP_LOG_WARNING("Failed to delete old scene snapshot %s", *DatedFiles[Index].Value);
+            }
+        }
+        MCP_LOG_VERBOSE("Pruned %d old scene snapshots", NumToDelete);
+    }
+}
+
+//
+// FMCPExportSceneSnapshotHandler
+//
+uint64 FMCPExportSceneSnapshotHandler::AllocateSnapshotId()
+{
+    // Millisecond timestamps keep ids unique across sessions while staying exact as JSON numbers
+    const FDateTime Now = FDateTime::UtcNow();
+    const uint64 TimestampId = static_cast<uint64>(Now.ToUnixTimestamp()) * 1000 + Now.GetMillisecond();
+    LastSnapshotId = FMath::Max(LastSnapshotId + 1, TimestampId);
+    return LastSnapshotId;
+}
+
+TSharedPtr<FJsonObject> FMCPExportSceneSnapshotHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling export_scene_snapshot command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    // Incremental exports only contain actors whose content hash differs from the base snapshot
+    uint64 BaseSnapshotId = 0;
+    double BaseSnapshotNumber = 0.0;
+    if (Params->TryGetNumberField(FStringView(TEXT("since_snapshot")), BaseSnapshotNumber) && BaseSnapshotNumber > 0.0)
+    {
+        BaseSnapshotId = static_cast<uint64>(BaseSnapshotNumber);
+    }
+
+    const TMap<FGuid, uint32>* BaseHashes = nullptr;
+    if (BaseSnapshotId != 0)
+    {
+        BaseHashes = RetainedSnapshots.Find(BaseSnapshotId);
+        if (!BaseHashes)
+        {
+            MCP_LOG_WARNING("Unknown base snapshot %llu for incremental export", BaseSnapshotId);
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown snapshot id %llu. Only the last %d snapshots of this editor session can be used as a base."),
+                BaseSnapshotId, MCPConstants::MAX_RETAINED_SCENE_SNAPSHOTS));
+        }
+    }
+
+    TArray<FString> PropertyPaths;
+    const TArray<TSharedPtr<FJsonValue>>* PropertiesArray = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("properties")), PropertiesArray) && PropertiesArray)
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *PropertiesArray)
+        {
+            FString PropertyPath;
+            if (Value.IsValid() && Value->TryGetString(PropertyPath) && !PropertyPath.IsEmpty())
+            {
+                PropertyPaths.AddUnique(PropertyPath);
+            }
+        }
+    }
+    const FString PropertiesSignature = FMCPSceneQueryUtils::GetFieldsSignature(PropertyPaths);
+
+    FSnapshotStringTable StringTable;
+    TArray<FMCPSceneSnapshotRecord> Records;
+    TArray<uint32> ClassNameOffsets;
+    TArray<uint32> PropertyValueOffsets;
+    TMap<const UClass*, uint32> ClassToId;
+    TMap<FGuid, uint32> CurrentHashes;
+    CurrentHashes.Reserve(World->GetActorCount());
+
+    const UClass* LastClass = nullptr;
+    TSharedPtr<const FMCPSceneFieldPlan> Plan;
+    TArray<FString> PropertyTexts;
+    PropertyTexts.SetNum(PropertyPaths.Num());
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        const AActor* Actor = *It;
+        const UClass* Class = Actor->GetClass();
+        const FGuid ActorGuid = Actor->GetActorGuid();
+
+        const FTransform& Transform = Actor->GetActorTransform();
+        const FVector Location = Transform.GetLocation();
+        const FQuat Rotation = Transform.GetRotation();
+        const FVector Scale = Transform.GetScale3D();
+        FVector BoundsOrigin;
+        FVector BoundsExtent;
+        Actor->GetActorBounds(false, BoundsOrigin, BoundsExtent);
+
+        FMCPSceneSnapshotRecord Record;
+        FMemory::Memzero(Record);
+        Record.Guid[0] = ActorGuid.A;
+        Record.Guid[1] = ActorGuid.B;
+        Record.Guid[2] = ActorGuid.C;
+        Record.Guid[3] = ActorGuid.D;
+        Record.Location[0] = Location.X; Record.Location[1] = Location.Y; Record.Location[2] = Location.Z;
+        Record.Rotation[0] = Rotation.X; Record.Rotation[1] = Rotation.Y; Record.Rotation[2] = Rotation.Z; Record.Rotation[3] = Rotation.W;
+        Record.Scale[0] = Scale.X; Record.Scale[1] = Scale.Y; Record.Scale[2] = Scale.Z;
+        Record.BoundsOrigin[0] = BoundsOrigin.X; Record.BoundsOrigin[1] = BoundsOrigin.Y; Record.BoundsOrigin[2] = BoundsOrigin.Z;
+        Record.BoundsExtent[0] = BoundsExtent.X; Record.BoundsExtent[1] = BoundsExtent.Y; Record.BoundsExtent[2] = BoundsExtent.Z;
+
+        const FString Name = Actor->GetName();
+        const FString Label = Actor->GetActorLabel();
+        const FString Folder = Actor->GetFolderPath().ToString();
+
+        if (PropertyPaths.Num() > 0)
+        {
+            if (Class != LastClass)
+            {
+                LastClass = Class;
+                Plan = FMCPSceneFieldPlanCache::Get().FindOrCompile(Class, PropertyPaths, PropertiesSignature);
+            }
+            for (int32 PropertyIndex = 0; PropertyIndex < PropertyPaths.Num(); ++PropertyIndex)
+            {
+                Plan->ExportFieldText(Actor, PropertyIndex, PropertyTexts[PropertyIndex]);
+            }
+        }
+
+        // Case-sensitive content hash over everything the record carries, independent of string table offsets.
+        // The transform and bounds are hashed at full precision so moves below float resolution still count.
+        const double HashedValues[] = {
+            Location.X, Location.Y, Location.Z,
+            Rotation.X, Rotation.Y, Rotation.Z, Rotation.W,
+            Scale.X, Scale.Y, Scale.Z,
+            BoundsOrigin.X, BoundsOrigin.Y, BoundsOrigin.Z,
+            BoundsExtent.X, BoundsExtent.Y, BoundsExtent.Z
+        };
+        uint32 Hash = FCrc::MemCrc32(HashedValues, sizeof(HashedValues));
+        Hash = HashCombine(Hash, FCrc::StrCrc32(*Class->GetPathName()));
+        Hash = HashCombine(Hash, FCrc::StrCrc32(*Name));
+        Hash = HashCombine(Hash, FCrc::StrCrc32(*Label));
+        Hash = HashCombine(Hash, FCrc::StrCrc32(*Folder));
+        for (const FString& PropertyText : PropertyTexts)
+        {
+            Hash = HashCombine(Hash, FCrc::StrCrc32(*PropertyText));
+        }
+        CurrentHashes.Add(ActorGuid, Hash);
+
+        if (BaseHashes)
+        {
+            const uint32* BaseHash = BaseHashes->Find(ActorGuid);
+            if (BaseHash && *BaseHash == Hash)
+            {
+                continue;
+            }
+        }
+
+        if (const uint32* ExistingClassId = ClassToId.Find(Class))
+        {
+            Record.ClassId = *ExistingClassId;
+        }
+        else
+        {
+            Record.ClassId = ClassNameOffsets.Add(StringTable.Add(Class->GetName()));
+            ClassToId.Add(Class, Record.ClassId);
+        }
+
+        Record.NameOffset = StringTable.Add(Name);
+        Record.LabelOffset = StringTable.Add(Label);
+        Record.FolderOffset = StringTable.Add(Folder);
+        Records.Add(Record);
+
+        for (const FString& PropertyText : PropertyTexts)
+        {
+            PropertyValueOffsets.Add(StringTable.Add(PropertyText));
+        }
+    }
+
+    TArray<FGuid> RemovedGuids;
+    if (BaseHashes)
+    {
+        for (const TPair<FGuid, uint32>& BaseEntry : *BaseHashes)
+        {
+            if (!CurrentHashes.Contains(BaseEntry.Key))
+            {
+                RemovedGuids.Add(BaseEntry.Key);
+            }
+        }
+    }
+
+    TArray<uint32> PropertyNameOffsets;
+    for (const FString& PropertyPath : PropertyPaths)
+    {
+        PropertyNameOffsets.Add(StringTable.Add(PropertyPath));
+    }
+
+    const uint64 SnapshotId = AllocateSnapshotId();
+
+    FMCPSceneSnapshotHeader Header;
+    FMemory::Memzero(Header);
+    Header.Magic[0] = 'M'; Header.Magic[1] = 'C'; Header.Magic[2] = 'P'; Header.Magic[3] = 'S';
+    Header.Version = MCPConstants::SCENE_SNAPSHOT_VERSION;
+    Header.SnapshotId = SnapshotId;
+    Header.BaseSnapshotId = BaseSnapshotId;
+    Header.Flags = static_cast<uint32>(BaseHashes ? EMCPSceneSnapshotFlags::Incremental : EMCPSceneSnapshotFlags::None);
+    Header.RecordSize = sizeof(FMCPSceneSnapshotRecord);
+    Header.RecordCount = Records.Num();
+    Header.ClassCount = ClassNameOffsets.Num();
+    Header.PropertyCount = PropertyPaths.Num();
+    Header.RemovedCount = RemovedGuids.Num();
+
+    TArray<uint8> Buffer;
+    Buffer.Reserve(sizeof(Header) + Records.Num() * sizeof(FMCPSceneSnapshotRecord) + StringTable.GetBlob().Num() + 64);
+    AppendSection(Buffer, &Header, sizeof(Header));
+    Header.RecordsOffset = AppendSection(Buffer, Records.GetData(), Records.Num() * sizeof(FMCPSceneSnapshotRecord));
+    Header.ClassTableOffset = AppendSection(Buffer, ClassNameOffsets.GetData(), ClassNameOffsets.Num() * sizeof(uint32));
+    Header.PropertyNamesOffset = AppendSection(Buffer, PropertyNameOffsets.GetData(), PropertyNameOffsets.Num() * sizeof(uint32));
+    Header.PropertyValuesOffset = AppendSection(Buffer, PropertyValueOffsets.GetData(), PropertyValueOffsets.Num() * sizeof(uint32));
+    Header.RemovedOffset = AppendSection(Buffer, RemovedGuids.GetData(), RemovedGuids.Num() * sizeof(FGuid));
+    Header.StringTableOffset = AppendSection(Buffer, StringTable.GetBlob().GetData(), StringTable.GetBlob().Num());
+    Header.StringTableSize = StringTable.GetBlob().Num();
+
+    // Patch the header now that every section offset is known
+    FMemory::Memcpy(Buffer.GetData(), &Header, sizeof(Header));
+
+    const FString SnapshotDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / MCPConstants::SCENE_SNAPSHOT_DIR_NAME);
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    if (!PlatformFile.DirectoryExists(*SnapshotDir) && !PlatformFile.CreateDirectoryTree(*SnapshotDir))
+    {
+        MCP_LOG_ERROR("Failed to create snapshot directory %s", *SnapshotDir);
+        return CreateErrorResponse(FString::Printf(TEXT("Failed to create snapshot directory '%s'"), *SnapshotDir));
+    }
+
+    const FString SnapshotPath = SnapshotDir / FString::Printf(TEXT("%s_%llu%s"), *World->GetName(), SnapshotId, MCPConstants::SCENE_SNAPSHOT_EXTENSION);
+    if (!FFileHelper::SaveArrayToFile(Buffer, *SnapshotPath))
+    {
+        MCP_LOG_ERROR("Failed to write scene snapshot %s", *SnapshotPath);
+        return CreateErrorResponse(FString::Printf(TEXT("Failed to write scene snapshot '%s'"), *SnapshotPath));
+    }
+
+    PruneSnapshotFiles(PlatformFile, SnapshotDir);
+
+    // Retain the hashes so the next export can be incremental against this one
+    RetainedSnapshots.Add(SnapshotId, MoveTemp(CurrentHashes));
+    RetainedOrder.Add(SnapshotId);
+    while (RetainedOrder.Num() > MCPConstants::MAX_RETAINED_SCENE_SNAPSHOTS)
+    {
+        RetainedSnapshots.Remove(RetainedOrder[0]);
+        RetainedOrder.RemoveAt(0);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("path"), SnapshotPath);
+    Result->SetNumberField(TEXT("snapshot_id"), static_cast<double>(SnapshotId));
+    Result->SetNumberField(TEXT("base_snapshot_id"), static_cast<double>(BaseSnapshotId));
+    Result->SetNumberField(TEXT("record_count"), Records.Num());
+    Result->SetNumberField(TEXT("removed_count"), RemovedGuids.Num());
+
+    MCP_LOG_INFO("Wrote scene snapshot %s (%d records, %d bytes)", *SnapshotPath, Records.Num(), Buffer.Num());
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPSceneChangeTracker
+//
+FMCPSceneChangeTracker& FMCPSceneChangeTracker::Get()
+{
+    static FMCPSceneChangeTracker Instance;
+    return Instance;
+}
+
+void FMCPSceneChangeTracker::EnsureTracking()
+{
+    if (bDelegatesBound || !GEngine)
+    {
+        return;
+    }
+
+    GEngine->OnActorMoved().AddRaw(this, &FMCPSceneChangeTracker::HandleActorChanged);
+    GEngine->OnLevelActorAdded().AddRaw(this, &FMCPSceneChangeTracker::HandleActorChanged);
+    GEngine->OnLevelActorDeleted().AddRaw(this, &FMCPSceneChangeTracker::HandleActorDeleted);
+    GEngine->OnLevelActorFolderChanged().AddRaw(this, &FMCPSceneChangeTracker::HandleActorFolderChanged);
+    GEngine->OnLevelActorListChanged().AddRaw(this, &FMCPSceneChangeTracker::MarkFullRescan);
+    FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FMCPSceneChangeTracker::HandleObjectPropertyChanged);
+    FEditorDelegates::PostUndoRedo.AddRaw(this, &FMCPSceneChangeTracker::MarkFullRescan);
+    FEditorDelegates::MapChange.AddRaw(this, &FMCPSceneChangeTracker::HandleMapChange);
+    bDelegatesBound = true;
+}
+
+void FMCPSceneChangeTracker::Shutdown()
+{
+    if (bDelegatesBound)
+    {
+        if (GEngine)
+        {
+            GEngine->OnActorMoved().RemoveAll(this);
+            GEngine->OnLevelActorAdded().RemoveAll(this);
+            GEngine->OnLevelActorDeleted().RemoveAll(this);
+            GEngine->OnLevelActorFolderChanged().RemoveAll(this);
+            GEngine->OnLevelActorListChanged().RemoveAll(this);
+        }
+        FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+        FEditorDelegates::PostUndoRedo.RemoveAll(this);
+        FEditorDelegates::MapChange.RemoveAll(this);
+        bDelegatesBound = false;
+    }
+
+    Leaves.Empty();
+    FolderGroups.Empty();
+    ClassGroups.Empty();
+    DirtyActors.Empty();
+    TrackedWorld.Reset();
+    bNeedsFullRescan = true;
+    ActorChangeSerials.Empty();
+    FullInvalidationSerial = ++ChangeSerial;
+    FMCPSceneFragmentCache::Get().Reset();
+}
+
+void FMCPSceneChangeTracker::MarkFullRescan()
+{
+    bNeedsFullRescan = true;
+    FullInvalidationSerial = ++ChangeSerial;
+    ActorChangeSerials.Reset();
+}
+
+void FMCPSceneChangeTracker::MarkActorDirty(const AActor* Actor)
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    const FObjectKey ActorKey(Actor);
+    ActorChangeSerials.Add(ActorKey, ++ChangeSerial);
+
+    if (bNeedsFullRescan || Actor->GetWorld() != TrackedWorld.Get())
+    {
+        return;
+    }
+
+    DirtyActors.Add(ActorKey, Actor);
+}
+
+bool FMCPSceneChangeTracker::IsUnchangedSince(const FObjectKey& ActorKey, uint64 Serial) const
+{
+    return bDelegatesBound && Serial >= FullInvalidationSerial && ActorChangeSerials.FindRef(ActorKey) <= Serial;
+}
+
+void FMCPSceneChangeTracker::HandleActorChanged(AActor* Actor)
+{
+    MarkActorDirty(Actor);
+}
+
+void FMCPSceneChangeTracker::HandleActorDeleted(AActor* Actor)
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    // Deleted actors never come back under the same key without an undo, which invalidates everything,
+    // so their serials and cached rows can go
+    const FObjectKey ActorKey(Actor);
+    ++ChangeSerial;
+    ActorChangeSerials.Remove(ActorKey);
+    FMCPSceneFragmentCache::Get().RemoveActor(ActorKey);
+
+    if (bNeedsFullRescan || Actor->GetWorld() != TrackedWorld.Get())
+    {
+        return;
+    }
+
+    // The actor is still valid here but will not be by the next query, so drop it right away
+    DirtyActors.Remove(ActorKey);
+    RemoveActor(ActorKey);
+}
+
+void FMCPSceneChangeTracker::HandleActorFolderChanged(const AActor* Actor, FName OldPath)
+{
+    MarkActorDirty(Actor);
+}
+
+void FMCPSceneChangeTracker::HandleMapChange(uint32 MapChangeFlags)
+{
+    MarkFullRescan();
+
+    // Nothing of the previous map can be reused, so release its memory as well
+    ActorChangeSerials.Empty();
+    FMCPSceneFragmentCache::Get().Reset();
+}
+
+void FMCPSceneChangeTracker::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event)
+{
+    if (!Object)
+    {
+        return;
+    }
+
+    // Component edits (transform, mobility, ...) count as changes of the owning actor
+    const AActor* Actor = Cast<AActor>(Object);
+    if (!Actor)
+    {
+        Actor = Object->GetTypedOuter<AActor>();
+    }
+    MarkActorDirty(Actor);
+}
+
+uint64 FMCPSceneChangeTracker::ComputeLeafHash(const AActor* Actor)
+{
+    const FGuid ActorGuid = Actor->GetActorGuid();
+    const FTransform& Transform = Actor->GetActorTransform();
+    const FVector Location = Transform.GetLocation();
+    const FQuat Rotation = Transform.GetRotation();
+    const FVector Scale = Transform.GetScale3D();
+    const double TransformValues[] = {
+        Location.X, Location.Y, Location.Z,
+        Rotation.X, Rotation.Y, Rotation.Z, Rotation.W,
+        Scale.X, Scale.Y, Scale.Z
+    };
+
+    uint64 Hash = CityHash64(reinterpret_cast<const char*>(&ActorGuid), sizeof(FGuid));
+    Hash = CityHash64WithSeed(reinterpret_cast<const char*>(TransformValues), sizeof(TransformValues), Hash);
+    Hash = HashString(Actor->GetName(), Hash);
+    Hash = HashString(Actor->GetActorLabel(), Hash);
+    Hash = HashString(Actor->GetClass()->GetPathName(), Hash);
+    return Hash;
+}
+
+FString FMCPSceneChangeTracker::GetFolderGroupName(const AActor* Actor)
+{
+    const FName FolderPath = Actor->GetFolderPath();
+    return FolderPath.IsNone() ? FString(TEXT("/")) : FolderPath.ToString();
+}
+
+void FMCPSceneChangeTracker::RemoveActor(const FObjectKey& ActorKey)
+{
+    FLeaf Leaf;
+    if (!Leaves.RemoveAndCopyValue(ActorKey, Leaf))
+    {
+        return;
+    }
+
+    auto RemoveFromGroup = [&ActorKey](TMap<FString, FGroup>& Groups, const FString& GroupName)
+    {
+        if (FGroup* Group = Groups.Find(GroupName))
+        {
+            Group->Members.Remove(ActorKey);
+            Group->bDirty = true;
+            if (Group->Members.Num() == 0)
+            {
+                Groups.Remove(GroupName);
+            }
+        }
+    };
+    RemoveFromGroup(FolderGroups, Leaf.Folder);
+    RemoveFromGroup(ClassGroups, Leaf.ClassName);
+}
+
+void FMCPSceneChangeTracker::RehashActor(const AActor* Actor)
+{
+    const FObjectKey ActorKey(Actor);
+    const FString Folder = GetFolderGroupName(Actor);
+    const FString ClassName = Actor->GetClass()->GetName();
+
+    FLeaf* Leaf = Leaves.Find(ActorKey);
+    if (Leaf && (Leaf->Folder != Folder || Leaf->ClassName != ClassName))
+    {
+        RemoveActor(ActorKey);
+        Leaf = nullptr;
+    }
+
+    if (!Leaf)
+    {
+        Leaf = &Leaves.Add(ActorKey);
+        Leaf->Folder = Folder;
+        Leaf->ClassName = ClassName;
+        FolderGroups.FindOrAdd(Folder).Members.Add(ActorKey);
+        ClassGroups.FindOrAdd(ClassName).Members.Add(ActorKey);
+    }
+
+    Leaf->Guid = Actor->GetActorGuid();
+    const uint64 NewHash = ComputeLeafHash(Actor);
+    if (Leaf->Hash != NewHash)
+    {
+        Leaf->Hash = NewHash;
+        FolderGroups.FindChecked(Folder).bDirty = true;
+        ClassGroups.FindChecked(ClassName).bDirty = true;
+    }
+}
+
+void FMCPSceneChangeTracker::Rescan(UWorld* World)
+{
+    Leaves.Reset();
+    FolderGroups.Reset();
+    ClassGroups.Reset();
+    DirtyActors.Reset();
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        RehashActor(*It);
+    }
+
+    TrackedWorld = World;
+    bNeedsFullRescan = false;
+    MCP_LOG_VERBOSE("Scene change tracker rescanned %d actors", Leaves.Num());
+}
+
+void FMCPSceneChangeTracker::RecomputeGroups(TMap<FString, FGroup>& Groups)
+{
+    struct FLeafEntry
+    {
+        FGuid Guid;
+        uint64 Hash;
+    };
+
+    TArray<FLeafEntry> Entries;
+    for (TPair<FString, FGroup>& GroupPair : Groups)
+    {
+        FGroup& Group = GroupPair.Value;
+        if (!Group.bDirty)
+        {
+            continue;
+        }
+
+        // Sort by GUID so the group hash does not depend on iteration order
+        Entries.Reset(Group.Members.Num());
+        for (const FObjectKey& Member : Group.Members)
+        {
+            const FLeaf& Leaf = Leaves.FindChecked(Member);
+            Entries.Add({ Leaf.Guid, Leaf.Hash });
+        }
+        Entries.Sort([](const FLeafEntry& A, const FLeafEntry& B)
+        {
+            return A.Guid == B.Guid ? A.Hash < B.Hash : A.Guid < B.Guid;
+        });
+
+        Group.Hash = CityHash64(reinterpret_cast<const char*>(Entries.GetData()), Entries.Num() * sizeof(FLeafEntry));
+        Group.bDirty = false;
+    }
+}
+
+uint64 FMCPSceneChangeTracker::ComputeHashes(UWorld* World, EMCPSceneHashGrouping Grouping, TMap<FString, FMCPSceneHashGroup>& OutGroups)
+{
+    check(IsInGameThread());
+    EnsureTracking();
+
+    if (bNeedsFullRescan || TrackedWorld.Get() != World)
+    {
+        Rescan(World);
+    }
+    else if (DirtyActors.Num() > 0)
+    {
+        for (const TPair<FObjectKey, TWeakObjectPtr<const AActor>>& Dirty : DirtyActors)
+        {
+            const AActor* Actor = Dirty.Value.Get();
+            if (Actor && IsValid(Actor) && Actor->GetWorld() == World)
+            {
+                RehashActor(Actor);
+            }
+            else
+            {
+                RemoveActor(Dirty.Key);
+            }
+        }
+        DirtyActors.Reset();
+    }
+
+    TMap<FString, FGroup>& Groups = Grouping == EMCPSceneHashGrouping::Class ? ClassGroups : FolderGroups;
+    RecomputeGroups(Groups);
+
+    TArray<FString> GroupNames;
+    Groups.GetKeys(GroupNames);
+    GroupNames.Sort();
+
+    OutGroups.Reset();
+    uint64 RootHash = 0;
+    for (const FString& GroupName : GroupNames)
+    {
+        const FGroup& Group = Groups.FindChecked(GroupName);
+        RootHash = HashString(GroupName, RootHash);
+        RootHash = CityHash64WithSeed(reinterpret_cast<const char*>(&Group.Hash), sizeof(Group.Hash), RootHash);
+
+        FMCPSceneHashGroup& OutGroup = OutGroups.Add(GroupName);
+        OutGroup.Hash = Group.Hash;
+        OutGroup.ActorCount = Group.Members.Num();
+    }
+    return RootHash;
+}
+
+//
+// FMCPGetSceneHashHandler
+//
+TSharedPtr<FJsonObject> FMCPGetSceneHashHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling get_scene_hash command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    FString GroupBy = TEXT("folder");
+    Params->TryGetStringField(FStringView(TEXT("group_by")), GroupBy);
+    EMCPSceneHashGrouping Grouping;
+    if (GroupBy.Equals(TEXT("folder"), ESearchCase::IgnoreCase))
+    {
+        Grouping = EMCPSceneHashGrouping::Folder;
+    }
+    else if (GroupBy.Equals(TEXT("class"), ESearchCase::IgnoreCase))
+    {
+        Grouping = EMCPSceneHashGrouping::Class;
+    }
+    else
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Invalid group_by '%s'. Expected 'folder' or 'class'"), *GroupBy));
+    }
+
+    FMCPSceneChangeTracker& Tracker = FMCPSceneChangeTracker::Get();
+    TMap<FString, FMCPSceneHashGroup> Groups;
+    const FString RootHash = FormatSceneHash(Tracker.ComputeHashes(World, Grouping, Groups));
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("root_hash"), RootHash);
+    Result->SetStringField(TEXT("group_by"), GroupBy.ToLower());
+    Result->SetNumberField(TEXT("actor_count"), Tracker.GetTrackedActorCount());
+
+    // Nothing below the root is needed when the client already has this exact scene
+    FString KnownRootHash;
+    if (Params->TryGetStringField(FStringView(TEXT("known_root_hash")), KnownRootHash) && KnownRootHash.Equals(RootHash, ESearchCase::IgnoreCase))
+    {
+        Result->SetBoolField(TEXT("unchanged"), true);
+        return CreateSuccessResponse(Result);
+    }
+    Result->SetBoolField(TEXT("unchanged"), false);
+
+    // With known group hashes, only report the groups that differ
+    const TSharedPtr<FJsonObject>* KnownHashesObject = nullptr;
+    const bool bHasKnownHashes = Params->TryGetObjectField(FStringView(TEXT("known_hashes")), KnownHashesObject) && KnownHashesObject && KnownHashesObject->IsValid();
+
+    TSharedPtr<FJsonObject> GroupsObject = MakeShared<FJsonObject>();
+    for (const TPair<FString, FMCPSceneHashGroup>& Group : Groups)
+    {
+        const FString GroupHash = FormatSceneHash(Group.Value.Hash);
+        FString KnownGroupHash;
+        if (bHasKnownHashes && (*KnownHashesObject)->TryGetStringField(Group.Key, KnownGroupHash) && KnownGroupHash.Equals(GroupHash, ESearchCase::IgnoreCase))
+        {
+            continue;
+        }
+
+        TSharedPtr<FJsonObject> GroupObject = MakeShared<FJsonObject>();
+        GroupObject->SetStringField(TEXT("hash"), GroupHash);
+        GroupObject->SetNumberField(TEXT("actor_count"), Group.Value.ActorCount);
+        GroupsObject->SetObjectField(Group.Key, GroupObject);
+    }
+    Result->SetObjectField(TEXT("groups"), GroupsObject);
+
+    if (bHasKnownHashes)
+    {
+        TArray<TSharedPtr<FJsonValue>> RemovedGroups;
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& KnownGroup : (*KnownHashesObject)->Values)
+        {
+            if (!Groups.Contains(KnownGroup.Key))
+            {
+                RemovedGroups.Add(MakeShared<FJsonValueString>(KnownGroup.Key));
+            }
+        }
+        Result->SetArrayField(TEXT("removed_groups"), RemovedGroups);
+    }
+
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPSceneStatsHandler
+//
+TSharedPtr<FJsonObject> FMCPSceneStatsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling scene_stats command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    int32 TopN = MCPConstants::DEFAULT_SCENE_STATS_TOP_N;
+    Params->TryGetNumberField(FStringView(TEXT("top_n")), TopN);
+    TopN = FMath::Clamp(TopN, 0, MCPConstants::MAX_SCENE_STATS_TOP_N);
+
+    int32 MaxMeshes = MCPConstants::DEFAULT_SCENE_STATS_MESHES;
+    Params->TryGetNumberField(FStringView(TEXT("max_meshes")), MaxMeshes);
+    MaxMeshes = FMath::Max(MaxMeshes, 0);
+
+    // Game thread: copy the plain per-actor data
+    FSceneStatsInput Input;
+    TArray<const AActor*> Actors;
+    GatherSceneStatsInput(World, Input, Actors);
+
+    // Workers: reduce chunks independently, then merge the partials here
+    const int32 NumActors = Input.Actors.Num();
+    const int32 NumChunks = FMath::Clamp(NumActors / MinActorsPerStatsChunk, 1, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+    TArray<FSceneStatsPartial> Partials;
+    Partials.SetNum(NumChunks);
+    ParallelFor(NumChunks, [&Input, &Partials, NumActors, NumChunks, TopN](int32 ChunkIndex)
+    {
+        const int32 BeginIndex = static_cast<int32>(static_cast<int64>(NumActors) * ChunkIndex / NumChunks);
+        const int32 EndIndex = static_cast<int32>(static_cast<int64>(NumActors) * (ChunkIndex + 1) / NumChunks);
+        ReduceSceneStats(Input, BeginIndex, EndIndex, TopN, Partials[ChunkIndex]);
+    }, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    FSceneStatsPartial Total = MoveTemp(Partials[0]);
+    for (int32 ChunkIndex = 1; ChunkIndex < NumChunks; ++ChunkIndex)
+    {
+        const FSceneStatsPartial& Partial = Partials[ChunkIndex];
+        for (int32 Index = 0; Index < Total.ClassCounts.Num(); ++Index)
+        {
+            Total.ClassCounts[Index] += Partial.ClassCounts[Index];
+        }
+        for (int32 Index = 0; Index < Total.FolderCounts.Num(); ++Index)
+        {
+            Total.FolderCounts[Index] += Partial.FolderCounts[Index];
+        }
+        for (int32 Index = 0; Index < Total.MeshComponentCounts.Num(); ++Index)
+        {
+            Total.MeshComponentCounts[Index] += Partial.MeshComponentCounts[Index];
+            Total.MeshInstanceCounts[Index] += Partial.MeshInstanceCounts[Index];
+        }
+        for (int32 Slot = 0; Slot < NumStatsMobilitySlots; ++Slot)
+        {
+            Total.MobilityCounts[Slot] += Partial.MobilityCounts[Slot];
+        }
+        Total.Bounds += Partial.Bounds;
+        Total.Triangles += Partial.Triangles;
+        Total.MaterialSlots += Partial.MaterialSlots;
+        Total.PrimitiveComponents += Partial.PrimitiveComponents;
+        Total.LightActors += Partial.LightActors;
+        Total.LightComponents += Partial.LightComponents;
+        Total.TopActors.Append(Partial.TopActors);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("level"), World->GetName());
+    Result->SetNumberField(TEXT("actor_count"), NumActors);
+    Result->SetNumberField(TEXT("primitive_component_count"), static_cast<double>(Total.PrimitiveComponents));
+    Result->SetNumberField(TEXT("triangle_count_lod0"), static_cast<double>(Total.Triangles));
+    Result->SetNumberField(TEXT("material_slot_count"), static_cast<double>(Total.MaterialSlots));
+    Result->SetNumberField(TEXT("light_actor_count"), Total.LightActors);
+    Result->SetNumberField(TEXT("light_component_count"), static_cast<double>(Total.LightComponents));
+
+    if (Total.Bounds.IsValid)
+    {
+        TSharedPtr<FJsonObject> BoundsObject = MakeShared<FJsonObject>();
+        BoundsObject->SetArrayField(TEXT("min"), FMCPSceneQueryUtils::VectorToJsonArray(Total.Bounds.Min));
+        BoundsObject->SetArrayField(TEXT("max"), FMCPSceneQueryUtils::VectorToJsonArray(Total.Bounds.Max));
+        Result->SetObjectField(TEXT("bounds"), BoundsObject);
+    }
+
+    Result->SetObjectField(TEXT("by_class"), CountsToJson(Input.ClassNames, Total.ClassCounts));
+    Result->SetObjectField(TEXT("by_folder"), CountsToJson(Input.FolderNames, Total.FolderCounts));
+
+    TSharedPtr<FJsonObject> MobilityObject = MakeShared<FJsonObject>();
+    MobilityObject->SetNumberField(FMCPSceneQueryUtils::MobilityToString(EComponentMobility::Static), Total.MobilityCounts[EComponentMobility::Static]);
+    MobilityObject->SetNumberField(FMCPSceneQueryUtils::MobilityToString(EComponentMobility::Stationary), Total.MobilityCounts[EComponentMobility::Stationary]);
+    MobilityObject->SetNumberField(FMCPSceneQueryUtils::MobilityToString(EComponentMobility::Movable), Total.MobilityCounts[EComponentMobility::Movable]);
+    MobilityObject->SetNumberField(TEXT("none"), Total.MobilityCounts[NumStatsMobilitySlots - 1]);
+    Result->SetObjectField(TEXT("by_mobility"), MobilityObject);
+
+    // Static meshes, heaviest total triangle count first
+    TArray<int32> MeshOrder;
+    MeshOrder.Reserve(Input.Meshes.Num());
+    for (int32 MeshId = 0; MeshId < Input.Meshes.Num(); ++MeshId)
+    {
+        MeshOrder.Add(MeshId);
+    }
+    auto MeshTriangles = [&Input, &Total](int32 MeshId)
+    {
+        return static_cast<int64>(Input.Meshes[MeshId].TrianglesLOD0) * Total.MeshInstanceCounts[MeshId];
+    };
+    MeshOrder.Sort([&MeshTriangles](int32 A, int32 B) { return MeshTriangles(A) > MeshTriangles(B); });
+
+    TArray<TSharedPtr<FJsonValue>> MeshesArray;
+    for (int32 OrderIndex = 0; OrderIndex < FMath::Min(MaxMeshes, MeshOrder.Num()); ++OrderIndex)
+    {
+        const int32 MeshId = MeshOrder[OrderIndex];
+        const FStatsMeshInfo& Mesh = Input.Meshes[MeshId];
+        TSharedPtr<FJsonObject> MeshObject = MakeShared<FJsonObject>();
+        MeshObject->SetStringField(TEXT("mesh"), Mesh.Path);
+        MeshObject->SetNumberField(TEXT("components"), Total.MeshComponentCounts[MeshId]);
+        MeshObject->SetNumberField(TEXT("instances"), static_cast<double>(Total.MeshInstanceCounts[MeshId]));
+        MeshObject->SetNumberField(TEXT("triangles_lod0"), Mesh.TrianglesLOD0);
+        MeshObject->SetNumberField(TEXT("material_slots"), Mesh.MaterialSlots);
+        MeshObject->SetNumberField(TEXT("total_triangles_lod0"), static_cast<double>(MeshTriangles(MeshId)));
+        MeshesArray.Add(MakeShared<FJsonValueObject>(MeshObject));
+    }
+    Result->SetNumberField(TEXT("unique_static_mesh_count"), Input.Meshes.Num());
+    Result->SetArrayField(TEXT("static_meshes"), MeshesArray);
+
+    // Top actors: merge the per-chunk heaps; names are resolved here on the game thread
+    Total.TopActors.Sort([&Input](int32 A, int32 B) { return Input.Actors[A].PrimitiveCount > Input.Actors[B].PrimitiveCount; });
+    Total.TopActors.SetNum(FMath::Min(Total.TopActors.Num(), TopN));
+
+    TArray<TSharedPtr<FJsonValue>> TopArray;
+    for (const int32 ActorIndex : Total.TopActors)
+    {
+        const AActor* Actor = Actors[ActorIndex];
+        TSharedPtr<FJsonObject> ActorObject = MakeShared<FJsonObject>();
+        ActorObject->SetStringField(TEXT("name"), Actor->GetName());
+        ActorObject->SetStringField(TEXT("label"), Actor->GetActorLabel());
+        ActorObject->SetStringField(TEXT("class"), Input.ClassNames[Input.Actors[ActorIndex].ClassId]);
+        ActorObject->SetNumberField(TEXT("primitive_count"), Input.Actors[ActorIndex].PrimitiveCount);
+        TopArray.Add(MakeShared<FJsonValueObject>(ActorObject));
+    }
+    Result->SetArrayField(TEXT("top_actors_by_primitive_count"), TopArray);
+
+    MCP_LOG_INFO("scene_stats reduced %d actors in %d chunks", NumActors, NumChunks);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPSceneFragmentCache
+//
+FMCPSceneFragmentCache& FMCPSceneFragmentCache::Get()
+{
+    static FMCPSceneFragmentCache Instance;
+    return Instance;
+}
+
+void FMCPSceneFragmentCache::FindFragments(const FString& FieldsSignature, TArrayView<const AActor* const> Actors, TArray<TSharedPtr<const FString>>& OutFragments)
+{
+    check(IsInGameThread());
+    OutFragments.Reset();
+    OutFragments.SetNum(Actors.Num());
+
+    const FMCPSceneChangeTracker& Tracker = FMCPSceneChangeTracker::Get();
+    int32 HitCount = 0;
+
+    FScopeLock ScopeLock(&Lock);
+    const TMap<FObjectKey, FEntry>* SignatureEntries = Entries.Find(FieldsSignature);
+    if (!SignatureEntries)
+    {
+        return;
+    }
+
+    for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+    {
+        const AActor* Actor = Actors[ActorIndex];
+        const FObjectKey ActorKey(Actor);
+        const FEntry* Entry = SignatureEntries->Find(ActorKey);
+        if (Entry && Tracker.IsUnchangedSince(ActorKey, Entry->Serial) && Entry->Transform.Equals(Actor->GetActorTransform(), 0.0))
+        {
+            OutFragments[ActorIndex] = Entry->Fragment;
+            ++HitCount;
+        }
+    }
+
+    MCP_LOG_VERBOSE("Scene fragment cache: %d of %d rows reused", HitCount, Actors.Num());
+}
+
+void FMCPSceneFragmentCache::StoreFragments(const FString& FieldsSignature, uint64 GatherSerial, TArrayView<const FObjectKey> ActorKeys, TArrayView<const FTransform> Transforms, TArrayView<const TSharedPtr<const FString>> Fragments)
+{
+    FScopeLock ScopeLock(&Lock);
+    if (!Entries.Contains(FieldsSignature) && Entries.Num() >= MaxSignatures)
+    {
+        Entries.Reset();
+    }
+
+    TMap<FObjectKey, FEntry>& SignatureEntries = Entries.FindOrAdd(FieldsSignature);
+    if (SignatureEntries.Num() >= MaxFragmentsPerSignature)
+    {
+        SignatureEntries.Reset();
+    }
+
+    for (int32 Index = 0; Index < Fragments.Num(); ++Index)
+    {
+        if (Fragments[Index].IsValid())
+        {
+            FEntry& Entry = SignatureEntries.FindOrAdd(ActorKeys[Index]);
+            Entry.Fragment = Fragments[Index];
+            Entry.Serial = GatherSerial;
+            Entry.Transform = Transforms[Index];
+        }
+    }
+}
+
+void FMCPSceneFragmentCache::RemoveActor(const FObjectKey& ActorKey)
+{
+    FScopeLock ScopeLock(&Lock);
+    for (TPair<FString, TMap<FObjectKey, FEntry>>& SignatureEntries : Entries)
+    {
+        SignatureEntries.Value.Remove(ActorKey);
+    }
+}
+
+void FMCPSceneFragmentCache::Reset()
+{
+    FScopeLock ScopeLock(&Lock);
+    Entries.Empty();
+}
+
+//
+// FMCPSceneSnapshotPublisher
+//
+FMCPSceneSnapshotPublisher& FMCPSceneSnapshotPublisher::Get()
+{
+    static FMCPSceneSnapshotPublisher Instance;
+    return Instance;
+}
+
+TSharedPtr<const FMCPSceneReadSnapshot> FMCPSceneSnapshotPublisher::GetLatest() const
+{
+    FScopeLock ScopeLock(&LatestLock);
+    return Latest;
+}
+
+TSharedPtr<const FMCPSceneReadSnapshot> FMCPSceneSnapshotPublisher::GetUpToDate(UWorld* World)
+{
+    check(IsInGameThread());
+
+    // Publication only runs every frame once somebody reads snapshots
+    if (!TickerHandle.IsValid())
+    {
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMCPSceneSnapshotPublisher::Tick));
+    }
+
+    if (World && NeedsPublish(World))
+    {
+        Publish(World);
+    }
+    return GetLatest();
+}
+
+void FMCPSceneSnapshotPublisher::Shutdown()
+{
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+
+    {
+        FScopeLock ScopeLock(&LatestLock);
+        Latest.Reset();
+    }
+    EntriesByActor.Empty();
+    PublishedWorld.Reset();
+    bDirty = true;
+}
+
+bool FMCPSceneSnapshotPublisher::Tick(float DeltaTime)
+{
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (World && NeedsPublish(World))
+    {
+        Publish(World);
+    }
+    return true;
+}
+
+bool FMCPSceneSnapshotPublisher::NeedsPublish(UWorld* World) const
+{
+    return bDirty
+        || !GetLatest().IsValid()
+        || PublishedWorld.Get() != World
+        || FMCPSceneChangeTracker::Get().GetChangeSerial() != PublishedChangeSerial;
+}
+
+void FMCPSceneSnapshotPublisher::Publish(UWorld* World)
+{
+    FMCPSceneChangeTracker& Tracker = FMCPSceneChangeTracker::Get();
+    Tracker.EnsureTracking();
+
+    // A dirty mark means actors may have changed labels, tags, folders or components without events, so nothing is reused
+    const bool bReuseEntries = !bDirty && PublishedWorld.Get() == World;
+    TSharedRef<FMCPSceneReadSnapshot> Snapshot = MakeShared<FMCPSceneReadSnapshot>();
+    Snapshot->LevelName = World->GetName();
+    Snapshot->Actors.Reserve(World->GetActorCount());
+
+    TMap<FObjectKey, TSharedRef<const FMCPSceneActorSnapshot>> NewEntries;
+    NewEntries.Reserve(EntriesByActor.Num());
+
+    int32 ReusedCount = 0;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        const AActor* Actor = *It;
+        const FObjectKey ActorKey(Actor);
+
+        // Copy-on-write: unchanged actors keep the entry of the previous snapshot
+        const TSharedRef<const FMCPSceneActorSnapshot>* Existing = bReuseEntries ? EntriesByActor.Find(ActorKey) : nullptr;
+        if (Existing && Tracker.IsUnchangedSince(ActorKey, PublishedChangeSerial) && (*Existing)->Transform.Equals(Actor->GetActorTransform(), 0.0))
+        {
+            Snapshot->Actors.Add(*Existing);
+            NewEntries.Add(ActorKey, *Existing);
+            ++ReusedCount;
+            continue;
+        }
+
+        TSharedRef<FMCPSceneActorSnapshot> Entry = MakeShared<FMCPSceneActorSnapshot>();
+        Entry->Guid = Actor->GetActorGuid();
+        Entry->Name = Actor->GetName();
+        Entry->Label = Actor->GetActorLabel();
+        Entry->ClassName = Actor->GetClass()->GetFName();
+        Entry->Folder = Actor->GetFolderPath();
+        Entry->Transform = Actor->GetActorTransform();
+        Entry->Tags = Actor->Tags;
+
+        FVector Origin;
+        FVector Extent;
+        Actor->GetActorBounds(false, Origin, Extent);
+        Entry->Bounds = FBox::BuildAABB(Origin, Extent);
+
+        Snapshot->Actors.Add(Entry);
+        NewEntries.Add(ActorKey, Entry);
+    }
+
+    Snapshot->Version = NextVersion++;
+    {
+        FScopeLock ScopeLock(&LatestLock);
+        Latest = Snapshot;
+    }
+
+    EntriesByActor = MoveTemp(NewEntries);
+    PublishedWorld = World;
+    PublishedChangeSerial = Tracker.GetChangeSerial();
+    bDirty = false;
+
+    MCP_LOG_VERBOSE("Published scene snapshot %llu (%d actors, %d reused)", Snapshot->Version, Snapshot->Actors.Num(), ReusedCount);
+}
+
+//
+// FMCPQuerySceneHandler
+//
+TSharedPtr<FJsonObject> FMCPQuerySceneHandler::RunQuery(const FMCPSceneReadSnapshot& Snapshot, const TSharedPtr<FJsonObject>& Params)
+{
+    FString ClassFilter;
+    FString LabelFilter;
+    FString TagFilter;
+    FString FolderFilter;
+    Params->TryGetStringField(FStringView(TEXT("class")), ClassFilter);
+    Params->TryGetStringField(FStringView(TEXT("label")), LabelFilter);
+    Params->TryGetStringField(FStringView(TEXT("tag")), TagFilter);
+    Params->TryGetStringField(FStringView(TEXT("folder")), FolderFilter);
+    const FName ClassName = ClassFilter.IsEmpty() ? NAME_None : FName(*ClassFilter, FNAME_Find);
+    const FName TagName = TagFilter.IsEmpty() ? NAME_None : FName(*TagFilter, FNAME_Find);
+
+    auto ReadVector = [](const TCHAR* FieldName, FVector& OutVector, const TSharedPtr<FJsonObject>& Object)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (!Object->TryGetArrayField(FStringView(FieldName), Values) || !Values || Values->Num() != 3)
+        {
+            return false;
+        }
+        OutVector = FVector((*Values)[0]->AsNumber(), (*Values)[1]->AsNumber(), (*Values)[2]->AsNumber());
+        return true;
+    };
+
+    FBox FilterBox(ForceInit);
+    const TSharedPtr<FJsonObject>* BoundsObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("bounds")), BoundsObject) && BoundsObject && BoundsObject->IsValid())
+    {
+        FVector Min;
+        FVector Max;
+        if (ReadVector(TEXT("min"), Min, *BoundsObject) && ReadVector(TEXT("max"), Max, *BoundsObject))
+        {
+            FilterBox = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+        }
+    }
+
+    FVector Center = FVector::ZeroVector;
+    double Radius = -1.0;
+    const bool bHasSphere = ReadVector(TEXT("center"), Center, Params) && Params->TryGetNumberField(FStringView(TEXT("radius")), Radius) && Radius >= 0.0;
+    const double RadiusSquared = Radius * Radius;
+
+    int32 MaxResults = MCPConstants::DEFAULT_SCENE_QUERY_RESULTS;
+    Params->TryGetNumberField(FStringView(TEXT("max_results")), MaxResults);
+    MaxResults = FMath::Clamp(MaxResults, 0, MCPConstants::MAX_SCENE_QUERY_RESULTS);
+
+    // A class or tag name that was never created cannot match anything
+    const bool bUnknownName = (!ClassFilter.IsEmpty() && ClassName.IsNone()) || (!TagFilter.IsEmpty() && TagName.IsNone());
+
+    struct FMatch
+    {
+        int32 ActorIndex;
+        double DistanceSquared;
+    };
+    TArray<FMatch> Matches;
+    TMap<FName, int32> CountsByClass;
+
+    for (int32 ActorIndex = 0; !bUnknownName && ActorIndex < Snapshot.Actors.Num(); ++ActorIndex)
+    {
+        const FMCPSceneActorSnapshot& Entry = *Snapshot.Actors[ActorIndex];
+        if (!ClassName.IsNone() && Entry.ClassName != ClassName)
+        {
+            continue;
+        }
+        if (!TagName.IsNone() && !Entry.Tags.Contains(TagName))
+        {
+            continue;
+        }
+        if (!LabelFilter.IsEmpty() && !Entry.Label.Contains(LabelFilter))
+        {
+            continue;
+        }
+        if (!FolderFilter.IsEmpty() && !Entry.Folder.ToString().StartsWith(FolderFilter))
+        {
+            continue;
+        }
+
+        const FVector Location = Entry.Transform.GetLocation();
+        if (FilterBox.IsValid && !(Entry.Bounds.IsValid ? Entry.Bounds.Intersect(FilterBox) : FilterBox.IsInsideOrOn(Location)))
+        {
+            continue;
+        }
+
+        const double DistanceSquared = bHasSphere ? FVector::DistSquared(Location, Center) : 0.0;
+        if (bHasSphere && DistanceSquared > RadiusSquared)
+        {
+            continue;
+        }
+
+        Matches.Add({ ActorIndex, DistanceSquared });
+        ++CountsByClass.FindOrAdd(Entry.ClassName);
+    }
+
+    if (bHasSphere)
+    {
+        Matches.Sort([](const FMatch& A, const FMatch& B) { return A.DistanceSquared < B.DistanceSquared; });
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    for (int32 MatchIndex = 0; MatchIndex < FMath::Min(Matches.Num(), MaxResults); ++MatchIndex)
+    {
+        const FMatch& Match = Matches[MatchIndex];
+        const FMCPSceneActorSnapshot& Entry = *Snapshot.Actors[Match.ActorIndex];
+
+        TSharedPtr<FJsonObject> ActorObject = MakeShared<FJsonObject>();
+        ActorObject->SetStringField(TEXT("name"), Entry.Name);
+        ActorObject->SetStringField(TEXT("label"), Entry.Label);
+        ActorObject->SetStringField(TEXT("class"), Entry.ClassName.ToString());
+        ActorObject->SetStringField(TEXT("guid"), Entry.Guid.ToString(EGuidFormats::DigitsWithHyphens));
+        ActorObject->SetStringField(TEXT("folder"), Entry.Folder.IsNone() ? FString() : Entry.Folder.ToString());
+        ActorObject->SetArrayField(TEXT("location"), FMCPSceneQueryUtils::VectorToJsonArray(Entry.Transform.GetLocation()));
+        ActorObject->SetArrayField(TEXT("rotation"), FMCPSceneQueryUtils::RotatorToJsonArray(Entry.Transform.Rotator()));
+        ActorObject->SetArrayField(TEXT("scale"), FMCPSceneQueryUtils::VectorToJsonArray(Entry.Transform.GetScale3D()));
+        if (Entry.Bounds.IsValid)
+        {
+            TSharedPtr<FJsonObject> BoundsJson = MakeShared<FJsonObject>();
+            BoundsJson->SetArrayField(TEXT("origin"), FMCPSceneQueryUtils::VectorToJsonArray(Entry.Bounds.GetCenter()));
+            BoundsJson->SetArrayField(TEXT("extent"), FMCPSceneQueryUtils::VectorToJsonArray(Entry.Bounds.GetExtent()));
+            ActorObject->SetObjectField(TEXT("bounds"), BoundsJson);
+        }
+
+        TArray<TSharedPtr<FJsonValue>> TagsArray;
+        for (const FName& Tag : Entry.Tags)
+        {
+            TagsArray.Add(MakeShared<FJsonValueString>(Tag.ToString()));
+        }
+        ActorObject->SetArrayField(TEXT("tags"), TagsArray);
+
+        if (bHasSphere)
+        {
+            ActorObject->SetNumberField(TEXT("distance"), FMath::Sqrt(Match.DistanceSquared));
+        }
+        ActorsArray.Add(MakeShared<FJsonValueObject>(ActorObject));
+    }
+
+    TSharedPtr<FJsonObject> CountsObject = MakeShared<FJsonObject>();
+    for (const TPair<FName, int32>& Count : CountsByClass)
+    {
+        CountsObject->SetNumberField(Count.Key.ToString(), Count.Value);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("snapshot_version"), static_cast<double>(Snapshot.Version));
+    Result->SetStringField(TEXT("level"), Snapshot.LevelName);
+    Result->SetNumberField(TEXT("actor_count"), Snapshot.Actors.Num());
+    Result->SetNumberField(TEXT("matched_count"), Matches.Num());
+    Result->SetNumberField(TEXT("returned_count"), ActorsArray.Num());
+    Result->SetBoolField(TEXT("truncated"), Matches.Num() > ActorsArray.Num());
+    Result->SetObjectField(TEXT("counts_by_class"), CountsObject);
+    Result->SetArrayField(TEXT("actors"), ActorsArray);
+    return Result;
+}
+
+TSharedPtr<FJsonObject> FMCPQuerySceneHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling query_scene command");
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!World)
+    {
+        return CreateErrorResponse(TEXT("Editor world is not available"));
+    }
+
+    const TSharedPtr<const FMCPSceneReadSnapshot> Snapshot = FMCPSceneSnapshotPublisher::Get().GetUpToDate(World);
+    if (!Snapshot.IsValid())
+    {
+        return CreateErrorResponse(TEXT("Scene snapshot is not available"));
+    }
+    return CreateSuccessResponse(RunQuery(*Snapshot, Params));
+}
+
+bool FMCPQuerySceneHandler::ExecuteDeferred(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket, TFuture<FString>& OutResponse)
+{
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    const TSharedPtr<const FMCPSceneReadSnapshot> Snapshot = World ? FMCPSceneSnapshotPublisher::Get().GetUpToDate(World) : nullptr;
+    if (!Snapshot.IsValid())
+    {
+        return false;
+    }
+
+    // The snapshot is immutable, so the query runs on a worker while the game thread keeps editing
+    MCP_LOG_INFO("Handling query_scene command against snapshot %llu", Snapshot->Version);
+    OutResponse = Async(EAsyncExecution::ThreadPool, [Snapshot, Params]()
+    {
+        return FMCPSceneQueryUtils::SerializeSuccessResponse(RunQuery(*Snapshot, Params));
+    });
+    return true;
+}
@@ -0,0 +1,414 @@
+#include "MCPCommandHandlers_WorldPartition.h"
+
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+#include "Editor.h"
+#include "Engine/World.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionActorDescInstance.h"
+#include "WorldPartition/WorldPartitionEditorLoaderAdapter.h"
+#include "WorldPartition/WorldPartitionHelpers.h"
+
+namespace
+{
+    /** Editor delegates that forget the loaded regions of the previous map */
+    FDelegateHandle MapChangeHandle;
+    FDelegateHandle MapOpenedHandle;
+
+    /** Read a 3-component number array. */
+    bool TryGetVectorField(const TSharedPtr<FJsonObject>& Object, const TCHAR* FieldName, FVector& OutVector)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+        if (!Object->TryGetArrayField(FStringView(FieldName), Values) || !Values || Values->Num() != 3)
+        {
+            return false;
+        }
+
+        OutVector = FVector((*Values)[0]->AsNumber(), (*Values)[1]->AsNumber(), (*Values)[2]->AsNumber());
+        return true;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> VectorToJson(const FVector& Vector)
+    {
+        return {
+            MakeShared<FJsonValueNumber>(Vector.X),
+            MakeShared<FJsonValueNumber>(Vector.Y),
+            MakeShared<FJsonValueNumber>(Vector.Z)
+        };
+    }
+
+    TSharedPtr<FJsonObject> BoxToJson(const FBox& Box)
+    {
+        TSharedPtr<FJsonObject> BoxObject = MakeShared<FJsonObject>();
+        BoxObject->SetArrayField(TEXT("min"), VectorToJson(Box.Min));
+        BoxObject->SetArrayField(TEXT("max"), VectorToJson(Box.Max));
+        return BoxObject;
+    }
+
+    /** Count the descriptors overlapping the box that currently have a loaded actor. */
+    int32 CountLoadedActorsInBox(UWorldPartition* WorldPartition, const FBox& Box)
+    {
+        int32 LoadedCount = 0;
+        FWorldPartitionHelpers::ForEachActorDescInstance(WorldPartition, AActor::StaticClass(), [&Box, &LoadedCount](const FWorldPartitionActorDescInstance* ActorDescInstance)
+        {
+            if (ActorDescInstance->IsLoaded() && ActorDescInstance->GetEditorBounds().Intersect(Box))
+            {
+                ++LoadedCount;
+            }
+            return true;
+        });
+        return LoadedCount;
+    }
+}
+
+UWorldPartition* FMCPWorldPartitionUtils::GetEditorWorldPartition(UWorld*& OutWorld, FString& OutErrorMessage)
+{
+    OutWorld = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!OutWorld)
+    {
+        OutErrorMessage = TEXT("Editor world is not available");
+        return nullptr;
+    }
+
+    UWorldPartition* WorldPartition = OutWorld->GetWorldPartition();
+    if (!WorldPartition)
+    {
+        OutErrorMessage = FString::Printf(TEXT("World '%s' does not use World Partition; use get_scene_info instead"), *OutWorld->GetName());
+        return nullptr;
+    }
+
+    return WorldPartition;
+}
+
+bool FMCPWorldPartitionUtils::ParseBox(const TSharedPtr<FJsonObject>& Params, FBox& OutBox)
+{
+    const TSharedPtr<FJsonObject>* BoundsObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("bounds")), BoundsObject) && BoundsObject && BoundsObject->IsValid())
+    {
+        FVector Min;
+        FVector Max;
+        if (!TryGetVectorField(*BoundsObject, TEXT("min"), Min) || !TryGetVectorField(*BoundsObject, TEXT("max"), Max))
+        {
+            return false;
+        }
+
+        OutBox = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+        return true;
+    }
+
+    FVector Center;
+    FVector Extent;
+    if (TryGetVectorField(Params, TEXT("center"), Center) && TryGetVectorField(Params, TEXT("extent"), Extent))
+    {
+        OutBox = FBox::BuildAABB(Center, Extent.GetAbs());
+        return true;
+    }
+
+    return false;
+}
+
+TArray<FGuid> FMCPWorldPartitionUtils::ParseActorGuids(const TSharedPtr<FJsonObject>& Params)
+{
+    TArray<FGuid> Guids;
+    const TArray<TSharedPtr<FJsonValue>>* GuidValues = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("actor_guids")), GuidValues) && GuidValues)
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *GuidValues)
+        {
+            FGuid Guid;
+            if (Value.IsValid() && FGuid::Parse(Value->AsString(), Guid))
+            {
+                Guids.Add(Guid);
+            }
+            else
+            {
+                MCP_LOG_WARNING("Ignoring invalid actor GUID in actor_guids");
+            }
+        }
+    }
+    return Guids;
+}
+
+TMap<FString, TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter>>& FMCPWorldPartitionUtils::GetLoadedRegions()
+{
+    static TMap<FString, TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter>> LoadedRegions;
+
+    // Adapters belong to the world they were created in, so region ids must not outlive it
+    if (!MapChangeHandle.IsValid())
+    {
+        MapChangeHandle = FEditorDelegates::MapChange.AddLambda([](uint32 MapChangeFlags)
+        {
+            GetLoadedRegions().Empty();
+        });
+        MapOpenedHandle = FEditorDelegates::OnMapOpened.AddLambda([](const FString& Filename, bool bAsTemplate)
+        {
+            GetLoadedRegions().Empty();
+        });
+    }
+    return LoadedRegions;
+}
+
+void FMCPWorldPartitionUtils::Shutdown()
+{
+    // Emptied first, since GetLoadedRegions binds the delegates again when they are unbound
+    GetLoadedRegions().Empty();
+    FEditorDelegates::MapChange.Remove(MapChangeHandle);
+    FEditorDelegates::OnMapOpened.Remove(MapOpenedHandle);
+    MapChangeHandle.Reset();
+    MapOpenedHandle.Reset();
+}
+
+//
+// FMCPQueryWorldPartitionHandler
+//
+TSharedPtr<FJsonObject> FMCPQueryWorldPartitionHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling query_world_partition command");
+
+    UWorld* World = nullptr;
+    FString ErrorMessage;
+    UWorldPartition* WorldPartition = FMCPWorldPartitionUtils::GetEditorWorldPartition(World, ErrorMessage);
+    if (!WorldPartition)
+    {
+        return CreateErrorResponse(ErrorMessage);
+    }
+
+    FString ClassFilter;
+    FString LabelFilter;
+    FString DataLayerFilter;
+    Params->TryGetStringField(FStringView(TEXT("class")), ClassFilter);
+    Params->TryGetStringField(FStringView(TEXT("label")), LabelFilter);
+    Params->TryGetStringField(FStringView(TEXT("data_layer")), DataLayerFilter);
+
+    FBox FilterBox(ForceInit);
+    const bool bHasBoxFilter = FMCPWorldPartitionUtils::ParseBox(Params, FilterBox);
+
+    // Optional loaded-state filter: true = loaded only, false = unloaded only
+    bool bLoadedFilter = false;
+    const bool bHasLoadedFilter = Params->TryGetBoolField(FStringView(TEXT("loaded")), bLoadedFilter);
+
+    int32 MaxResults = MCPConstants::DEFAULT_WORLD_PARTITION_DESCRIPTORS;
+    Params->TryGetNumberField(FStringView(TEXT("max_results")), MaxResults);
+    MaxResults = FMath::Clamp(MaxResults, 1, MCPConstants::MAX_WORLD_PARTITION_DESCRIPTORS);
+
+    TArray<TSharedPtr<FJsonValue>> Descriptors;
+    int32 TotalDescriptors = 0;
+    int32 MatchedCount = 0;
+    int32 LoadedCount = 0;
+
+    FWorldPartitionHelpers::ForEachActorDescInstance(WorldPartition, AActor::StaticClass(), [&](const FWorldPartitionActorDescInstance* ActorDescInstance)
+    {
+        ++TotalDescriptors;
+
+        const bool bIsLoaded = ActorDescInstance->IsLoaded();
+        if (bHasLoadedFilter && bIsLoaded != bLoadedFilter)
+        {
+            return true;
+        }
+
+        const FBox EditorBounds = ActorDescInstance->GetEditorBounds();
+        if (bHasBoxFilter && !EditorBounds.Intersect(FilterBox))
+        {
+            return true;
+        }
+
+        // Blueprint classes are matched through the base class path so nothing has to be loaded
+        const UClass* NativeClass = ActorDescInstance->GetActorNativeClass();
+        const FString NativeClassName = NativeClass ? NativeClass->GetName() : FString();
+        const FString BaseClassPath = ActorDescInstance->GetBaseClass().IsValid() ? ActorDescInstance->GetBaseClass().ToString() : FString();
+        if (!ClassFilter.IsEmpty() && !NativeClassName.Equals(ClassFilter, ESearchCase::IgnoreCase) && !BaseClassPath.Contains(ClassFilter))
+        {
+            return true;
+        }
+
+        const FString Label = ActorDescInstance->GetActorLabel().ToString();
+        if (!LabelFilter.IsEmpty() && !Label.Contains(LabelFilter))
+        {
+            return true;
+        }
+
+        const TArray<FName> DataLayers = ActorDescInstance->GetDataLayerInstanceNames().ToArray();
+        if (!DataLayerFilter.IsEmpty() && !DataLayers.ContainsByPredicate([&DataLayerFilter](const FName& DataLayer) { return DataLayer.ToString().Contains(DataLayerFilter); }))
+        {
+            return true;
+        }
+
+        ++MatchedCount;
+        LoadedCount += bIsLoaded ? 1 : 0;
+        if (Descriptors.Num() >= MaxResults)
+        {
+            return true;
+        }
+
+        TSharedPtr<FJsonObject> Descriptor = MakeShared<FJsonObject>();
+        Descriptor->SetStringField(TEXT("guid"), ActorDescInstance->GetGuid().ToString(EGuidFormats::DigitsWithHyphens));
+        Descriptor->SetStringField(TEXT("name"), ActorDescInstance->GetActorName().ToString());
+        Descriptor->SetStringField(TEXT("label"), Label);
+        Descriptor->SetStringField(TEXT("class"), NativeClassName);
+        if (!BaseClassPath.IsEmpty())
+        {
+            Descriptor->SetStringField(TEXT("base_class"), BaseClassPath);
+        }
+        Descriptor->SetStringField(TEXT("package"), ActorDescInstance->GetActorPackage().ToString());
+        Descriptor->SetObjectField(TEXT("bounds"), BoxToJson(EditorBounds));
+        Descriptor->SetStringField(TEXT("runtime_grid"), ActorDescInstance->GetRuntimeGrid().ToString());
+        Descriptor->SetBoolField(TEXT("spatially_loaded"), ActorDescInstance->GetIsSpatiallyLoaded());
+        Descriptor->SetBoolField(TEXT("loaded"), bIsLoaded);
+
+        TArray<TSharedPtr<FJsonValue>> DataLayerValues;
+        for (const FName& DataLayer : DataLayers)
+        {
+            DataLayerValues.Add(MakeShared<FJsonValueString>(DataLayer.ToString()));
+        }
+        Descriptor->SetArrayField(TEXT("data_layers"), DataLayerValues);
+
+        Descriptors.Add(MakeShared<FJsonValueObject>(Descriptor));
+        return true;
+    });
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("world"), World->GetName());
+    Result->SetNumberField(TEXT("total_descriptors"), TotalDescriptors);
+    Result->SetNumberField(TEXT("matched_count"), MatchedCount);
+    Result->SetNumberField(TEXT("matched_loaded_count"), LoadedCount);
+    Result->SetNumberField(TEXT("returned_count"), Descriptors.Num());
+    Result->SetBoolField(TEXT("truncated"), MatchedCount > Descriptors.Num());
+    Result->SetArrayField(TEXT("descriptors"), Descriptors);
+
+    MCP_LOG_INFO("query_world_partition matched %d of %d descriptors", MatchedCount, TotalDescriptors);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPLoadWorldPartitionRegionHandler
+//
+TSharedPtr<FJsonObject> FMCPLoadWorldPartitionRegionHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling load_world_partition_region command");
+
+    UWorld* World = nullptr;
+    FString ErrorMessage;
+    UWorldPartition* WorldPartition = FMCPWorldPartitionUtils::GetEditorWorldPartition(World, ErrorMessage);
+    if (!WorldPartition)
+    {
+        return CreateErrorResponse(ErrorMessage);
+    }
+
+    FBox Box(ForceInit);
+    const bool bHasBox = FMCPWorldPartitionUtils::ParseBox(Params, Box);
+    const TArray<FGuid> ActorGuids = FMCPWorldPartitionUtils::ParseActorGuids(Params);
+    if (!bHasBox && ActorGuids.Num() == 0)
+    {
+        return CreateErrorResponse(TEXT("Specify 'bounds' (min/max), 'center' and 'extent', or 'actor_guids'"));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+
+    if (bHasBox)
+    {
+        static int32 NextRegionIndex = 0;
+        FString RegionId;
+        if (!Params->TryGetStringField(FStringView(TEXT("region_id")), RegionId) || RegionId.IsEmpty())
+        {
+            RegionId = FString::Printf(TEXT("MCP_Region_%d"), ++NextRegionIndex);
+        }
+
+        TMap<FString, TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter>>& LoadedRegions = FMCPWorldPartitionUtils::GetLoadedRegions();
+        if (const TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter>* Existing = LoadedRegions.Find(RegionId); Existing && Existing->IsValid())
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Region '%s' is already loaded; unload it first or use another region_id"), *RegionId));
+        }
+
+        UWorldPartitionEditorLoaderAdapter* EditorLoaderAdapter = WorldPartition->CreateEditorLoaderAdapter<FLoaderAdapterShape>(World, Box, RegionId);
+        if (!EditorLoaderAdapter || !EditorLoaderAdapter->GetLoaderAdapter())
+        {
+            return CreateErrorResponse(TEXT("Failed to create a World Partition loader adapter"));
+        }
+
+        IWorldPartitionActorLoaderInterface::ILoaderAdapter* LoaderAdapter = EditorLoaderAdapter->GetLoaderAdapter();
+        LoaderAdapter->SetUserCreated(true);
+        LoaderAdapter->Load();
+        LoadedRegions.Add(RegionId, EditorLoaderAdapter);
+
+        Result->SetStringField(TEXT("region_id"), RegionId);
+        Result->SetObjectField(TEXT("bounds"), BoxToJson(Box));
+        Result->SetNumberField(TEXT("loaded_actor_count"), CountLoadedActorsInBox(WorldPartition, Box));
+        MCP_LOG_INFO("Loaded World Partition region %s", *RegionId);
+    }
+
+    if (ActorGuids.Num() > 0)
+    {
+        WorldPartition->PinActors(ActorGuids);
+        Result->SetNumberField(TEXT("pinned_actor_count"), ActorGuids.Num());
+        MCP_LOG_INFO("Pinned %d World Partition actors", ActorGuids.Num());
+    }
+
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPUnloadWorldPartitionRegionHandler
+//
+TSharedPtr<FJsonObject> FMCPUnloadWorldPartitionRegionHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling unload_world_partition_region command");
+
+    UWorld* World = nullptr;
+    FString ErrorMessage;
+    UWorldPartition* WorldPartition = FMCPWorldPartitionUtils::GetEditorWorldPartition(World, ErrorMessage);
+    if (!WorldPartition)
+    {
+        return CreateErrorResponse(ErrorMessage);
+    }
+
+    TMap<FString, TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter>>& LoadedRegions = FMCPWorldPartitionUtils::GetLoadedRegions();
+
+    TArray<FString> RegionIds;
+    bool bUnloadAll = false;
+    FString RegionId;
+    if (Params->TryGetBoolField(FStringView(TEXT("all")), bUnloadAll) && bUnloadAll)
+    {
+        LoadedRegions.GetKeys(RegionIds);
+    }
+    else if (Params->TryGetStringField(FStringView(TEXT("region_id")), RegionId))
+    {
+        if (!LoadedRegions.Contains(RegionId))
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown region '%s'"), *RegionId));
+        }
+        RegionIds.Add(RegionId);
+    }
+
+    const TArray<FGuid> ActorGuids = FMCPWorldPartitionUtils::ParseActorGuids(Params);
+    if (RegionIds.Num() == 0 && ActorGuids.Num() == 0 && !bUnloadAll)
+    {
+        return CreateErrorResponse(TEXT("Specify 'region_id', 'all' or 'actor_guids'"));
+    }
+
+    TArray<TSharedPtr<FJsonValue>> UnloadedRegions;
+    for (const FString& Id : RegionIds)
+    {
+        TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter> EditorLoaderAdapter = LoadedRegions.FindAndRemoveChecked(Id);
+        if (EditorLoaderAdapter.IsValid())
+        {
+            if (IWorldPartitionActorLoaderInterface::ILoaderAdapter* LoaderAdapter = EditorLoaderAdapter->GetLoaderAdapter())
+            {
+                LoaderAdapter->Unload();
+            }
+            WorldPartition->ReleaseEditorLoaderAdapter(EditorLoaderAdapter.Get());
+        }
+        UnloadedRegions.Add(MakeShared<FJsonValueString>(Id));
+    }
+
+    if (ActorGuids.Num() > 0)
+    {
+        WorldPartition->UnpinActors(ActorGuids);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField(TEXT("unloaded_regions"), UnloadedRegions);
+    Result->SetNumberField(TEXT("unpinned_actor_count"), ActorGuids.Num());
+    return CreateSuccessResponse(Result);
+}
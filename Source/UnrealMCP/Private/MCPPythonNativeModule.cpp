@@ -0,0 +1,709 @@
+#include "MCPPythonNativeModule.h"
+
+#include "MCPFileLogger.h"
+#include "MCPTCPServer.h"
+#include "UnrealMCP.h"
+
+#include "Editor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "IPythonScriptPlugin.h"
+#include "Modules/ModuleManager.h"
+#include "ScopedTransaction.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_PYTHON
+
+THIRD_PARTY_INCLUDES_START
+#include "Python.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+    /**
+     * Doubles per actor in the transforms array: location XYZ, rotation pitch/yaw/roll, scale XYZ.
+     * float64 because float32 cannot hold large world coordinates to a useful precision past ~1e5 units.
+     */
+    constexpr int32 TransformStride = 9;
+
+    /** Floats per actor in the bounds array: origin XYZ, extent XYZ */
+    constexpr int32 BoundsStride = 6;
+
+    /** Snapshots kept for apply_transforms */
+    constexpr int32 MaxRetainedSnapshots = 4;
+
+    /** Nesting limit when converting dispatch params and responses */
+    constexpr int32 MaxJsonDepth = 64;
+
+    /** C++ side of a snapshot handed to Python: the actors and the values they had */
+    struct FNativeSnapshot
+    {
+        int64 Id = 0;
+        TArray<TWeakObjectPtr<AActor>> Actors;
+        TArray<double> OriginalTransforms;
+    };
+
+    TArray<FNativeSnapshot> RetainedSnapshots;
+    int64 NextSnapshotId = 1;
+    FDelegateHandle PythonInitializedHandle;
+    bool bRegisteredWithInterpreter = false;
+
+    /** Wrap part of the buffer object as a memoryview cast to the given format and shape. */
+    PyObject* MakeView(PyObject* Buffer, Py_ssize_t ByteOffset, Py_ssize_t ByteLength, const char* Format, Py_ssize_t Rows, Py_ssize_t Columns)
+    {
+        PyObject* FullView = PyMemoryView_FromObject(Buffer);
+        if (!FullView)
+        {
+            return nullptr;
+        }
+
+        PyObject* Start = PyLong_FromSsize_t(ByteOffset);
+        PyObject* Stop = PyLong_FromSsize_t(ByteOffset + ByteLength);
+        PyObject* Slice = PySlice_New(Start, Stop, nullptr);
+        Py_XDECREF(Start);
+        Py_XDECREF(Stop);
+        PyObject* SlicedView = Slice ? PyObject_GetItem(FullView, Slice) : nullptr;
+        Py_XDECREF(Slice);
+        Py_DECREF(FullView);
+        if (!SlicedView)
+        {
+            return nullptr;
+        }
+
+        // memoryview.cast rejects zero-sized dimensions, so an empty snapshot stays one-dimensional
+        PyObject* CastView = Columns > 1 && Rows > 0
+            ? PyObject_CallMethod(SlicedView, "cast", "s(nn)", Format, Rows, Columns)
+            : PyObject_CallMethod(SlicedView, "cast", "s", Format);
+        Py_DECREF(SlicedView);
+        return CastView;
+    }
+
+    UWorld* GetEditorWorld()
+    {
+        return GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    }
+
+    PyObject* Snapshot(PyObject* Self, PyObject* Args, PyObject* Kwargs)
+    {
+        static const char* Keywords[] = { "class_name", nullptr };
+        const char* ClassNameUtf8 = nullptr;
+        if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "|z", const_cast<char**>(Keywords), &ClassNameUtf8))
+        {
+            return nullptr;
+        }
+
+        UWorld* World = GetEditorWorld();
+        if (!World)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Editor world is not available");
+            return nullptr;
+        }
+
+        const FString ClassFilter = ClassNameUtf8 ? FString(UTF8_TO_TCHAR(ClassNameUtf8)) : FString();
+
+        FNativeSnapshot NativeSnapshot;
+        NativeSnapshot.Id = NextSnapshotId++;
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            if (ClassFilter.IsEmpty() || It->GetClass()->GetName().Equals(ClassFilter, ESearchCase::IgnoreCase))
+            {
+                NativeSnapshot.Actors.Add(*It);
+            }
+        }
+
+        const Py_ssize_t Count = NativeSnapshot.Actors.Num();
+        const Py_ssize_t TransformBytes = Count * TransformStride * sizeof(double);
+        const Py_ssize_t BoundsBytes = Count * BoundsStride * sizeof(float);
+        const Py_ssize_t ClassIdBytes = Count * sizeof(int32);
+
+        // One contiguous, writable buffer owned by Python; the arrays are filled in place
+        PyObject* Buffer = PyByteArray_FromStringAndSize(nullptr, TransformBytes + BoundsBytes + ClassIdBytes);
+        if (!Buffer)
+        {
+            return nullptr;
+        }
+
+        uint8* Data = reinterpret_cast<uint8*>(PyByteArray_AsString(Buffer));
+        double* Transforms = reinterpret_cast<double*>(Data);
+        float* Bounds = reinterpret_cast<float*>(Data + TransformBytes);
+        int32* ClassIds = reinterpret_cast<int32*>(Data + TransformBytes + BoundsBytes);
+
+        PyObject* Names = PyList_New(Count);
+        PyObject* Labels = PyList_New(Count);
+        PyObject* ClassNames = PyList_New(0);
+        TMap<const UClass*, int32> ClassToId;
+
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const AActor* Actor = NativeSnapshot.Actors[Index].Get();
+            const FTransform& Transform = Actor->GetActorTransform();
+            const FVector Location = Transform.GetLocation();
+            const FRotator Rotation = Transform.Rotator();
+            const FVector Scale = Transform.GetScale3D();
+
+            double* Row = Transforms + Index * TransformStride;
+            Row[0] = Location.X; Row[1] = Location.Y; Row[2] = Location.Z;
+            Row[3] = Rotation.Pitch; Row[4] = Rotation.Yaw; Row[5] = Rotation.Roll;
+            Row[6] = Scale.X; Row[7] = Scale.Y; Row[8] = Scale.Z;
+
+            FVector Origin;
+            FVector Extent;
+            Actor->GetActorBounds(false, Origin, Extent);
+            float* BoundsRow = Bounds + Index * BoundsStride;
+            BoundsRow[0] = Origin.X; BoundsRow[1] = Origin.Y; BoundsRow[2] = Origin.Z;
+            BoundsRow[3] = Extent.X; BoundsRow[4] = Extent.Y; BoundsRow[5] = Extent.Z;
+
+            const UClass* Class = Actor->GetClass();
+            if (const int32* ExistingClassId = ClassToId.Find(Class))
+            {
+                ClassIds[Index] = *ExistingClassId;
+            }
+            else
+            {
+                ClassIds[Index] = ClassToId.Add(Class, static_cast<int32>(PyList_Size(ClassNames)));
+                PyObject* ClassName = PyUnicode_FromString(TCHAR_TO_UTF8(*Class->GetName()));
+                PyList_Append(ClassNames, ClassName);
+                Py_DECREF(ClassName);
+            }
+
+            PyList_SET_ITEM(Names, Index, PyUnicode_FromString(TCHAR_TO_UTF8(*Actor->GetName())));
+            PyList_SET_ITEM(Labels, Index, PyUnicode_FromString(TCHAR_TO_UTF8(*Actor->GetActorLabel())));
+        }
+
+        NativeSnapshot.OriginalTransforms = TArray<double>(Transforms, Count * TransformStride);
+
+        PyObject* Result = PyDict_New();
+        PyObject* TransformsView = MakeView(Buffer, 0, TransformBytes, "d", Count, TransformStride);
+        PyObject* BoundsView = MakeView(Buffer, TransformBytes, BoundsBytes, "f", Count, BoundsStride);
+        PyObject* ClassIdsView = MakeView(Buffer, TransformBytes + BoundsBytes, ClassIdBytes, "i", Count, 1);
+        if (!TransformsView || !BoundsView || !ClassIdsView)
+        {
+            Py_XDECREF(TransformsView);
+            Py_XDECREF(BoundsView);
+            Py_XDECREF(ClassIdsView);
+            Py_DECREF(Result);
+            Py_DECREF(Names);
+            Py_DECREF(Labels);
+            Py_DECREF(ClassNames);
+            Py_DECREF(Buffer);
+            return nullptr;
+        }
+
+        PyObject* IdObject = PyLong_FromLongLong(NativeSnapshot.Id);
+        PyObject* CountObject = PyLong_FromSsize_t(Count);
+        PyDict_SetItemString(Result, "snapshot_id", IdObject);
+        PyDict_SetItemString(Result, "count", CountObject);
+        PyDict_SetItemString(Result, "buffer", Buffer);
+        PyDict_SetItemString(Result, "transforms", TransformsView);
+        PyDict_SetItemString(Result, "bounds", BoundsView);
+        PyDict_SetItemString(Result, "class_ids", ClassIdsView);
+        PyDict_SetItemString(Result, "class_names", ClassNames);
+        PyDict_SetItemString(Result, "names", Names);
+        PyDict_SetItemString(Result, "labels", Labels);
+        Py_DECREF(IdObject);
+        Py_DECREF(CountObject);
+        Py_DECREF(Buffer);
+        Py_DECREF(TransformsView);
+        Py_DECREF(BoundsView);
+        Py_DECREF(ClassIdsView);
+        Py_DECREF(ClassNames);
+        Py_DECREF(Names);
+        Py_DECREF(Labels);
+
+        RetainedSnapshots.Add(MoveTemp(NativeSnapshot));
+        if (RetainedSnapshots.Num() > MaxRetainedSnapshots)
+        {
+            RetainedSnapshots.RemoveAt(0);
+        }
+
+        return Result;
+    }
+
+    PyObject* ApplyTransforms(PyObject* Self, PyObject* Args, PyObject* Kwargs)
+    {
+        static const char* Keywords[] = { "snapshot_id", "transforms", nullptr };
+        long long SnapshotId = 0;
+        PyObject* TransformsObject = nullptr;
+        if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "LO", const_cast<char**>(Keywords), &SnapshotId, &TransformsObject))
+        {
+            return nullptr;
+        }
+
+        FNativeSnapshot* NativeSnapshot = RetainedSnapshots.FindByPredicate([SnapshotId](const FNativeSnapshot& Candidate) { return Candidate.Id == SnapshotId; });
+        if (!NativeSnapshot)
+        {
+            PyErr_Format(PyExc_KeyError, "Unknown or expired snapshot id %lld", SnapshotId);
+            return nullptr;
+        }
+
+        // Accept any contiguous float64 buffer: the snapshot's memoryview, a NumPy array, a bytearray...
+        Py_buffer View;
+        if (PyObject_GetBuffer(TransformsObject, &View, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+        {
+            return nullptr;
+        }
+
+        const int32 NumValues = NativeSnapshot->OriginalTransforms.Num();
+        const bool bIsFloat64 = View.itemsize == sizeof(double) && (!View.format || FCStringAnsi::Strcmp(View.format, "d") == 0 || FCStringAnsi::Strcmp(View.format, "<d") == 0);
+        if (!bIsFloat64 || View.len != static_cast<Py_ssize_t>(NumValues * sizeof(double)))
+        {
+            PyBuffer_Release(&View);
+            PyErr_Format(PyExc_ValueError, "Expected %d float64 values (%d actors x %d)", NumValues, NativeSnapshot->Actors.Num(), TransformStride);
+            return nullptr;
+        }
+
+        const double* Values = static_cast<const double*>(View.buf);
+        int32 AppliedCount = 0;
+        int32 MissingCount = 0;
+        {
+            const FScopedTransaction Transaction(NSLOCTEXT("UnrealMCP", "ApplyNativeTransforms", "MCP Apply Transforms"));
+            for (int32 Index = 0; Index < NativeSnapshot->Actors.Num(); ++Index)
+            {
+                const double* Row = Values + Index * TransformStride;
+                const double* OriginalRow = NativeSnapshot->OriginalTransforms.GetData() + Index * TransformStride;
+                if (FMemory::Memcmp(Row, OriginalRow, TransformStride * sizeof(double)) == 0)
+                {
+                    continue;
+                }
+
+                AActor* Actor = NativeSnapshot->Actors[Index].Get();
+                if (!Actor)
+                {
+                    ++MissingCount;
+                    continue;
+                }
+
+                Actor->Modify();
+                Actor->SetActorTransform(FTransform(
+                    FRotator(Row[3], Row[4], Row[5]),
+                    FVector(Row[0], Row[1], Row[2]),
+                    FVector(Row[6], Row[7], Row[8])));
+                Actor->PostEditMove(true);
+                ++AppliedCount;
+            }
+        }
+
+        // Later calls with the same snapshot only apply what changed since this one
+        FMemory::Memcpy(NativeSnapshot->OriginalTransforms.GetData(), Values, NumValues * sizeof(double));
+        PyBuffer_Release(&View);
+
+        MCP_LOG_INFO("unreal_mcp_native.apply_transforms updated %d actors (%d no longer exist)", AppliedCount, MissingCount);
+        return Py_BuildValue("{s:i,s:i}", "applied", AppliedCount, "missing", MissingCount);
+    }
+
+    FMCPTCPServer* GetMCPServer()
+    {
+        FUnrealMCPModule* Module = FModuleManager::GetModulePtr<FUnrealMCPModule>(TEXT("UnrealMCP"));
+        return Module ? Module->GetServer() : nullptr;
+    }
+
+    TSharedPtr<FJsonObject> PythonDictToJson(PyObject* Dict, int32 Depth);
+
+    /** Convert a Python value straight to a JSON value; returns null with a Python error set on failure. */
+    TSharedPtr<FJsonValue> PythonToJson(PyObject* Value, int32 Depth)
+    {
+        if (Depth > MaxJsonDepth)
+        {
+            PyErr_SetString(PyExc_ValueError, "params are nested too deeply");
+            return nullptr;
+        }
+
+        if (Value == Py_None)
+        {
+            return MakeShared<FJsonValueNull>();
+        }
+        // bool before int: bool is an int subclass
+        if (PyBool_Check(Value))
+        {
+            return MakeShared<FJsonValueBoolean>(Value == Py_True);
+        }
+        if (PyLong_Check(Value) || PyFloat_Check(Value))
+        {
+            const double Number = PyFloat_AsDouble(Value);
+            return PyErr_Occurred() ? nullptr : MakeShared<FJsonValueNumber>(Number);
+        }
+        if (PyUnicode_Check(Value))
+        {
+            const char* Utf8 = PyUnicode_AsUTF8(Value);
+            return Utf8 ? MakeShared<FJsonValueString>(UTF8_TO_TCHAR(Utf8)) : nullptr;
+        }
+        if (PyDict_Check(Value))
+        {
+            TSharedPtr<FJsonObject> Object = PythonDictToJson(Value, Depth + 1);
+            return Object.IsValid() ? MakeShared<FJsonValueObject>(Object) : nullptr;
+        }
+        if (PyList_Check(Value) || PyTuple_Check(Value))
+        {
+            PyObject* Sequence = PySequence_Fast(Value, "expected a sequence");
+            if (!Sequence)
+            {
+                return nullptr;
+            }
+
+            const Py_ssize_t Count = PySequence_Fast_GET_SIZE(Sequence);
+            PyObject** Items = PySequence_Fast_ITEMS(Sequence);
+            TArray<TSharedPtr<FJsonValue>> Values;
+            Values.Reserve(Count);
+            for (Py_ssize_t Index = 0; Index < Count; ++Index)
+            {
+                TSharedPtr<FJsonValue> Element = PythonToJson(Items[Index], Depth + 1);
+                if (!Element.IsValid())
+                {
+                    Py_DECREF(Sequence);
+                    return nullptr;
+                }
+                Values.Add(Element);
+            }
+            Py_DECREF(Sequence);
+            return MakeShared<FJsonValueArray>(Values);
+        }
+
+        PyErr_Format(PyExc_TypeError, "Cannot pass a %s as a command parameter", Py_TYPE(Value)->tp_name);
+        return nullptr;
+    }
+
+    TSharedPtr<FJsonObject> PythonDictToJson(PyObject* Dict, int32 Depth)
+    {
+        TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+        PyObject* Key = nullptr;
+        PyObject* Value = nullptr;
+        Py_ssize_t Position = 0;
+        while (PyDict_Next(Dict, &Position, &Key, &Value))
+        {
+            const char* KeyUtf8 = PyUnicode_Check(Key) ? PyUnicode_AsUTF8(Key) : nullptr;
+            if (!KeyUtf8)
+            {
+                PyErr_SetString(PyExc_TypeError, "Command parameter keys must be strings");
+                return nullptr;
+            }
+
+            TSharedPtr<FJsonValue> FieldValue = PythonToJson(Value, Depth);
+            if (!FieldValue.IsValid())
+            {
+                return nullptr;
+            }
+            Object->SetField(UTF8_TO_TCHAR(KeyUtf8), FieldValue);
+        }
+        return Object;
+    }
+
+    PyObject* JsonObjectToPython(const TSharedPtr<FJsonObject>& Object);
+
+    /** Convert a JSON value to Python. Integral numbers come back as int. */
+    PyObject* JsonToPython(const TSharedPtr<FJsonValue>& Value)
+    {
+        if (!Value.IsValid())
+        {
+            Py_RETURN_NONE;
+        }
+
+        switch (Value->Type)
+        {
+        case EJson::Boolean:
+            return PyBool_FromLong(Value->AsBool() ? 1 : 0);
+        case EJson::Number:
+        {
+            const double Number = Value->AsNumber();
+            if (FMath::IsFinite(Number) && Number == FMath::FloorToDouble(Number) && FMath::Abs(Number) <= 9007199254740992.0)
+            {
+                return PyLong_FromLongLong(static_cast<long long>(Number));
+            }
+            return PyFloat_FromDouble(Number);
+        }
+        case EJson::String:
+            return PyUnicode_FromString(TCHAR_TO_UTF8(*Value->AsString()));
+        case EJson::Array:
+        {
+            const TArray<TSharedPtr<FJsonValue>>& Values = Value->AsArray();
+            PyObject* List = PyList_New(Values.Num());
+            for (int32 Index = 0; List && Index < Values.Num(); ++Index)
+            {
+                PyObject* Element = JsonToPython(Values[Index]);
+                if (!Element)
+                {
+                    Py_DECREF(List);
+                    return nullptr;
+                }
+                PyList_SET_ITEM(List, Index, Element);
+            }
+            return List;
+        }
+        case EJson::Object:
+            return JsonObjectToPython(Value->AsObject());
+        default:
+            Py_RETURN_NONE;
+        }
+    }
+
+    PyObject* JsonObjectToPython(const TSharedPtr<FJsonObject>& Object)
+    {
+        PyObject* Dict = PyDict_New();
+        if (!Dict || !Object.IsValid())
+        {
+            return Dict;
+        }
+
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Object->Values)
+        {
+            PyObject* FieldValue = JsonToPython(Pair.Value);
+            if (!FieldValue || PyDict_SetItemString(Dict, TCHAR_TO_UTF8(*Pair.Key), FieldValue) != 0)
+            {
+                Py_XDECREF(FieldValue);
+                Py_DECREF(Dict);
+                return nullptr;
+            }
+            Py_DECREF(FieldValue);
+        }
+        return Dict;
+    }
+
+    /**
+     * Read dispatch params: None, a dict (converted directly), or str / bytes-like JSON text that was
+     * encoded ahead of time.
+     */
+    TSharedPtr<FJsonObject> ReadDispatchParams(PyObject* ParamsObject)
+    {
+        if (!ParamsObject || ParamsObject == Py_None)
+        {
+            return MakeShared<FJsonObject>();
+        }
+        if (PyDict_Check(ParamsObject))
+        {
+            return PythonDictToJson(ParamsObject, 0);
+        }
+
+        FString ParamsText;
+        if (PyUnicode_Check(ParamsObject))
+        {
+            const char* Utf8 = PyUnicode_AsUTF8(ParamsObject);
+            if (!Utf8)
+            {
+                return nullptr;
+            }
+            ParamsText = UTF8_TO_TCHAR(Utf8);
+        }
+        else if (PyObject_CheckBuffer(ParamsObject))
+        {
+            Py_buffer View;
+            if (PyObject_GetBuffer(ParamsObject, &View, PyBUF_C_CONTIGUOUS) != 0)
+            {
+                return nullptr;
+            }
+            const FUTF8ToTCHAR Converted(static_cast<const ANSICHAR*>(View.buf), static_cast<int32>(View.len));
+            ParamsText = FString(Converted.Length(), Converted.Get());
+            PyBuffer_Release(&View);
+        }
+        else
+        {
+            PyErr_Format(PyExc_TypeError, "params must be a dict, str or bytes-like JSON, not %s", Py_TYPE(ParamsObject)->tp_name);
+            return nullptr;
+        }
+
+        TSharedPtr<FJsonObject> Params;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ParamsText);
+        if (!FJsonSerializer::Deserialize(Reader, Params) || !Params.IsValid())
+        {
+            PyErr_SetString(PyExc_ValueError, "params is not a JSON object");
+            return nullptr;
+        }
+        return Params;
+    }
+
+    /** Server whose handlers dispatch uses; sets a Python error when it cannot be used from here. */
+    FMCPTCPServer* GetDispatchServer()
+    {
+        if (!IsInGameThread())
+        {
+            PyErr_SetString(PyExc_RuntimeError, "MCP commands can only be dispatched from the game thread");
+            return nullptr;
+        }
+
+        FMCPTCPServer* Server = GetMCPServer();
+        if (!Server)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "The MCP server is not running");
+        }
+        return Server;
+    }
+
+    PyObject* Dispatch(PyObject* Self, PyObject* Args, PyObject* Kwargs)
+    {
+        static const char* Keywords[] = { "command", "params", nullptr };
+        const char* CommandUtf8 = nullptr;
+        PyObject* ParamsObject = nullptr;
+        if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "s|O", const_cast<char**>(Keywords), &CommandUtf8, &ParamsObject))
+        {
+            return nullptr;
+        }
+
+        FMCPTCPServer* Server = GetDispatchServer();
+        TSharedPtr<FJsonObject> Params = Server ? ReadDispatchParams(ParamsObject) : nullptr;
+        if (!Params.IsValid())
+        {
+            return nullptr;
+        }
+        return JsonObjectToPython(Server->ExecuteCommand(UTF8_TO_TCHAR(CommandUtf8), Params));
+    }
+
+    PyObject* DispatchBatch(PyObject* Self, PyObject* Args, PyObject* Kwargs)
+    {
+        static const char* Keywords[] = { "calls", "stop_on_error", nullptr };
+        PyObject* CallsObject = nullptr;
+        int bStopOnError = 0;
+        if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "O|p", const_cast<char**>(Keywords), &CallsObject, &bStopOnError))
+        {
+            return nullptr;
+        }
+
+        FMCPTCPServer* Server = GetDispatchServer();
+        PyObject* Calls = Server ? PySequence_Fast(CallsObject, "calls must be a sequence of (command, params) pairs or {'type', 'params'} dicts") : nullptr;
+        if (!Calls)
+        {
+            return nullptr;
+        }
+
+        const Py_ssize_t Count = PySequence_Fast_GET_SIZE(Calls);
+        PyObject** Items = PySequence_Fast_ITEMS(Calls);
+        PyObject* Responses = PyList_New(0);
+        for (Py_ssize_t Index = 0; Responses && Index < Count; ++Index)
+        {
+            PyObject* Call = Items[Index];
+            PyObject* CommandObject = nullptr;
+            PyObject* ParamsObject = nullptr;
+            if (PyDict_Check(Call))
+            {
+                CommandObject = PyDict_GetItemString(Call, "type");
+                ParamsObject = PyDict_GetItemString(Call, "params");
+            }
+            else if (PyTuple_Check(Call) && PyTuple_Size(Call) >= 1 && PyTuple_Size(Call) <= 2)
+            {
+                CommandObject = PyTuple_GetItem(Call, 0);
+                ParamsObject = PyTuple_Size(Call) == 2 ? PyTuple_GetItem(Call, 1) : nullptr;
+            }
+
+            const char* CommandUtf8 = CommandObject && PyUnicode_Check(CommandObject) ? PyUnicode_AsUTF8(CommandObject) : nullptr;
+            TSharedPtr<FJsonObject> Params = CommandUtf8 ? ReadDispatchParams(ParamsObject) : nullptr;
+            if (!Params.IsValid())
+            {
+                if (!PyErr_Occurred())
+                {
+                    PyErr_Format(PyExc_ValueError, "Call %zd needs a command name and optional params", Index);
+                }
+                Py_CLEAR(Responses);
+                break;
+            }
+
+            const TSharedPtr<FJsonObject> Response = Server->ExecuteCommand(UTF8_TO_TCHAR(CommandUtf8), Params);
+            PyObject* ResponseObject = JsonObjectToPython(Response);
+            if (!ResponseObject || PyList_Append(Responses, ResponseObject) != 0)
+            {
+                Py_XDECREF(ResponseObject);
+                Py_CLEAR(Responses);
+                break;
+            }
+            Py_DECREF(ResponseObject);
+
+            FString Status;
+            if (bStopOnError && (!Response.IsValid() || !Response->TryGetStringField(FStringView(TEXT("status")), Status) || Status != TEXT("success")))
+            {
+                break;
+            }
+        }
+
+        Py_DECREF(Calls);
+        return Responses;
+    }
+
+    PyMethodDef NativeMethods[] = {
+        { "snapshot", reinterpret_cast<PyCFunction>(reinterpret_cast<void*>(&Snapshot)), METH_VARARGS | METH_KEYWORDS,
+          "snapshot(class_name=None) -> dict with transforms (N x 9 float64), bounds (N x 6 float32), class_ids (int32), class_names, names, labels and snapshot_id" },
+        { "apply_transforms", reinterpret_cast<PyCFunction>(reinterpret_cast<void*>(&ApplyTransforms)), METH_VARARGS | METH_KEYWORDS,
+          "apply_transforms(snapshot_id, transforms) -> dict; writes changed rows back to the actors in one undo transaction" },
+        { "dispatch", reinterpret_cast<PyCFunction>(reinterpret_cast<void*>(&Dispatch)), METH_VARARGS | METH_KEYWORDS,
+          "dispatch(command, params=None) -> dict; runs an MCP command handler in-process. params is a dict or pre-encoded JSON (str/bytes)" },
+        { "dispatch_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void*>(&DispatchBatch)), METH_VARARGS | METH_KEYWORDS,
+          "dispatch_batch(calls, stop_on_error=False) -> list of dicts; calls are (command, params) pairs or {'type', 'params'} dicts" },
+        { nullptr, nullptr, 0, nullptr }
+    };
+
+    PyModuleDef NativeModuleDef = {
+        PyModuleDef_HEAD_INIT,
+        "unreal_mcp_native",
+        "Contiguous actor data arrays and in-process MCP command dispatch for editor scripts",
+        -1,
+        NativeMethods
+    };
+
+    void RegisterWithInterpreter()
+    {
+        if (bRegisteredWithInterpreter)
+        {
+            return;
+        }
+
+        const PyGILState_STATE GILState = PyGILState_Ensure();
+        PyObject* Module = PyModule_Create(&NativeModuleDef);
+        if (Module)
+        {
+            PyDict_SetItemString(PyImport_GetModuleDict(), NativeModuleDef.m_name, Module);
+            Py_DECREF(Module);
+            bRegisteredWithInterpreter = true;
+            MCP_LOG_INFO("Registered Python module %s", UTF8_TO_TCHAR(NativeModuleDef.m_name));
+        }
+        else
+        {
+            PyErr_Print();
+            MCP_LOG_ERROR("Failed to create Python module %s", UTF8_TO_TCHAR(NativeModuleDef.m_name));
+        }
+        PyGILState_Release(GILState);
+    }
+}
+
+#endif // WITH_PYTHON
+
+void FMCPPythonNativeModule::Register()
+{
+#if WITH_PYTHON
+    if (bRegisteredWithInterpreter)
+    {
+        return;
+    }
+
+    IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+    if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+    {
+        MCP_LOG_WARNING("Python is not available; unreal_mcp_native will not be registered");
+        return;
+    }
+
+    if (PythonPlugin->IsPythonInitialized())
+    {
+        RegisterWithInterpreter();
+    }
+    else if (!PythonInitializedHandle.IsValid())
+    {
+        PythonInitializedHandle = PythonPlugin->OnPythonInitialized().AddLambda([]()
+        {
+            RegisterWithInterpreter();
+        });
+    }
+#endif
+}
+
+void FMCPPythonNativeModule::Unregister()
+{
+#if WITH_PYTHON
+    if (PythonInitializedHandle.IsValid())
+    {
+        if (IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get())
+        {
+            PythonPlugin->OnPythonInitialized().Remove(PythonInitializedHandle);
+        }
+        PythonInitializedHandle.Reset();
+    }
+    RetainedSnapshots.Empty();
+    bRegisteredWithInterpreter = false;
+#endif
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Native Python module "unreal_mcp_native", available to scripts run through execute_python.
+ *
+ * snapshot(class_name=None) copies the transforms, bounds and class ids of the editor world's actors
+ * into one contiguous buffer and returns memoryviews over it (NumPy can wrap them with np.asarray
+ * without copying). apply_transforms(snapshot_id, transforms) writes modified transforms back in a
+ * single undo transaction, touching only the actors whose values changed.
+ *
+ * dispatch(command, params) and dispatch_batch(calls) run MCP command handlers directly, converting
+ * between Python objects and FJsonObject without sockets, framing or JSON text.
+ */
+class FMCPPythonNativeModule
+{
+public:
+    /**
+     * Register the module with the interpreter, now or as soon as Python is initialized. Safe to call more than once.
+     */
+    static void Register();
+
+    /**
+     * Stop waiting for Python initialization and drop retained snapshots.
+     */
+    static void Unregister();
+};
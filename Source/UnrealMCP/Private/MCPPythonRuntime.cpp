@@ -0,0 +1,1073 @@
+#include "MCPPythonRuntime.h"
+
+#include "MCPCommandHandlers_Jobs.h"
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include "IPythonScriptPlugin.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_PYTHON
+
+THIRD_PARTY_INCLUDES_START
+#include "Python.h"
+THIRD_PARTY_INCLUDES_END
+
+#endif // WITH_PYTHON
+
+namespace
+{
+    /** Named snippets, stored as source so an evicted code object can be recompiled */
+    TMap<FString, FString> Snippets;
+
+#if WITH_PYTHON
+
+    /**
+     * Run a command through the Python plugin and collect what it printed.
+     * Info lines (stdout) go to OutOutput, warnings and errors (stderr, tracebacks) to OutError.
+     * OutLines, if given, receives every line in order with stderr lines prefixed.
+     */
+    bool RunPythonCommand(const FString& CommandText, FString& OutOutput, FString& OutError, TArray<FString>* OutLines = nullptr)
+    {
+        FPythonCommandEx Command;
+        Command.Command = CommandText;
+        Command.ExecutionMode = EPythonCommandExecutionMode::ExecuteFile;
+        Command.FileExecutionScope = EPythonFileExecutionScope::Private;
+        Command.Flags = EPythonCommandFlags::Unattended;
+
+        const bool bSuccess = IPythonScriptPlugin::Get()->ExecPythonCommandEx(Command);
+
+        for (const FPythonLogOutputEntry& Entry : Command.LogOutput)
+        {
+            const bool bIsInfo = Entry.Type == EPythonLogOutputType::Info;
+            FString& Target = bIsInfo ? OutOutput : OutError;
+            Target += Entry.Output;
+            Target += TEXT("\n");
+
+            if (OutLines)
+            {
+                TArray<FString> EntryLines;
+                Entry.Output.ParseIntoArrayLines(EntryLines, false);
+                for (const FString& Line : EntryLines)
+                {
+                    OutLines->Add(bIsInfo ? Line : TEXT("[stderr] ") + Line);
+                }
+            }
+        }
+
+        // The traceback is normally logged as an error entry as well; only fall back to the result text
+        if (!bSuccess && OutError.IsEmpty())
+        {
+            OutError = Command.CommandResult;
+        }
+        return bSuccess;
+    }
+
+    /** Private module holding the entry point the trampoline calls */
+    constexpr const char* RuntimeModuleName = "_unreal_mcp_runtime";
+
+    /**
+     * Literal run through ExecPythonCommandEx for every request. The plugin still captures output and
+     * formats tracebacks, but the user code itself is a cached code object rather than recompiled text.
+     */
+    const TCHAR* RuntimeTrampoline = TEXT("import _unreal_mcp_runtime\n_unreal_mcp_runtime.run_pending()\n");
+
+    /** A compiled source, when it was last run and which owners sent its source */
+    struct FCompiledCode
+    {
+        PyObject* Code = nullptr;
+        uint64 LastUse = 0;
+        TSet<FString> Owners;
+    };
+
+    /** What run_pending does with the queued entry */
+    enum class EPendingAction : uint8
+    {
+        Execute,
+        Compile,
+        ResumeJob,
+        CancelJob
+    };
+
+    /** What the trampoline should run next */
+    struct FPendingRun
+    {
+        EPendingAction Action = EPendingAction::Execute;
+        FString Key;
+        /** Empty when Key is known to be cached */
+        FString Source;
+        FString Filename;
+        FString FilePath;
+        FString ArgsJson;
+        /** Client the run was requested by */
+        FString Owner;
+        /** Key of the session whose namespace the run uses, if any */
+        FString SessionKey;
+        /** Job the run belongs to, if any */
+        FString JobId;
+    };
+
+    /** Globals dict kept alive between runs */
+    struct FPythonSession
+    {
+        /** Created on the first run */
+        PyObject* Globals = nullptr;
+        FString Owner;
+        FString Id;
+        double LastUseTime = 0.0;
+        int32 RunCount = 0;
+    };
+
+    /** Interpreter side of a Python job */
+    struct FPythonJob
+    {
+        /** First run of the job; cleared once it has started */
+        TOptional<FPendingRun> FirstRun;
+        /** Generator returned by main(), advanced on later ticks */
+        PyObject* Iterator = nullptr;
+        bool bFinished = false;
+        float Progress = 0.0f;
+        FString Message;
+        /** JSON text of the value main() returned, or its repr when it is not JSON serializable */
+        FString ReturnValue;
+        bool bReturnValueIsJson = false;
+    };
+
+    TMap<FString, FCompiledCode> CompiledCode;
+    uint64 UseCounter = 0;
+
+    /** Stack, so a script that runs execute_python itself gets its own entry */
+    TArray<FPendingRun> PendingRuns;
+
+    /** Keyed by owner and session id, so clients cannot reach each other's sessions */
+    TMap<FString, FPythonSession> Sessions;
+
+    TMap<FString, FPythonJob> PythonJobs;
+
+    /** Exception thrown into a job's generator when the job is cancelled */
+    PyObject* JobCancelledType = nullptr;
+
+    bool bRuntimeModuleReady = false;
+
+    /** Set while waiting for the Python plugin to initialize */
+    FDelegateHandle PythonInitializedHandle;
+
+    /** Low-frequency ticker that expires idle sessions even when no new runs arrive */
+    FTSTicker::FDelegateHandle SessionExpiryTickerHandle;
+
+    /**
+     * Return a borrowed reference to the compiled code for the run, compiling and caching it on a miss.
+     * A run that brings its own source makes its owner one that may run the code by hash later.
+     */
+    PyObject* FindOrCompile(const FPendingRun& Run)
+    {
+        const bool bHasSource = !Run.Source.IsEmpty() || !Run.FilePath.IsEmpty();
+        if (FCompiledCode* Cached = CompiledCode.Find(Run.Key))
+        {
+            if (bHasSource && !Run.Owner.IsEmpty())
+            {
+                Cached->Owners.Add(Run.Owner);
+            }
+            else if (!bHasSource && !Cached->Owners.Contains(Run.Owner))
+            {
+                PyErr_SetString(PyExc_KeyError, "code_hash is not cached; send the code again");
+                return nullptr;
+            }
+            Cached->LastUse = ++UseCounter;
+            return Cached->Code;
+        }
+
+        if (Run.Source.IsEmpty() && Run.FilePath.IsEmpty())
+        {
+            PyErr_SetString(PyExc_KeyError, "code_hash is not cached; send the code again");
+            return nullptr;
+        }
+
+        PyObject* Code = Py_CompileString(TCHAR_TO_UTF8(*Run.Source), TCHAR_TO_UTF8(*Run.Filename), Py_file_input);
+        if (!Code)
+        {
+            return nullptr;
+        }
+
+        if (CompiledCode.Num() >= MCPConstants::MAX_CACHED_PYTHON_CODE_OBJECTS)
+        {
+            const FString* OldestKey = nullptr;
+            uint64 OldestUse = MAX_uint64;
+            for (const TPair<FString, FCompiledCode>& Pair : CompiledCode)
+            {
+                if (Pair.Value.LastUse < OldestUse)
+                {
+                    OldestUse = Pair.Value.LastUse;
+                    OldestKey = &Pair.Key;
+                }
+            }
+
+            const FString EvictedKey = *OldestKey;
+            Py_DECREF(CompiledCode[EvictedKey].Code);
+            CompiledCode.Remove(EvictedKey);
+        }
+
+        FCompiledCode& Entry = CompiledCode.Add(Run.Key);
+        Entry.Code = Code;
+        Entry.LastUse = ++UseCounter;
+        if (!Run.Owner.IsEmpty())
+        {
+            Entry.Owners.Add(Run.Owner);
+        }
+        return Code;
+    }
+
+    FString MakeSessionKey(const FString& Owner, const FString& SessionId)
+    {
+        return Owner + TEXT("/") + SessionId;
+    }
+
+    /** Empty module-level namespace with __main__ semantics. */
+    PyObject* MakeNamespace()
+    {
+        PyObject* Globals = PyDict_New();
+        if (!Globals)
+        {
+            return nullptr;
+        }
+
+        PyDict_SetItemString(Globals, "__builtins__", PyEval_GetBuiltins());
+
+        PyObject* Name = PyUnicode_FromString("__main__");
+        PyDict_SetItemString(Globals, "__name__", Name);
+        Py_XDECREF(Name);
+        return Globals;
+    }
+
+    /** Decrement session dicts and job generators under the GIL; they may hold the last references to editor objects. */
+    void ReleaseReferences(const TArray<PyObject*>& Objects)
+    {
+        if (Objects.Num() == 0 || !Py_IsInitialized())
+        {
+            return;
+        }
+
+        const PyGILState_STATE GILState = PyGILState_Ensure();
+        for (PyObject* Object : Objects)
+        {
+            Py_XDECREF(Object);
+        }
+        PyGILState_Release(GILState);
+    }
+
+    /** Drop the sessions nobody has used within the idle timeout. */
+    void ExpireIdleSessions()
+    {
+        const double Now = FPlatformTime::Seconds();
+        TArray<PyObject*> Released;
+        for (auto It = Sessions.CreateIterator(); It; ++It)
+        {
+            if (Now - It.Value().LastUseTime > MCPConstants::PYTHON_SESSION_IDLE_TIMEOUT_SECONDS)
+            {
+                MCP_LOG_INFO("Python session %s expired", *It.Key());
+                Released.Add(It.Value().Globals);
+                It.RemoveCurrent();
+            }
+        }
+        ReleaseReferences(Released);
+    }
+
+    /**
+     * Globals for one run (new reference): the session's dict, or a fresh namespace,
+     * with 'args' set to this run's arguments.
+     */
+    PyObject* MakeGlobals(const FPendingRun& Run)
+    {
+        PyObject* Globals = nullptr;
+        if (FPythonSession* Session = Run.SessionKey.IsEmpty() ? nullptr : Sessions.Find(Run.SessionKey))
+        {
+            if (!Session->Globals)
+            {
+                Session->Globals = MakeNamespace();
+            }
+            Globals = Session->Globals;
+            Py_XINCREF(Globals);
+        }
+        else
+        {
+            Globals = MakeNamespace();
+        }
+
+        if (!Globals)
+        {
+            return nullptr;
+        }
+
+        if (!Run.FilePath.IsEmpty())
+        {
+            PyObject* File = PyUnicode_FromString(TCHAR_TO_UTF8(*Run.FilePath));
+            PyDict_SetItemString(Globals, "__file__", File);
+            Py_XDECREF(File);
+        }
+
+        PyObject* Args = nullptr;
+        if (Run.ArgsJson.IsEmpty())
+        {
+            Args = PyDict_New();
+        }
+        else if (PyObject* Json = PyImport_ImportModule("json"))
+        {
+            Args = PyObject_CallMethod(Json, "loads", "s", TCHAR_TO_UTF8(*Run.ArgsJson));
+            Py_DECREF(Json);
+        }
+
+        if (!Args)
+        {
+            Py_DECREF(Globals);
+            return nullptr;
+        }
+        PyDict_SetItemString(Globals, "args", Args);
+        Py_DECREF(Args);
+        return Globals;
+    }
+
+    PyObject* NewRef(PyObject* Object)
+    {
+        Py_INCREF(Object);
+        return Object;
+    }
+
+    /** Store main()'s return value on the job as JSON, falling back to its repr. */
+    void StoreReturnValue(FPythonJob& Job, PyObject* Value)
+    {
+        if (!Value || Value == Py_None)
+        {
+            return;
+        }
+
+        PyObject* Text = nullptr;
+        if (PyObject* Json = PyImport_ImportModule("json"))
+        {
+            Text = PyObject_CallMethod(Json, "dumps", "O", Value);
+            Py_DECREF(Json);
+        }
+        Job.bReturnValueIsJson = Text != nullptr;
+        if (!Text)
+        {
+            PyErr_Clear();
+            Text = PyObject_Repr(Value);
+        }
+        if (Text && PyUnicode_Check(Text))
+        {
+            Job.ReturnValue = UTF8_TO_TCHAR(PyUnicode_AsUTF8(Text));
+        }
+        Py_XDECREF(Text);
+        PyErr_Clear();
+    }
+
+    /** A yielded value reports progress: a number (0-1), a message, or a (progress, message) tuple. */
+    void ApplyYieldedValue(FPythonJob& Job, PyObject* Value)
+    {
+        PyObject* ProgressValue = Value;
+        PyObject* MessageValue = Value;
+        if (PyTuple_Check(Value) && PyTuple_Size(Value) == 2)
+        {
+            ProgressValue = PyTuple_GetItem(Value, 0);
+            MessageValue = PyTuple_GetItem(Value, 1);
+        }
+
+        if (PyFloat_Check(ProgressValue) || PyLong_Check(ProgressValue))
+        {
+            Job.Progress = FMath::Clamp(static_cast<float>(PyFloat_AsDouble(ProgressValue)), 0.0f, 1.0f);
+        }
+        if (PyUnicode_Check(MessageValue))
+        {
+            Job.Message = UTF8_TO_TCHAR(PyUnicode_AsUTF8(MessageValue));
+        }
+        PyErr_Clear();
+    }
+
+    /** Compile and run the code; in a job, also call main() and keep the generator it returns. */
+    PyObject* ExecuteRun(const FPendingRun& Run)
+    {
+        PyObject* Code = FindOrCompile(Run);
+        if (!Code)
+        {
+            return nullptr;
+        }
+
+        PyObject* Globals = MakeGlobals(Run);
+        if (!Globals)
+        {
+            return nullptr;
+        }
+
+        // A nested run could evict this entry while it is still executing
+        Py_INCREF(Code);
+        PyObject* Result = PyEval_EvalCode(Code, Globals, Globals);
+        Py_DECREF(Code);
+        if (Result && !Run.JobId.IsEmpty())
+        {
+            Py_DECREF(Result);
+            Result = nullptr;
+
+            PyObject* Main = PyDict_GetItemString(Globals, "main");
+            PyObject* MainResult = Main && PyCallable_Check(Main) ? PyObject_CallNoArgs(Main) : NewRef(Py_None);
+            if (MainResult)
+            {
+                FPythonJob* Job = PythonJobs.Find(Run.JobId);
+                if (Job && PyGen_Check(MainResult))
+                {
+                    Job->Iterator = MainResult;
+                }
+                else
+                {
+                    if (Job)
+                    {
+                        Job->bFinished = true;
+                        StoreReturnValue(*Job, MainResult);
+                    }
+                    Py_DECREF(MainResult);
+                }
+                Result = NewRef(Py_None);
+            }
+        }
+        Py_DECREF(Globals);
+        if (!Result)
+        {
+            return nullptr;
+        }
+        Py_DECREF(Result);
+        Py_RETURN_NONE;
+    }
+
+    /** Advance the job's generator until it finishes or this tick's time budget is used up. */
+    PyObject* ResumeJob(const FPendingRun& Run)
+    {
+        FPythonJob* Job = PythonJobs.Find(Run.JobId);
+        if (!Job || !Job->Iterator)
+        {
+            if (Job)
+            {
+                Job->bFinished = true;
+            }
+            Py_RETURN_NONE;
+        }
+
+        // Keep the generator alive even if the job is released while it runs
+        PyObject* Iterator = NewRef(Job->Iterator);
+        const double StartTime = FPlatformTime::Seconds();
+        bool bFinished = false;
+        FPythonJob Update;
+        bool bHasUpdate = false;
+        do
+        {
+            PyObject* Item = PyObject_CallMethod(Iterator, "send", "O", Py_None);
+            if (Item)
+            {
+                ApplyYieldedValue(Update, Item);
+                bHasUpdate = true;
+                Py_DECREF(Item);
+                continue;
+            }
+
+            if (!PyErr_ExceptionMatches(PyExc_StopIteration))
+            {
+                Py_DECREF(Iterator);
+                return nullptr;
+            }
+
+            PyObject* Type = nullptr;
+            PyObject* Value = nullptr;
+            PyObject* Traceback = nullptr;
+            PyErr_Fetch(&Type, &Value, &Traceback);
+            PyErr_NormalizeException(&Type, &Value, &Traceback);
+            PyObject* ReturnValue = Value ? PyObject_GetAttrString(Value, "value") : nullptr;
+            PyErr_Clear();
+            if (FPythonJob* FinishedJob = PythonJobs.Find(Run.JobId))
+            {
+                StoreReturnValue(*FinishedJob, ReturnValue);
+            }
+            Py_XDECREF(ReturnValue);
+            Py_XDECREF(Type);
+            Py_XDECREF(Value);
+            Py_XDECREF(Traceback);
+            bFinished = true;
+        }
+        while (!bFinished && FPlatformTime::Seconds() - StartTime < MCPConstants::PYTHON_JOB_STEP_BUDGET_SECONDS);
+        Py_DECREF(Iterator);
+
+        if (FPythonJob* UpdatedJob = PythonJobs.Find(Run.JobId))
+        {
+            UpdatedJob->bFinished = bFinished;
+            if (bHasUpdate)
+            {
+                UpdatedJob->Progress = FMath::Max(UpdatedJob->Progress, Update.Progress);
+                if (!Update.Message.IsEmpty())
+                {
+                    UpdatedJob->Message = Update.Message;
+                }
+            }
+        }
+        Py_RETURN_NONE;
+    }
+
+    /** Raise JobCancelled at the generator's current yield so its finally blocks and handlers run. */
+    PyObject* CancelJob(const FPendingRun& Run)
+    {
+        FPythonJob* Job = PythonJobs.Find(Run.JobId);
+        if (!Job || !Job->Iterator)
+        {
+            Py_RETURN_NONE;
+        }
+
+        PyObject* Iterator = NewRef(Job->Iterator);
+        PyObject* Item = PyObject_CallMethod(Iterator, "throw", "O", JobCancelledType);
+        if (Item)
+        {
+            // The script swallowed the cancellation and yielded again; close it for good
+            Py_DECREF(Item);
+            PyObject* CloseResult = PyObject_CallMethod(Iterator, "close", nullptr);
+            Py_XDECREF(CloseResult);
+        }
+        Py_DECREF(Iterator);
+
+        if (PyErr_Occurred() && !PyErr_ExceptionMatches(JobCancelledType) && !PyErr_ExceptionMatches(PyExc_StopIteration))
+        {
+            return nullptr;
+        }
+        PyErr_Clear();
+        Py_RETURN_NONE;
+    }
+
+    PyObject* RunPending(PyObject* Self, PyObject* Args)
+    {
+        if (PendingRuns.Num() == 0)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "No MCP script is pending");
+            return nullptr;
+        }
+        const FPendingRun Run = PendingRuns.Pop();
+
+        switch (Run.Action)
+        {
+        case EPendingAction::Compile:
+            if (!FindOrCompile(Run))
+            {
+                return nullptr;
+            }
+            Py_RETURN_NONE;
+        case EPendingAction::ResumeJob:
+            return ResumeJob(Run);
+        case EPendingAction::CancelJob:
+            return CancelJob(Run);
+        default:
+            return ExecuteRun(Run);
+        }
+    }
+
+    PyMethodDef RuntimeMethods[] = {
+        { "run_pending", reinterpret_cast<PyCFunction>(RunPending), METH_NOARGS, "Run the script queued by the MCP server" },
+        { nullptr, nullptr, 0, nullptr }
+    };
+
+    bool EnsureRuntimeModule()
+    {
+        if (bRuntimeModuleReady)
+        {
+            return true;
+        }
+
+        const PyGILState_STATE GILState = PyGILState_Ensure();
+        PyObject* Module = PyImport_AddModule(RuntimeModuleName);
+        bRuntimeModuleReady = Module && PyModule_AddFunctions(Module, RuntimeMethods) == 0;
+        if (bRuntimeModuleReady && !JobCancelledType)
+        {
+            // Derived from BaseException so a script's 'except Exception' does not swallow it
+            JobCancelledType = PyErr_NewException("_unreal_mcp_runtime.JobCancelled", PyExc_BaseException, nullptr);
+            bRuntimeModuleReady = JobCancelledType && PyModule_AddObject(Module, "JobCancelled", NewRef(JobCancelledType)) == 0;
+        }
+        if (!bRuntimeModuleReady)
+        {
+            PyErr_Print();
+            MCP_LOG_ERROR("Failed to create Python module %s", UTF8_TO_TCHAR(RuntimeModuleName));
+        }
+        PyGILState_Release(GILState);
+        return bRuntimeModuleReady;
+    }
+
+    /** Queue the run and execute it through the trampoline. */
+    bool RunThroughTrampoline(const FPendingRun& Run, FMCPPythonResult& OutResult, TArray<FString>* OutLines = nullptr)
+    {
+        OutResult.CodeHash = Run.Key;
+        OutResult.bCacheHit = CompiledCode.Contains(Run.Key);
+
+        const int32 Depth = PendingRuns.Num();
+        PendingRuns.Push(Run);
+        OutResult.bSuccess = RunPythonCommand(RuntimeTrampoline, OutResult.Output, OutResult.Error, OutLines);
+
+        // run_pending pops the entry; it is only left over if the trampoline failed before reaching it
+        PendingRuns.SetNum(FMath::Min(PendingRuns.Num(), Depth));
+        return OutResult.bSuccess;
+    }
+
+    /** Resolve the request's source (reading files and checking hashes on a cache miss) and session. */
+    bool PrepareRun(const FMCPPythonRequest& Request, FPendingRun& Run, FString& OutErrorMessage)
+    {
+        Run.ArgsJson = Request.ArgsJson;
+        Run.Owner = Request.Owner;
+
+        if (!Request.FilePath.IsEmpty())
+        {
+            const FString FullPath = FPaths::ConvertRelativePathToFull(Request.FilePath);
+            const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FullPath);
+            if (TimeStamp == FDateTime::MinValue())
+            {
+                OutErrorMessage = FString::Printf(TEXT("Python file not found: %s"), *Request.FilePath);
+                return false;
+            }
+
+            // An edited file gets a new key; the stale entry ages out of the LRU
+            Run.Key = FMCPPythonRuntime::HashSource(FString::Printf(TEXT("%s|%lld"), *FullPath, TimeStamp.GetTicks()));
+            Run.FilePath = FullPath;
+            Run.Filename = FullPath;
+            if (!CompiledCode.Contains(Run.Key) && !FFileHelper::LoadFileToString(Run.Source, *FullPath))
+            {
+                OutErrorMessage = FString::Printf(TEXT("Failed to read Python file: %s"), *Request.FilePath);
+                return false;
+            }
+        }
+        else
+        {
+            Run.Key = Request.Code.IsEmpty() ? Request.CodeHash.ToLower() : FMCPPythonRuntime::HashSource(Request.Code);
+            Run.Source = Request.Code;
+            Run.Filename = Request.DisplayName;
+
+            // Reported exactly like a miss, so a hash another client sent reveals nothing
+            const FCompiledCode* Cached = CompiledCode.Find(Run.Key);
+            if (Run.Source.IsEmpty() && (!Cached || !Cached->Owners.Contains(Request.Owner)))
+            {
+                OutErrorMessage = FString::Printf(TEXT("Unknown code_hash '%s'. Send the code again."), *Request.CodeHash);
+                return false;
+            }
+        }
+
+        if (!Request.SessionId.IsEmpty())
+        {
+            ExpireIdleSessions();
+
+            Run.SessionKey = MakeSessionKey(Request.Owner, Request.SessionId);
+            FPythonSession* Session = Sessions.Find(Run.SessionKey);
+            if (!Session)
+            {
+                if (Sessions.Num() >= MCPConstants::MAX_PYTHON_SESSIONS)
+                {
+                    OutErrorMessage = FString::Printf(TEXT("Too many Python sessions (limit %d). Drop one first."), MCPConstants::MAX_PYTHON_SESSIONS);
+                    return false;
+                }
+
+                MCP_LOG_INFO("Created Python session %s", *Run.SessionKey);
+                Session = &Sessions.Add(Run.SessionKey);
+                Session->Owner = Request.Owner;
+                Session->Id = Request.SessionId;
+            }
+            Session->LastUseTime = FPlatformTime::Seconds();
+            ++Session->RunCount;
+        }
+        return true;
+    }
+
+    /** Release the job's generator and forget it. */
+    void ReleaseJob(const FString& JobId)
+    {
+        FPythonJob Job;
+        if (PythonJobs.RemoveAndCopyValue(JobId, Job) && Job.Iterator)
+        {
+            ReleaseReferences({ Job.Iterator });
+        }
+    }
+
+    /** One editor tick of a Python job: the first run, then time-sliced resumes of its generator. */
+    bool StepPythonJob(const FString& JobId, bool& bOutEditedScene)
+    {
+        FPythonJob* Job = PythonJobs.Find(JobId);
+        if (!Job)
+        {
+            // The runtime shut down underneath the job
+            FMCPJobRegistry::Get().FailJob(JobId, TEXT("Python runtime shut down"));
+            return true;
+        }
+
+        FPendingRun Run;
+        if (Job->FirstRun.IsSet())
+        {
+            Run = Job->FirstRun.GetValue();
+            Job->FirstRun.Reset();
+        }
+        else
+        {
+            Run.Action = EPendingAction::ResumeJob;
+        }
+        Run.JobId = JobId;
+
+        // Like execute_python, the script may have touched any actor
+        FMCPPythonResult Result;
+        TArray<FString> Lines;
+        const bool bSuccess = RunThroughTrampoline(Run, Result, &Lines);
+        bOutEditedScene = true;
+
+        FMCPJobRegistry& Registry = FMCPJobRegistry::Get();
+        Registry.AppendOutput(JobId, Lines);
+
+        // The script may have started or finished other jobs, so look the job up again
+        Job = PythonJobs.Find(JobId);
+        if (!bSuccess || !Job)
+        {
+            Registry.FailJob(JobId, Result.Error.IsEmpty() ? TEXT("Python job failed") : Result.Error.TrimEnd());
+            ReleaseJob(JobId);
+            return true;
+        }
+
+        if (Job->bFinished)
+        {
+            TSharedPtr<FJsonObject> JobResult = MakeShared<FJsonObject>();
+            if (!Job->ReturnValue.IsEmpty())
+            {
+                TSharedPtr<FJsonValue> ReturnValue;
+                const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Job->ReturnValue);
+                if (!Job->bReturnValueIsJson || !FJsonSerializer::Deserialize(Reader, ReturnValue) || !ReturnValue.IsValid())
+                {
+                    ReturnValue = MakeShared<FJsonValueString>(Job->ReturnValue);
+                }
+                JobResult->SetField(TEXT("return_value"), ReturnValue);
+            }
+            ReleaseJob(JobId);
+            Registry.CompleteJob(JobId, JobResult);
+            return true;
+        }
+
+        Registry.SetProgress(JobId, Job->Progress, Job->Message.IsEmpty() && Lines.Num() > 0 ? Lines.Last() : Job->Message);
+        return false;
+    }
+
+    /** Unwind a cancelled job by raising JobCancelled inside its generator. */
+    void CancelPythonJob(const FString& JobId)
+    {
+        if (!PythonJobs.Contains(JobId))
+        {
+            return;
+        }
+
+        FPendingRun Run;
+        Run.Action = EPendingAction::CancelJob;
+        Run.JobId = JobId;
+
+        FMCPPythonResult Result;
+        TArray<FString> Lines;
+        if (bRuntimeModuleReady)
+        {
+            RunThroughTrampoline(Run, Result, &Lines);
+        }
+        FMCPJobRegistry::Get().AppendOutput(JobId, Lines);
+        ReleaseJob(JobId);
+    }
+
+#endif // WITH_PYTHON
+
+    bool CheckPythonAvailable(FString& OutErrorMessage)
+    {
+        IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+#if WITH_PYTHON
+        if (PythonPlugin && PythonPlugin->IsPythonAvailable() && !PythonPlugin->IsPythonInitialized())
+        {
+            OutErrorMessage = TEXT("Python is still initializing. Try again shortly.");
+            return false;
+        }
+        if (PythonPlugin && PythonPlugin->IsPythonAvailable() && EnsureRuntimeModule())
+        {
+            return true;
+        }
+#endif
+        OutErrorMessage = TEXT("Python is not available. Enable the Python Editor Script Plugin.");
+        return false;
+    }
+}
+
+FString FMCPPythonRuntime::GetConnectionOwner(const FSocket* ClientSocket)
+{
+    if (!ClientSocket)
+    {
+        return TEXT("client:in-process");
+    }
+    return FString::Printf(TEXT("connection:%p"), ClientSocket);
+}
+
+void FMCPPythonRuntime::Startup()
+{
+#if WITH_PYTHON
+    IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+    if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+    {
+        return;
+    }
+
+    if (!SessionExpiryTickerHandle.IsValid())
+    {
+        SessionExpiryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+        {
+            ExpireIdleSessions();
+            return true;
+        }), MCPConstants::PYTHON_SESSION_EXPIRY_INTERVAL_SECONDS);
+    }
+
+    // The interpreter and GIL do not exist until the plugin has initialized
+    if (PythonPlugin->IsPythonInitialized())
+    {
+        EnsureRuntimeModule();
+    }
+    else if (!PythonInitializedHandle.IsValid())
+    {
+        PythonInitializedHandle = PythonPlugin->OnPythonInitialized().AddLambda([]()
+        {
+            EnsureRuntimeModule();
+        });
+    }
+#endif
+}
+
+FString FMCPPythonRuntime::HashSource(const FString& Code)
+{
+    const FTCHARToUTF8 Utf8(*Code);
+    FSHAHash Hash;
+    FSHA1::HashBuffer(Utf8.Get(), Utf8.Length(), Hash.Hash);
+    return Hash.ToString().ToLower();
+}
+
+bool FMCPPythonRuntime::Execute(const FMCPPythonRequest& Request, FMCPPythonResult& OutResult, FString& OutErrorMessage)
+{
+    if (!CheckPythonAvailable(OutErrorMessage))
+    {
+        return false;
+    }
+
+#if WITH_PYTHON
+    FPendingRun Run;
+    if (!PrepareRun(Request, Run, OutErrorMessage))
+    {
+        return false;
+    }
+
+    RunThroughTrampoline(Run, OutResult);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FMCPPythonRuntime::StartJob(const FMCPPythonRequest& Request, FString& OutJobId, FString& OutErrorMessage)
+{
+    if (!CheckPythonAvailable(OutErrorMessage))
+    {
+        return false;
+    }
+
+#if WITH_PYTHON
+    FPendingRun Run;
+    if (!PrepareRun(Request, Run, OutErrorMessage))
+    {
+        return false;
+    }
+
+    // The first step runs on the next tick, after the job id has been returned to the client
+    OutJobId = FMCPJobRegistry::Get().StartTickedJob(TEXT("python"), &StepPythonJob, &CancelPythonJob);
+    PythonJobs.Add(OutJobId).FirstRun = MoveTemp(Run);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FMCPPythonRuntime::RegisterSnippet(const FString& Name, const FString& Code, FMCPPythonResult& OutResult, FString& OutErrorMessage)
+{
+    if (!Snippets.Contains(Name) && Snippets.Num() >= MCPConstants::MAX_PYTHON_SNIPPETS)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Too many snippets (limit %d). Remove one first."), MCPConstants::MAX_PYTHON_SNIPPETS);
+        return false;
+    }
+    if (!CheckPythonAvailable(OutErrorMessage))
+    {
+        return false;
+    }
+
+#if WITH_PYTHON
+    FPendingRun Run;
+    Run.Key = HashSource(Code);
+    Run.Source = Code;
+    Run.Filename = FString::Printf(TEXT("<snippet:%s>"), *Name);
+    Run.Action = EPendingAction::Compile;
+
+    if (RunThroughTrampoline(Run, OutResult))
+    {
+        Snippets.Add(Name, Code);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FMCPPythonRuntime::RemoveSnippet(const FString& Name)
+{
+    return Snippets.Remove(Name) > 0;
+}
+
+bool FMCPPythonRuntime::FindSnippet(const FString& Name, FString& OutCode)
+{
+    if (const FString* Code = Snippets.Find(Name))
+    {
+        OutCode = *Code;
+        return true;
+    }
+    return false;
+}
+
+TArray<FString> FMCPPythonRuntime::GetSnippetNames()
+{
+    TArray<FString> Names;
+    Snippets.GetKeys(Names);
+    Names.Sort();
+    return Names;
+}
+
+bool FMCPPythonRuntime::ResetSession(const FString& Owner, const FString& SessionId)
+{
+#if WITH_PYTHON
+    FPythonSession* Session = Sessions.Find(MakeSessionKey(Owner, SessionId));
+    if (!Session)
+    {
+        return false;
+    }
+
+    // The next run creates a fresh namespace
+    ReleaseReferences({ Session->Globals });
+    Session->Globals = nullptr;
+    Session->RunCount = 0;
+    Session->LastUseTime = FPlatformTime::Seconds();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FMCPPythonRuntime::DropSession(const FString& Owner, const FString& SessionId)
+{
+#if WITH_PYTHON
+    FPythonSession Session;
+    if (!Sessions.RemoveAndCopyValue(MakeSessionKey(Owner, SessionId), Session))
+    {
+        return false;
+    }
+    ReleaseReferences({ Session.Globals });
+    return true;
+#else
+    return false;
+#endif
+}
+
+int32 FMCPPythonRuntime::DropClientSessions(const FString& Owner)
+{
+#if WITH_PYTHON
+    TArray<PyObject*> Released;
+    for (auto It = Sessions.CreateIterator(); It; ++It)
+    {
+        if (It.Value().Owner == Owner)
+        {
+            Released.Add(It.Value().Globals);
+            It.RemoveCurrent();
+        }
+    }
+    ReleaseReferences(Released);
+    return Released.Num();
+#else
+    return 0;
+#endif
+}
+
+TArray<FMCPPythonSessionInfo> FMCPPythonRuntime::GetSessions(const FString& Owner)
+{
+    TArray<FMCPPythonSessionInfo> Infos;
+#if WITH_PYTHON
+    const double Now = FPlatformTime::Seconds();
+    const bool bCountGlobals = Py_IsInitialized() != 0;
+    PyGILState_STATE GILState = PyGILState_UNLOCKED;
+    if (bCountGlobals)
+    {
+        GILState = PyGILState_Ensure();
+    }
+    for (const TPair<FString, FPythonSession>& Pair : Sessions)
+    {
+        if (Pair.Value.Owner != Owner)
+        {
+            continue;
+        }
+
+        FMCPPythonSessionInfo& Info = Infos.AddDefaulted_GetRef();
+        Info.Id = Pair.Value.Id;
+        Info.RunCount = Pair.Value.RunCount;
+        Info.IdleSeconds = Now - Pair.Value.LastUseTime;
+        Info.NumGlobals = bCountGlobals && Pair.Value.Globals ? static_cast<int32>(PyDict_Size(Pair.Value.Globals)) : 0;
+    }
+    if (bCountGlobals)
+    {
+        PyGILState_Release(GILState);
+    }
+    Infos.Sort([](const FMCPPythonSessionInfo& A, const FMCPPythonSessionInfo& B) { return A.Id < B.Id; });
+#endif
+    return Infos;
+}
+
+void FMCPPythonRuntime::Shutdown()
+{
+#if WITH_PYTHON
+    if (PythonInitializedHandle.IsValid())
+    {
+        if (IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get())
+        {
+            PythonPlugin->OnPythonInitialized().Remove(PythonInitializedHandle);
+        }
+        PythonInitializedHandle.Reset();
+    }
+    if (SessionExpiryTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(SessionExpiryTickerHandle);
+        SessionExpiryTickerHandle.Reset();
+    }
+
+    TArray<PyObject*> Released;
+    for (const TPair<FString, FPythonSession>& Pair : Sessions)
+    {
+        Released.Add(Pair.Value.Globals);
+    }
+    for (const TPair<FString, FPythonJob>& Pair : PythonJobs)
+    {
+        Released.Add(Pair.Value.Iterator);
+    }
+    ReleaseReferences(Released);
+    Sessions.Empty();
+    PythonJobs.Empty();
+
+    if (CompiledCode.Num() > 0 && Py_IsInitialized())
+    {
+        const PyGILState_STATE GILState = PyGILState_Ensure();
+        for (const TPair<FString, FCompiledCode>& Pair : CompiledCode)
+        {
+            Py_DECREF(Pair.Value.Code);
+        }
+        PyGILState_Release(GILState);
+    }
+    CompiledCode.Empty();
+    PendingRuns.Empty();
+#endif
+    Snippets.Empty();
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSocket;
+
+/**
+ * One script run requested through execute_python.
+ */
+struct FMCPPythonRequest
+{
+    /** Source text; may be left empty when CodeHash names code the runtime has already compiled */
+    FString Code;
+
+    /** Content hash of the source (see FMCPPythonRuntime::HashSource); derived from Code when empty */
+    FString CodeHash;
+
+    /** Script file to run instead of Code */
+    FString FilePath;
+
+    /** Name reported for Code in tracebacks */
+    FString DisplayName = TEXT("<string>");
+
+    /** JSON object exposed to the script as the global 'args' */
+    FString ArgsJson;
+
+    /**
+     * Client making the request: its client id, or its connection when it sent none. Sessions and
+     * code_hash lookups are scoped to it.
+     */
+    FString Owner;
+
+    /** Persistent namespace to run in; empty runs in a fresh namespace */
+    FString SessionId;
+};
+
+/**
+ * Outcome of a script run.
+ */
+struct FMCPPythonResult
+{
+    bool bSuccess = false;
+
+    /** The compiled code object was reused from the cache */
+    bool bCacheHit = false;
+
+    FString CodeHash;
+    FString Output;
+    FString Error;
+};
+
+/**
+ * Summary of a persistent Python session.
+ */
+struct FMCPPythonSessionInfo
+{
+    FString Id;
+    int32 NumGlobals = 0;
+    int32 RunCount = 0;
+    double IdleSeconds = 0.0;
+};
+
+/**
+ * Runs execute_python scripts in-process through the Python plugin.
+ *
+ * Compiled code objects are kept in a bounded LRU cache keyed by a SHA-1 of the source (of the full
+ * path and modification time for files), so resent snippets skip compile() and clients can send just
+ * the hash of code they sent before. A hash only resolves for owners that sent its source themselves,
+ * so one client cannot run another's code by hash. Named snippets are shared by every client; they
+ * are stored as source and invoked by name.
+ * Sessions keep a globals dict alive between runs; they are namespaced per owning client and are
+ * dropped when that client disconnects or stays idle too long. Long scripts can run as cooperative
+ * jobs tracked by FMCPJobRegistry.
+ */
+class FMCPPythonRuntime
+{
+public:
+    /**
+     * Hash used as the cache key: lowercase hex SHA-1 of the UTF-8 source, as hashlib.sha1 computes it.
+     */
+    static FString HashSource(const FString& Code);
+
+    /**
+     * Create the interpreter-side runtime module now, or as soon as the Python plugin has initialized,
+     * and start the ticker that expires idle sessions.
+     */
+    static void Startup();
+
+    /**
+     * Run the request, compiling the source only on a cache miss.
+     * @return False with OutErrorMessage set if the request could not be started (unknown hash, missing file, no Python)
+     */
+    static bool Execute(const FMCPPythonRequest& Request, FMCPPythonResult& OutResult, FString& OutErrorMessage);
+
+    /**
+     * Run the request as a tracked job starting on the next editor tick. If the script defines main(),
+     * it is called; when main is a generator function it is resumed across ticks within a per-tick time
+     * budget, each yield reporting progress (a 0-1 number, a message or both as a tuple). Printed lines
+     * stream into the job's output, and cancel_job raises JobCancelled at the current yield.
+     * @return False with OutErrorMessage set if the request could not be started
+     */
+    static bool StartJob(const FMCPPythonRequest& Request, FString& OutJobId, FString& OutErrorMessage);
+
+    /**
+     * Compile the code and store it under Name, replacing a snippet of the same name.
+     * Syntax errors are reported in OutResult.Error and leave the snippet unregistered.
+     */
+    static bool RegisterSnippet(const FString& Name, const FString& Code, FMCPPythonResult& OutResult, FString& OutErrorMessage);
+
+    static bool RemoveSnippet(const FString& Name);
+
+    static bool FindSnippet(const FString& Name, FString& OutCode);
+
+    static TArray<FString> GetSnippetNames();
+
+    /**
+     * Clear a session's globals, keeping the session.
+     */
+    static bool ResetSession(const FString& Owner, const FString& SessionId);
+
+    static bool DropSession(const FString& Owner, const FString& SessionId);
+
+    /**
+     * Drop every session of a client, e.g. when its connection closes.
+     * @return Number of sessions dropped
+     */
+    static int32 DropClientSessions(const FString& Owner);
+
+    static TArray<FMCPPythonSessionInfo> GetSessions(const FString& Owner);
+
+    /**
+     * Session owner used for clients that do not send a client id; their sessions end with the connection.
+     * In-process callers without a socket share the owner "client:in-process".
+     */
+    static FString GetConnectionOwner(const FSocket* ClientSocket);
+
+    /**
+     * Release cached code objects and snippets.
+     */
+    static void Shutdown();
+};
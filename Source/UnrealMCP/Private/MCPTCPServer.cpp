@@ -18,17 +18,24 @@
 #include "MCPCommandHandlers.h"
 #include "MCPCommandHandlers_Blueprints.h"
 #include "MCPCommandHandlers_CelestialVault.h"
+#include "MCPCommandHandlers_Collision.h"
 #include "MCPCommandHandlers_DataTables.h"
 #include "MCPCommandHandlers_GameplayAbilities.h"
+#include "MCPCommandHandlers_Instancing.h"
+#include "MCPCommandHandlers_Jobs.h"
 #include "MCPCommandHandlers_Materials.h"
+#include "MCPCommandHandlers_Meshes.h"
 #include "MCPCommandHandlers_Niagara.h"
 #include "MCPCommandHandlers_PostProcess.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPCommandHandlers_WorldPartition.h"
 #include "MCPCommandHandlers_UI.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "Misc/Guid.h"
 #include "MCPConstants.h"
+#include "MCPPythonRuntime.h"
 
 
 FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig& InConfig) 
@@ -42,8 +49,38 @@ FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig& InConfig)
     RegisterCommandHandler(MakeShared<FMCPModifyObjectHandler>());
     RegisterCommandHandler(MakeShared<FMCPDeleteObjectHandler>());
     RegisterCommandHandler(MakeShared<FMCPExecutePythonHandler>());
+    RegisterCommandHandler(MakeShared<FMCPRegisterPythonSnippetHandler>());
+    RegisterCommandHandler(MakeShared<FMCPPythonSessionHandler>());
     RegisterCommandHandler(MakeShared<FMCPImportTemplateHandler>());
 
+    // Scene query command handlers
+    RegisterCommandHandler(MakeShared<FMCPExportSceneSnapshotHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGetSceneHashHandler>());
+    RegisterCommandHandler(MakeShared<FMCPSceneStatsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPQuerySceneHandler>());
+
+    // World Partition command handlers
+    RegisterCommandHandler(MakeShared<FMCPQueryWorldPartitionHandler>());
+    RegisterCommandHandler(MakeShared<FMCPLoadWorldPartitionRegionHandler>());
+    RegisterCommandHandler(MakeShared<FMCPUnloadWorldPartitionRegionHandler>());
+
+    // Collision query command handlers
+    RegisterCommandHandler(MakeShared<FMCPBatchTracesHandler>());
+
+    // Instanced static mesh command handlers
+    RegisterCommandHandler(MakeShared<FMCPCreateInstancesHandler>());
+    RegisterCommandHandler(MakeShared<FMCPScatterHandler>());
+    RegisterCommandHandler(MakeShared<FMCPConsolidateInstancesHandler>());
+
+    // Job tracking command handlers
+    RegisterCommandHandler(MakeShared<FMCPGetJobStatusHandler>());
+    RegisterCommandHandler(MakeShared<FMCPCancelJobHandler>());
+
+    // Static mesh processing command handlers
+    RegisterCommandHandler(MakeShared<FMCPMergeActorsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGenerateLODsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGenerateMeshHandler>());
+
     // Scene rendering and grading tools
     RegisterCommandHandler(MakeShared<FMCPApplyColorGradingHandler>());
 
@@ -60,6 +97,7 @@ FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig& InConfig)
     // Data table command handlers
     RegisterCommandHandler(MakeShared<FMCPCreateDataTableHandler>());
     RegisterCommandHandler(MakeShared<FMCPModifyDataTableHandler>());
+    RegisterCommandHandler(MakeShared<FMCPQueryDataTableHandler>());
 
     // Gameplay Ability System command handlers
     RegisterCommandHandler(MakeShared<FMCPCreateGameplayEffectHandler>());
@@ -194,6 +232,9 @@ bool FMCPTCPServer::Start()
 
 void FMCPTCPServer::Stop()
 {
+    // Drop responses still being serialized; their workers do not reference the server
+    PendingResponses.Empty();
+
     // Clean up all client connections
     CleanupAllClientConnections();
     
@@ -220,6 +261,8 @@ bool FMCPTCPServer::Tick(float DeltaTime)
     // Normal processing
     ProcessPendingConnections();
     ProcessClientData();
+    ProcessPendingResponses();
+    ProcessPendingSends();
     CheckClientTimeouts(DeltaTime);
     return true;
 }
@@ -257,16 +300,15 @@ bool FMCPTCPServer::HandleConnectionAccepted(FSocket* InSocket, const FIPv4Endpo
 
 void FMCPTCPServer::ProcessClientData()
 {
-    // Make a copy of the array since we might modify it during iteration
-    TArray<FMCPClientConnection> ConnectionsCopy = ClientConnections;
-    
-    for (FMCPClientConnection& ClientConnection : ConnectionsCopy)
+    // Commands may add or remove connections, so walk the sockets and look each connection up again
+    for (FSocket* ClientSocket : GetClientSockets())
     {
-        if (!ClientConnection.Socket) continue;
+        FMCPClientConnection* Connection = FindClientConnection(ClientSocket);
+        if (!Connection || !ClientSocket) continue;
         
         // Check if the client is still connected
         uint32 PendingDataSize = 0;
-        if (!ClientConnection.Socket->HasPendingData(PendingDataSize))
+        if (!ClientSocket->HasPendingData(PendingDataSize))
         {
             // Try to check connection status
             uint8 DummyBuffer[1];
@@ -276,7 +318,7 @@ void FMCPTCPServer::ProcessClientData()
             
             try
             {
-                if (!ClientConnection.Socket->Recv(DummyBuffer, 1, BytesRead, ESocketReceiveFlags::Peek))
+                if (!ClientSocket->Recv(DummyBuffer, 1, BytesRead, ESocketReceiveFlags::Peek))
                 {
                     // Check if it's a real error or just a non-blocking socket that would block
                     int32 ErrorCode = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
@@ -284,7 +326,7 @@ void FMCPTCPServer::ProcessClientData()
                     {
                         // Real connection error
                         MCP_LOG_INFO("Client connection from %s appears to be closed (error code %d), cleaning up", 
-                            *ClientConnection.Endpoint.ToString(), ErrorCode);
+                            *Connection->Endpoint.ToString(), ErrorCode);
                         bConnectionLost = true;
                     }
                 }
@@ -292,70 +334,173 @@ void FMCPTCPServer::ProcessClientData()
             catch (...)
             {
                 MCP_LOG_ERROR("Exception while checking client connection status for %s", 
-                    *ClientConnection.Endpoint.ToString());
+                    *Connection->Endpoint.ToString());
                 bConnectionLost = true;
             }
             
             if (bConnectionLost)
             {
-                CleanupClientConnection(ClientConnection);
+                CleanupClientConnection(ClientSocket);
                 continue; // Skip to the next client
             }
         }
         
         // Reset PendingDataSize and check again to ensure we have the latest value
         PendingDataSize = 0;
-        if (ClientConnection.Socket->HasPendingData(PendingDataSize))
+        if (ClientSocket->HasPendingData(PendingDataSize))
         {
             if (Config.bEnableVerboseLogging)
             {
                 MCP_LOG_VERBOSE("Client from %s has %u bytes of pending data", 
-                    *ClientConnection.Endpoint.ToString(), PendingDataSize);
+                    *Connection->Endpoint.ToString(), PendingDataSize);
             }
-            
+
             // Reset timeout timer since we're receiving data
-            ClientConnection.TimeSinceLastActivity = 0.0f;
+            Connection->TimeSinceLastActivity = 0.0f;
             
-            int32 BytesRead = 0;
-            if (ClientConnection.Socket->Recv(ClientConnection.ReceiveBuffer.GetData(), ClientConnection.ReceiveBuffer.Num(), BytesRead))
+            // Read until the socket would block; a command may be larger than the receive buffer
+            bool bConnectionLost = false;
+            int32 BytesThisTick = 0;
+            while (BytesThisTick < MCPConstants::MAX_RECEIVE_BYTES_PER_TICK)
             {
-                if (BytesRead > 0)
+                int32 BytesRead = 0;
+                if (!Connection->Socket->Recv(Connection->ReceiveBuffer.GetData(), Connection->ReceiveBuffer.Num(), BytesRead))
                 {
-                    if (Config.bEnableVerboseLogging)
+                    // Check if it's a real error or just a non-blocking socket that would block
+                    int32 ErrorCode = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+                    if (ErrorCode != SE_EWOULDBLOCK)
                     {
-                        MCP_LOG_VERBOSE("Read %d bytes from client %s", BytesRead, *ClientConnection.Endpoint.ToString());
+                        // Real connection error, close the socket
+                        MCP_LOG_WARNING("Socket error %d for client %s, closing connection", 
+                            ErrorCode, *Connection->Endpoint.ToString());
+                        bConnectionLost = true;
                     }
-                    
-                    // Null-terminate the buffer to ensure it's a valid string
-                    ClientConnection.ReceiveBuffer[BytesRead] = 0;
-                    FString ReceivedData = FString(UTF8_TO_TCHAR(ClientConnection.ReceiveBuffer.GetData()));
-                    ProcessCommand(ReceivedData, ClientConnection.Socket);
+                    break;
+                }
+
+                if (BytesRead <= 0)
+                {
+                    break;
                 }
+
+                if (Config.bEnableVerboseLogging)
+                {
+                    MCP_LOG_VERBOSE("Read %d bytes from client %s", BytesRead, *Connection->Endpoint.ToString());
+                }
+
+                Connection->PendingCommandBytes.Append(Connection->ReceiveBuffer.GetData(), BytesRead);
+                BytesThisTick += BytesRead;
             }
-            else
+
+            if (bConnectionLost)
             {
-                // Check if it's a real error or just a non-blocking socket that would block
-                int32 ErrorCode = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
-                if (ErrorCode != SE_EWOULDBLOCK)
+                CleanupClientConnection(ClientSocket);
+                continue;
+            }
+
+            TArray<FString> Commands;
+            ExtractCommands(*Connection, Commands);
+
+            if (Connection->PendingCommandBytes.Num() > MCPConstants::MAX_COMMAND_BYTES)
+            {
+                // The rest of the stream cannot be framed once a command is dropped, so the client is disconnected
+                MCP_LOG_WARNING("Command from client %s exceeds %d bytes, closing connection", 
+                    *Connection->Endpoint.ToString(), MCPConstants::MAX_COMMAND_BYTES);
+                CleanupClientConnection(ClientSocket);
+                continue;
+            }
+
+            // Handlers may add or remove connections, so Connection is not used past this point
+            for (const FString& Command : Commands)
+            {
+                if (!FindClientConnection(ClientSocket))
                 {
-                    // Real connection error, close the socket
-                    MCP_LOG_WARNING("Socket error %d for client %s, closing connection", 
-                        ErrorCode, *ClientConnection.Endpoint.ToString());
-                    CleanupClientConnection(ClientConnection);
+                    break;
                 }
+                ProcessCommand(Command, ClientSocket);
             }
         }
     }
 }
 
+void FMCPTCPServer::ExtractCommands(FMCPClientConnection& ClientConnection, TArray<FString>& OutCommands)
+{
+    TArray<uint8>& Bytes = ClientConnection.PendingCommandBytes;
+
+    auto ToCommand = [&Bytes](int32 Start, int32 Length)
+    {
+        FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + Start), Length);
+        return FString(Converter.Length(), Converter.Get());
+    };
+
+    // Track nesting outside of strings until the top-level value closes
+    int32 CommandStart = 0;
+    for (int32 Index = ClientConnection.ScannedCommandBytes; Index < Bytes.Num(); ++Index)
+    {
+        const uint8 Byte = Bytes[Index];
+        if (ClientConnection.bCommandInString)
+        {
+            if (ClientConnection.bCommandEscaped)
+            {
+                ClientConnection.bCommandEscaped = false;
+            }
+            else if (Byte == '\\')
+            {
+                ClientConnection.bCommandEscaped = true;
+            }
+            else if (Byte == '"')
+            {
+                ClientConnection.bCommandInString = false;
+            }
+        }
+        else if (Byte == '{' || Byte == '[')
+        {
+            ++ClientConnection.CommandDepth;
+        }
+        else if (ClientConnection.CommandDepth > 0)
+        {
+            if (Byte == '"')
+            {
+                ClientConnection.bCommandInString = true;
+            }
+            else if ((Byte == '}' || Byte == ']') && --ClientConnection.CommandDepth == 0)
+            {
+                OutCommands.Add(ToCommand(CommandStart, Index + 1 - CommandStart));
+                CommandStart = Index + 1;
+            }
+        }
+        else if (Byte == ' ' || Byte == '\t' || Byte == '\r' || Byte == '\n')
+        {
+            // Whitespace between commands
+            CommandStart = Index + 1;
+        }
+        else
+        {
+            // Not a JSON object; hand the rest over as one command so the client gets an error response
+            OutCommands.Add(ToCommand(CommandStart, Bytes.Num() - CommandStart));
+            CommandStart = Bytes.Num();
+            break;
+        }
+    }
+
+    Bytes.RemoveAt(0, CommandStart);
+    ClientConnection.ScannedCommandBytes = Bytes.Num();
+}
+
 void FMCPTCPServer::CheckClientTimeouts(float DeltaTime)
 {
-    // Make a copy of the array since we might modify it during iteration
-    TArray<FMCPClientConnection> ConnectionsCopy = ClientConnections;
-    
-    for (FMCPClientConnection& ClientConnection : ConnectionsCopy)
+    TArray<FSocket*> TimedOutSockets;
+    for (FMCPClientConnection& ClientConnection : ClientConnections)
     {
         if (!ClientConnection.Socket) continue;
+
+        // A client waiting for a deferred response is not idle
+        FSocket* const ClientSocket = ClientConnection.Socket;
+        if (PendingResponses.ContainsByPredicate([ClientSocket](const FMCPPendingResponse& Pending) { return Pending.Socket == ClientSocket; }))
+        {
+            ClientConnection.TimeSinceLastActivity = 0.0f;
+            continue;
+        }
         
         // Increment time since last activity
         ClientConnection.TimeSinceLastActivity += DeltaTime;
@@ -365,21 +510,24 @@ void FMCPTCPServer::CheckClientTimeouts(float DeltaTime)
         {
             MCP_LOG_WARNING("Client from %s timed out after %.1f seconds of inactivity, disconnecting", 
                 *ClientConnection.Endpoint.ToString(), ClientConnection.TimeSinceLastActivity);
-            CleanupClientConnection(ClientConnection);
+            TimedOutSockets.Add(ClientConnection.Socket);
         }
     }
+
+    for (FSocket* Socket : TimedOutSockets)
+    {
+        CleanupClientConnection(Socket);
+    }
 }
 
 void FMCPTCPServer::CleanupAllClientConnections()
 {
     MCP_LOG_INFO("Cleaning up all client connections (%d total)", ClientConnections.Num());
     
-    // Make a copy of the array since we'll be modifying it during iteration
-    TArray<FMCPClientConnection> ConnectionsCopy = ClientConnections;
-    
-    for (FMCPClientConnection& Connection : ConnectionsCopy)
+    // Cleanup removes each connection from the array, so walk the sockets instead
+    for (FSocket* ClientSocket : GetClientSockets())
     {
-        CleanupClientConnection(Connection);
+        CleanupClientConnection(ClientSocket);
     }
     
     // Ensure the array is empty
@@ -406,6 +554,22 @@ void FMCPTCPServer::CleanupClientConnection(FMCPClientConnection& ClientConnecti
     if (!ClientConnection.Socket) return;
     
     MCP_LOG_INFO("Cleaning up client connection from %s", *ClientConnection.Endpoint.ToString());
+
+    // ClientConnection may be an element of ClientConnections, which the removal below shifts
+    FSocket* const ClientSocket = ClientConnection.Socket;
+
+    // Nobody is left to receive deferred responses for this client
+    PendingResponses.RemoveAll([ClientSocket](const FMCPPendingResponse& Pending) {
+        return Pending.Socket == ClientSocket;
+    });
+
+    if (ClientConnection.SentBytes < ClientConnection.PendingSendBytes.Num())
+    {
+        MCP_LOG_WARNING("Dropping %d unsent response bytes", ClientConnection.PendingSendBytes.Num() - ClientConnection.SentBytes);
+    }
+
+    // Python sessions opened without a client id live as long as the connection
+    FMCPPythonRuntime::DropClientSessions(FMCPPythonRuntime::GetConnectionOwner(ClientSocket));
     
     try
     {
@@ -414,7 +578,7 @@ void FMCPTCPServer::CleanupClientConnection(FMCPClientConnection& ClientConnecti
         MCP_LOG_VERBOSE("Closing client socket with description: %s", *SocketDesc);
         
         // First close the socket
-        bool bCloseSuccess = ClientConnection.Socket->Close();
+        bool bCloseSuccess = ClientSocket->Close();
         if (!bCloseSuccess)
         {
             MCP_LOG_ERROR("Failed to close client socket");
@@ -424,7 +588,7 @@ void FMCPTCPServer::CleanupClientConnection(FMCPClientConnection& ClientConnecti
         ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
         if (SocketSubsystem)
         {
-            SocketSubsystem->DestroySocket(ClientConnection.Socket);
+            SocketSubsystem->DestroySocket(ClientSocket);
             MCP_LOG_VERBOSE("Successfully destroyed client socket");
         }
         else
@@ -442,8 +606,8 @@ void FMCPTCPServer::CleanupClientConnection(FMCPClientConnection& ClientConnecti
     }
     
     // Remove from our list of connections
-    ClientConnections.RemoveAll([&ClientConnection](const FMCPClientConnection& Connection) {
-        return Connection.Socket == ClientConnection.Socket;
+    ClientConnections.RemoveAll([ClientSocket](const FMCPClientConnection& Connection) {
+        return Connection.Socket == ClientSocket;
     });
     
     MCP_LOG_INFO("MCP Client disconnected (Remaining clients: %d)", ClientConnections.Num());
@@ -463,34 +627,29 @@ void FMCPTCPServer::ProcessCommand(const FString& CommandJson, FSocket* ClientSo
         FString Type;
         if (Command->TryGetStringField(FStringView(TEXT("type")), Type))
         {
-            TSharedPtr<IMCPCommandHandler> Handler = CommandHandlers.FindRef(Type);
-            if (Handler.IsValid())
+            const TSharedPtr<FJsonObject>* ParamsPtr = nullptr;
+            TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+            
+            if (Command->TryGetObjectField(FStringView(TEXT("params")), ParamsPtr) && ParamsPtr != nullptr)
             {
-                MCP_LOG_INFO("Processing command: %s", *Type);
-                
-                const TSharedPtr<FJsonObject>* ParamsPtr = nullptr;
-                TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
-                
-                if (Command->TryGetObjectField(FStringView(TEXT("params")), ParamsPtr) && ParamsPtr != nullptr)
-                {
-                    Params = *ParamsPtr;
-                }
-                
-                // Handle the command and get the response
-                TSharedPtr<FJsonObject> Response = Handler->Execute(Params, ClientSocket);
-                
-                // Send the response
-                SendResponse(ClientSocket, Response);
+                Params = *ParamsPtr;
             }
-            else
+            
+            // Earlier deferred responses of this client go out first
+            FlushPendingResponses(ClientSocket);
+
+            // Handlers that serialize off the game thread hand back a future instead of a response
+            TSharedPtr<IMCPCommandHandler> Handler = CommandHandlers.FindRef(Type);
+            TFuture<FString> DeferredResponse;
+            if (Handler.IsValid() && Handler->ExecuteDeferred(Params, ClientSocket, DeferredResponse))
             {
-                MCP_LOG_WARNING("Unknown command: %s", *Type);
-                
-                TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
-                Response->SetStringField("status", "error");
-                Response->SetStringField("message", FString::Printf(TEXT("Unknown command: %s"), *Type));
-                SendResponse(ClientSocket, Response);
+                MCP_LOG_INFO("Processing command: %s", *Type);
+                PendingResponses.Add({ ClientSocket, Type, MoveTemp(DeferredResponse) });
+                return;
             }
+
+            // Handle the command and send the response
+            SendResponse(ClientSocket, ExecuteCommand(Type, Params, ClientSocket));
         }
         else
         {
@@ -516,6 +675,67 @@ void FMCPTCPServer::ProcessCommand(const FString& CommandJson, FSocket* ClientSo
     // Do not close the socket here
 }
 
+TSharedPtr<FJsonObject> FMCPTCPServer::ExecuteCommand(const FString& Type, const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    TSharedPtr<IMCPCommandHandler> Handler = CommandHandlers.FindRef(Type);
+    if (!Handler.IsValid())
+    {
+        MCP_LOG_WARNING("Unknown command: %s", *Type);
+
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField("status", "error");
+        Response->SetStringField("message", FString::Printf(TEXT("Unknown command: %s"), *Type));
+        return Response;
+    }
+
+    MCP_LOG_INFO("Processing command: %s", *Type);
+    TSharedPtr<FJsonObject> Response = Handler->Execute(Params.IsValid() ? Params : MakeShared<FJsonObject>(), ClientSocket);
+
+    // Commands that edit unknown actors without editor notifications invalidate every scene cache
+    if (Handler->ModifiesSceneWithoutEvents())
+    {
+        FMCPSceneChangeTracker::Get().MarkFullRescan();
+        FMCPSceneSnapshotPublisher::Get().MarkDirty();
+    }
+    return Response;
+}
+
+void FMCPTCPServer::ProcessPendingResponses()
+{
+    for (int32 Index = 0; Index < PendingResponses.Num();)
+    {
+        FMCPPendingResponse& Pending = PendingResponses[Index];
+        if (!Pending.Response.IsReady())
+        {
+            ++Index;
+            continue;
+        }
+
+        MCP_LOG_VERBOSE("Deferred response for %s is ready", *Pending.CommandName);
+        const FString ResponseStr = Pending.Response.Get();
+        FSocket* ClientSocket = Pending.Socket;
+        PendingResponses.RemoveAt(Index);
+        SendResponseString(ClientSocket, ResponseStr);
+    }
+}
+
+void FMCPTCPServer::FlushPendingResponses(FSocket* ClientSocket)
+{
+    for (int32 Index = 0; Index < PendingResponses.Num();)
+    {
+        if (PendingResponses[Index].Socket != ClientSocket)
+        {
+            ++Index;
+            continue;
+        }
+
+        // Get() blocks until the worker has finished serializing
+        const FString ResponseStr = PendingResponses[Index].Response.Get();
+        PendingResponses.RemoveAt(Index);
+        SendResponseString(ClientSocket, ResponseStr);
+    }
+}
+
 void FMCPTCPServer::SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>& Response)
 {
     if (!Client) return;
@@ -523,50 +743,124 @@ void FMCPTCPServer::SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>&
     FString ResponseStr;
     TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResponseStr);
     FJsonSerializer::Serialize(Response.ToSharedRef(), Writer);
+
+    SendResponseString(Client, ResponseStr);
+}
+
+void FMCPTCPServer::SendResponseString(FSocket* Client, const FString& ResponseStr)
+{
+    if (!Client) return;
     
+    FMCPClientConnection* Connection = FindClientConnection(Client);
+    if (!Connection)
+    {
+        MCP_LOG_WARNING("Dropping response for a client that is no longer connected");
+        return;
+    }
+
     if (Config.bEnableVerboseLogging)
     {
         MCP_LOG_VERBOSE("Preparing to send response: %s", *ResponseStr);
     }
     
+    // Queue behind earlier responses so a large response is never cut off when the socket would block
     FTCHARToUTF8 Converter(*ResponseStr);
-    int32 BytesSent = 0;
-    int32 TotalBytes = Converter.Length();
-    const uint8* Data = (const uint8*)Converter.Get();
-    
-    // Ensure all data is sent
-    while (BytesSent < TotalBytes)
+
+    // A client that keeps sending commands without reading responses would grow the queue without bound;
+    // a single response of any size is still allowed while nothing else is waiting
+    const int64 UnsentBytes = Connection->PendingSendBytes.Num() - Connection->SentBytes;
+    if (UnsentBytes > 0 && UnsentBytes + Converter.Length() > MCPConstants::MAX_PENDING_SEND_BYTES)
+    {
+        MCP_LOG_WARNING("Client %s is not reading its responses (%lld bytes unsent), closing connection", 
+            *Connection->Endpoint.ToString(), UnsentBytes);
+        CleanupClientConnection(Client);
+        return;
+    }
+
+    Connection->PendingSendBytes.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+    MCP_LOG_INFO("Queued response (%d bytes)", Converter.Length());
+
+    if (!FlushPendingSend(*Connection))
+    {
+        CleanupClientConnection(Client);
+    }
+}
+
+bool FMCPTCPServer::FlushPendingSend(FMCPClientConnection& ClientConnection)
+{
+    const int32 TotalBytes = ClientConnection.PendingSendBytes.Num();
+    while (ClientConnection.SentBytes < TotalBytes)
     {
         int32 SentThisTime = 0;
-        if (!Client->Send(Data + BytesSent, TotalBytes - BytesSent, SentThisTime))
+        if (!ClientConnection.Socket->Send(ClientConnection.PendingSendBytes.GetData() + ClientConnection.SentBytes, TotalBytes - ClientConnection.SentBytes, SentThisTime))
         {
-            MCP_LOG_WARNING("Failed to send response");
-            break;
+            int32 ErrorCode = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+            if (ErrorCode != SE_EWOULDBLOCK)
+            {
+                MCP_LOG_WARNING("Failed to send response to %s (error code %d)", *ClientConnection.Endpoint.ToString(), ErrorCode);
+                return false;
+            }
+            SentThisTime = 0;
         }
         
         if (SentThisTime <= 0)
         {
             // Would block, try again next tick
             MCP_LOG_VERBOSE("Socket would block, will try again next tick");
-            break;
+            return true;
         }
         
-        BytesSent += SentThisTime;
+        ClientConnection.SentBytes += SentThisTime;
+        ClientConnection.TimeSinceLastActivity = 0.0f;
         
         if (Config.bEnableVerboseLogging)
         {
-            MCP_LOG_VERBOSE("Sent %d/%d bytes", BytesSent, TotalBytes);
+            MCP_LOG_VERBOSE("Sent %d/%d bytes", ClientConnection.SentBytes, TotalBytes);
         }
     }
     
-    if (BytesSent == TotalBytes)
+    if (TotalBytes > 0)
     {
-        MCP_LOG_INFO("Successfully sent complete response (%d bytes)", TotalBytes);
+        MCP_LOG_INFO("Successfully sent buffered responses (%d bytes)", TotalBytes);
+        ClientConnection.PendingSendBytes.Reset();
+        ClientConnection.SentBytes = 0;
     }
-    else
+    return true;
+}
+
+void FMCPTCPServer::ProcessPendingSends()
+{
+    TArray<FSocket*> FailedSockets;
+    for (FMCPClientConnection& Connection : ClientConnections)
+    {
+        if (Connection.Socket && !FlushPendingSend(Connection))
+        {
+            FailedSockets.Add(Connection.Socket);
+        }
+    }
+
+    for (FSocket* Socket : FailedSockets)
+    {
+        CleanupClientConnection(Socket);
+    }
+}
+
+FMCPClientConnection* FMCPTCPServer::FindClientConnection(FSocket* ClientSocket)
+{
+    return ClientConnections.FindByPredicate([ClientSocket](const FMCPClientConnection& Connection) {
+        return Connection.Socket == ClientSocket;
+    });
+}
+
+TArray<FSocket*> FMCPTCPServer::GetClientSockets() const
+{
+    TArray<FSocket*> Sockets;
+    Sockets.Reserve(ClientConnections.Num());
+    for (const FMCPClientConnection& Connection : ClientConnections)
     {
-        MCP_LOG_WARNING("Only sent %d/%d bytes of response", BytesSent, TotalBytes);
+        Sockets.Add(Connection.Socket);
     }
+    return Sockets;
 }
 
 FString FMCPTCPServer::GetSafeSocketDescription(FSocket* Socket)
@@ -4,6 +4,12 @@
 #include "MCPTCPServer.h"
 #include "MCPSettings.h"
 #include "MCPConstants.h"
+#include "MCPCommandHandlers_DataTables.h"
+#include "MCPCommandHandlers_Jobs.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPCommandHandlers_WorldPartition.h"
+#include "MCPPythonNativeModule.h"
+#include "MCPPythonRuntime.h"
 #include "LevelEditor.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Styling/SlateStyleRegistry.h"
@@ -137,6 +143,10 @@ void FUnrealMCPModule::StartupModule()
 	
 	MCP_LOG_INFO("Registering OnPostEngineInit delegate");
 	FCoreDelegates::OnPostEngineInit.AddRaw(this, &FUnrealMCPModule::ExtendLevelEditorToolbar);
+
+	// Prepare the execute_python runtime and the unreal_mcp_native module once the interpreter exists
+	FMCPPythonRuntime::Startup();
+	FMCPPythonNativeModule::Register();
 }
 
 void FUnrealMCPModule::ShutdownModule()
@@ -158,6 +168,18 @@ void FUnrealMCPModule::ShutdownModule()
 	
 	// Close control panel if open
 	CloseMCPControlPanel();
+
+	// Stop tracking scene changes and publishing snapshots
+	FMCPSceneSnapshotPublisher::Get().Shutdown();
+	FMCPSceneChangeTracker::Get().Shutdown();
+	FMCPSceneFieldPlanCache::Get().Shutdown();
+	FMCPWorldPartitionUtils::Shutdown();
+	FMCPPythonNativeModule::Unregister();
+	FMCPPythonRuntime::Shutdown();
+	FMCPDataTableIndexCache::Get().Shutdown();
+
+	// Cancel jobs that are still stepping on the game thread
+	FMCPJobRegistry::Get().Shutdown();
 	
 	// Clean up delegates
 	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
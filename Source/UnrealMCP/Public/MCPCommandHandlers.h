@@ -82,6 +82,15 @@ public:
      * @return JSON response object
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /**
+     * Gather the scene on the game thread and serialize the response on worker threads
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @param OutResponse - Future yielding the serialized response
+     * @return True if the response was deferred
+     */
+    virtual bool ExecuteDeferred(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket, TFuture<FString>& OutResponse) override;
 };
 
 /**
@@ -182,8 +191,51 @@ public:
      * @return JSON response object
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /** Scripts can touch any actor through APIs that fire no editor events */
+    virtual bool ModifiesSceneWithoutEvents() const override { return true; }
 }; 
 
+/**
+ * Handler for registering (or removing) a named Python snippet that execute_python can invoke by name
+ */
+class FMCPRegisterPythonSnippetHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPRegisterPythonSnippetHandler()
+        : FMCPCommandHandlerBase("register_python_snippet")
+    {
+    }
+
+    /**
+     * Execute the register_python_snippet command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for listing, resetting and dropping the persistent Python sessions of the calling client
+ */
+class FMCPPythonSessionHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPPythonSessionHandler()
+        : FMCPCommandHandlerBase("python_session")
+    {
+    }
+
+    /**
+     * Execute the python_session command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
 /**
  * Handler for importing template content packs into the project
  */
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+/**
+ * Handler that runs many line traces or shape sweeps against the editor world in one call
+ * and returns the hits as packed arrays.
+ */
+class FMCPBatchTracesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPBatchTracesHandler()
+        : FMCPCommandHandlerBase(TEXT("batch_traces"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
@@ -3,9 +3,212 @@
 #include "CoreMinimal.h"
 #include "MCPCommandHandlers.h"
 #include "Engine/DataTable.h"
+#include "UObject/ObjectKey.h"
 
 #include "Dom/JsonObject.h"
 
+/**
+ * How a planned row field is written. Common leaf types are set directly; everything else goes
+ * through FJsonObjectConverter.
+ */
+enum class EMCPRowFieldSetter : uint8
+{
+    Bool,
+    Integer,
+    FloatingPoint,
+    String,
+    Name,
+    /** Enums, text, containers, nested structs and references */
+    Converter
+};
+
+/**
+ * One top-level property of a row struct.
+ */
+struct FMCPRowField
+{
+    FProperty* Property = nullptr;
+
+    /** Offset of the value inside the row */
+    int32 Offset = 0;
+
+    EMCPRowFieldSetter Setter = EMCPRowFieldSetter::Converter;
+};
+
+/**
+ * Conversion plan for one row struct. JSON keys are resolved to properties once when the plan is
+ * compiled, so decoding a row only looks up its keys and writes at known offsets.
+ */
+class FMCPRowConversionPlan
+{
+public:
+    explicit FMCPRowConversionPlan(const UScriptStruct* Struct);
+
+    /**
+     * Write the fields present in the JSON object into initialized row memory; absent fields keep
+     * their current values and unknown keys are ignored. Safe on worker threads when IsParallelSafe().
+     */
+    bool Decode(const FJsonObject& RowJson, uint8* RowData, FString& OutErrorMessage) const;
+
+    /** The struct holds no references that would have to be resolved on the game thread */
+    bool IsParallelSafe() const { return bParallelSafe; }
+
+    /** The struct still has the properties the plan was compiled against (user structs are recompiled in place) */
+    bool Matches(const UScriptStruct* Struct) const { return LayoutHash == ComputeLayoutHash(Struct); }
+
+private:
+    static uint32 ComputeLayoutHash(const UScriptStruct* Struct);
+
+    /** Whether converting a value of the property can touch objects other than the row itself */
+    static bool IsParallelSafeProperty(const FProperty* Property);
+
+    TArray<FMCPRowField> Fields;
+
+    /** Property name, authored name and display name (case-insensitive) to index into Fields */
+    TMap<FString, int32> FieldIndices;
+
+    uint32 LayoutHash = 0;
+    bool bParallelSafe = true;
+};
+
+/**
+ * Process-wide cache of row conversion plans keyed by struct.
+ */
+class FMCPRowConversionPlanCache
+{
+public:
+    static FMCPRowConversionPlanCache& Get();
+
+    /**
+     * Find or compile the plan for a struct, recompiling it if the struct changed. Game thread only.
+     */
+    TSharedRef<const FMCPRowConversionPlan> FindOrCompile(const UScriptStruct* Struct);
+
+    /** Drop every cached plan */
+    void Reset();
+
+private:
+    /** Upper bound on cached plans before the cache is flushed */
+    static constexpr int32 MaxCachedPlans = 256;
+
+    TMap<FObjectKey, TSharedRef<const FMCPRowConversionPlan>> Plans;
+};
+
+/**
+ * Rows of a data table in table order. Column index entries refer to rows by their position here.
+ */
+struct FMCPDataTableRows
+{
+    TArray<FName> Names;
+    TArray<uint8*> Data;
+
+    /** Position of each row by name, for row name equality filters */
+    TMap<FName, int32> Ordinals;
+};
+
+/**
+ * Values of one column sorted for binary search, answering equality and range filters without a scan.
+ */
+struct FMCPDataTableColumnIndex
+{
+    struct FEntry
+    {
+        double Number = 0.0;
+        FString Text;
+
+        /** Position of the row in FMCPDataTableRows */
+        int32 RowOrdinal = 0;
+    };
+
+    /** Entries are ordered by Number (numeric and bool columns) or by case-insensitive Text */
+    bool bNumeric = false;
+
+    TArray<FEntry> Entries;
+};
+
+/**
+ * Column indexes of data tables, built the first time a query filters on a column. A table's indexes
+ * are dropped when it broadcasts OnDataTableChanged (editor edits and the MCP data table commands do)
+ * and rebuilt when its rows were added, removed or reallocated without a notification.
+ */
+class FMCPDataTableIndexCache
+{
+public:
+    static FMCPDataTableIndexCache& Get();
+
+    /**
+     * Rows of the table as the indexes see them. Game thread only.
+     */
+    TSharedRef<const FMCPDataTableRows> GetRows(UDataTable* DataTable);
+
+    /**
+     * Find or build the index of one column of the table. Game thread only.
+     */
+    TSharedRef<const FMCPDataTableColumnIndex> FindOrBuild(UDataTable* DataTable, const FProperty* Column);
+
+    /** Drop the indexes of one table */
+    void Invalidate(const UDataTable* DataTable);
+
+    /** Drop every index and stop listening to the tables */
+    void Shutdown();
+
+private:
+    struct FTableIndexes
+    {
+        TWeakObjectPtr<UDataTable> Table;
+        FDelegateHandle ChangedHandle;
+
+        /**
+         * Hash of the row names and row pointers the indexes were built from. It catches rows added,
+         * removed or reallocated behind the table's back; edits to a row's values in place are only
+         * seen through OnDataTableChanged.
+         */
+        uint32 RowMapHash = 0;
+
+        TSharedPtr<const FMCPDataTableRows> Rows;
+        TMap<const FProperty*, TSharedRef<const FMCPDataTableColumnIndex>> Columns;
+    };
+
+    FTableIndexes& FindOrAddTable(UDataTable* DataTable);
+
+    void HandleTableChanged(FObjectKey TableKey);
+
+    static uint32 ComputeRowMapHash(const UDataTable* DataTable);
+
+    /** Upper bound on indexed tables before every index is dropped */
+    static constexpr int32 MaxIndexedTables = 64;
+
+    TMap<FObjectKey, FTableIndexes> Tables;
+};
+
+/**
+ * A row that could not be imported.
+ */
+struct FMCPDataTableRowError
+{
+    FString RowName;
+
+    /** Line of the source file the row starts on */
+    int32 Line = 0;
+
+    FString Message;
+};
+
+/**
+ * Outcome of importing rows from a file. Rows that fail to convert are skipped, not fatal.
+ */
+struct FMCPDataTableImportStats
+{
+    int32 RowsApplied = 0;
+    int32 RowsFailed = 0;
+
+    /** The first MCPConstants::MAX_DATA_TABLE_IMPORT_ERRORS failures */
+    TArray<FMCPDataTableRowError> Errors;
+
+    /** CSV columns that match no property of the row struct */
+    TArray<FString> IgnoredColumns;
+};
+
 /**
  * Utility helpers for working with data tables via MCP commands.
  */
@@ -23,7 +226,7 @@ public:
         FString& OutErrorMessage);
 
     /**
-     * Convert a JSON object into row data for the supplied struct.
+     * Convert a JSON object into row data for the supplied struct using its cached conversion plan.
      */
     static bool ConvertJsonToStruct(
         const TSharedPtr<FJsonObject>& JsonObject,
@@ -32,7 +235,8 @@ public:
         FString& OutErrorMessage);
 
     /**
-     * Apply the supplied rows to the target data table (add or replace).
+     * Apply the supplied rows to the target data table (add or replace). Rows are decoded in
+     * batches on worker threads and added in order; the first row that fails stops the apply.
      */
     static bool ApplyRowsToDataTable(
         UDataTable* DataTable,
@@ -40,6 +244,47 @@ public:
         int32& OutRowsApplied,
         FString& OutErrorMessage);
 
+    /**
+     * Load a data table from an object path or package path; relative paths are taken under /Game.
+     */
+    static UDataTable* LoadDataTable(const FString& InPath, FString& OutErrorMessage);
+
+    /**
+     * Resolve a row file path (relative paths are taken from the project directory) and check it exists.
+     * @param Format - "csv", "json" or empty to pick from the file extension; replaced with the resolved format
+     */
+    static bool ResolveRowsFile(
+        const FString& InFilePath,
+        FString& InOutFormat,
+        FString& OutFullPath,
+        FString& OutErrorMessage);
+
+    /**
+     * Stream rows from a CSV or JSON file into the data table, decoding the file in fixed-size chunks
+     * and holding at most one batch of rows, so memory does not grow with the file. Each batch is
+     * decoded on worker threads and then added to the table on the calling thread.
+     *
+     * CSV files start with a header row; the row name is in NameColumn (the first column when empty)
+     * and other cells are imported as property text, as the editor's CSV import does.
+     * JSON files hold either an object keyed by row name or an array of row objects carrying the row
+     * name in NameColumn ("Name" when empty), as the editor's JSON export writes them.
+     *
+     * @return False if the file cannot be read or is malformed past the point of recovery; rows
+     *         applied before that point stay in the table
+     */
+    static bool ImportRowsFromFile(
+        UDataTable* DataTable,
+        const FString& FullPath,
+        const FString& Format,
+        const FString& NameColumn,
+        FMCPDataTableImportStats& OutStats,
+        FString& OutErrorMessage);
+
+    /**
+     * Add the failure counts and row errors of an import to a command result.
+     */
+    static void WriteImportStats(const FMCPDataTableImportStats& Stats, const TSharedPtr<FJsonObject>& Result);
+
     /**
      * Remove rows from the data table.
      */
@@ -49,6 +294,12 @@ public:
         int32& OutRowsRemoved,
         FString& OutErrorMessage);
 
+    /**
+     * Notify the editor of rows already written before an operation failed part way, so the table and
+     * its caches stay consistent, and build the error message reporting how many rows were applied.
+     */
+    static FString NotifyPartialRowsChange(UDataTable* DataTable, int32 RowsApplied, const FString& ErrorMessage);
+
     /**
      * Save the package that owns the supplied asset.
      */
@@ -87,3 +338,17 @@ public:
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
 };
 
+/**
+ * Handler that reads data table rows with column projection, filters (equality, range, contains),
+ * sorting and pagination. Equality and range filters on large tables use lazily built column indexes.
+ */
+class FMCPQueryDataTableHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPQueryDataTableHandler()
+        : FMCPCommandHandlerBase(TEXT("query_data_table"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Utility helpers shared by the instanced static mesh commands.
+ */
+class FMCPInstancingUtils
+{
+public:
+    /**
+     * Find an actor in the world by object name or path, or by label when exactly one actor carries it.
+     * @param OutErrorMessage - Set when the label matches several actors; the result is then null
+     */
+    static AActor* FindActorByNameOrLabel(UWorld* World, const FString& NameOrLabel, FString& OutErrorMessage);
+
+    /**
+     * Spawn an empty actor with a scene root that can host instance components.
+     */
+    static AActor* SpawnInstanceHostActor(UWorld* World, const FVector& Location, const FString& Label);
+
+    /**
+     * Find an instance component on the host that renders the given mesh, or create one.
+     * @param bHierarchical - Create a HierarchicalInstancedStaticMeshComponent when a new component is needed
+     */
+    static UInstancedStaticMeshComponent* FindOrCreateInstanceComponent(
+        AActor* HostActor,
+        UStaticMesh* Mesh,
+        bool bHierarchical,
+        bool& bOutCreated);
+
+    /**
+     * Decode a packed transform array. Each instance occupies Stride values:
+     * 3 = location, 6 = location + rotation (pitch, yaw, roll), 9 = location + rotation + scale.
+     * The data is read as described for ParsePackedDoubles, so large world coordinates survive intact.
+     */
+    static bool ParsePackedTransforms(
+        const TSharedPtr<FJsonObject>& Params,
+        const FString& ArrayFieldName,
+        const FString& Base64FieldName,
+        TArray<FTransform>& OutTransforms,
+        FString& OutErrorMessage);
+
+    /**
+     * Decode a flat float array from a JSON number array or a base64 float32 field.
+     * @return False if neither field is present or the data is malformed
+     */
+    static bool ParsePackedFloats(
+        const TSharedPtr<FJsonObject>& Params,
+        const FString& ArrayFieldName,
+        const FString& Base64FieldName,
+        TArray<float>& OutValues,
+        FString& OutErrorMessage);
+
+    /**
+     * Decode a flat double array for positional data. Accepts, in order of preference,
+     * "<ArrayFieldName>_f64_base64" (little-endian float64), the base64 float32 field, or a JSON number array.
+     * @return False if none of the fields is present or the data is malformed
+     */
+    static bool ParsePackedDoubles(
+        const TSharedPtr<FJsonObject>& Params,
+        const FString& ArrayFieldName,
+        const FString& Base64FieldName,
+        TArray<double>& OutValues,
+        FString& OutErrorMessage);
+
+    /**
+     * Append instances (and optional per-instance custom data) to the component in one batch.
+     * @return Index of the first added instance, or INDEX_NONE on failure
+     */
+    static int32 AddInstances(
+        UInstancedStaticMeshComponent* Component,
+        const TArray<FTransform>& Transforms,
+        bool bWorldSpace,
+        const TArray<float>& CustomData,
+        int32 NumCustomDataFloats);
+};
+
+/**
+ * Handler that bulk-adds instances of a mesh to an (H)ISM component on a single host actor.
+ */
+class FMCPCreateInstancesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPCreateInstancesHandler()
+        : FMCPCommandHandlerBase(TEXT("create_instances"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler that generates instance transforms server-side (Poisson disk or jittered grid over a box,
+ * a band along a spline or the surface of a static mesh actor) and adds them to an (H)ISM component.
+ */
+class FMCPScatterHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPScatterHandler()
+        : FMCPCommandHandlerBase(TEXT("scatter"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler that replaces groups of StaticMeshActors sharing a mesh and material set with one
+ * HierarchicalInstancedStaticMeshComponent per group.
+ */
+class FMCPConsolidateInstancesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPConsolidateInstancesHandler()
+        : FMCPCommandHandlerBase(TEXT("consolidate_instances"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
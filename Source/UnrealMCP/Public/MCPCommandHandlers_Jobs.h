@@ -0,0 +1,142 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "MCPCommandHandlers.h"
+
+/**
+ * Lifecycle of a tracked job
+ */
+enum class EMCPJobState : uint8
+{
+    Running,
+    Succeeded,
+    Failed,
+    Cancelled
+};
+
+/**
+ * Status of a tracked job as reported by get_job_status
+ */
+struct FMCPJobStatus
+{
+    FString Id;
+    FString Type;
+    EMCPJobState State = EMCPJobState::Running;
+    float Progress = 0.0f;
+    FString Message;
+    TSharedPtr<FJsonObject> Result;
+    bool bCancelRequested = false;
+    double StartTime = 0.0;
+    double FinishTime = 0.0;
+
+    /** Streamed output, oldest lines dropped past MAX_JOB_OUTPUT_LINES */
+    TArray<FString> Output;
+    int32 DroppedOutputLines = 0;
+};
+
+/**
+ * Registry of long-running commands. A command starts a job, returns its id straight away and
+ * the client polls get_job_status. Ticked jobs run one step per editor frame on the game thread,
+ * so work that must touch UObjects stays responsive and can be cancelled between steps.
+ * Status updates are safe to make from any thread.
+ */
+class FMCPJobRegistry
+{
+public:
+    /**
+     * One unit of work; return true when the job has finished.
+     * Set bOutEditedScene when the step may have edited actors without editor events, so the scene caches are rebuilt.
+     */
+    using FJobStep = TFunction<bool(const FString& JobId, bool& bOutEditedScene)>;
+
+    /** Called on the game thread instead of the next step when a ticked job is cancelled */
+    using FJobCancel = TFunction<void(const FString& JobId)>;
+
+    static FMCPJobRegistry& Get();
+
+    /**
+     * Register a job whose work is driven elsewhere (e.g. a worker task).
+     * @return Id of the new job
+     */
+    FString CreateJob(const FString& Type);
+
+    /**
+     * Register a job and call Step once per editor tick on the game thread until it returns true,
+     * fails, or is cancelled. A job that finishes without calling CompleteJob succeeds with no result.
+     * OnCancel lets the job clean up (or unwind work in progress) before it is marked cancelled.
+     */
+    FString StartTickedJob(const FString& Type, FJobStep Step, FJobCancel OnCancel = FJobCancel());
+
+    void SetProgress(const FString& JobId, float Progress, const FString& Message);
+
+    /** Append lines the client can read incrementally with get_job_status(output_from=...) */
+    void AppendOutput(const FString& JobId, const TArray<FString>& Lines);
+    void CompleteJob(const FString& JobId, const TSharedPtr<FJsonObject>& Result);
+    void FailJob(const FString& JobId, const FString& Error);
+
+    /** Ask a job to stop. Ticked jobs stop before their next step; other jobs poll IsCancelRequested. */
+    bool RequestCancel(const FString& JobId);
+    bool IsCancelRequested(const FString& JobId) const;
+
+    /** Mark a job that honoured a cancel request as cancelled */
+    void MarkCancelled(const FString& JobId);
+
+    bool IsFinished(const FString& JobId) const;
+
+    /**
+     * @param OutputFrom - Include the output lines from this index on; negative omits the output
+     */
+    TSharedPtr<FJsonObject> GetJobJson(const FString& JobId, int32 OutputFrom = INDEX_NONE) const;
+    TArray<TSharedPtr<FJsonValue>> ListJobsJson() const;
+
+    /** Cancel ticked jobs and stop ticking */
+    void Shutdown();
+
+private:
+    bool Tick(float DeltaTime);
+    void FinishJob(const FString& JobId, EMCPJobState State, const FString& Message, const TSharedPtr<FJsonObject>& Result);
+    void PruneFinishedJobs();
+
+    mutable FCriticalSection JobsLock;
+    TMap<FString, FMCPJobStatus> Jobs;
+
+    struct FTickedJob
+    {
+        FJobStep Step;
+        FJobCancel OnCancel;
+    };
+
+    /** Ticked jobs, shared so a step may start other jobs while it runs. Game thread only. */
+    TMap<FString, TSharedPtr<FTickedJob>> TickedJobs;
+
+    FTSTicker::FDelegateHandle TickerHandle;
+};
+
+/**
+ * Handler for get_job_status: one job by id, or every retained job when no id is given.
+ */
+class FMCPGetJobStatusHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetJobStatusHandler()
+        : FMCPCommandHandlerBase(TEXT("get_job_status"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for cancel_job
+ */
+class FMCPCancelJobHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPCancelJobHandler()
+        : FMCPCommandHandlerBase(TEXT("cancel_job"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+/**
+ * Handler that merges the static meshes of a set of actors into one static mesh asset with the
+ * editor's mesh merging utilities, optionally replacing the sources with a single actor.
+ * Runs as a tracked job; poll get_job_status with the returned job id.
+ */
+class FMCPMergeActorsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPMergeActorsHandler()
+        : FMCPCommandHandlerBase(TEXT("merge_actors"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler that applies LOD reduction settings to a list of static meshes (or an asset registry
+ * filter) and rebuilds them with the engine's batched, asynchronous static mesh build.
+ * Runs as a tracked job with per-asset progress.
+ */
+class FMCPGenerateLODsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGenerateLODsHandler()
+        : FMCPCommandHandlerBase(TEXT("generate_lods"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler that builds parametric meshes (box, rounded box, sphere, cylinder/cone, plane grid and
+ * spline sweeps) into static meshes via MeshDescription. Without an asset path the mesh is a
+ * transient preview. Accepts a 'shapes' array to generate many meshes in one call.
+ */
+class FMCPGenerateMeshHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGenerateMeshHandler()
+        : FMCPCommandHandlerBase(TEXT("generate_mesh"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
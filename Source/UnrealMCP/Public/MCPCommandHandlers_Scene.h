@@ -0,0 +1,698 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "MCPCommandHandlers.h"
+#include "UObject/ObjectKey.h"
+
+#include "Dom/JsonObject.h"
+
+/**
+ * Built-in actor fields that scene queries can project.
+ */
+enum class EMCPSceneField : uint8
+{
+    Name,
+    Type,
+    ClassPath,
+    Label,
+    Location,
+    Rotation,
+    Scale,
+    Bounds,
+    Mobility,
+    Folder,
+    Tags,
+    Guid,
+    Hidden,
+    Parent,
+    Components,
+    /** Reflected UPROPERTY path resolved through the plan's property chain */
+    Property
+};
+
+/**
+ * One step of a reflected property path. Struct members are folded into the offset;
+ * object references end a step and are dereferenced at extraction time.
+ */
+struct FMCPPropertyPathStep
+{
+    /** Offset from the current container to the property value */
+    int32 Offset = 0;
+
+    /** Object property to dereference, or null for the final (leaf) step */
+    const FObjectPropertyBase* ObjectProperty = nullptr;
+};
+
+/**
+ * A single output column of a field plan.
+ */
+struct FMCPSceneFieldAccessor
+{
+    /** Key written to the output object (the requested field string) */
+    FString Key;
+
+    EMCPSceneField Field = EMCPSceneField::Property;
+
+    /** Resolved steps for Property fields; empty when the path did not resolve on this class */
+    TArray<FMCPPropertyPathStep> Steps;
+
+    /** Leaf property for Property fields */
+    const FProperty* LeafProperty = nullptr;
+};
+
+/**
+ * Plain value of one planned field, read on the game thread and turned into JSON on any thread.
+ * Only the members used by the field's kind are set.
+ */
+struct FMCPSceneFieldValue
+{
+    /** Name, Type, ClassPath, Label, Mobility, Folder, Guid and Parent */
+    FString Text;
+
+    /** Location, Rotation (pitch, yaw, roll) and Scale use the first vector; Bounds uses origin and extent */
+    FVector Vectors[2] = { FVector::ZeroVector, FVector::ZeroVector };
+
+    /** Hidden */
+    bool bFlag = false;
+
+    /** Tags, or component name and type pairs */
+    TArray<FString> Strings;
+
+    /** Reflected properties are converted while the actor is still safe to read */
+    TSharedPtr<FJsonValue> PropertyValue;
+};
+
+/**
+ * Extraction plan for one actor class and one set of requested fields.
+ * Property names are resolved once when the plan is compiled, so extraction only follows offsets.
+ */
+class FMCPSceneFieldPlan
+{
+public:
+    /**
+     * Compile a plan for the given class.
+     * @param Class - Actor class the plan is compiled for
+     * @param Fields - Requested fields, either built-in names or dotted UPROPERTY paths
+     */
+    FMCPSceneFieldPlan(const UClass* Class, const TArray<FString>& Fields);
+
+    /**
+     * Write the planned fields of the actor into the target object.
+     */
+    void Extract(const AActor* Actor, const TSharedPtr<FJsonObject>& OutObject) const;
+
+    /**
+     * Read the planned fields of the actor into plain values, one per field in request order.
+     * Must run on the game thread.
+     */
+    void Gather(const AActor* Actor, TArray<FMCPSceneFieldValue>& OutValues) const;
+
+    /**
+     * Write values produced by Gather into the target object. Safe on any thread.
+     */
+    void WriteValues(TConstArrayView<FMCPSceneFieldValue> Values, const TSharedPtr<FJsonObject>& OutObject) const;
+
+    /**
+     * Export one planned field of the actor as text (UPROPERTY fields use the property's text export).
+     * @return False if the field did not resolve or the value is unavailable
+     */
+    bool ExportFieldText(const AActor* Actor, int32 FieldIndex, FString& OutText) const;
+
+    /** Number of planned fields, in request order */
+    int32 NumFields() const { return Accessors.Num(); }
+
+    /** Field strings that could not be resolved on this class */
+    const TArray<FString>& GetUnresolvedFields() const { return UnresolvedFields; }
+
+private:
+    /** Resolve a dotted property path against the class */
+    static bool CompilePropertyPath(const UStruct* Struct, const FString& Path, FMCPSceneFieldAccessor& OutAccessor);
+
+    /** Read a single planned field of the actor */
+    static void GatherField(const AActor* Actor, const FMCPSceneFieldAccessor& Accessor, FMCPSceneFieldValue& OutValue);
+
+    /** Write a single gathered field into the target object */
+    static void WriteField(const FMCPSceneFieldAccessor& Accessor, const FMCPSceneFieldValue& Value, const TSharedPtr<FJsonObject>& OutObject);
+
+    /** Follow the resolved steps to the leaf value, or null if a reference on the way is null */
+    static const uint8* ResolveValuePtr(const AActor* Actor, const FMCPSceneFieldAccessor& Accessor);
+
+    /** Follow the resolved steps and convert the leaf value to JSON */
+    static TSharedPtr<FJsonValue> ReadProperty(const AActor* Actor, const FMCPSceneFieldAccessor& Accessor);
+
+    TArray<FMCPSceneFieldAccessor> Accessors;
+    TArray<FString> UnresolvedFields;
+};
+
+/**
+ * Process-wide cache of compiled field plans keyed by class and field list.
+ */
+class FMCPSceneFieldPlanCache
+{
+public:
+    static FMCPSceneFieldPlanCache& Get();
+
+    /**
+     * Find or compile the plan for a class.
+     * @param Class - Actor class
+     * @param Fields - Requested fields
+     * @param FieldsSignature - Stable string identifying the field list (see FMCPSceneQueryUtils::GetFieldsSignature)
+     */
+    TSharedRef<const FMCPSceneFieldPlan> FindOrCompile(const UClass* Class, const TArray<FString>& Fields, const FString& FieldsSignature);
+
+    /** Drop every cached plan (e.g. after classes were reinstanced) */
+    void Reset();
+
+    /** Unbind from the class reload delegates and drop every cached plan */
+    void Shutdown();
+
+private:
+    /** Flush the plans whenever property layouts may change: blueprint compiles, reinstancing and hot reload */
+    void EnsureInvalidation();
+    void HandleObjectsReinstanced(const TMap<UObject*, UObject*>& ReplacedObjects);
+    void HandleReloadComplete(EReloadCompleteReason Reason);
+
+    /** Upper bound on cached plans before the cache is flushed */
+    static constexpr int32 MaxCachedPlans = 1024;
+
+    TMap<TPair<FObjectKey, FString>, TSharedRef<const FMCPSceneFieldPlan>> Plans;
+    bool bDelegatesBound = false;
+};
+
+/**
+ * Struct-of-arrays view of the scene, filled in one pass over the actors.
+ * Per-actor vectors are stored as contiguous float triples so they can be sent or written as-is.
+ */
+struct FMCPSceneColumns
+{
+    /** Name of the level the data was gathered from */
+    FString LevelName;
+
+    /** Number of actors in the world (may exceed the gathered count) */
+    int32 TotalActorCount = 0;
+
+    /** Class dictionary; ClassIds index into it */
+    TArray<FString> ClassNames;
+
+    /** Deduplicated string table; NameIds and LabelIds index into it */
+    TArray<FString> Strings;
+
+    TArray<int32> ClassIds;
+    TArray<int32> NameIds;
+    TArray<int32> LabelIds;
+
+    /** 3 doubles per actor: X, Y, Z. Doubles keep large-world coordinates exact. */
+    TArray<double> Positions;
+
+    /** 3 floats per actor: pitch, yaw, roll */
+    TArray<float> Rotations;
+
+    /** 3 floats per actor: X, Y, Z */
+    TArray<float> Scales;
+
+    /** 6 doubles per actor: origin XYZ followed by extent XYZ */
+    TArray<double> Bounds;
+
+    int32 Num() const { return ClassIds.Num(); }
+};
+
+/**
+ * Field values of one actor in a get_scene_info response.
+ */
+struct FMCPSceneRow
+{
+    /** Plan the values were gathered with; null where a cached fragment is used instead */
+    TSharedPtr<const FMCPSceneFieldPlan> Plan;
+
+    /** One value per planned field */
+    TArray<FMCPSceneFieldValue> Values;
+};
+
+/**
+ * Per-actor rows of a get_scene_info response, gathered on the game thread as plain values.
+ * The JSON objects are only built when the rows are serialized, which can happen on any thread.
+ */
+struct FMCPSceneRows
+{
+    FString LevelName;
+    int32 TotalActorCount = 0;
+    bool bLimitReached = false;
+
+    /** One row per actor */
+    TArray<FMCPSceneRow> Actors;
+    TSet<FString> UnresolvedFields;
+
+    /** Whether the rows were gathered through FMCPSceneFragmentCache */
+    bool bUseFragmentCache = false;
+
+    /** Cached serialized rows, parallel to Actors when the fragment cache is used */
+    TArray<TSharedPtr<const FString>> Fragments;
+
+    /** Actor keys and transforms, parallel to Actors, used to store newly serialized rows */
+    TArray<FObjectKey> ActorKeys;
+    TArray<FTransform> ActorTransforms;
+
+    /** Field signature and change serial the rows were gathered with */
+    FString FieldsSignature;
+    uint64 GatherSerial = 0;
+};
+
+/**
+ * Utility helpers shared by the scene query commands.
+ */
+class FMCPSceneQueryUtils
+{
+public:
+    /**
+     * Read the "fields" parameter; falls back to the default name/type/label/location set.
+     */
+    static TArray<FString> ReadRequestedFields(const TSharedPtr<FJsonObject>& Params);
+
+    /**
+     * Build the cache key for a list of fields.
+     */
+    static FString GetFieldsSignature(const TArray<FString>& Fields);
+
+    /**
+     * Convert a vector into a JSON number array.
+     */
+    static TArray<TSharedPtr<FJsonValue>> VectorToJsonArray(const FVector& Vector);
+
+    /**
+     * Convert a rotator into a JSON number array (pitch, yaw, roll).
+     */
+    static TArray<TSharedPtr<FJsonValue>> RotatorToJsonArray(const FRotator& Rotator);
+
+    /**
+     * Get the lower-case name of a mobility value.
+     */
+    static FString MobilityToString(EComponentMobility::Type Mobility);
+
+    /**
+     * Gather class, name, label, transform and bounds columns for up to MaxActors actors.
+     */
+    static void GatherColumns(UWorld* World, int32 MaxActors, FMCPSceneColumns& OutColumns);
+
+    /**
+     * Build the columnar result object.
+     * @param bBinary - Encode the numeric columns as base64 little-endian buffers and the string table as a packed blob
+     */
+    static TSharedPtr<FJsonObject> BuildColumnarResult(const FMCPSceneColumns& Columns, bool bBinary);
+
+    /**
+     * Extract the requested fields of up to MaxActors actors. Must run on the game thread.
+     * @param bUseFragmentCache - Reuse cached serialized rows of unchanged actors and only extract the others
+     */
+    static void GatherRows(UWorld* World, const TArray<FString>& Fields, int32 MaxActors, FMCPSceneRows& OutRows, bool bUseFragmentCache = false);
+
+    /**
+     * Build the get_scene_info result object from gathered rows.
+     */
+    static TSharedPtr<FJsonObject> BuildRowsResult(const FMCPSceneRows& Rows);
+
+    /**
+     * Serialize a complete get_scene_info success response from gathered rows, in parallel chunks of actors.
+     * Safe to call from any thread.
+     */
+    static FString SerializeRowsResponse(const FMCPSceneRows& Rows);
+
+    /**
+     * Serialize a success response around the result object. Safe to call from any thread.
+     */
+    static FString SerializeSuccessResponse(const TSharedPtr<FJsonObject>& Result);
+};
+
+/**
+ * Flags stored in FMCPSceneSnapshotHeader::Flags.
+ */
+enum class EMCPSceneSnapshotFlags : uint32
+{
+    None = 0,
+    /** Records only cover actors added or changed since BaseSnapshotId */
+    Incremental = 1 << 0
+};
+ENUM_CLASS_FLAGS(EMCPSceneSnapshotFlags);
+
+/**
+ * Header of an export_scene_snapshot file.
+ * All integers are little-endian; all offsets are in bytes from the start of the file.
+ * Strings are referenced by byte offset into a table of NUL-terminated UTF-8 strings; offset 0 is the empty string.
+ */
+struct FMCPSceneSnapshotHeader
+{
+    /** 'M', 'C', 'P', 'S' */
+    uint8 Magic[4];
+    uint32 Version;
+    uint64 SnapshotId;
+    /** Snapshot the records are relative to, or 0 for a full snapshot */
+    uint64 BaseSnapshotId;
+    uint32 Flags;
+    uint32 RecordSize;
+    uint32 RecordCount;
+    uint32 ClassCount;
+    uint32 PropertyCount;
+    uint32 RemovedCount;
+    /** RecordCount fixed-size FMCPSceneSnapshotRecord entries */
+    uint64 RecordsOffset;
+    /** ClassCount uint32 string offsets (class names, indexed by record ClassId) */
+    uint64 ClassTableOffset;
+    /** PropertyCount uint32 string offsets (requested property paths) */
+    uint64 PropertyNamesOffset;
+    /** RecordCount * PropertyCount uint32 string offsets (exported values, row-major) */
+    uint64 PropertyValuesOffset;
+    /** RemovedCount 16-byte actor GUIDs removed since the base snapshot */
+    uint64 RemovedOffset;
+    uint64 StringTableOffset;
+    uint64 StringTableSize;
+};
+static_assert(sizeof(FMCPSceneSnapshotHeader) == 104, "Scene snapshot header layout changed; bump SCENE_SNAPSHOT_VERSION");
+
+/**
+ * Fixed-size per-actor record of an export_scene_snapshot file.
+ */
+struct FMCPSceneSnapshotRecord
+{
+    /** Actor GUID as four uint32 (FGuid A, B, C, D) */
+    uint32 Guid[4];
+    uint32 ClassId;
+    uint32 NameOffset;
+    uint32 LabelOffset;
+    uint32 FolderOffset;
+    /** World positions are doubles so large-world coordinates survive the export */
+    double Location[3];
+    double BoundsOrigin[3];
+    /** Rotation quaternion X, Y, Z, W */
+    float Rotation[4];
+    float Scale[3];
+    float BoundsExtent[3];
+};
+static_assert(sizeof(FMCPSceneSnapshotRecord) == 120, "Scene snapshot record layout changed; bump SCENE_SNAPSHOT_VERSION");
+
+/**
+ * Handler for the export_scene_snapshot command.
+ * Writes the scene to a versioned binary file under Saved/ and returns only its path.
+ */
+class FMCPExportSceneSnapshotHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPExportSceneSnapshotHandler()
+        : FMCPCommandHandlerBase(TEXT("export_scene_snapshot"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+private:
+    /** Allocate a snapshot id that does not collide with files from earlier editor sessions */
+    uint64 AllocateSnapshotId();
+
+    /** Per-actor content hashes of recent snapshots, used as bases for incremental exports */
+    TMap<uint64, TMap<FGuid, uint32>> RetainedSnapshots;
+
+    /** Retained snapshot ids, oldest first */
+    TArray<uint64> RetainedOrder;
+
+    uint64 LastSnapshotId = 0;
+};
+
+/**
+ * How get_scene_hash groups actors below the root hash.
+ */
+enum class EMCPSceneHashGrouping : uint8
+{
+    Folder,
+    Class
+};
+
+/**
+ * Hash and size of one group of actors.
+ */
+struct FMCPSceneHashGroup
+{
+    uint64 Hash = 0;
+    int32 ActorCount = 0;
+};
+
+/**
+ * Tracks editor actor changes and maintains a two-level Merkle hash of the editor world:
+ * one leaf hash per actor (identity and transform), one hash per folder and per class over
+ * their sorted leaves, and a root hash over the sorted groups.
+ * Only actors reported by editor events are rehashed, and only their groups are recombined.
+ */
+class FMCPSceneChangeTracker
+{
+public:
+    static FMCPSceneChangeTracker& Get();
+
+    /**
+     * Bring the hashes up to date for the world and return them.
+     * @param OutGroups - Receives every group of the requested grouping, keyed by folder path or class name
+     * @return Root hash for the requested grouping
+     */
+    uint64 ComputeHashes(UWorld* World, EMCPSceneHashGrouping Grouping, TMap<FString, FMCPSceneHashGroup>& OutGroups);
+
+    /** Number of actors currently hashed */
+    int32 GetTrackedActorCount() const { return Leaves.Num(); }
+
+    /** Counter bumped on every tracked change, for cheap "did anything happen" checks */
+    uint64 GetChangeSerial() const { return ChangeSerial; }
+
+    /** Start listening to editor events if not already doing so */
+    void EnsureTracking();
+
+    /**
+     * Whether no change of the actor was reported after the given change serial.
+     * Always false while the tracker is not listening to editor events.
+     */
+    bool IsUnchangedSince(const FObjectKey& ActorKey, uint64 Serial) const;
+
+    /**
+     * Treat every actor as changed: rehash the whole world on the next query and invalidate cached rows.
+     * Called after commands and jobs that may edit arbitrary actors without firing editor events.
+     */
+    void MarkFullRescan();
+
+    /**
+     * Record a change of one actor that no editor event reported, such as a handler adding instances
+     * or setting a transform. Only that actor is rehashed and its cached rows rebuilt.
+     */
+    void MarkActorDirty(const AActor* Actor);
+
+    /** Unbind from the editor delegates and drop all state */
+    void Shutdown();
+
+private:
+    struct FLeaf
+    {
+        FGuid Guid;
+        uint64 Hash = 0;
+        FString Folder;
+        FString ClassName;
+    };
+
+    struct FGroup
+    {
+        TSet<FObjectKey> Members;
+        uint64 Hash = 0;
+        bool bDirty = true;
+    };
+
+    void Rescan(UWorld* World);
+    void RehashActor(const AActor* Actor);
+    void RemoveActor(const FObjectKey& ActorKey);
+    void RecomputeGroups(TMap<FString, FGroup>& Groups);
+
+    static uint64 ComputeLeafHash(const AActor* Actor);
+    static FString GetFolderGroupName(const AActor* Actor);
+
+    void HandleActorChanged(AActor* Actor);
+    void HandleActorDeleted(AActor* Actor);
+    void HandleActorFolderChanged(const AActor* Actor, FName OldPath);
+    void HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event);
+    void HandleMapChange(uint32 MapChangeFlags);
+
+    TMap<FObjectKey, FLeaf> Leaves;
+    TMap<FString, FGroup> FolderGroups;
+    TMap<FString, FGroup> ClassGroups;
+
+    /** Actors touched since the last update; resolved lazily on the next query */
+    TMap<FObjectKey, TWeakObjectPtr<const AActor>> DirtyActors;
+
+    /** Change serial of the last event per live actor since the last full invalidation */
+    TMap<FObjectKey, uint64> ActorChangeSerials;
+
+    TWeakObjectPtr<UWorld> TrackedWorld;
+    bool bNeedsFullRescan = true;
+    bool bDelegatesBound = false;
+    uint64 ChangeSerial = 0;
+
+    /** Change serial of the last event that invalidated every actor (undo/redo, map or level list change) */
+    uint64 FullInvalidationSerial = 0;
+};
+
+/**
+ * Cache of serialized get_scene_info rows, keyed by actor and field signature.
+ * A fragment is reused while the change tracker reports no event for its actor and the actor
+ * transform is unchanged (the latter also catches moves made without editor notifications).
+ */
+class FMCPSceneFragmentCache
+{
+public:
+    static FMCPSceneFragmentCache& Get();
+
+    /**
+     * Look up the still valid fragments of a batch of actors under one lock. Game thread only.
+     * @param OutFragments - One entry per actor, null where the actor has no valid fragment
+     */
+    void FindFragments(const FString& FieldsSignature, TArrayView<const AActor* const> Actors, TArray<TSharedPtr<const FString>>& OutFragments);
+
+    /**
+     * Store newly serialized rows. Safe to call from any thread.
+     * @param GatherSerial - Tracker change serial at the time the rows were gathered
+     */
+    void StoreFragments(const FString& FieldsSignature, uint64 GatherSerial, TArrayView<const FObjectKey> ActorKeys, TArrayView<const FTransform> Transforms, TArrayView<const TSharedPtr<const FString>> Fragments);
+
+    /** Drop the fragments of one actor under every signature, e.g. when it is deleted */
+    void RemoveActor(const FObjectKey& ActorKey);
+
+    /** Drop every cached fragment */
+    void Reset();
+
+private:
+    struct FEntry
+    {
+        TSharedPtr<const FString> Fragment;
+        uint64 Serial = 0;
+        FTransform Transform;
+    };
+
+    /** Upper bounds before a signature's fragments, or the whole cache, are flushed */
+    static constexpr int32 MaxFragmentsPerSignature = 500000;
+    static constexpr int32 MaxSignatures = 16;
+
+    FCriticalSection Lock;
+    TMap<FString, TMap<FObjectKey, FEntry>> Entries;
+};
+
+/**
+ * Handler for the get_scene_hash command.
+ * Returns the root hash and per-group hashes so clients only re-fetch the groups that changed.
+ */
+class FMCPGetSceneHashHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetSceneHashHandler()
+        : FMCPCommandHandlerBase(TEXT("get_scene_hash"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the scene_stats command.
+ * The game thread only copies plain per-actor data; counts, bounds, mesh totals and the
+ * top-N ranking are reduced in parallel chunks.
+ */
+class FMCPSceneStatsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPSceneStatsHandler()
+        : FMCPCommandHandlerBase(TEXT("scene_stats"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Immutable copy of one actor's query data. Shared between snapshots while the actor is unchanged.
+ */
+struct FMCPSceneActorSnapshot
+{
+    FGuid Guid;
+    FString Name;
+    FString Label;
+    FName ClassName;
+    FName Folder;
+    FTransform Transform;
+    FBox Bounds = FBox(ForceInit);
+    TArray<FName> Tags;
+};
+
+/**
+ * Read-only version of the scene-query data. Never modified after publication, so any thread may read it.
+ */
+struct FMCPSceneReadSnapshot
+{
+    /** Increases with every publication */
+    uint64 Version = 0;
+    FString LevelName;
+    TArray<TSharedRef<const FMCPSceneActorSnapshot>> Actors;
+};
+
+/**
+ * Publishes copy-on-write snapshots of the scene-query data so read-only commands can run on worker threads.
+ * A new snapshot is built at most once per frame, and only when the scene changed; entries of unchanged
+ * actors are shared with the previous snapshot.
+ */
+class FMCPSceneSnapshotPublisher
+{
+public:
+    static FMCPSceneSnapshotPublisher& Get();
+
+    /** Latest published snapshot, or null before the first publication. Safe to call from any thread. */
+    TSharedPtr<const FMCPSceneReadSnapshot> GetLatest() const;
+
+    /**
+     * Publish first if the scene changed since the last snapshot, then return it.
+     * Game thread only; used by handlers so a read always sees the writes that preceded it.
+     */
+    TSharedPtr<const FMCPSceneReadSnapshot> GetUpToDate(UWorld* World);
+
+    /** Force the next publication to rebuild every entry, e.g. after commands that edit the scene without editor notifications */
+    void MarkDirty() { bDirty = true; }
+
+    /** Stop the per-frame publication and drop the snapshots */
+    void Shutdown();
+
+private:
+    bool Tick(float DeltaTime);
+    bool NeedsPublish(UWorld* World) const;
+    void Publish(UWorld* World);
+
+    mutable FCriticalSection LatestLock;
+    TSharedPtr<const FMCPSceneReadSnapshot> Latest;
+
+    /** Entries of the latest snapshot by actor, reused for unchanged actors. Game thread only. */
+    TMap<FObjectKey, TSharedRef<const FMCPSceneActorSnapshot>> EntriesByActor;
+
+    FTSTicker::FDelegateHandle TickerHandle;
+    TWeakObjectPtr<UWorld> PublishedWorld;
+    uint64 PublishedChangeSerial = 0;
+    uint64 NextVersion = 1;
+    bool bDirty = true;
+};
+
+/**
+ * Handler for the query_scene command.
+ * Filters the latest scene snapshot by class, label, tag, folder and region on a worker thread.
+ */
+class FMCPQuerySceneHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPQuerySceneHandler()
+        : FMCPCommandHandlerBase(TEXT("query_scene"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    virtual bool ExecuteDeferred(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket, TFuture<FString>& OutResponse) override;
+
+    /**
+     * Run the query against a snapshot. Safe to call from any thread.
+     */
+    static TSharedPtr<FJsonObject> RunQuery(const FMCPSceneReadSnapshot& Snapshot, const TSharedPtr<FJsonObject>& Params);
+};
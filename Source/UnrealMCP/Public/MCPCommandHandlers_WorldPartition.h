@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+class UWorldPartition;
+class UWorldPartitionEditorLoaderAdapter;
+
+/**
+ * Utility helpers shared by the World Partition commands.
+ */
+class FMCPWorldPartitionUtils
+{
+public:
+    /**
+     * Get the World Partition of the editor world.
+     * @param OutErrorMessage - Set when there is no editor world or it is not partitioned
+     */
+    static UWorldPartition* GetEditorWorldPartition(UWorld*& OutWorld, FString& OutErrorMessage);
+
+    /**
+     * Read a box either from "bounds": {"min": [x, y, z], "max": [x, y, z]} or from "center" and "extent".
+     * @return False if neither form is present or malformed
+     */
+    static bool ParseBox(const TSharedPtr<FJsonObject>& Params, FBox& OutBox);
+
+    /**
+     * Read the "actor_guids" string array.
+     */
+    static TArray<FGuid> ParseActorGuids(const TSharedPtr<FJsonObject>& Params);
+
+    /**
+     * Loaded regions created by load_world_partition_region, keyed by region id.
+     * The regions are forgotten when another map is loaded or opened.
+     */
+    static TMap<FString, TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter>>& GetLoadedRegions();
+
+    /**
+     * Stop listening for map changes and forget the loaded regions.
+     */
+    static void Shutdown();
+};
+
+/**
+ * Handler that lists World Partition actor descriptors (class, label, GUID, bounds, data layers)
+ * without loading the actors.
+ */
+class FMCPQueryWorldPartitionHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPQueryWorldPartitionHandler()
+        : FMCPCommandHandlerBase(TEXT("query_world_partition"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler that streams in the cells overlapping a box and/or pins individual actors so they stay loaded.
+ */
+class FMCPLoadWorldPartitionRegionHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPLoadWorldPartitionRegionHandler()
+        : FMCPCommandHandlerBase(TEXT("load_world_partition_region"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /** Loaded actors are added to the level without OnLevelActorAdded */
+    virtual bool ModifiesSceneWithoutEvents() const override { return true; }
+};
+
+/**
+ * Handler that releases a region loaded by load_world_partition_region and/or unpins actors.
+ */
+class FMCPUnloadWorldPartitionRegionHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPUnloadWorldPartitionRegionHandler()
+        : FMCPCommandHandlerBase(TEXT("unload_world_partition_region"))
+    {
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /** Unloaded actors leave the level without OnLevelActorDeleted */
+    virtual bool ModifiesSceneWithoutEvents() const override { return true; }
+};
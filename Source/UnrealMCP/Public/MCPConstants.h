@@ -11,18 +11,64 @@ namespace MCPConstants
     constexpr int32 DEFAULT_PORT = 13377;
     constexpr int32 DEFAULT_RECEIVE_BUFFER_SIZE = 65536; // 64KB buffer size
     constexpr int32 DEFAULT_SEND_BUFFER_SIZE = DEFAULT_RECEIVE_BUFFER_SIZE;
+    constexpr int32 MAX_COMMAND_BYTES = 128 * 1024 * 1024; // Largest single command accepted; commands span several reads
+    constexpr int32 MAX_PENDING_SEND_BYTES = MAX_COMMAND_BYTES; // Unsent response bytes a client may fall behind by before it is disconnected
+    constexpr int32 MAX_RECEIVE_BYTES_PER_TICK = 16 * 1024 * 1024; // Bytes read from one client per tick
     constexpr float DEFAULT_CLIENT_TIMEOUT_SECONDS = 30.0f;
     constexpr float DEFAULT_TICK_INTERVAL_SECONDS = 0.1f;
     
-    // Python constants
-    constexpr const TCHAR* PYTHON_TEMP_DIR_NAME = TEXT("PythonTemp");
-    constexpr const TCHAR* PYTHON_TEMP_FILE_PREFIX = TEXT("mcp_temp_script_");
+    // Scene snapshot constants
+    constexpr const TCHAR* SCENE_SNAPSHOT_DIR_NAME = TEXT("MCP/Snapshots");
+    constexpr const TCHAR* SCENE_SNAPSHOT_EXTENSION = TEXT(".mcpsnap");
+    constexpr uint32 SCENE_SNAPSHOT_VERSION = 2;
+    constexpr int32 MAX_RETAINED_SCENE_SNAPSHOTS = 8; // Snapshots kept in memory as incremental bases
+    constexpr int32 MAX_SCENE_SNAPSHOT_FILES = 32; // Newest snapshot files kept on disk; older ones are deleted on export
     
     // Logging constants
     constexpr bool DEFAULT_VERBOSE_LOGGING = false;
     
     // Performance constants
     constexpr int32 MAX_ACTORS_IN_SCENE_INFO = 1000;
+    constexpr int32 MAX_ACTORS_IN_COLUMNAR_SCENE_INFO = 200000; // Columnar rows are a few dozen bytes each
+    constexpr int32 DEFAULT_SCENE_STATS_TOP_N = 10;
+    constexpr int32 MAX_SCENE_STATS_TOP_N = 1000;
+    constexpr int32 DEFAULT_SCENE_STATS_MESHES = 100;
+    constexpr int32 DEFAULT_SCENE_QUERY_RESULTS = 1000;
+    constexpr int32 MAX_SCENE_QUERY_RESULTS = 100000;
+    constexpr int32 DEFAULT_WORLD_PARTITION_DESCRIPTORS = 1000;
+    constexpr int32 MAX_WORLD_PARTITION_DESCRIPTORS = 50000;
+    constexpr int32 DEFAULT_SCATTER_MAX_INSTANCES = 100000;
+    constexpr int32 MAX_SCATTER_INSTANCES = 1000000;
+    constexpr int64 SCATTER_GRID_CELLS_PER_INSTANCE = 16; // Poisson grid cells allowed per requested instance; a full fill uses about 3
+    constexpr int64 MIN_SCATTER_GRID_CELLS = 64 * 1024; // Grid floor so small budgets can still sample modest regions
+    constexpr double DEFAULT_SCATTER_TRACE_DISTANCE = 10000.0;
+    constexpr double DEFAULT_SCATTER_SPLINE_WIDTH = 1000.0;
+    constexpr double DEFAULT_CONSOLIDATE_CELL_SIZE = 12800.0; // Default World Partition runtime grid cell size
+    constexpr int32 MAX_BATCH_TRACES = 1000000; // ~32MB of base64 origins and ends, within MAX_COMMAND_BYTES
+    constexpr double DEFAULT_TRACE_DISTANCE = 100000.0;
+    constexpr int32 MAX_RETAINED_JOBS = 64; // Finished jobs kept for get_job_status
+    constexpr int32 MAX_JOB_OUTPUT_LINES = 10000; // Streamed output lines kept per job
+    constexpr int32 MAX_GENERATED_LODS = 8;
+    constexpr int32 LOD_MESHES_CONFIGURED_PER_TICK = 16; // generate_lods meshes loaded and configured per editor tick
+    constexpr int32 MAX_GENERATED_MESH_SEGMENTS = 1024;
+    constexpr int32 MAX_GENERATED_MESHES_PER_REQUEST = 10000;
+    
+    // Python runtime constants
+    constexpr int32 MAX_CACHED_PYTHON_CODE_OBJECTS = 256; // LRU of compiled execute_python sources
+    constexpr int32 MAX_PYTHON_SNIPPETS = 1024;
+    constexpr int32 MAX_PYTHON_SESSIONS = 64;
+    constexpr double PYTHON_SESSION_IDLE_TIMEOUT_SECONDS = 3600.0; // Sessions unused this long are dropped
+    constexpr float PYTHON_SESSION_EXPIRY_INTERVAL_SECONDS = 60.0f; // How often idle sessions are looked for
+    constexpr double PYTHON_JOB_STEP_BUDGET_SECONDS = 0.015; // Time a Python job may run per editor tick
+    
+    // Data table constants
+    constexpr int32 DATA_TABLE_IMPORT_CHUNK_BYTES = 64 * 1024; // File bytes decoded per read during row imports
+    constexpr int32 MAX_DATA_TABLE_IMPORT_RECORD_CHARS = 1024 * 1024; // Longest CSV record accepted
+    constexpr int32 MAX_DATA_TABLE_IMPORT_ERRORS = 100; // Row errors reported per import
+    constexpr int32 DATA_TABLE_DECODE_BATCH_ROWS = 1024; // Rows decoded in parallel before being added to the table
+    constexpr int32 DEFAULT_DATA_TABLE_QUERY_ROWS = 100;
+    constexpr int32 MAX_DATA_TABLE_QUERY_ROWS = 10000;
+    constexpr int32 DATA_TABLE_INDEX_MIN_ROWS = 256; // Smaller tables are scanned instead of indexed
     
     // Path constants - use these instead of hardcoded paths
     // These will be initialized at runtime in the module startup
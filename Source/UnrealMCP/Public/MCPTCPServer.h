@@ -1,5 +1,6 @@
 #pragma once
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "Containers/Ticker.h"
 #include "Json.h"
 #include "Networking.h"
@@ -47,6 +48,27 @@ struct FMCPClientConnection
     /** Buffer for receiving data */
     TArray<uint8> ReceiveBuffer;
 
+    /** Received bytes that do not yet form a complete command */
+    TArray<uint8> PendingCommandBytes;
+
+    /** Bytes of PendingCommandBytes already scanned for the end of the command */
+    int32 ScannedCommandBytes;
+
+    /** Object and array nesting depth at ScannedCommandBytes */
+    int32 CommandDepth;
+
+    /** Whether the scan stopped inside a JSON string */
+    bool bCommandInString;
+
+    /** Whether the scan stopped after a backslash inside a JSON string */
+    bool bCommandEscaped;
+
+    /** Serialized responses not yet accepted by the socket */
+    TArray<uint8> PendingSendBytes;
+
+    /** Bytes of PendingSendBytes already sent */
+    int32 SentBytes;
+
     /**
      * Constructor
      * @param InSocket - The client socket
@@ -57,6 +79,11 @@ struct FMCPClientConnection
         : Socket(InSocket)
         , Endpoint(InEndpoint)
         , TimeSinceLastActivity(0.0f)
+        , ScannedCommandBytes(0)
+        , CommandDepth(0)
+        , bCommandInString(false)
+        , bCommandEscaped(false)
+        , SentBytes(0)
     {
         ReceiveBuffer.SetNumUninitialized(BufferSize);
     }
@@ -84,6 +111,45 @@ public:
      * @return JSON response object
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) = 0;
+
+    /**
+     * Handle the command with a response that is completed off the game thread
+     * Handlers override this to gather on the game thread and serialize on worker threads
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @param OutResponse - Future yielding the complete serialized JSON response
+     * @return True if OutResponse was set, false to fall back to Execute
+     */
+    virtual bool ExecuteDeferred(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket, TFuture<FString>& OutResponse)
+    {
+        return false;
+    }
+
+    /**
+     * Whether the command may edit arbitrary actors without firing editor events, e.g. by running scripts
+     * The scene caches are fully invalidated after such commands. Handlers that know which actors they edit
+     * keep the default and report them through FMCPSceneChangeTracker::MarkActorDirty instead
+     * @return True if every scene cache must be rebuilt after the command
+     */
+    virtual bool ModifiesSceneWithoutEvents() const
+    {
+        return false;
+    }
+};
+
+/**
+ * A response still being produced by a handler's ExecuteDeferred
+ */
+struct FMCPPendingResponse
+{
+    /** Client the response goes to */
+    FSocket* Socket = nullptr;
+
+    /** Command that produced the response, for logging */
+    FString CommandName;
+
+    /** Serialized JSON response */
+    TFuture<FString> Response;
 };
 
 /**
@@ -155,6 +221,25 @@ public:
      */
     void SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>& Response);
 
+    /**
+     * Send an already serialized response to a client
+     * Bytes the socket cannot take yet are buffered and sent on later ticks
+     * @param Client - The client socket
+     * @param ResponseStr - The serialized JSON response
+     */
+    void SendResponseString(FSocket* Client, const FString& ResponseStr);
+
+    /**
+     * Run a command in-process, without a socket or JSON text, and return its response object.
+     * Handlers that defer their response off the game thread run synchronously through Execute.
+     * @param Type - The command name
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket, if the caller has one; without one, Python sessions opened
+     *                       without a client_id belong to the shared "client:in-process" owner
+     * @return The response, or an error response for an unknown command
+     */
+    TSharedPtr<FJsonObject> ExecuteCommand(const FString& Type, const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket = nullptr);
+
     /**
      * Get the command handlers map (for testing purposes)
      * @return The map of command handlers
@@ -179,12 +264,57 @@ protected:
      */
     virtual void ProcessClientData();
     
+    /**
+     * Split the received bytes of a client into complete JSON commands
+     * Commands may arrive over several reads and several commands may share one read
+     * @param ClientConnection - The client connection whose pending bytes are scanned
+     * @param OutCommands - Complete commands, in arrival order
+     */
+    void ExtractCommands(FMCPClientConnection& ClientConnection, TArray<FString>& OutCommands);
+
+    /**
+     * Send as much of a client's buffered response bytes as the socket accepts
+     * @param ClientConnection - The client connection
+     * @return False if the socket failed
+     */
+    bool FlushPendingSend(FMCPClientConnection& ClientConnection);
+
+    /**
+     * Send the buffered response bytes of every client
+     */
+    virtual void ProcessPendingSends();
+
+    /**
+     * Find the connection of a client socket
+     * @param ClientSocket - The client socket
+     * @return The connection, or nullptr if the socket is not connected
+     */
+    FMCPClientConnection* FindClientConnection(FSocket* ClientSocket);
+
+    /**
+     * Get the sockets of the connected clients, for loops that may add or remove connections
+     * Connections buffer up to MAX_COMMAND_BYTES each, so loops copy these rather than the connections
+     * @return The client sockets
+     */
+    TArray<FSocket*> GetClientSockets() const;
+
     /**
      * Process a command
      * @param CommandJson - The command JSON
      * @param ClientSocket - The client socket
      */
     virtual void ProcessCommand(const FString& CommandJson, FSocket* ClientSocket);
+
+    /**
+     * Send the deferred responses that have completed
+     */
+    virtual void ProcessPendingResponses();
+
+    /**
+     * Wait for and send the deferred responses of one client, so responses keep the order of their commands
+     * @param ClientSocket - The client socket
+     */
+    void FlushPendingResponses(FSocket* ClientSocket);
     
     /**
      * Check for client timeouts
@@ -242,6 +372,9 @@ protected:
     /** Command handlers map */
     TMap<FString, TSharedPtr<IMCPCommandHandler>> CommandHandlers;
 
+    /** Deferred responses waiting to be sent, oldest first */
+    TArray<FMCPPendingResponse> PendingResponses;
+
 private:
     // Disable copy and assignment
     FMCPTCPServer(const FMCPTCPServer&) = delete;
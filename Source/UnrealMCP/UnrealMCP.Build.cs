@@ -36,11 +36,11 @@ public class UnrealMCP : ModuleRules
 		
 		PrivateDependencyModuleNames.AddRange(
 			new string[] { 
-				"Json", "JsonUtilities", "Settings", "InputCore", "PythonScriptPlugin",
+				"Json", "JsonUtilities", "Settings", "InputCore", "PythonScriptPlugin", "Python3",
 				"Kismet", "KismetWidgets", "AssetRegistry", "AssetTools",
 				"GameplayAbilities", "GameplayTags", "GameplayTasks",
 				"UMGEditor", "ModelViewViewModelEditor", "CommonInput",
-				"NiagaraEditor"
+				"NiagaraEditor", "MeshMergeUtilities", "MeshDescription", "StaticMeshDescription"
 
 			}
 		);